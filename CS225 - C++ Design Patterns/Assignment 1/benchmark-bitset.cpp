@@ -0,0 +1,205 @@
+// Times csd2125::bitset against std::bitset and the byte-per-8-bits bitset it replaced.
+// Build with: g++ -std=c++17 -O2 [-mavx2 -mpopcnt] benchmark-bitset.cpp
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <memory>
+#include <bitset>
+#include <stdexcept>
+
+#include "bitset.h"
+
+namespace legacy
+{
+    // The previous csd2125::bitset, cut down to what the benchmark uses
+    template <size_t N>
+    class bitset
+    {
+      public:
+        bitset()
+        {
+            bits = new uint8_t[(N / CHAR_BIT) + (N % CHAR_BIT ? 1 : 0)];
+            for (size_t i = 0; i < N; ++i) { reset(i); }
+        }
+        ~bitset() { delete[](bits); }
+        bitset(const bitset&) = delete;
+        bitset& operator =(const bitset&) = delete;
+
+        bool test(size_t pos) const
+        {
+            if (pos >= N) { throw std::out_of_range("Bit position is out of range!"); }
+            return bits[pos / CHAR_BIT] >> (pos % CHAR_BIT) & 1U;
+        }
+        void set(size_t pos, bool value = true)
+        {
+            if (pos >= N) { throw std::out_of_range("Bit position is out of range!"); }
+            value ? bits[pos / CHAR_BIT] |= static_cast<uint8_t>(1U << (pos % CHAR_BIT)) :
+                    bits[pos / CHAR_BIT] &= static_cast<uint8_t>(~(1U << (pos % CHAR_BIT)));
+        }
+        void reset(size_t pos) { set(pos, false); }
+        size_t count() const
+        {
+            size_t out = 0;
+            for (size_t i = 0; i < N; ++i)
+            {
+                if (test(i)) { ++out; }
+            }
+            return out;
+        }
+
+      private:
+        uint8_t* bits;
+    };
+}
+
+namespace
+{
+    constexpr size_t BITS = size_t{ 1 } << 20;     // 128 KiB, held in L2
+    constexpr int    REPS = 200;
+
+    using Clock = std::chrono::steady_clock;
+
+    // Stops the optimiser from dropping a result
+    volatile size_t sink;
+
+    template <typename Fn>
+    double timeMs(int reps, Fn fn)
+    {
+        const auto START = Clock::now();
+        for (int i = 0; i < reps; ++i) { fn(); }
+        return std::chrono::duration<double, std::milli>(Clock::now() - START).count() / reps;
+    }
+
+    // Sets about one bit in density, the same bits in every implementation
+    template <typename Bitset>
+    void fill(Bitset& bitset, uint32_t seed, uint32_t density)
+    {
+        for (size_t i = 0; i < BITS; ++i)
+        {
+            seed = seed * 1664525U + 1013904223U;
+            if ((seed >> 8) % density == 0) { bitset.set(i); }
+        }
+    }
+
+    // legacyMs is 0 for operations the old bitset didn't have
+    void report(const char* name, double legacyMs, double stdMs, double newMs)
+    {
+        std::cout << std::left << std::setw(22) << name << std::right << std::fixed << std::setprecision(4);
+        if (legacyMs > 0) { std::cout << std::setw(12) << legacyMs; }
+        else              { std::cout << std::setw(12) << "-"; }
+        std::cout << std::setw(12) << stdMs << std::setw(12) << newMs << std::setprecision(1);
+        if (legacyMs > 0) { std::cout << std::setw(10) << legacyMs / newMs << "x"; }
+        else              { std::cout << std::setw(11) << "-"; }
+        std::cout << std::setw(9) << stdMs / newMs << "x" << std::endl;
+    }
+}
+
+int main()
+{
+    using StdBitset = std::bitset<BITS>;
+
+    std::cout << BITS << " bits, ms per operation" << std::endl;
+    std::cout << std::left << std::setw(22) << "operation" << std::right
+              << std::setw(12) << "legacy" << std::setw(12) << "std" << std::setw(12) << "csd2125"
+              << std::setw(11) << "vs legacy" << std::setw(10) << "vs std" << std::endl;
+
+    // Construction
+    {
+        const double LEGACY = timeMs(REPS / 10, [] { legacy::bitset<BITS> b; sink = b.test(0); });
+        const double STD    = timeMs(REPS, [] { auto b = std::make_unique<StdBitset>(); sink = b->test(0); });
+        const double NEW    = timeMs(REPS, [] { csd2125::bitset<BITS> b; sink = b.test(0); });
+        report("construct", LEGACY, STD, NEW);
+    }
+
+    legacy::bitset<BITS> legacyA, legacyB;
+    auto stdA = std::make_unique<StdBitset>();
+    auto stdB = std::make_unique<StdBitset>();
+    csd2125::bitset<BITS> newA, newB;
+    fill(legacyA, 1U, 2U); fill(*stdA, 1U, 2U); fill(newA, 1U, 2U);
+    fill(legacyB, 2U, 2U); fill(*stdB, 2U, 2U); fill(newB, 2U, 2U);
+
+    if (newA.count() != stdA->count() || legacyA.count() != stdA->count())
+    {
+        std::cout << "Implementations disagree!" << std::endl;
+        return 1;
+    }
+
+    // count()
+    {
+        const double LEGACY = timeMs(REPS / 10, [&] { sink = legacyA.count(); });
+        const double STD    = timeMs(REPS, [&] { sink = stdA->count(); });
+        const double NEW    = timeMs(REPS, [&] { sink = newA.count(); });
+        report("count", LEGACY, STD, NEW);
+    }
+
+    // a ^= b, which the old bitset could only do a bit at a time
+    {
+        const double LEGACY = timeMs(REPS / 10, [&]
+        {
+            for (size_t i = 0; i < BITS; ++i) { legacyA.set(i, legacyA.test(i) != legacyB.test(i)); }
+        });
+        const double STD    = timeMs(REPS, [&] { *stdA ^= *stdB; });
+        const double NEW    = timeMs(REPS, [&] { newA ^= newB; });
+        report("a ^= b", LEGACY, STD, NEW);
+    }
+
+    // c = a & b, including allocating the result
+    {
+        const double STD    = timeMs(REPS, [&] { auto c = std::make_unique<StdBitset>(*stdA & *stdB); sink = c->test(0); });
+        const double NEW    = timeMs(REPS, [&] { csd2125::bitset<BITS> c = newA & newB; sink = c.test(0); });
+        report("c = a & b", 0.0, STD, NEW);
+    }
+
+    // a <<= 77
+    {
+        const double STD    = timeMs(REPS, [&] { *stdA <<= 77; });
+        const double NEW    = timeMs(REPS, [&] { newA <<= 77; });
+        report("a <<= 77", 0.0, STD, NEW);
+    }
+
+    // none() on an empty bitset, which has to read every word
+    {
+        legacy::bitset<BITS> legacyEmpty;
+        auto stdEmpty = std::make_unique<StdBitset>();
+        csd2125::bitset<BITS> newEmpty;
+        const double LEGACY = timeMs(REPS / 10, [&] { sink = legacyEmpty.count() == 0; });
+        const double STD    = timeMs(REPS, [&] { sink = stdEmpty->none(); });
+        const double NEW    = timeMs(REPS, [&] { sink = newEmpty.none(); });
+        report("none (empty)", LEGACY, STD, NEW);
+    }
+
+    // Visiting every set bit of a sparse bitset
+    {
+        legacy::bitset<BITS> legacySparse;
+        auto stdSparse = std::make_unique<StdBitset>();
+        csd2125::bitset<BITS> newSparse;
+        fill(legacySparse, 3U, 1000U); fill(*stdSparse, 3U, 1000U); fill(newSparse, 3U, 1000U);
+
+        const double LEGACY = timeMs(REPS / 10, [&]
+        {
+            size_t sum = 0;
+            for (size_t i = 0; i < BITS; ++i) { if (legacySparse.test(i)) { sum += i; } }
+            sink = sum;
+        });
+        const double STD    = timeMs(REPS, [&]
+        {
+            size_t sum = 0;
+        #if defined(__GLIBCXX__)
+            for (size_t i = stdSparse->_Find_first(); i < BITS; i = stdSparse->_Find_next(i)) { sum += i; }
+        #else
+            for (size_t i = 0; i < BITS; ++i) { if (stdSparse->test(i)) { sum += i; } }
+        #endif
+            sink = sum;
+        });
+        const double NEW    = timeMs(REPS, [&]
+        {
+            size_t sum = 0;
+            for (size_t i = newSparse.find_first(); i < BITS; i = newSparse.find_next(i)) { sum += i; }
+            sink = sum;
+        });
+        report("iterate (0.1% set)", LEGACY, STD, NEW);
+    }
+}
@@ -16,10 +16,19 @@ of DigiPen Institute of Technology is prohibited.
 
 // Standard libraries
 #include <cstdlib>   // size_t
+#include <cstdint>
 #include <string>
 
 namespace csd2125
 {
+    /********************************************************************************//*!
+    @brief	    A fixed-size set of N bits.
+
+                The bits are packed into 64-bit words, on the heap so the object stays
+                the size of a pointer. The words are aligned to and padded out to whole
+                cache lines, so the bulk operations work on full SIMD vectors with no
+                tail, and every bit past N is kept clear.
+    *//*********************************************************************************/
     template <size_t N>
     class bitset
     {
@@ -32,6 +41,23 @@ namespace csd2125
         *//*****************************************************************************/
         constexpr bitset();
 
+        /****************************************************************************//*!
+        @brief	    Copy constructor for bitset.
+
+        @param[in]  other
+            The bitset to copy.
+        *//*****************************************************************************/
+        bitset(const bitset& other);
+
+        /****************************************************************************//*!
+        @brief	    Move constructor for bitset. The moved-from bitset can only be
+                    assigned to or destroyed.
+
+        @param[in]  other
+            The bitset to move.
+        *//*****************************************************************************/
+        bitset(bitset&& other) noexcept;
+
         /****************************************************************************//*!
         @brief	    Destructor for bitset.
         *//*****************************************************************************/
@@ -51,6 +77,90 @@ namespace csd2125
         *//*****************************************************************************/
         bool operator [](size_t pos) const;
 
+        /****************************************************************************//*!
+        @brief	    Copy assignment operator.
+
+        @param[in]  other
+            The bitset to copy.
+
+        @returns    A reference to this bitset.
+        *//*****************************************************************************/
+        bitset& operator =(const bitset& other);
+
+        /****************************************************************************//*!
+        @brief	    Move assignment operator.
+
+        @param[in]  other
+            The bitset to move.
+
+        @returns    A reference to this bitset.
+        *//*****************************************************************************/
+        bitset& operator =(bitset&& other) noexcept;
+
+        /****************************************************************************//*!
+        @brief	    Bitwise AND, OR and XOR with another bitset, a SIMD vector of words
+                    at a time.
+
+        @param[in]  other
+            The other bitset.
+
+        @returns    A reference to this bitset.
+        *//*****************************************************************************/
+        bitset& operator &=(const bitset& other);
+        bitset& operator |=(const bitset& other);
+        bitset& operator ^=(const bitset& other);
+
+        /****************************************************************************//*!
+        @brief	    Gets a copy of the bitset with every bit flipped.
+
+        @returns    The flipped bitset.
+        *//*****************************************************************************/
+        bitset operator ~() const;
+
+        /****************************************************************************//*!
+        @brief	    Shifts the bits towards higher positions, a word at a time. Bits
+                    shifted past N are lost, and the low bits are cleared.
+
+        @param[in]  shift
+            The number of positions to shift by.
+
+        @returns    A reference to this bitset.
+        *//*****************************************************************************/
+        bitset& operator <<=(size_t shift);
+
+        /****************************************************************************//*!
+        @brief	    Shifts the bits towards lower positions, a word at a time. The high
+                    bits are cleared.
+
+        @param[in]  shift
+            The number of positions to shift by.
+
+        @returns    A reference to this bitset.
+        *//*****************************************************************************/
+        bitset& operator >>=(size_t shift);
+
+        /****************************************************************************//*!
+        @brief	    Gets a shifted copy of the bitset.
+
+        @param[in]  shift
+            The number of positions to shift by.
+
+        @returns    The shifted bitset.
+        *//*****************************************************************************/
+        bitset operator <<(size_t shift) const;
+        bitset operator >>(size_t shift) const;
+
+        /****************************************************************************//*!
+        @brief	    Compares two bitsets.
+
+        @param[in]  other
+            The other bitset.
+
+        @returns    True if every bit is the same.
+        *//*****************************************************************************/
+        bool operator ==(const bitset& other) const;
+        bool operator !=(const bitset& other) const;
+
         /*-----------------------------------------------------------------------------*/
         /* Member Functions				     						   				   */
         /*-----------------------------------------------------------------------------*/
@@ -94,12 +204,39 @@ namespace csd2125
         std::string to_string(char clearBit = '0', char setBit = '1') const;
 
         /****************************************************************************//*!
-        @brief	    Counts the number of set bits.
+        @brief	    Counts the number of set bits, with a popcount per word.
 
         @returns    The number of set bits.
         *//*****************************************************************************/
         size_t count() const;
 
+        /****************************************************************************//*!
+        @brief	    Checks if any, none or all of the bits are set, a word at a time.
+
+        @returns    True if the bits are as asked.
+        *//*****************************************************************************/
+        bool any() const;
+        bool none() const;
+        bool all() const;
+
+        /****************************************************************************//*!
+        @brief	    Finds the lowest set bit.
+
+        @returns    The position of the bit, or N if no bit is set.
+        *//*****************************************************************************/
+        size_t find_first() const;
+
+        /****************************************************************************//*!
+        @brief	    Finds the lowest set bit above a position. With find_first(), visits
+                    every set bit while skipping whole words of clear ones.
+
+        @param[in]  pos
+            The position to search above.
+
+        @returns    The position of the bit, or N if no bit above pos is set.
+        *//*****************************************************************************/
+        size_t find_next(size_t pos) const;
+
         /****************************************************************************//*!
         @brief	    Getter for the size of the bitset
 
@@ -121,9 +258,99 @@ namespace csd2125
         /*-----------------------------------------------------------------------------*/
         /* Member Variables				     						   				   */
         /*-----------------------------------------------------------------------------*/
-        uint8_t* bits;
-        
+        static constexpr size_t         WORD_BITS   = 64;
+        static constexpr size_t         WORDS       = (N + WORD_BITS - 1) / WORD_BITS;   // Words holding the bits
+        static constexpr size_t         ALIGNMENT   = 64;                               // One cache line
+        static constexpr size_t         STORED      = (WORDS + 7) / 8 * 8;              // Words allocated, whole cache lines
+        static constexpr std::uint64_t  LAST_MASK   = N % WORD_BITS ? (std::uint64_t{ 1 } << N % WORD_BITS) - 1 : ~std::uint64_t{ 0 };
+
+        std::uint64_t* bits;
+
+        /*-----------------------------------------------------------------------------*/
+        /* Helper Functions				     						   				   */
+        /*-----------------------------------------------------------------------------*/
+
+        /****************************************************************************//*!
+        @brief	    Tag for the constructor that leaves the words uninitialised.
+        *//*****************************************************************************/
+        struct NoInit {};
+
+        /****************************************************************************//*!
+        @brief	    Constructs a bitset without clearing its words, for results that
+                    overwrite every word.
+        *//*****************************************************************************/
+        explicit bitset(NoInit);
+
+        /****************************************************************************//*!
+        @brief	    Allocates aligned words for a bitset, without clearing them.
+
+        @returns    The words.
+        *//*****************************************************************************/
+        static std::uint64_t* allocate();
+
+        /****************************************************************************//*!
+        @brief	    Frees the words of a bitset.
+
+        @param[in]  words
+            The words, or nullptr.
+        *//*****************************************************************************/
+        static void deallocate(std::uint64_t* words);
+
+        /****************************************************************************//*!
+        @brief	    Combines the words of two bitsets into a third, a SIMD vector at a
+                    time. Any of them can be the same.
+
+        @param[out] out
+            The words to write.
+        @param[in]  lhs
+            The left words.
+        @param[in]  rhs
+            The right words.
+        *//*****************************************************************************/
+        template <typename Op>
+        static void combine(std::uint64_t* out, const std::uint64_t* lhs, const std::uint64_t* rhs);
+
+        /****************************************************************************//*!
+        @brief	    Clears the bits past N, after an operation that may have set them.
+        *//*****************************************************************************/
+        void clearPadding();
+
+        /****************************************************************************//*!
+        @brief	    Finds the lowest set bit at or above the start of a word.
+
+        @param[in]  word
+            The index of the word to start from.
+        @param[in]  value
+            The bits of that word to search.
+
+        @returns    The position of the bit, or N if there is none.
+        *//*****************************************************************************/
+        size_t findFrom(size_t word, std::uint64_t value) const;
+
+        template <size_t M>
+        friend bitset<M> operator &(const bitset<M>& lhs, const bitset<M>& rhs);
+        template <size_t M>
+        friend bitset<M> operator |(const bitset<M>& lhs, const bitset<M>& rhs);
+        template <size_t M>
+        friend bitset<M> operator ^(const bitset<M>& lhs, const bitset<M>& rhs);
     };
+
+    /************************************************************************************//*!
+    @brief	    Bitwise AND, OR and XOR of two bitsets, in one pass over their words.
+
+    @param[in]  lhs
+        The left bitset.
+    @param[in]  rhs
+        The right bitset.
+
+    @returns    The combined bitset.
+    *//*************************************************************************************/
+    template <size_t N>
+    bitset<N> operator &(const bitset<N>& lhs, const bitset<N>& rhs);
+    template <size_t N>
+    bitset<N> operator |(const bitset<N>& lhs, const bitset<N>& rhs);
+    template <size_t N>
+    bitset<N> operator ^(const bitset<N>& lhs, const bitset<N>& rhs);
 } // namespace csd2125
 
 #endif // BITSET_H
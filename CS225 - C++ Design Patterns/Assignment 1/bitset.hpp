@@ -21,9 +21,97 @@ of DigiPen Institute of Technology is prohibited.
 #include <sstream>
 #include <stdexcept>
 #include <climits>
+#include <cstring>
+#include <new>
+#include <utility>
+// Intrinsics
+#if defined(__SSE2__) || defined(_M_X64)
+    #include <immintrin.h>
+#endif
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#endif
 
 namespace csd2125
 {
+    namespace detail
+    {
+        /*-----------------------------------------------------------------------------*/
+        /* Word Helpers                                                                */
+        /*-----------------------------------------------------------------------------*/
+
+        // Number of set bits in a word, a single instruction where the target has one
+        inline size_t popcount(std::uint64_t word)
+        {
+        #if defined(_MSC_VER)
+            return static_cast<size_t>(__popcnt64(word));
+        #else
+            return static_cast<size_t>(__builtin_popcountll(word));
+        #endif
+        }
+
+        // Index of the lowest set bit of a non-zero word
+        inline size_t lowestBit(std::uint64_t word)
+        {
+        #if defined(_MSC_VER)
+            unsigned long index;
+            _BitScanForward64(&index, word);
+            return static_cast<size_t>(index);
+        #else
+            return static_cast<size_t>(__builtin_ctzll(word));
+        #endif
+        }
+
+        /*-----------------------------------------------------------------------------*/
+        /* Bitwise Operations                                                          */
+        /*-----------------------------------------------------------------------------*/
+
+        // Each applies to a word, an SSE2 vector and an AVX2 vector. NotOp ignores rhs.
+        struct AndOp
+        {
+            static std::uint64_t apply(std::uint64_t lhs, std::uint64_t rhs) { return lhs & rhs; }
+        #if defined(__SSE2__) || defined(_M_X64)
+            static __m128i apply(__m128i lhs, __m128i rhs) { return _mm_and_si128(lhs, rhs); }
+        #endif
+        #if defined(__AVX2__)
+            static __m256i apply(__m256i lhs, __m256i rhs) { return _mm256_and_si256(lhs, rhs); }
+        #endif
+        };
+
+        struct OrOp
+        {
+            static std::uint64_t apply(std::uint64_t lhs, std::uint64_t rhs) { return lhs | rhs; }
+        #if defined(__SSE2__) || defined(_M_X64)
+            static __m128i apply(__m128i lhs, __m128i rhs) { return _mm_or_si128(lhs, rhs); }
+        #endif
+        #if defined(__AVX2__)
+            static __m256i apply(__m256i lhs, __m256i rhs) { return _mm256_or_si256(lhs, rhs); }
+        #endif
+        };
+
+        struct XorOp
+        {
+            static std::uint64_t apply(std::uint64_t lhs, std::uint64_t rhs) { return lhs ^ rhs; }
+        #if defined(__SSE2__) || defined(_M_X64)
+            static __m128i apply(__m128i lhs, __m128i rhs) { return _mm_xor_si128(lhs, rhs); }
+        #endif
+        #if defined(__AVX2__)
+            static __m256i apply(__m256i lhs, __m256i rhs) { return _mm256_xor_si256(lhs, rhs); }
+        #endif
+        };
+
+        struct NotOp
+        {
+            static std::uint64_t apply(std::uint64_t lhs, std::uint64_t) { return ~lhs; }
+        #if defined(__SSE2__) || defined(_M_X64)
+            static __m128i apply(__m128i lhs, __m128i) { return _mm_xor_si128(lhs, _mm_set1_epi32(-1)); }
+        #endif
+        #if defined(__AVX2__)
+            static __m256i apply(__m256i lhs, __m256i) { return _mm256_xor_si256(lhs, _mm256_set1_epi32(-1)); }
+        #endif
+        };
+    } // namespace detail
+
     /*---------------------------------------------------------------------------------*/
     /* Constructors & Destructors                                                      */
     /*---------------------------------------------------------------------------------*/
@@ -36,14 +124,33 @@ namespace csd2125
             throw std::invalid_argument("Size of bitset cannot be lesser or equal to 0!");
         }
 
-        bits = new uint8_t[(N / CHAR_BIT) + (N % CHAR_BIT ? 1 : 0)];
-        for (size_t i = 0; i < N; ++i) { reset(i); }
+        bits = allocate();
+        std::memset(bits, 0, STORED * sizeof(std::uint64_t));
     } 
 
+    template <size_t N>
+    bitset<N>::bitset(const bitset& other)
+    : bits { allocate() }
+    {
+        std::memcpy(bits, other.bits, STORED * sizeof(std::uint64_t));
+    }
+
+    template <size_t N>
+    bitset<N>::bitset(bitset&& other) noexcept
+    : bits { other.bits }
+    {
+        other.bits = nullptr;
+    }
+
+    template <size_t N>
+    bitset<N>::bitset(NoInit)
+    : bits { allocate() }
+    {}
+
     template <size_t N>
     bitset<N>::~bitset()
     {
-        delete[](bits);
+        deallocate(bits);
     }
 
     /*---------------------------------------------------------------------------------*/
@@ -53,12 +160,163 @@ namespace csd2125
     template <size_t N>
     bool bitset<N>::operator [](size_t pos) const
     {
-        if (pos >= N || pos < 0) { throw std::out_of_range("Bit position is out of range!"); }
+        if (pos >= N) { throw std::out_of_range("Bit position is out of range!"); }
+
+        return bits[pos / WORD_BITS] >> (pos % WORD_BITS) & 1U;
+    }
+
+    template <size_t N>
+    bitset<N>& bitset<N>::operator =(const bitset& other)
+    {
+        if (this == &other) { return *this; }
+
+        // A moved-from bitset has no words to copy into
+        if (!bits) { bits = allocate(); }
+
+        std::memcpy(bits, other.bits, STORED * sizeof(std::uint64_t));
+        return *this;
+    }
+
+    template <size_t N>
+    bitset<N>& bitset<N>::operator =(bitset&& other) noexcept
+    {
+        std::swap(bits, other.bits);
+        return *this;
+    }
+
+    template <size_t N>
+    bitset<N>& bitset<N>::operator &=(const bitset& other)
+    {
+        combine<detail::AndOp>(bits, bits, other.bits);
+        return *this;
+    }
+
+    template <size_t N>
+    bitset<N>& bitset<N>::operator |=(const bitset& other)
+    {
+        combine<detail::OrOp>(bits, bits, other.bits);
+        return *this;
+    }
+
+    template <size_t N>
+    bitset<N>& bitset<N>::operator ^=(const bitset& other)
+    {
+        combine<detail::XorOp>(bits, bits, other.bits);
+        return *this;
+    }
+
+    template <size_t N>
+    bitset<N> bitset<N>::operator ~() const
+    {
+        bitset out { NoInit{} };
+        combine<detail::NotOp>(out.bits, bits, bits);
+        out.clearPadding();
+        return out;
+    }
+
+    template <size_t N>
+    bitset<N>& bitset<N>::operator <<=(size_t shift)
+    {
+        if (shift >= N)
+        {
+            std::memset(bits, 0, WORDS * sizeof(std::uint64_t));
+            return *this;
+        }
+
+        const size_t WORD_SHIFT = shift / WORD_BITS;
+        const size_t BIT_SHIFT  = shift % WORD_BITS;
+
+        // Go from the top down so every source word is read before it is overwritten
+        for (size_t i = WORDS - 1; i > WORD_SHIFT; --i)
+        {
+            const std::uint64_t LOW = bits[i - WORD_SHIFT];
+            const std::uint64_t CARRY = BIT_SHIFT ? bits[i - WORD_SHIFT - 1] >> (WORD_BITS - BIT_SHIFT) : 0;
+            bits[i] = LOW << BIT_SHIFT | CARRY;
+        }
+        bits[WORD_SHIFT] = bits[0] << BIT_SHIFT;
+        std::memset(bits, 0, WORD_SHIFT * sizeof(std::uint64_t));
+
+        clearPadding();
+        return *this;
+    }
+
+    template <size_t N>
+    bitset<N>& bitset<N>::operator >>=(size_t shift)
+    {
+        if (shift >= N)
+        {
+            std::memset(bits, 0, WORDS * sizeof(std::uint64_t));
+            return *this;
+        }
+
+        const size_t WORD_SHIFT = shift / WORD_BITS;
+        const size_t BIT_SHIFT  = shift % WORD_BITS;
+        const size_t LAST       = WORDS - 1 - WORD_SHIFT;
+
+        // Go from the bottom up so every source word is read before it is overwritten
+        for (size_t i = 0; i < LAST; ++i)
+        {
+            const std::uint64_t HIGH = bits[i + WORD_SHIFT];
+            const std::uint64_t CARRY = BIT_SHIFT ? bits[i + WORD_SHIFT + 1] << (WORD_BITS - BIT_SHIFT) : 0;
+            bits[i] = HIGH >> BIT_SHIFT | CARRY;
+        }
+        bits[LAST] = bits[WORDS - 1] >> BIT_SHIFT;
+        std::memset(bits + LAST + 1, 0, WORD_SHIFT * sizeof(std::uint64_t));
+
+        return *this;
+    }
+
+    template <size_t N>
+    bitset<N> bitset<N>::operator <<(size_t shift) const
+    {
+        bitset out { *this };
+        out <<= shift;
+        return out;
+    }
+
+    template <size_t N>
+    bitset<N> bitset<N>::operator >>(size_t shift) const
+    {
+        bitset out { *this };
+        out >>= shift;
+        return out;
+    }
 
-        size_t addressOffset = pos / CHAR_BIT;
-        size_t bitOffset = pos % CHAR_BIT;
+    template <size_t N>
+    bool bitset<N>::operator ==(const bitset& other) const
+    {
+        // The padding is always clear, so whole words compare
+        return std::memcmp(bits, other.bits, WORDS * sizeof(std::uint64_t)) == 0;
+    }
 
-        return *(bits + addressOffset) >> bitOffset & 1U;
+    template <size_t N>
+    bool bitset<N>::operator !=(const bitset& other) const
+    {
+        return !(*this == other);
+    }
+
+    template <size_t N>
+    bitset<N> operator &(const bitset<N>& lhs, const bitset<N>& rhs)
+    {
+        bitset<N> out { typename bitset<N>::NoInit{} };
+        bitset<N>::template combine<detail::AndOp>(out.bits, lhs.bits, rhs.bits);
+        return out;
+    }
+
+    template <size_t N>
+    bitset<N> operator |(const bitset<N>& lhs, const bitset<N>& rhs)
+    {
+        bitset<N> out { typename bitset<N>::NoInit{} };
+        bitset<N>::template combine<detail::OrOp>(out.bits, lhs.bits, rhs.bits);
+        return out;
+    }
+
+    template <size_t N>
+    bitset<N> operator ^(const bitset<N>& lhs, const bitset<N>& rhs)
+    {
+        bitset<N> out { typename bitset<N>::NoInit{} };
+        bitset<N>::template combine<detail::XorOp>(out.bits, lhs.bits, rhs.bits);
+        return out;
     }
 
     /*---------------------------------------------------------------------------------*/
@@ -69,60 +327,57 @@ namespace csd2125
     void bitset<N>::set(size_t pos, bool value)
     {
         // Check if input pos is valid
-        if (pos >= N || pos < 0) { throw std::out_of_range("Bit position is out of range!"); }
+        if (pos >= N) { throw std::out_of_range("Bit position is out of range!"); }
 
         // Get appropriate offsets
-        size_t addressOffset = pos / CHAR_BIT;
-        size_t bitOffset = pos % CHAR_BIT;
+        const size_t WORD = pos / WORD_BITS;
+        const std::uint64_t MASK = std::uint64_t{ 1 } << (pos % WORD_BITS);
 
         // Set bit
-        value ? *(bits + addressOffset) |= static_cast<uint8_t>(1U << bitOffset) :
-                *(bits + addressOffset) &= static_cast<uint8_t>(~(1U << bitOffset)) ;      
+        value ? bits[WORD] |= MASK : bits[WORD] &= ~MASK;
     }
 
     template <size_t N>
     void bitset<N>::reset(size_t pos)
     {
-        if (pos >= N || pos < 0) { throw std::out_of_range("Bit position is out of range!"); }
+        if (pos >= N) { throw std::out_of_range("Bit position is out of range!"); }
 
-        size_t addressOffset = pos / CHAR_BIT;
-        size_t bitOffset = pos % CHAR_BIT;
-
-        *(bits + addressOffset) &= static_cast<uint8_t>(~(1U << bitOffset));
+        bits[pos / WORD_BITS] &= ~(std::uint64_t{ 1 } << (pos % WORD_BITS));
     }
 
     template <size_t N>
     void bitset<N>::flip(size_t pos)
     {
-        if (pos >= N || pos < 0) { throw std::out_of_range("Bit position is out of range!"); }
-
-        size_t addressOffset = pos / CHAR_BIT;
-        size_t bitOffset = pos % CHAR_BIT;
+        if (pos >= N) { throw std::out_of_range("Bit position is out of range!"); }
 
-        *(bits + addressOffset) ^= static_cast<uint8_t>(1U << bitOffset);
+        bits[pos / WORD_BITS] ^= std::uint64_t{ 1 } << (pos % WORD_BITS);
     }
 
     template <size_t N>
     std::string bitset<N>::to_string(char clearBit, char setBit) const
     {
-        std::stringstream ss;
-        for (size_t i = 1; i <= N; ++i)
+        std::string out(N, clearBit);
+        for (size_t i = find_first(); i < N; i = find_next(i))
         {
-            char bitValue = (*this)[N-i] ? setBit : clearBit;
-            ss << bitValue;
+            out[N - 1 - i] = setBit;
         }
-        return ss.str();
+        return out;
     }
 
     template <size_t N>
     size_t bitset<N>::count() const
     {
-        size_t out = 0;
-        for (size_t i = 0; i < N; ++i)
+        // Separate sums so the popcounts don't wait on each other. The padding is
+        // clear and STORED is a multiple of 4, so there is no tail.
+        size_t sums[4] = {};
+        for (size_t i = 0; i < STORED; i += 4)
         {
-            if ((*this)[i]) { ++out; }
+            sums[0] += detail::popcount(bits[i]);
+            sums[1] += detail::popcount(bits[i + 1]);
+            sums[2] += detail::popcount(bits[i + 2]);
+            sums[3] += detail::popcount(bits[i + 3]);
         }
-        return out;
+        return sums[0] + sums[1] + sums[2] + sums[3];
     }
 
     template <size_t N>
@@ -137,6 +392,109 @@ namespace csd2125
         return (*this)[pos];
     }
 
+    template <size_t N>
+    bool bitset<N>::any() const
+    {
+        std::uint64_t found = 0;
+        for (size_t i = 0; i < WORDS; ++i) { found |= bits[i]; }
+        return found != 0;
+    }
+
+    template <size_t N>
+    bool bitset<N>::none() const
+    {
+        return !any();
+    }
+
+    template <size_t N>
+    bool bitset<N>::all() const
+    {
+        std::uint64_t full = ~std::uint64_t{ 0 };
+        for (size_t i = 0; i + 1 < WORDS; ++i) { full &= bits[i]; }
+        return full == ~std::uint64_t{ 0 } && bits[WORDS - 1] == LAST_MASK;
+    }
+
+    template <size_t N>
+    size_t bitset<N>::find_first() const
+    {
+        return findFrom(0, bits[0]);
+    }
+
+    template <size_t N>
+    size_t bitset<N>::find_next(size_t pos) const
+    {
+        if (pos + 1 >= N) { return N; }
+
+        ++pos;
+        const size_t WORD = pos / WORD_BITS;
+        return findFrom(WORD, bits[WORD] & (~std::uint64_t{ 0 } << (pos % WORD_BITS)));
+    }
+
+    /*---------------------------------------------------------------------------------*/
+    /* Helper Functions                                                                */
+    /*---------------------------------------------------------------------------------*/
+
+    template <size_t N>
+    std::uint64_t* bitset<N>::allocate()
+    {
+        return static_cast<std::uint64_t*>
+        (
+            ::operator new(STORED * sizeof(std::uint64_t), std::align_val_t{ ALIGNMENT })
+        );
+    }
+
+    template <size_t N>
+    void bitset<N>::deallocate(std::uint64_t* words)
+    {
+        if (words) { ::operator delete(words, std::align_val_t{ ALIGNMENT }); }
+    }
+
+    template <size_t N>
+    template <typename Op>
+    void bitset<N>::combine(std::uint64_t* out, const std::uint64_t* lhs, const std::uint64_t* rhs)
+    {
+        // STORED is whole cache lines and the words are aligned to one, so there is no
+        // tail and every load is aligned
+    #if defined(__AVX2__)
+        for (size_t i = 0; i < STORED; i += 4)
+        {
+            const __m256i LHS = _mm256_load_si256(reinterpret_cast<const __m256i*>(lhs + i));
+            const __m256i RHS = _mm256_load_si256(reinterpret_cast<const __m256i*>(rhs + i));
+            _mm256_store_si256(reinterpret_cast<__m256i*>(out + i), Op::apply(LHS, RHS));
+        }
+    #elif defined(__SSE2__) || defined(_M_X64)
+        for (size_t i = 0; i < STORED; i += 2)
+        {
+            const __m128i LHS = _mm_load_si128(reinterpret_cast<const __m128i*>(lhs + i));
+            const __m128i RHS = _mm_load_si128(reinterpret_cast<const __m128i*>(rhs + i));
+            _mm_store_si128(reinterpret_cast<__m128i*>(out + i), Op::apply(LHS, RHS));
+        }
+    #else
+        for (size_t i = 0; i < STORED; ++i)
+        {
+            out[i] = Op::apply(lhs[i], rhs[i]);
+        }
+    #endif
+    }
+
+    template <size_t N>
+    void bitset<N>::clearPadding()
+    {
+        bits[WORDS - 1] &= LAST_MASK;
+        std::memset(bits + WORDS, 0, (STORED - WORDS) * sizeof(std::uint64_t));
+    }
+
+    template <size_t N>
+    size_t bitset<N>::findFrom(size_t word, std::uint64_t value) const
+    {
+        while (value == 0)
+        {
+            if (++word == WORDS) { return N; }
+            value = bits[word];
+        }
+        return word * WORD_BITS + detail::lowestBit(value);
+    }
+
 } // namespace csd2125
 
-#endif // BITSET_HPP
\ No newline at end of file
+#endif // BITSET_HPP
@@ -7,6 +7,7 @@
 #include <exception>
 
 #ifndef USE_STL_BITSET
+    #include <bitset>       // Reference for the bulk operations
     #include "bitset.h"
     namespace ns = csd2125;
 #else
@@ -318,6 +319,145 @@ namespace {
 		}
 	}
 
+	// Fills both bitsets with the same pseudo-random bits
+	template <size_t N>
+	void fill(ns::bitset<N>& bitset, std::bitset<N>& reference, uint32_t seed)
+	{
+		std::string bits(N, '0');
+		for (size_t i = 0; i < N; ++i)
+		{
+			seed = seed * 1664525U + 1013904223U;
+			const bool VALUE = (seed >> 16) & 1U;
+			bitset.set(i, VALUE);
+			bits[N - 1 - i] = VALUE ? '1' : '0';
+		}
+		reference = std::bitset<N>{ bits };
+	}
+
+	template <size_t N>
+	bool matches(const ns::bitset<N>& bitset, const std::bitset<N>& reference)
+	{
+		return bitset.to_string() == reference.to_string() && bitset.count() == reference.count();
+	}
+
+	void test22()
+	{
+		constexpr size_t SIZE = 1000;
+		ns::bitset<SIZE> lhs, rhs;
+		std::bitset<SIZE> lhsRef, rhsRef;
+		fill(lhs, lhsRef, 1U);
+		fill(rhs, rhsRef, 2U);
+
+		if (!matches(lhs & rhs, lhsRef & rhsRef) || !matches(lhs | rhs, lhsRef | rhsRef) ||
+			!matches(lhs ^ rhs, lhsRef ^ rhsRef) || !matches(~lhs, ~lhsRef))
+		{
+			throw std::runtime_error{"Bitwise operators did not work."};
+		}
+
+		lhs &= rhs;
+		lhsRef &= rhsRef;
+		lhs |= ~rhs;
+		lhsRef |= ~rhsRef;
+		lhs ^= rhs;
+		lhsRef ^= rhsRef;
+		if (!matches(lhs, lhsRef))
+		{
+			throw std::runtime_error{"Bitwise assignment operators did not work."};
+		}
+	}
+
+	void test23()
+	{
+		constexpr size_t SIZE = 200;
+		ns::bitset<SIZE> bitset;
+		std::bitset<SIZE> reference;
+		fill(bitset, reference, 3U);
+
+		for (size_t shift = 0; shift <= SIZE + 1; ++shift)
+		{
+			if (!matches(bitset << shift, reference << shift) || !matches(bitset >> shift, reference >> shift))
+			{
+				throw std::runtime_error{"Shifting by " + std::to_string(shift) + " did not work."};
+			}
+		}
+	}
+
+	void test24()
+	{
+		ns::bitset<64> word;
+		ns::bitset<65> overWord;
+		if (word.any() || !word.none() || word.all() || overWord.any())
+		{
+			throw std::runtime_error{"Empty bitsets should have no bits set."};
+		}
+
+		word = ~word;
+		overWord = ~overWord;
+		if (!word.all() || !overWord.all() || overWord.count() != 65)
+		{
+			throw std::runtime_error{"Flipped bitsets should have every bit set."};
+		}
+
+		overWord.reset(64);
+		if (overWord.all() || !overWord.any() || (overWord << 1).count() != 64)
+		{
+			throw std::runtime_error{"Bits past the size should never be set."};
+		}
+	}
+
+	void test25()
+	{
+		constexpr size_t SIZE = 300;
+		ns::bitset<SIZE> bitset;
+		if (bitset.find_first() != SIZE)
+		{
+			throw std::runtime_error{"An empty bitset should have no first bit."};
+		}
+
+		std::bitset<SIZE> reference;
+		fill(bitset, reference, 4U);
+		bitset.reset(0);
+		bitset.set(SIZE - 1);
+
+		size_t visited = 0;
+		size_t last = 0;
+		for (size_t i = bitset.find_first(); i < SIZE; i = bitset.find_next(i))
+		{
+			if (!bitset.test(i) || (visited && i <= last))
+			{
+				throw std::runtime_error{"Finding set bits did not work."};
+			}
+			last = i;
+			++visited;
+		}
+
+		if (visited != bitset.count() || last != SIZE - 1 || bitset.find_next(SIZE - 1) != SIZE)
+		{
+			throw std::runtime_error{"Finding set bits missed some."};
+		}
+	}
+
+	void test26()
+	{
+		ns::bitset<100> bitset;
+		bitset.set(7);
+		bitset.set(99);
+
+		ns::bitset<100> copy{ bitset };
+		ns::bitset<100> moved{ std::move(copy) };
+		if (moved != bitset || !(moved == bitset))
+		{
+			throw std::runtime_error{"Copied bitsets should be equal."};
+		}
+
+		copy = moved;
+		copy.flip(7);
+		if (copy == bitset || !moved.test(7))
+		{
+			throw std::runtime_error{"Copies should not share bits."};
+		}
+	}
+
 #endif
 
     void run(std::size_t& testIndex, void (*test)()) 
@@ -345,7 +485,7 @@ namespace {
 
 int main() 
 {
-    constexpr uint32_t max_tests{21};
+    constexpr uint32_t max_tests{26};
     std::array<void (*)(), max_tests> tests = 
     { 
         test1,
@@ -370,6 +510,11 @@ int main()
         test19, 
         test20, 
         test21,
+        test22,
+        test23,
+        test24,
+        test25,
+        test26,
 #endif
     };
 
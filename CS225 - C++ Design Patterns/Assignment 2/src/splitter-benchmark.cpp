@@ -0,0 +1,147 @@
+// Times splitting a large file and joining it back with the standard streams and
+// with the high-throughput engine (-f), and checks every output against the input.
+// Build with: make benchmark
+// Run with:   ./splitter-benchmark [GiB, default 4] [scratch directory, default bench-data]
+
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "splitter.h"
+
+namespace
+{
+    namespace fs = std::filesystem;
+    using Clock = std::chrono::steady_clock;
+
+    constexpr std::uintmax_t GIB        = std::uintmax_t{1} << 30;
+    constexpr int            CHUNK_SIZE = 256 << 20;
+    constexpr size_t         BLOCK      = size_t{8} << 20;
+
+    // Fills the file with pseudo-random bytes, so nothing compresses or dedupes it
+    void generate(const fs::path& path, std::uintmax_t bytes)
+    {
+        std::unique_ptr<std::uint64_t[]> block {new std::uint64_t[BLOCK / 8]};
+        std::uint64_t state = 0x9E3779B97F4A7C15ULL;
+        std::ofstream file {path, std::ios::binary};
+        for (std::uintmax_t written = 0; written < bytes; written += BLOCK)
+        {
+            for (size_t i = 0; i < BLOCK / 8; ++i)
+            {
+                state ^= state << 13; state ^= state >> 7; state ^= state << 17;
+                block[i] = state;
+            }
+            file.write(reinterpret_cast<const char*>(block.get()), static_cast<std::streamsize>(std::min<std::uintmax_t>(BLOCK, bytes - written)));
+        }
+    }
+
+    bool sameContents(const fs::path& lhs, const fs::path& rhs)
+    {
+        if (fs::file_size(lhs) != fs::file_size(rhs)) { return false; }
+
+        std::unique_ptr<char[]> lhsBlock {new char[BLOCK]}, rhsBlock {new char[BLOCK]};
+        std::ifstream lhsFile {lhs, std::ios::binary}, rhsFile {rhs, std::ios::binary};
+        while (lhsFile && rhsFile)
+        {
+            lhsFile.read(lhsBlock.get(), BLOCK);
+            rhsFile.read(rhsBlock.get(), BLOCK);
+            if (lhsFile.gcount() != rhsFile.gcount() || std::memcmp(lhsBlock.get(), rhsBlock.get(), static_cast<size_t>(lhsFile.gcount())) != 0) { return false; }
+        }
+        return true;
+    }
+
+    // Runs split_join on the arguments, as the command line would pass them
+    double timeSplitJoin(std::vector<std::string> arguments, CSD2125::SplitResult expected)
+    {
+        arguments.insert(arguments.begin(), "splitter-benchmark");
+        std::vector<char*> argv;
+        for (std::string& argument : arguments) { argv.push_back(argument.data()); }
+
+        const auto START = Clock::now();
+        const CSD2125::SplitResult RESULT = CSD2125::split_join(static_cast<int>(argv.size()), argv.data());
+        const double SECONDS = std::chrono::duration<double>(Clock::now() - START).count();
+
+        if (RESULT != expected) { throw std::runtime_error{"split_join failed"}; }
+        return SECONDS;
+    }
+
+    std::vector<std::string> pieces(const fs::path& directory)
+    {
+        std::vector<std::string> paths;
+        for (const fs::directory_entry& entry : fs::directory_iterator{directory}) { paths.push_back(entry.path().string()); }
+        std::sort(paths.begin(), paths.end());
+        return paths;
+    }
+
+    void report(const char* name, std::uintmax_t bytes, double legacySeconds, double fastSeconds)
+    {
+        const double GB = static_cast<double>(bytes) / 1e9;
+        std::cout << std::left << std::setw(8) << name << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(12) << GB / legacySeconds << std::setw(12) << GB / fastSeconds
+                  << std::setw(10) << std::setprecision(1) << legacySeconds / fastSeconds << "x" << std::endl;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const std::uintmax_t BYTES = (argc > 1 ? std::stoull(argv[1]) : 4) * GIB;
+    const fs::path DIRECTORY = argc > 2 ? argv[2] : "bench-data";
+
+    try
+    {
+        fs::remove_all(DIRECTORY);
+        fs::create_directories(DIRECTORY / "legacy");
+        fs::create_directories(DIRECTORY / "fast");
+
+        const fs::path INPUT = DIRECTORY / "input";
+        generate(INPUT, BYTES);
+
+        std::cout << BYTES / GIB << " GiB in pieces of " << (CHUNK_SIZE >> 20) << " MiB, GB/s" << std::endl;
+        std::cout << std::left << std::setw(8) << "" << std::right
+                  << std::setw(12) << "streams" << std::setw(12) << "-f" << std::setw(11) << "speedup" << std::endl;
+
+        using CSD2125::SplitResult;
+        const std::string CHUNK = std::to_string(CHUNK_SIZE);
+        const double LEGACY_SPLIT = timeSplitJoin({"-s", CHUNK, "-o", (DIRECTORY / "legacy" / "p_").string(), "-i", INPUT.string()}, SplitResult::E_SPLIT_SUCCESS);
+        const double FAST_SPLIT   = timeSplitJoin({"-f", "-s", CHUNK, "-o", (DIRECTORY / "fast" / "p_").string(), "-i", INPUT.string()}, SplitResult::E_SPLIT_SUCCESS);
+        report("split", BYTES, LEGACY_SPLIT, FAST_SPLIT);
+
+        const std::vector<std::string> LEGACY_PIECES = pieces(DIRECTORY / "legacy");
+        const std::vector<std::string> FAST_PIECES = pieces(DIRECTORY / "fast");
+        if (LEGACY_PIECES.size() != FAST_PIECES.size()) { throw std::runtime_error{"splits made different pieces"}; }
+        for (size_t i = 0; i < LEGACY_PIECES.size(); ++i)
+        {
+            if (!sameContents(LEGACY_PIECES[i], FAST_PIECES[i])) { throw std::runtime_error{"splits disagree"}; }
+        }
+        fs::remove_all(DIRECTORY / "legacy");
+
+        std::vector<std::string> legacyJoin {"-j", "-o", (DIRECTORY / "legacy-joined").string(), "-i"};
+        std::vector<std::string> fastJoin {"-f", "-j", "-o", (DIRECTORY / "fast-joined").string(), "-i"};
+        legacyJoin.insert(legacyJoin.end(), FAST_PIECES.begin(), FAST_PIECES.end());
+        fastJoin.insert(fastJoin.end(), FAST_PIECES.begin(), FAST_PIECES.end());
+
+        const double LEGACY_JOIN = timeSplitJoin(legacyJoin, SplitResult::E_JOIN_SUCCESS);
+        const double FAST_JOIN   = timeSplitJoin(fastJoin, SplitResult::E_JOIN_SUCCESS);
+        report("join", BYTES, LEGACY_JOIN, FAST_JOIN);
+
+        if (!sameContents(INPUT, DIRECTORY / "legacy-joined") || !sameContents(INPUT, DIRECTORY / "fast-joined"))
+        {
+            throw std::runtime_error{"a joined file differs from the input"};
+        }
+
+        fs::remove_all(DIRECTORY);
+    }
+    catch (const std::exception& e)
+    {
+        std::cout << "Error: " << e.what() << std::endl;
+        fs::remove_all(DIRECTORY);
+        return 1;
+    }
+}
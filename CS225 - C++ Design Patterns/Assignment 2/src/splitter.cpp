@@ -20,6 +20,23 @@ of DigiPen Institute of Technology is prohibited.
 #include <iterator>     
 #include <algorithm>    // std::copy_n
 #include <type_traits>  // std::is_integral
+#include <memory>       // std::unique_ptr
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <system_error>
+#include <new>          // std::align_val_t
+// File descriptors, for the high-throughput engine
+#if defined(__unix__) || defined(__APPLE__)
+    #define SPLITTER_POSIX
+    #include <cerrno>
+    #include <fcntl.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+#if defined(__linux__)
+    #include <sys/sendfile.h>
+#endif
      
 
 namespace CSD2125
@@ -33,6 +50,24 @@ namespace CSD2125
         JOIN
     };
 
+    // The high-throughput engine copies at most this much at a time through its
+    // buffers, when the kernel can't copy between the files itself
+    constexpr size_t FAST_BUFFER_SIZE       = size_t{1} << 20;
+    constexpr size_t FAST_BUFFER_ALIGNMENT  = 4096;     // A page, as O_DIRECT would want
+    constexpr unsigned FAST_MAX_THREADS     = 8;
+
+    /********************************************************************************//*!
+    @brief  Gets the path of a piece of a split file.
+                    
+    @param[in]  outputFilePrefix
+        The prefix for the output files.
+    @param[in]  fileIdx
+        The number of the piece, from 1.
+
+    @return The prefix followed by the number, padded to 4 digits.
+    *//*********************************************************************************/
+    std::string piecePath(const std::string& outputFilePrefix, size_t fileIdx);
+
     /********************************************************************************//*!
     @brief  Splits a binary file into multiple files.
                     
@@ -59,6 +94,36 @@ namespace CSD2125
     *//*********************************************************************************/
     SplitResult join(const std::vector<std::string>& inputFiles, const std::string& outputFilePath);
 
+    /********************************************************************************//*!
+    @brief  Splits a binary file into multiple files, writing the pieces in parallel
+            and copying in the kernel where it can. Memory is not limited to
+            MAX_SPLIT_SIZE.
+                    
+    @param[in]  inputFilePath
+        The input file path.
+    @param[in]  outputFilePrefix
+        The prefix for the output files.
+    @param[in]  chunkSize
+        The chunk size.
+
+    @return Returns the result depending on the state of the execution.
+    *//*********************************************************************************/
+    SplitResult splitFast(const std::string& inputFilePath, const std::string& outputFilePrefix, int chunkSize);
+
+    /********************************************************************************//*!
+    @brief  Joins multiple binary files into one file, copying every file to its
+            offset in parallel, in the kernel where it can. Memory is not limited to
+            MAX_SPLIT_SIZE.
+                    
+    @param[in]  inputFiles
+        The container of input files
+    @param[in]  outputFilePath
+        The file path to put the joined files in.
+
+    @return Returns the result depending on the state of the execution.
+    *//*********************************************************************************/
+    SplitResult joinFast(const std::vector<std::string>& inputFiles, const std::string& outputFilePath);
+
     /****************************************************************************//*!
     @brief  Takes in a set of command line arguments and joins or splits a
             binary file depending on the switches provided
@@ -74,6 +139,7 @@ namespace CSD2125
     {
         SplitResult result = SplitResult::E_NO_ACTION;
         State state = State::SPLIT;
+        bool fast = false;
 
         // Insufficient arguments passed in
         if (argc < 2) { return result; }
@@ -107,6 +173,11 @@ namespace CSD2125
                         state = State::JOIN;
                         break;
                     }
+                    case 'f':   // High-throughput engine
+                    {
+                        fast = true;
+                        break;
+                    }
                     case 'o':   // Output arg
                     {
                         // Get the output file
@@ -140,11 +211,14 @@ namespace CSD2125
 
         if (state == State::SPLIT)
         {
-            result = split(inputFiles.front(), outputFilePrefix, splitChunkSize); 
+            if (splitChunkSize <= 0) { return SplitResult::E_SMALL_SIZE; }
+
+            result = fast ? splitFast(inputFiles.front(), outputFilePrefix, splitChunkSize)
+                          : split(inputFiles.front(), outputFilePrefix, splitChunkSize); 
         }
         else
         {
-            result = join(inputFiles, outputFile);
+            result = fast ? joinFast(inputFiles, outputFile) : join(inputFiles, outputFile);
         }
 
         return result;
@@ -164,7 +238,7 @@ namespace CSD2125
         */
 
         // Perform split
-        int fileIdx = 1;
+        size_t fileIdx = 1;
         std::ifstream inputFile;
 
         inputFile.open(inputFilePath, std::ios::binary);
@@ -172,42 +246,40 @@ namespace CSD2125
         if (!inputFile.is_open()) { return SplitResult::E_BAD_SOURCE; }
 
         inputFile.seekg (0, inputFile.end);
-        int remainingLength = static_cast<int>(inputFile.tellg());
+        std::streamoff remainingLength = inputFile.tellg();
         inputFile.seekg (0, inputFile.beg);
 
+        // Allocate space for buffer, reused for every file
+        const int bufferSize = std::min(chunkSize, MAX_SPLIT_SIZE);
+        std::unique_ptr<char[]> buffer;
+        try
+        {
+            buffer.reset(new char[static_cast<size_t>(bufferSize)]);
+        }
+        catch(const std::bad_alloc& e)
+        {
+            return SplitResult::E_NO_MEMORY;
+        }
+
         // Determine number of files;
         while (remainingLength > 0)
         {
-            // Pad file number with 0's
-            std::stringstream outputFilePath;
-            outputFilePath << outputFilePrefix << std::setfill('0') << std::setw(4) << fileIdx;
-
             std::ofstream outputFile;
-            outputFile.open(outputFilePath.str(), std::ios::binary);
+            outputFile.open(piecePath(outputFilePrefix, fileIdx), std::ios::binary);
             // Error handling
             if (!outputFile.is_open()) { return SplitResult::E_BAD_DESTINATION; }
 
-            // Allocate space for buffer
-            const int splitSize = std::min(remainingLength, std::min(chunkSize, MAX_SPLIT_SIZE));
-            char* buffer;
-            try
+            // Copy over elements, a buffer at a time
+            std::streamoff pieceLength = std::min<std::streamoff>(remainingLength, chunkSize);
+            remainingLength -= pieceLength; 
+            while (pieceLength > 0)
             {
-                buffer = new char[splitSize];
+                const std::streamsize copySize = std::min<std::streamoff>(pieceLength, bufferSize);
+                if (!inputFile.read(buffer.get(), copySize))     { return SplitResult::E_BAD_SOURCE; }
+                if (!outputFile.write(buffer.get(), copySize))   { return SplitResult::E_BAD_DESTINATION; }
+                pieceLength -= copySize;
             }
-            catch(const std::bad_alloc& e)
-            {
-                return SplitResult::E_NO_MEMORY;
-            }
-            
-            // Copy over elements
-            inputFile.read(buffer, splitSize);
-            outputFile.write(buffer, splitSize);
-
-            // Clean up
-            delete[] buffer;
 
-            // reduce chunk size        
-            remainingLength -= splitSize; 
             ++fileIdx;
         }
 
@@ -230,7 +302,7 @@ namespace CSD2125
             if (!inputFile.is_open()) { return SplitResult::E_BAD_SOURCE; }
 
             inputFile.seekg (0, inputFile.end);
-            int inputFileLength = static_cast<int>(inputFile.tellg());
+            std::streamoff inputFileLength = inputFile.tellg();
             inputFile.seekg (0, inputFile.beg);
 
             std::copy_n(std::istreambuf_iterator<char>(inputFile), inputFileLength, std::ostreambuf_iterator<char>(outputFile));
@@ -238,4 +310,304 @@ namespace CSD2125
 
         return SplitResult::E_JOIN_SUCCESS;
     }
+    std::string piecePath(const std::string& outputFilePrefix, size_t fileIdx)
+    {
+        // Pad file number with 0's
+        std::stringstream outputFilePath;
+        outputFilePath << outputFilePrefix << std::setfill('0') << std::setw(4) << fileIdx;
+        return outputFilePath.str();
+    }
+
+#if defined(SPLITTER_POSIX)
+    /********************************************************************************//*!
+    @brief  Owns a file descriptor, closing it when destroyed.
+    *//*********************************************************************************/
+    class FileDescriptor
+    {
+    public:
+        explicit FileDescriptor(int f) : fd {f} {}
+        ~FileDescriptor() { if (fd >= 0) { ::close(fd); } }
+        FileDescriptor(const FileDescriptor&) = delete;
+        FileDescriptor& operator=(const FileDescriptor&) = delete;
+
+        int get() const { return fd; }
+        bool is_open() const { return fd >= 0; }
+
+        // Closes now, so an error writing back is reported
+        bool close()
+        {
+            const int CLOSED = ::close(fd);
+            fd = -1;
+            return CLOSED == 0;
+        }
+
+    private:
+        int fd;
+    };
+
+    /********************************************************************************//*!
+    @brief  A page-aligned buffer of FAST_BUFFER_SIZE bytes, allocated on first use
+            and reused for every copy a thread makes.
+    *//*********************************************************************************/
+    class CopyBuffer
+    {
+    public:
+        CopyBuffer() = default;
+        ~CopyBuffer() { if (data) { ::operator delete(data, std::align_val_t{FAST_BUFFER_ALIGNMENT}); } }
+        CopyBuffer(const CopyBuffer&) = delete;
+        CopyBuffer& operator=(const CopyBuffer&) = delete;
+
+        // Null if it can't be allocated
+        char* get()
+        {
+            if (!data) { data = static_cast<char*>(::operator new(FAST_BUFFER_SIZE, std::align_val_t{FAST_BUFFER_ALIGNMENT}, std::nothrow)); }
+            return data;
+        }
+
+    private:
+        char* data = nullptr;
+    };
+
+    /********************************************************************************//*!
+    @brief  Copies a range of one file into another at an offset. The kernel copies
+            it with copy_file_range, or failing that sendfile, without it passing
+            through this process. Otherwise it goes through the buffer with pread and
+            pwrite, which also tells a failed read from a failed write.
+
+    @param[in]  in
+        The file to copy from.
+    @param[in]  inOffset
+        The offset of the range in in.
+    @param[in]  out
+        The file to copy to.
+    @param[in]  outOffset
+        The offset to copy it to in out.
+    @param[in]  length
+        The number of bytes to copy.
+    @param[in]  buffer
+        The buffer of the calling thread.
+    @param[out] error
+        Why the copy failed, if it did.
+
+    @return True if every byte was copied.
+    *//*********************************************************************************/
+    bool copyRange(int in, off_t inOffset, int out, off_t outOffset, off_t length, CopyBuffer& buffer, SplitResult& error)
+    {
+    #if defined(__linux__)
+        constexpr off_t MAX_KERNEL_COPY = off_t{1} << 30;   // Per call, so it can be retried on a signal
+
+        // Anything but a signal falls through to the next way of copying, from where
+        // this one stopped
+        while (length > 0)
+        {
+            const ssize_t COPIED = ::copy_file_range(in, &inOffset, out, &outOffset, static_cast<size_t>(std::min(length, MAX_KERNEL_COPY)), 0);
+            if (COPIED > 0)                     { length -= COPIED; continue; }
+            if (COPIED < 0 && errno == EINTR)   { continue; }
+            break;
+        }
+
+        // sendfile writes at the position of out
+        if (length > 0 && ::lseek(out, outOffset, SEEK_SET) == outOffset)
+        {
+            while (length > 0)
+            {
+                const ssize_t COPIED = ::sendfile(out, in, &inOffset, static_cast<size_t>(std::min(length, MAX_KERNEL_COPY)));
+                if (COPIED > 0)                     { length -= COPIED; outOffset += COPIED; continue; }
+                if (COPIED < 0 && errno == EINTR)   { continue; }
+                break;
+            }
+        }
+    #endif
+
+        if (length == 0) { return true; }
+
+        char* data = buffer.get();
+        if (!data)
+        {
+            error = SplitResult::E_NO_MEMORY;
+            return false;
+        }
+
+        while (length > 0)
+        {
+            const ssize_t READ = ::pread(in, data, static_cast<size_t>(std::min(length, static_cast<off_t>(FAST_BUFFER_SIZE))), inOffset);
+            if (READ < 0 && errno == EINTR) { continue; }
+            // The file ending early is as bad as failing to read it
+            if (READ <= 0)
+            {
+                error = SplitResult::E_BAD_SOURCE;
+                return false;
+            }
+
+            for (ssize_t written = 0; written < READ; )
+            {
+                const ssize_t WRITTEN = ::pwrite(out, data + written, static_cast<size_t>(READ - written), outOffset + written);
+                if (WRITTEN < 0 && errno == EINTR) { continue; }
+                if (WRITTEN <= 0)
+                {
+                    error = SplitResult::E_BAD_DESTINATION;
+                    return false;
+                }
+                written += WRITTEN;
+            }
+
+            inOffset    += READ;
+            outOffset   += READ;
+            length      -= READ;
+        }
+
+        return true;
+    }
+
+    /********************************************************************************//*!
+    @brief  Runs a task for every piece on a pool of threads. Threads take the pieces
+            in order and stop taking them after a failure, so the error returned is
+            the one of the first piece to fail, as it would be copying them in turn.
+
+    @param[in]  pieces
+        The number of pieces.
+    @param[in]  task
+        Called with the index of a piece, the buffer of the thread and the error to
+        set, returning false if it failed.
+    @param[in]  success
+        The result if every task succeeds.
+
+    @return Returns the result depending on the state of the execution.
+    *//*********************************************************************************/
+    template <typename Task>
+    SplitResult forEachPiece(size_t pieces, Task task, SplitResult success)
+    {
+        std::atomic<size_t> nextPiece {0};
+        std::atomic<bool>   failed {false};
+        std::mutex          errorMutex;
+        size_t              errorPiece = pieces;
+        SplitResult         result = success;
+
+        auto work = [&]()
+        {
+            CopyBuffer buffer;
+            for (size_t piece = nextPiece++; piece < pieces && !failed; piece = nextPiece++)
+            {
+                SplitResult error = success;
+                if (task(piece, buffer, error)) { continue; }
+
+                std::lock_guard<std::mutex> lock {errorMutex};
+                if (piece < errorPiece)
+                {
+                    errorPiece = piece;
+                    result = error;
+                }
+                failed = true;
+            }
+        };
+
+        // Copies are bound by I/O more than by the cores, so use a few threads even
+        // on one core. This thread is one of them.
+        const unsigned HARDWARE = std::max(std::thread::hardware_concurrency(), 2U);
+        const size_t THREAD_COUNT = std::min<size_t>(std::min(HARDWARE, FAST_MAX_THREADS), pieces);
+
+        std::vector<std::thread> threads;
+        for (size_t i = 1; i < THREAD_COUNT; ++i)
+        {
+            // The threads already started share the pieces if another can't start
+            try                                 { threads.emplace_back(work); }
+            catch (const std::system_error&)    { break; }
+        }
+        work();
+        for (std::thread& thread : threads) { thread.join(); }
+
+        return result;
+    }
+
+    SplitResult splitFast(const std::string& inputFilePath, const std::string& outputFilePrefix, int chunkSize)
+    {
+        FileDescriptor inputFile {::open(inputFilePath.c_str(), O_RDONLY)};
+        struct stat inputStat;
+        if (!inputFile.is_open() || ::fstat(inputFile.get(), &inputStat) != 0) { return SplitResult::E_BAD_SOURCE; }
+
+        const off_t LENGTH = inputStat.st_size;
+        const off_t CHUNK = chunkSize;
+        const size_t PIECES = static_cast<size_t>((LENGTH + CHUNK - 1) / CHUNK);
+
+        auto copyPiece = [&](size_t piece, CopyBuffer& buffer, SplitResult& error)
+        {
+            FileDescriptor outputFile {::open(piecePath(outputFilePrefix, piece + 1).c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666)};
+            if (!outputFile.is_open())
+            {
+                error = SplitResult::E_BAD_DESTINATION;
+                return false;
+            }
+
+            const off_t OFFSET = static_cast<off_t>(piece) * CHUNK;
+            if (!copyRange(inputFile.get(), OFFSET, outputFile.get(), 0, std::min(CHUNK, LENGTH - OFFSET), buffer, error)) { return false; }
+
+            if (!outputFile.close())
+            {
+                error = SplitResult::E_BAD_DESTINATION;
+                return false;
+            }
+            return true;
+        };
+
+        return forEachPiece(PIECES, copyPiece, SplitResult::E_SPLIT_SUCCESS);
+    }
+
+    SplitResult joinFast(const std::vector<std::string>& inputFiles, const std::string& outputFilePath)
+    {
+        FileDescriptor outputFile {::open(outputFilePath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666)};
+        // Error handling
+        if (!outputFile.is_open()) { return SplitResult::E_BAD_DESTINATION; }
+
+        // Every file is copied to the sum of the lengths before it
+        std::vector<off_t> offsets;
+        off_t totalLength = 0;
+        for (auto& filePath : inputFiles)
+        {
+            struct stat inputStat;
+            if (::stat(filePath.c_str(), &inputStat) != 0) { return SplitResult::E_BAD_SOURCE; }
+
+            offsets.emplace_back(totalLength);
+            totalLength += inputStat.st_size;
+        }
+        offsets.emplace_back(totalLength);
+
+        // Sized up front, so the pieces can be written in any order
+        if (::ftruncate(outputFile.get(), totalLength) != 0) { return SplitResult::E_BAD_DESTINATION; }
+
+        auto copyPiece = [&](size_t piece, CopyBuffer& buffer, SplitResult& error)
+        {
+            FileDescriptor inputFile {::open(inputFiles[piece].c_str(), O_RDONLY)};
+            if (!inputFile.is_open())
+            {
+                error = SplitResult::E_BAD_SOURCE;
+                return false;
+            }
+
+            // A descriptor of its own, since sendfile moves its position
+            FileDescriptor pieceOutput {::open(outputFilePath.c_str(), O_WRONLY)};
+            if (!pieceOutput.is_open())
+            {
+                error = SplitResult::E_BAD_DESTINATION;
+                return false;
+            }
+
+            return copyRange(inputFile.get(), 0, pieceOutput.get(), offsets[piece], offsets[piece + 1] - offsets[piece], buffer, error);
+        };
+
+        const SplitResult RESULT = forEachPiece(inputFiles.size(), copyPiece, SplitResult::E_JOIN_SUCCESS);
+        if (RESULT == SplitResult::E_JOIN_SUCCESS && !outputFile.close()) { return SplitResult::E_BAD_DESTINATION; }
+        return RESULT;
+    }
+#else
+    // Without file descriptors, the standard streams do it
+    SplitResult splitFast(const std::string& inputFilePath, const std::string& outputFilePrefix, int chunkSize)
+    {
+        return split(inputFilePath, outputFilePrefix, chunkSize);
+    }
+
+    SplitResult joinFast(const std::vector<std::string>& inputFiles, const std::string& outputFilePath)
+    {
+        return join(inputFiles, outputFilePath);
+    }
+#endif
 }
@@ -0,0 +1,251 @@
+// Times csd2125::Matrix multiplication against the triple loop it replaced, and checks
+// both agree on sizes that don't fill a whole tile. Then times an element-wise
+// expression against the operators that each made a temporary Matrix.
+// Build with: make benchmark
+
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include "matrix.hpp"
+
+namespace
+{
+    // Counts every allocation, through the replaced global new below
+    size_t allocations = 0;
+}
+
+void* operator new(size_t size)
+{
+    ++allocations;
+    if (void* p = std::malloc(size ? size : 1)) { return p; }
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* p) noexcept                  { std::free(p); }
+void operator delete(void* p, size_t) noexcept          { std::free(p); }
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+    using csd2125::Matrix;
+
+    // The previous operator*, through the proxies and down the columns of rhs
+    template <typename T>
+    Matrix<T> legacyMultiply(const Matrix<T>& lhs, const Matrix<T>& rhs)
+    {
+        Matrix<T> result(lhs.get_rows(), rhs.get_cols());
+        for (size_t r = 0; r < lhs.get_rows(); ++r)
+        {
+            for (size_t c = 0; c < rhs.get_cols(); ++c)
+            {
+                for (size_t n = 0; n < lhs.get_cols(); ++n)
+                {
+                    result[r][c] += lhs[r][n] * rhs[n][c];
+                }
+            }
+        }
+        return result;
+    }
+
+    // The previous element-wise operators, each into a new Matrix through the proxies
+    template <typename T>
+    Matrix<T> legacyAdd(const Matrix<T>& lhs, const Matrix<T>& rhs)
+    {
+        Matrix<T> result(lhs.get_rows(), lhs.get_cols());
+        for (size_t r = 0; r < lhs.get_rows(); ++r)
+        {
+            for (size_t c = 0; c < lhs.get_cols(); ++c)
+            {
+                result[r][c] = lhs[r][c] + rhs[r][c];
+            }
+        }
+        return result;
+    }
+
+    template <typename T>
+    Matrix<T> legacySubtract(const Matrix<T>& lhs, const Matrix<T>& rhs)
+    {
+        Matrix<T> result(lhs.get_rows(), lhs.get_cols());
+        for (size_t r = 0; r < lhs.get_rows(); ++r)
+        {
+            for (size_t c = 0; c < lhs.get_cols(); ++c)
+            {
+                result[r][c] = lhs[r][c] - rhs[r][c];
+            }
+        }
+        return result;
+    }
+
+    template <typename T>
+    Matrix<T> legacyScale(T lhs, const Matrix<T>& rhs)
+    {
+        Matrix<T> result(rhs.get_rows(), rhs.get_cols());
+        for (size_t r = 0; r < rhs.get_rows(); ++r)
+        {
+            for (size_t c = 0; c < rhs.get_cols(); ++c)
+            {
+                result[r][c] = lhs * rhs[r][c];
+            }
+        }
+        return result;
+    }
+
+    template <typename T>
+    Matrix<T> randomMatrix(size_t rows, size_t cols, unsigned seed)
+    {
+        std::mt19937 random{ seed };
+        std::uniform_int_distribution<int> distribution{ -8, 8 };
+
+        Matrix<T> m(rows, cols);
+        for (size_t r = 0; r < rows; ++r)
+        {
+            for (size_t c = 0; c < cols; ++c)
+            {
+                m[r][c] = static_cast<T>(distribution(random)) / T{ 4 };
+            }
+        }
+        return m;
+    }
+
+    // Largest difference relative to the largest element of expected
+    template <typename T>
+    double relativeError(const Matrix<T>& expected, const Matrix<T>& actual)
+    {
+        double largest = 1.0, difference = 0.0;
+        for (size_t r = 0; r < expected.get_rows(); ++r)
+        {
+            for (size_t c = 0; c < expected.get_cols(); ++c)
+            {
+                largest    = std::max(largest, std::abs(static_cast<double>(expected[r][c])));
+                difference = std::max(difference, std::abs(static_cast<double>(expected[r][c] - actual[r][c])));
+            }
+        }
+        return difference / largest;
+    }
+
+    template <typename T>
+    void check(const char* type)
+    {
+        const size_t SIZES[][3] = { { 1, 1, 1 }, { 7, 6, 7 }, { 13, 300, 17 }, { 100, 257, 33 }, { 301, 129, 250 } };
+        for (const auto& size : SIZES)
+        {
+            const Matrix<T> A = randomMatrix<T>(size[0], size[1], 1);
+            const Matrix<T> B = randomMatrix<T>(size[1], size[2], 2);
+            if (relativeError(legacyMultiply(A, B), A * B) > 1e-5)
+            {
+                throw std::runtime_error{ std::string{ "Products disagree for " } + type + "." };
+            }
+        }
+    }
+
+    // legacy is skipped past legacyLimit, where it takes too long
+    template <typename T>
+    void report(const char* type, size_t n, size_t legacyLimit)
+    {
+        const Matrix<T> A = randomMatrix<T>(n, n, 3);
+        const Matrix<T> B = randomMatrix<T>(n, n, 4);
+        const double FLOPS = 2.0 * static_cast<double>(n) * static_cast<double>(n) * static_cast<double>(n);
+
+        double newSeconds = 1e30;
+        for (int run = 0; run < 3; ++run)
+        {
+            const auto START = Clock::now();
+            const Matrix<T> C = A * B;
+            newSeconds = std::min(newSeconds, std::chrono::duration<double>(Clock::now() - START).count());
+        }
+
+        std::cout << std::left << std::setw(8) << type << std::right << std::setw(6) << n << std::fixed << std::setprecision(2);
+        if (n <= legacyLimit)
+        {
+            const auto START = Clock::now();
+            const Matrix<T> C = legacyMultiply(A, B);
+            const double LEGACY_SECONDS = std::chrono::duration<double>(Clock::now() - START).count();
+            std::cout << std::setw(12) << FLOPS / LEGACY_SECONDS * 1e-9 << std::setw(12) << FLOPS / newSeconds * 1e-9
+                      << std::setw(10) << std::setprecision(1) << LEGACY_SECONDS / newSeconds << "x" << std::endl;
+        }
+        else
+        {
+            std::cout << std::setw(12) << "-" << std::setw(12) << FLOPS / newSeconds * 1e-9 << std::setw(11) << "-" << std::endl;
+        }
+    }
+
+    // R = A + B - 2 * C into an R of the right size, so only temporaries allocate. The
+    // unfused column evaluates every operator into a Matrix of its own, as the legacy
+    // operators did, but with the same loops, so it shows what fusing them saves.
+    template <typename T>
+    void reportElementWise(const char* type, size_t n)
+    {
+        const Matrix<T> A = randomMatrix<T>(n, n, 5);
+        const Matrix<T> B = randomMatrix<T>(n, n, 6);
+        const Matrix<T> C = randomMatrix<T>(n, n, 7);
+        Matrix<T> legacyR(n, n), unfusedR(n, n), newR(n, n);
+        const int REPS = static_cast<int>(std::max<size_t>(1, (size_t{ 1 } << 26) / (n * n)));
+
+        auto time = [&](auto fn, size_t& count)
+        {
+            double best = 1e30;
+            for (int run = 0; run < 3; ++run)
+            {
+                const size_t BEFORE = allocations;
+                const auto START = Clock::now();
+                for (int rep = 0; rep < REPS; ++rep) { fn(); }
+                best = std::min(best, std::chrono::duration<double, std::milli>(Clock::now() - START).count() / REPS);
+                count = (allocations - BEFORE) / static_cast<size_t>(REPS);
+            }
+            return best;
+        };
+
+        size_t legacyAllocations = 0, unfusedAllocations = 0, newAllocations = 0;
+        const double LEGACY  = time([&] { legacyR = legacySubtract(legacyAdd(A, B), legacyScale(T{ 2 }, C)); }, legacyAllocations);
+        const double UNFUSED = time([&] { unfusedR = Matrix<T>(Matrix<T>(A + B) - Matrix<T>(T{ 2 } * C)); }, unfusedAllocations);
+        const double NEW     = time([&] { newR = A + B - T{ 2 } * C; }, newAllocations);
+        if (relativeError(legacyR, newR) > 0.0 || relativeError(unfusedR, newR) > 0.0)
+        {
+            throw std::runtime_error{ std::string{ "Element-wise results disagree for " } + type + "." };
+        }
+
+        std::cout << std::left << std::setw(8) << type << std::right << std::setw(6) << n << std::fixed << std::setprecision(3)
+                  << std::setw(12) << LEGACY << std::setw(12) << UNFUSED << std::setw(12) << NEW
+                  << std::setw(10) << std::setprecision(1) << LEGACY / NEW << "x" << std::setw(10) << UNFUSED / NEW << "x"
+                  << std::setw(8) << legacyAllocations << " / " << unfusedAllocations << " / " << newAllocations << std::endl;
+    }
+}
+
+int main()
+{
+    try
+    {
+        check<float>("float");
+        check<double>("double");
+        check<int>("int");
+
+        std::cout << std::left << std::setw(8) << "GFLOP/s" << std::right << std::setw(6) << "n"
+                  << std::setw(12) << "legacy" << std::setw(12) << "csd2125" << std::setw(11) << "speedup" << std::endl;
+        for (size_t n : { 256, 512, 1024, 2048 })
+        {
+            report<float>("float", n, 1024);
+            report<double>("double", n, 1024);
+        }
+
+        std::cout << "\n" << std::left << std::setw(8) << "A+B-2C" << std::right << std::setw(6) << "n"
+                  << std::setw(12) << "legacy ms" << std::setw(12) << "unfused ms" << std::setw(12) << "csd2125 ms"
+                  << std::setw(11) << "vs legacy" << std::setw(11) << "vs unfused" << std::setw(16) << "allocations" << std::endl;
+        for (size_t n : { 64, 256, 1024, 2048 })
+        {
+            reportElementWise<float>("float", n);
+            reportElementWise<double>("double", n);
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cout << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
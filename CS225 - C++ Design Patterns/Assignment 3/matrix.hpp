@@ -20,14 +20,405 @@ consent of DigiPen Institute of Technology is prohibited.
 #include <memory>               // std::unique_ptr
 #include <type_traits>          // std::is_floating_point_v
 #include <numeric>              // std::numeric_limits::epsilon
+#include <thread>               // std::thread
+#include <vector>               // std::vector
+// Intrinsics
+#if defined(__AVX2__)
+    #include <immintrin.h>
+#endif
+
+// Fully unrolls the loop that follows, so a tile of vectors stays in registers
+#if defined(__GNUC__)
+    #define MATRIX_UNROLL _Pragma("GCC unroll 16")
+#else
+    #define MATRIX_UNROLL
+#endif
+// Promises no iteration of the loop that follows reads what an earlier one wrote, so it
+// is vectorised without checking its pointers for overlap
+#if defined(__clang__)
+    #define MATRIX_IVDEP _Pragma("clang loop vectorize(assume_safety)")
+#elif defined(__GNUC__)
+    #define MATRIX_IVDEP _Pragma("GCC ivdep")
+#elif defined(_MSC_VER)
+    #define MATRIX_IVDEP __pragma(loop(ivdep))
+#else
+    #define MATRIX_IVDEP
+#endif
 
 namespace csd2125 
 {
+    template <typename T>
+    class Matrix;
+
+    namespace detail
+    {
+        /*-----------------------------------------------------------------------------*/
+        /* Element-wise Operations                                                     */
+        /*-----------------------------------------------------------------------------*/
+
+        struct AddOp
+        {
+            template <typename T>
+            static T apply(const T& lhs, const T& rhs) { return lhs + rhs; }
+        };
+
+        struct SubtractOp
+        {
+            template <typename T>
+            static T apply(const T& lhs, const T& rhs) { return lhs - rhs; }
+        };
+
+        // Expressions hold a Matrix by reference, and other expressions, which only
+        // hold references themselves, by value, since they are usually temporaries
+        template <typename E>
+        struct Operand
+        {
+            using type = const E;
+        };
+
+        template <typename T>
+        struct Operand<Matrix<T>>
+        {
+            using type = const Matrix<T>&;
+        };
+
+        /*-----------------------------------------------------------------------------*/
+        /* Matrix Multiplication Kernels                                               */
+        /*-----------------------------------------------------------------------------*/
+
+        // Computes an MR x NR tile of c += a * b, from a panel of MR rows of A and a
+        // panel of NR columns of B, both packed so every step of k reads them in order.
+        // MC x KC of A is packed at a time to stay in L2, and KC x NC of B in L3.
+        template <typename T>
+        struct GemmKernel
+        {
+            static constexpr size_t MR = 4;
+            static constexpr size_t NR = 4;
+            static constexpr size_t MC = 64;
+            static constexpr size_t KC = 256;
+            static constexpr size_t NC = 1024;
+
+            static void run(size_t kc, const T* a, const T* b, T* c, size_t ldc)
+            {
+                T tile[MR][NR] {};
+                for (size_t k = 0; k < kc; ++k, a += MR, b += NR)
+                {
+                    for (size_t i = 0; i < MR; ++i)
+                    {
+                        for (size_t j = 0; j < NR; ++j)
+                        {
+                            tile[i][j] += a[i] * b[j];
+                        }
+                    }
+                }
+
+                for (size_t i = 0; i < MR; ++i)
+                {
+                    for (size_t j = 0; j < NR; ++j)
+                    {
+                        c[i * ldc + j] += tile[i][j];
+                    }
+                }
+            }
+        };
+
+    #if defined(__AVX2__)
+        // a * b + c, fused where the target has FMA
+        inline __m256d multiplyAdd(__m256d a, __m256d b, __m256d c)
+        {
+        #if defined(__FMA__)
+            return _mm256_fmadd_pd(a, b, c);
+        #else
+            return _mm256_add_pd(_mm256_mul_pd(a, b), c);
+        #endif
+        }
+
+        inline __m256 multiplyAdd(__m256 a, __m256 b, __m256 c)
+        {
+        #if defined(__FMA__)
+            return _mm256_fmadd_ps(a, b, c);
+        #else
+            return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+        #endif
+        }
+
+        // The tile is 6 rows of 2 vectors, 12 of the 16 registers, leaving room to
+        // load a row of B and broadcast an element of A
+        template <>
+        struct GemmKernel<double>
+        {
+            static constexpr size_t MR = 6;
+            static constexpr size_t NR = 8;
+            static constexpr size_t MC = 72;
+            static constexpr size_t KC = 256;
+            static constexpr size_t NC = 4080;
+
+            static void run(size_t kc, const double* a, const double* b, double* c, size_t ldc)
+            {
+                __m256d tile[MR][2];
+                MATRIX_UNROLL
+                for (size_t i = 0; i < MR; ++i)
+                {
+                    tile[i][0] = _mm256_setzero_pd();
+                    tile[i][1] = _mm256_setzero_pd();
+                }
+
+                for (size_t k = 0; k < kc; ++k, a += MR, b += NR)
+                {
+                    const __m256d B0 = _mm256_loadu_pd(b);
+                    const __m256d B1 = _mm256_loadu_pd(b + 4);
+                    MATRIX_UNROLL
+                    for (size_t i = 0; i < MR; ++i)
+                    {
+                        const __m256d A = _mm256_broadcast_sd(a + i);
+                        tile[i][0] = multiplyAdd(A, B0, tile[i][0]);
+                        tile[i][1] = multiplyAdd(A, B1, tile[i][1]);
+                    }
+                }
+
+                MATRIX_UNROLL
+                for (size_t i = 0; i < MR; ++i)
+                {
+                    double* row = c + i * ldc;
+                    _mm256_storeu_pd(row,     _mm256_add_pd(_mm256_loadu_pd(row),     tile[i][0]));
+                    _mm256_storeu_pd(row + 4, _mm256_add_pd(_mm256_loadu_pd(row + 4), tile[i][1]));
+                }
+            }
+        };
+
+        template <>
+        struct GemmKernel<float>
+        {
+            static constexpr size_t MR = 6;
+            static constexpr size_t NR = 16;
+            static constexpr size_t MC = 144;
+            static constexpr size_t KC = 256;
+            static constexpr size_t NC = 4080;
+
+            static void run(size_t kc, const float* a, const float* b, float* c, size_t ldc)
+            {
+                __m256 tile[MR][2];
+                MATRIX_UNROLL
+                for (size_t i = 0; i < MR; ++i)
+                {
+                    tile[i][0] = _mm256_setzero_ps();
+                    tile[i][1] = _mm256_setzero_ps();
+                }
+
+                for (size_t k = 0; k < kc; ++k, a += MR, b += NR)
+                {
+                    const __m256 B0 = _mm256_loadu_ps(b);
+                    const __m256 B1 = _mm256_loadu_ps(b + 8);
+                    MATRIX_UNROLL
+                    for (size_t i = 0; i < MR; ++i)
+                    {
+                        const __m256 A = _mm256_broadcast_ss(a + i);
+                        tile[i][0] = multiplyAdd(A, B0, tile[i][0]);
+                        tile[i][1] = multiplyAdd(A, B1, tile[i][1]);
+                    }
+                }
+
+                MATRIX_UNROLL
+                for (size_t i = 0; i < MR; ++i)
+                {
+                    float* row = c + i * ldc;
+                    _mm256_storeu_ps(row,     _mm256_add_ps(_mm256_loadu_ps(row),     tile[i][0]));
+                    _mm256_storeu_ps(row + 8, _mm256_add_ps(_mm256_loadu_ps(row + 8), tile[i][1]));
+                }
+            }
+        };
+    #endif
+
+        /*-----------------------------------------------------------------------------*/
+        /* Matrix Multiplication                                                       */
+        /*-----------------------------------------------------------------------------*/
+
+        // Copies mc x kc of A, a row-major block, into panels of MR rows, each stored a
+        // column at a time. Rows past mc are zero.
+        template <typename T>
+        void packA(size_t mc, size_t kc, const T* a, size_t lda, T* out)
+        {
+            constexpr size_t MR = GemmKernel<T>::MR;
+            for (size_t ir = 0; ir < mc; ir += MR)
+            {
+                for (size_t k = 0; k < kc; ++k)
+                {
+                    for (size_t i = 0; i < MR; ++i)
+                    {
+                        *out++ = ir + i < mc ? a[(ir + i) * lda + k] : T{};
+                    }
+                }
+            }
+        }
+
+        // Copies kc x nc of B, a row-major block, into panels of NR columns, each
+        // stored a row at a time. Columns past nc are zero.
+        template <typename T>
+        void packB(size_t kc, size_t nc, const T* b, size_t ldb, T* out)
+        {
+            constexpr size_t NR = GemmKernel<T>::NR;
+            for (size_t jr = 0; jr < nc; jr += NR)
+            {
+                for (size_t k = 0; k < kc; ++k)
+                {
+                    for (size_t j = 0; j < NR; ++j)
+                    {
+                        *out++ = jr + j < nc ? b[k * ldb + jr + j] : T{};
+                    }
+                }
+            }
+        }
+
+        // Adds the product of a packed block of A and a packed block of B to C, a tile
+        // at a time. Tiles cut off by the edge of C are computed aside and copied in.
+        template <typename T>
+        void multiplyBlock(size_t mc, size_t nc, size_t kc, const T* packedA, const T* packedB, T* c, size_t ldc)
+        {
+            using Kernel = GemmKernel<T>;
+            for (size_t jr = 0; jr < nc; jr += Kernel::NR)
+            {
+                const size_t NR = std::min(Kernel::NR, nc - jr);
+                for (size_t ir = 0; ir < mc; ir += Kernel::MR)
+                {
+                    const size_t MR = std::min(Kernel::MR, mc - ir);
+                    if (MR == Kernel::MR && NR == Kernel::NR)
+                    {
+                        Kernel::run(kc, packedA + ir * kc, packedB + jr * kc, c + ir * ldc + jr, ldc);
+                        continue;
+                    }
+
+                    T edge[Kernel::MR * Kernel::NR] {};
+                    Kernel::run(kc, packedA + ir * kc, packedB + jr * kc, edge, Kernel::NR);
+                    for (size_t i = 0; i < MR; ++i)
+                    {
+                        for (size_t j = 0; j < NR; ++j)
+                        {
+                            c[(ir + i) * ldc + jr + j] += edge[i * Kernel::NR + j];
+                        }
+                    }
+                }
+            }
+        }
+
+        /********************************************************************************//*!
+        @brief      Adds the product of two row-major matrices to a third. B is packed
+                    KC x NC at a time, and the MC row blocks of A against it are shared
+                    out between threads, each packing its own.
+
+        @param      m
+            The number of rows of A and C.
+        @param      n
+            The number of columns of B and C.
+        @param      k
+            The number of columns of A and rows of B.
+        @param[in]  a
+            The left operand.
+        @param[in]  b
+            The right operand.
+        @param[out] c
+            The matrix to add the product to.
+        *//*********************************************************************************/
+        template <typename T>
+        void gemm(size_t m, size_t n, size_t k, const T* a, const T* b, T* c)
+        {
+            using Kernel = GemmKernel<T>;
+            if (m == 0 || n == 0 || k == 0) { return; }
+
+            // Threads only pay for themselves on large products, and arithmetic types
+            // are the ones that can't throw on another thread
+            const size_t BLOCKS = (m + Kernel::MC - 1) / Kernel::MC;
+            size_t threadCount = 1;
+            if constexpr (std::is_arithmetic_v<T>)
+            {
+                if (m * n * k >= (size_t{1} << 21))
+                {
+                    threadCount = std::clamp<size_t>(std::thread::hardware_concurrency(), 1, BLOCKS);
+                }
+            }
+
+            const size_t PANEL_COLS = (std::min(Kernel::NC, n) + Kernel::NR - 1) / Kernel::NR * Kernel::NR;
+            const size_t PANEL_ROWS = (std::min(Kernel::MC, m) + Kernel::MR - 1) / Kernel::MR * Kernel::MR;
+            std::vector<T> packedB(Kernel::KC * PANEL_COLS);
+            std::vector<std::vector<T>> packedA(threadCount, std::vector<T>(PANEL_ROWS * Kernel::KC));
+
+            for (size_t jc = 0; jc < n; jc += Kernel::NC)
+            {
+                const size_t NC = std::min(Kernel::NC, n - jc);
+                for (size_t pc = 0; pc < k; pc += Kernel::KC)
+                {
+                    const size_t KC = std::min(Kernel::KC, k - pc);
+                    packB(KC, NC, b + pc * n + jc, n, packedB.data());
+
+                    // Thread t takes row blocks t, t + threadCount... so they write
+                    // to different rows of C
+                    auto work = [&](size_t thread)
+                    {
+                        for (size_t block = thread; block < BLOCKS; block += threadCount)
+                        {
+                            const size_t IC = block * Kernel::MC;
+                            const size_t MC = std::min(Kernel::MC, m - IC);
+                            packA(MC, KC, a + IC * k + pc, k, packedA[thread].data());
+                            multiplyBlock(MC, NC, KC, packedA[thread].data(), packedB.data(), c + IC * n + jc, n);
+                        }
+                    };
+
+                    std::vector<std::thread> threads;
+                    threads.reserve(threadCount - 1);
+                    try
+                    {
+                        for (size_t thread = 1; thread < threadCount; ++thread)
+                        {
+                            threads.emplace_back(work, thread);
+                        }
+                    }
+                    catch (...)
+                    {
+                        for (std::thread& started : threads) { started.join(); }
+                        throw;
+                    }
+
+                    work(0);
+                    for (std::thread& thread : threads) { thread.join(); }
+                }
+            }
+        }
+    } // namespace detail
+
     /*---------------------------------------------------------------------------------*/
     /* Class Definitions                                                               */
     /*---------------------------------------------------------------------------------*/ 
+    /********************************************************************************//*!
+    @brief      The base of a Matrix and of every element-wise expression of matrices.
+                An expression is not evaluated until it is assigned to a Matrix, which
+                computes every element of it in one loop, in place of a temporary
+                Matrix for every operator.
+
+                Every expression has get_rows(), get_cols() and element(index), which
+                computes the element at index in row-major order. Expressions refer to
+                the matrices in them, so they are assigned before those go away.
+
+                The result of +, - or a scalar * must be assigned to a Matrix, not held
+                with auto. An expression has no operator[], and one holding a
+                temporary, such as auto e = A * B + C, dangles at the end of the
+                statement.
+
+    @tparam     E
+        The expression deriving from this.
+    *//*********************************************************************************/
+    template <typename E>
+    class MatrixExpression
+    {
+    public:
+        /****************************************************************************//*!
+        @brief      Gets the expression deriving from this.
+
+        @returns    The expression.
+        *//*****************************************************************************/
+        const E& self() const noexcept { return static_cast<const E&>(*this); }
+    };
+
     template <typename T>
-    class Matrix
+    class Matrix : public MatrixExpression<Matrix<T>>
     {
     public:
         /*-----------------------------------------------------------------------------*/
@@ -160,6 +551,15 @@ namespace csd2125
         *//*****************************************************************************/
         Matrix(Matrix<value_type>&& rhs) noexcept;
 
+        /****************************************************************************//*!
+        @brief  Constructor for Matrix. Evaluates an element-wise expression into it.
+
+        @param  expression
+            The expression to evaluate.
+        *//*****************************************************************************/
+        template <typename E>
+        Matrix(const MatrixExpression<E>& expression);
+
         /****************************************************************************//*!
         @brief  Destructor for Matrix
         *//*****************************************************************************/
@@ -182,6 +582,16 @@ namespace csd2125
         *//*****************************************************************************/
         size_type get_cols() const noexcept;
 
+        /****************************************************************************//*!
+        @brief      Gets an element of the Matrix without checking the index.
+
+        @param[in]  index
+            The index of the element, row by row.
+
+        @returns    The element.
+        *//*****************************************************************************/
+        const value_type& element(size_type index) const noexcept;
+
         /*-----------------------------------------------------------------------------*/
         /* Operator Overloads                                                          */
         /*-----------------------------------------------------------------------------*/ 
@@ -205,6 +615,19 @@ namespace csd2125
         *//*****************************************************************************/
         Matrix<value_type>& operator=(Matrix<value_type>&& rhs) noexcept;
 
+        /****************************************************************************//*!
+        @brief      Evaluates an element-wise expression into this Matrix. Storage is
+                    reused if the size matches, which is safe even if the expression
+                    reads this Matrix, since every element only reads its own index.
+
+        @param[in]  expression
+            The expression to evaluate.
+
+        @returns    A reference to this Matrix with the result.
+        *//*****************************************************************************/
+        template <typename E>
+        Matrix<value_type>& operator=(const MatrixExpression<E>& expression);
+
         /****************************************************************************//*!
         @brief      Gets a row in the Matrix.
 
@@ -245,6 +668,117 @@ namespace csd2125
             A Matrix.
         *//*****************************************************************************/
         static void swap(Matrix<value_type>& lhs, Matrix<value_type>& rhs);
+
+        /****************************************************************************//*!
+        @brief      Evaluates an expression of the same size into the storage, in one
+                    vectorisable loop.
+
+        @param[in]  expression
+            The expression to evaluate.
+        *//*****************************************************************************/
+        template <typename E>
+        void assign(const E& expression);
+
+        /*-----------------------------------------------------------------------------*/
+        /* Friends                                                                     */
+        /*-----------------------------------------------------------------------------*/ 
+        // Multiplies on the storage directly, past the bounds checks of the proxies
+        template <typename U>
+        friend Matrix<U> operator*(const Matrix<U>& lhs, const Matrix<U>& rhs);
+    };
+
+    /********************************************************************************//*!
+    @brief      An element-wise operation on two expressions of the same size.
+
+    @tparam     L
+        The left expression.
+    @tparam     R
+        The right expression.
+    @tparam     Op
+        The operation, with a static apply(lhs, rhs).
+    *//*********************************************************************************/
+    template <typename L, typename R, typename Op>
+    class MatrixBinary : public MatrixExpression<MatrixBinary<L, R, Op>>
+    {
+    public:
+        /*-----------------------------------------------------------------------------*/
+        /* Type Aliases                                                                */
+        /*-----------------------------------------------------------------------------*/ 
+        using value_type        = typename L::value_type;
+        using size_type         = size_t;
+
+        static_assert(std::is_same_v<value_type, typename R::value_type>, "operands must hold the same type");
+
+        /*-----------------------------------------------------------------------------*/
+        /* Constructors                                                                */
+        /*-----------------------------------------------------------------------------*/ 
+        /****************************************************************************//*!
+        @brief  Constructor for MatrixBinary. The sizes are checked by the operator.
+
+        @param  l
+            The left expression.
+        @param  r
+            The right expression.
+        *//*****************************************************************************/
+        MatrixBinary(const L& l, const R& r) : lhs {l}, rhs {r} {}
+
+        /*-----------------------------------------------------------------------------*/
+        /* Function Members                                                            */
+        /*-----------------------------------------------------------------------------*/ 
+        size_type get_rows() const noexcept { return lhs.get_rows(); }
+        size_type get_cols() const noexcept { return lhs.get_cols(); }
+        value_type element(size_type index) const { return Op::apply(lhs.element(index), rhs.element(index)); }
+
+    private:
+        /*-----------------------------------------------------------------------------*/
+        /* Data Members                                                                */
+        /*-----------------------------------------------------------------------------*/ 
+        typename detail::Operand<L>::type lhs;
+        typename detail::Operand<R>::type rhs;
+    };
+
+    /********************************************************************************//*!
+    @brief      An expression with every element multiplied by a value.
+
+    @tparam     E
+        The expression.
+    *//*********************************************************************************/
+    template <typename E>
+    class MatrixScale : public MatrixExpression<MatrixScale<E>>
+    {
+    public:
+        /*-----------------------------------------------------------------------------*/
+        /* Type Aliases                                                                */
+        /*-----------------------------------------------------------------------------*/ 
+        using value_type        = typename E::value_type;
+        using size_type         = size_t;
+
+        /*-----------------------------------------------------------------------------*/
+        /* Constructors                                                                */
+        /*-----------------------------------------------------------------------------*/ 
+        /****************************************************************************//*!
+        @brief  Constructor for MatrixScale.
+
+        @param  s
+            The value to multiply by.
+        @param  e
+            The expression.
+        *//*****************************************************************************/
+        MatrixScale(value_type s, const E& e) : scale {s}, rhs {e} {}
+
+        /*-----------------------------------------------------------------------------*/
+        /* Function Members                                                            */
+        /*-----------------------------------------------------------------------------*/ 
+        size_type get_rows() const noexcept { return rhs.get_rows(); }
+        size_type get_cols() const noexcept { return rhs.get_cols(); }
+        value_type element(size_type index) const { return scale * rhs.element(index); }
+
+    private:
+        /*-----------------------------------------------------------------------------*/
+        /* Data Members                                                                */
+        /*-----------------------------------------------------------------------------*/ 
+        value_type                      scale;
+        typename detail::Operand<E>::type rhs;
     };
 
     /*---------------------------------------------------------------------------------*/
@@ -254,30 +788,32 @@ namespace csd2125
     @brief      Adds two matrices together.
 
     @param[in]  lhs
-        A Matrix.
+        A Matrix or an element-wise expression.
     @param[in]  rhs
-        A Matrix.
+        A Matrix or an element-wise expression.
 
-    @returns    The result of the addition of the two matrices
+    @returns    An expression of the addition of the two matrices, evaluated when it
+                is assigned to a Matrix.
     *//*****************************************************************************/
-    template <typename T>
-    Matrix<T> operator+(const Matrix<T>& lhs, const Matrix<T>& rhs);
+    template <typename L, typename R>
+    MatrixBinary<L, R, detail::AddOp> operator+(const MatrixExpression<L>& lhs, const MatrixExpression<R>& rhs);
 
     /****************************************************************************//*!
     @brief      Subtracts one matrix from another.
 
     @param[in]  lhs
-        A Matrix to subtract from.
+        A Matrix or an element-wise expression to subtract from.
     @param[in]  rhs
-        A Matrix used for subtraction.
+        A Matrix or an element-wise expression used for subtraction.
 
-    @returns    The result of lhs - rhs.
+    @returns    An expression of lhs - rhs, evaluated when it is assigned to a Matrix.
     *//*****************************************************************************/
-    template <typename T>
-    Matrix<T> operator-(const Matrix<T>& lhs, const Matrix<T>& rhs);
+    template <typename L, typename R>
+    MatrixBinary<L, R, detail::SubtractOp> operator-(const MatrixExpression<L>& lhs, const MatrixExpression<R>& rhs);
 
     /****************************************************************************//*!
-    @brief      Multiplies two matrices.
+    @brief      Multiplies two matrices, a cache-sized block at a time, and across
+                threads for large matrices.
 
     @param[in]  lhs
         A Matrix.
@@ -289,44 +825,60 @@ namespace csd2125
     template <typename T>
     Matrix<T> operator*(const Matrix<T>& lhs, const Matrix<T>& rhs);
 
+    /****************************************************************************//*!
+    @brief      Multiplies two matrices, either of which is an element-wise
+                expression. Products can't be computed an element at a time, so the
+                expressions are evaluated first.
+
+    @param[in]  lhs
+        A Matrix or an element-wise expression.
+    @param[in]  rhs
+        A Matrix or an element-wise expression.
+
+    @returns    The result of the multiplication of the two matrices
+    *//*****************************************************************************/
+    template <typename L, typename R>
+    Matrix<typename L::value_type> operator*(const MatrixExpression<L>& lhs, const MatrixExpression<R>& rhs);
+
     /****************************************************************************//*!
     @brief      Multiplies each element in the Matrix by a value.
 
     @param[in]  lhs
         A value matching the value_type of the matrix
     @param[in]  rhs
-        A Matrix.
+        A Matrix or an element-wise expression.
 
-    @returns    The result of the multiplication.
+    @returns    An expression of the multiplication, evaluated when it is assigned to
+                a Matrix.
     *//*****************************************************************************/
-    template <typename T>
-    Matrix<T> operator*(typename Matrix<T>::value_type lhs, const Matrix<T>& rhs);
+    template <typename E>
+    MatrixScale<E> operator*(typename E::value_type lhs, const MatrixExpression<E>& rhs);
 
     /****************************************************************************//*!
     @brief      Compares two matrices for equality.
 
     @param[in]  lhs
-        A Matrix.
+        A Matrix or an element-wise expression.
     @param[in]  rhs
-        A Matrix.
+        A Matrix or an element-wise expression.
 
     @returns    True if all elements of the matrices are equal.
     *//*****************************************************************************/
-    template <typename T>
-    bool operator==(const Matrix<T>& lhs, const Matrix<T>& rhs);
+    template <typename L, typename R>
+    bool operator==(const MatrixExpression<L>& lhs, const MatrixExpression<R>& rhs);
 
     /****************************************************************************//*!
     @brief      Compares two matrices for inequality.
 
     @param[in]  lhs
-        A Matrix.
+        A Matrix or an element-wise expression.
     @param[in]  rhs
-        A Matrix.
+        A Matrix or an element-wise expression.
 
     @returns    True if any element of the matrices are not equal.
     *//*****************************************************************************/
-    template <typename T>
-    bool operator!=(const Matrix<T>& lhs, const Matrix<T>& rhs);
+    template <typename L, typename R>
+    bool operator!=(const MatrixExpression<L>& lhs, const MatrixExpression<R>& rhs);
 
     /*---------------------------------------------------------------------------------*/
     /* Matrix Constructors & Destructor Definitions                                    */
@@ -389,6 +941,16 @@ namespace csd2125
         rhs.cols = 0;
     }
 
+    template <typename T>
+    template <typename E>
+    Matrix<T>::Matrix(const MatrixExpression<E>& expression)
+    : rows {expression.self().get_rows()}
+    , cols {expression.self().get_cols()}
+    , data {new value_type[rows * cols]}    // Every element is assigned, so none are zeroed
+    {
+        assign(expression.self());
+    }
+
     template <typename T>
     Matrix<T>::~Matrix() noexcept
     {
@@ -410,6 +972,38 @@ namespace csd2125
         return cols;
     }
 
+    template <typename T>
+    const typename Matrix<T>::value_type& Matrix<T>::element(typename Matrix<T>::size_type index) const noexcept
+    {
+        return data[index];
+    }
+
+    template <typename T>
+    template <typename E>
+    void Matrix<T>::assign(const E& expression)
+    {
+        // Chunks of a fixed count are vectorised even by compilers that won't add a
+        // scalar loop for the remainder themselves, such as GCC at -O2
+        constexpr size_type CHUNK = 16;
+
+        value_type* out = data.get();
+        const size_type SIZE = rows * cols;
+
+        size_type i = 0;
+        for (; i + CHUNK <= SIZE; i += CHUNK)
+        {
+            MATRIX_IVDEP
+            for (size_type j = i; j < i + CHUNK; ++j)
+            {
+                out[j] = expression.element(j);
+            }
+        }
+        for (; i < SIZE; ++i)
+        {
+            out[i] = expression.element(i);
+        }
+    }
+
     template <typename T>
     void Matrix<T>::swap(Matrix<T>& lhs, Matrix<T>& rhs)
     {
@@ -449,6 +1043,23 @@ namespace csd2125
         return *this;
     }
 
+    template <typename T>
+    template <typename E>
+    Matrix<T>& Matrix<T>::operator=(const MatrixExpression<E>& expression)
+    {
+        const E& source = expression.self();
+        if (source.get_rows() != rows || source.get_cols() != cols)
+        {
+            // Evaluate aside, as the expression might read this Matrix
+            Matrix<T> tmp = source;
+            swap(*this, tmp);
+            return *this;
+        }
+
+        assign(source);
+        return *this;
+    }
+
     template <typename T>
     typename Matrix<T>::Proxy Matrix<T>::operator[](typename Matrix<T>::size_type r)
     {
@@ -516,58 +1127,30 @@ namespace csd2125
     /*---------------------------------------------------------------------------------*/
     /* Global Function Definitions                                                     */
     /*---------------------------------------------------------------------------------*/
-    template <typename T>
-    Matrix<T> operator+(const Matrix<T>& lhs, const Matrix<T>& rhs)
+    template <typename L, typename R>
+    MatrixBinary<L, R, detail::AddOp> operator+(const MatrixExpression<L>& lhs, const MatrixExpression<R>& rhs)
     {
-        using sizeType = typename Matrix<T>::size_type;
-        sizeType lhsNumRows = lhs.get_rows();
-        sizeType lhsNumCols = lhs.get_cols();
-        sizeType rhsNumRows = rhs.get_rows();
-        sizeType rhsNumCols = rhs.get_cols();
-
         // Check if number of rows and columns are the same. 
-        // If sizes are different, return false.
-        if (lhsNumRows != rhsNumRows || lhsNumCols != rhsNumCols)
+        // If sizes are different, throw.
+        if (lhs.self().get_rows() != rhs.self().get_rows() || lhs.self().get_cols() != rhs.self().get_cols())
         {
             throw std::runtime_error("operands for matrix addition must have same dimensions");
         }
 
-        Matrix<T> result(lhsNumRows, lhsNumCols);
-        for (sizeType r = 0; r < lhsNumRows; ++r)
-        {
-            for (sizeType c = 0; c < lhsNumCols; ++c)
-            {
-                result[r][c] = lhs[r][c] + rhs[r][c];
-            }
-        }
-        return result;
+        return MatrixBinary<L, R, detail::AddOp>{lhs.self(), rhs.self()};
     }
 
-    template <typename T>
-    Matrix<T> operator-(const Matrix<T>& lhs, const Matrix<T>& rhs)
+    template <typename L, typename R>
+    MatrixBinary<L, R, detail::SubtractOp> operator-(const MatrixExpression<L>& lhs, const MatrixExpression<R>& rhs)
     {
-        using sizeType = typename Matrix<T>::size_type;
-        sizeType lhsNumRows = lhs.get_rows();
-        sizeType lhsNumCols = lhs.get_cols();
-        sizeType rhsNumRows = rhs.get_rows();
-        sizeType rhsNumCols = rhs.get_cols();
-
         // Check if number of rows and columns are the same. 
-        // If sizes are different, return false.
-        if (lhsNumRows != rhsNumRows || lhsNumCols != rhsNumCols)
+        // If sizes are different, throw.
+        if (lhs.self().get_rows() != rhs.self().get_rows() || lhs.self().get_cols() != rhs.self().get_cols())
         {
             throw std::runtime_error("operands for matrix subtraction must have same dimensions");
         }
 
-        Matrix<T> result(lhsNumRows, lhsNumCols);
-        for (sizeType r = 0; r < lhsNumRows; ++r)
-        {
-            for (sizeType c = 0; c < lhsNumCols; ++c)
-            {
-                result[r][c] = lhs[r][c] - rhs[r][c];
-            }
-        }
-        return result;
+        return MatrixBinary<L, R, detail::SubtractOp>{lhs.self(), rhs.self()};
     }
 
     template <typename T>
@@ -586,120 +1169,84 @@ namespace csd2125
             throw std::runtime_error("number of columns in left operand must match number of rows in right operand");
         }
 
+        // The result starts at zero, and the product is added to it
         Matrix<T> result(lhsNumRows, rhsNumCols);
-        for(sizeType r = 0; r < lhsNumRows; ++r)
-        {
-            for(sizeType c = 0; c < rhsNumCols; ++c)
-            {
-                for(sizeType n = 0; n < lhsNumCols; ++n)
-                {
-                    result[r][c] += lhs[r][n] * rhs[n][c];
-                }
-            }
-        }
+        detail::gemm(lhsNumRows, rhsNumCols, lhsNumCols, lhs.data.get(), rhs.data.get(), result.data.get());
         return result;
     }
 
-    template <typename T>
-    Matrix<T> operator*(typename Matrix<T>::value_type lhs, const Matrix<T>& rhs)
+    template <typename L, typename R>
+    Matrix<typename L::value_type> operator*(const MatrixExpression<L>& lhs, const MatrixExpression<R>& rhs)
     {
-        using sizeType = typename Matrix<T>::size_type;
-        sizeType numRows = rhs.get_rows();
-        sizeType numCols = rhs.get_cols();
-
-        Matrix<T> result(numRows, numCols);
-        for (sizeType r = 0; r < numRows; ++r)
+        // Matrices are used as they are, and anything else is evaluated
+        auto evaluate = [](const auto& expression) -> decltype(auto)
         {
-            for (sizeType c = 0; c < numCols; ++c)
+            using Expression = std::decay_t<decltype(expression)>;
+            using Result     = Matrix<typename Expression::value_type>;
+            if constexpr (std::is_same_v<Expression, Result>)
             {
-                result[r][c] = lhs * rhs[r][c];
+                return expression;
             }
-        }
-        return result;
+            else
+            {
+                return Result(expression);
+            }
+        };
+
+        return evaluate(lhs.self()) * evaluate(rhs.self());
     }
 
-    template <typename T>
-    bool operator==(const Matrix<T>& lhs, const Matrix<T>& rhs)
+    template <typename E>
+    MatrixScale<E> operator*(typename E::value_type lhs, const MatrixExpression<E>& rhs)
     {
-        using sizeType = typename Matrix<T>::size_type;
-        sizeType lhsNumRows = lhs.get_rows();
-        sizeType lhsNumCols = lhs.get_cols();
-        sizeType rhsNumRows = rhs.get_rows();
-        sizeType rhsNumCols = rhs.get_cols();
+        return MatrixScale<E>{lhs, rhs.self()};
+    }
+
+    template <typename L, typename R>
+    bool operator==(const MatrixExpression<L>& lhs, const MatrixExpression<R>& rhs)
+    {
+        using T         = typename L::value_type;
+        using sizeType  = typename Matrix<T>::size_type;
+        const L& left   = lhs.self();
+        const R& right  = rhs.self();
 
         // Check if number of rows and columns are the same. 
         // If sizes are different, return false.
-        if (lhsNumRows != rhsNumRows || lhsNumCols != rhsNumCols)
+        if (left.get_rows() != right.get_rows() || left.get_cols() != right.get_cols())
         {
             return false;
         }
 
-        for (sizeType r = 0; r < lhsNumRows; ++r)
+        // Expressions are computed an element at a time, without a temporary Matrix
+        const sizeType NUM_ELEMENTS = left.get_rows() * left.get_cols();
+        for (sizeType i = 0; i < NUM_ELEMENTS; ++i)
         {
-            for (sizeType c = 0; c < lhsNumCols; ++c)
+            if constexpr (std::is_floating_point_v<T>)
             {
-                if constexpr (std::is_floating_point_v<T>)
+                T diff = std::abs(left.element(i) - right.element(i));
+                if (diff > std::numeric_limits<T>::epsilon())
                 {
-                    T diff = std::abs(lhs[r][c] - rhs[r][c]);
-                    if (diff > std::numeric_limits<T>::epsilon())
-                    {
-                        return false;
-                    }
+                    return false;
                 }
-                else
-                {
-                    if (lhs[r][c] != rhs[r][c])
-                    {
-                        return false;
-                    }
-                }                
             }
-        }
-
-        return true;
-    }
-
-    template <typename T>
-    bool operator!=(const Matrix<T>& lhs, const Matrix<T>& rhs)
-    {
-        using sizeType = typename Matrix<T>::size_type;
-        sizeType lhsNumRows = lhs.get_rows();
-        sizeType lhsNumCols = lhs.get_cols();
-        sizeType rhsNumRows = rhs.get_rows();
-        sizeType rhsNumCols = rhs.get_cols();
-
-        // Check if number of rows and columns are the same. 
-        // If sizes are different, return true.
-        if (lhsNumRows != rhsNumRows || lhsNumCols != rhsNumCols)
-        {
-            return true;
-        }
-
-        for (sizeType r = 0; r < lhsNumRows; ++r)
-        {
-            for (sizeType c = 0; c < lhsNumCols; ++c)
+            else
             {
-                if constexpr (std::is_floating_point_v<T>)
+                if (left.element(i) != right.element(i))
                 {
-                    T diff = std::abs(lhs[r][c] - rhs[r][c]);
-                    if (diff <= std::numeric_limits<T>::epsilon())
-                    {
-                        return false;
-                    }
+                    return false;
                 }
-                else
-                {
-                    if (lhs[r][c] == rhs[r][c])
-                    {
-                        return false;
-                    }
-                } 
             }
         }
 
         return true;
     }
 
+    template <typename L, typename R>
+    bool operator!=(const MatrixExpression<L>& lhs, const MatrixExpression<R>& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
 }   // namespace csd2125
 
 #endif
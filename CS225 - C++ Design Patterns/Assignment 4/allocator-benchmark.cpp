@@ -0,0 +1,173 @@
+// Times csd2125::allocator against std::allocator, directly and as the allocator of
+// std::list and std::map, and checks that no two live allocations overlap.
+// Build with: make benchmark
+
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include "allocator.hpp"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+    using Flags = unsigned long long;   // 64 elements per pool
+
+    // Stops the optimiser from dropping a result
+    volatile std::uint64_t sink;
+
+    constexpr int RUNS = 5;
+
+    template <typename Fn>
+    double timeMs(Fn fn)
+    {
+        const auto START = Clock::now();
+        fn();
+        return std::chrono::duration<double, std::milli>(Clock::now() - START).count();
+    }
+
+    // Times both sides RUNS times, taking turns, and keeps the best of each
+    template <typename StdFn, typename PoolFn>
+    void compare(const char* name, StdFn stdFn, PoolFn poolFn)
+    {
+        double stdMs = 1e30, poolMs = 1e30;
+        for (int run = 0; run < RUNS; ++run)
+        {
+            stdMs  = std::min(stdMs, timeMs(stdFn));
+            poolMs = std::min(poolMs, timeMs(poolFn));
+        }
+
+        std::cout << std::left << std::setw(28) << name << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(12) << stdMs << std::setw(12) << poolMs
+                  << std::setw(10) << std::setprecision(2) << stdMs / poolMs << "x" << std::endl;
+    }
+
+    // Keeps LIVE runs of 1 to 8 elements alive, replacing a random one every step. Every
+    // element holds the index of its run, checked before the run is freed.
+    template <typename Allocator>
+    void churn(Allocator& allocator, size_t steps)
+    {
+        constexpr size_t LIVE = 4096;
+        struct Run { std::uint64_t* p; size_t count; };
+
+        std::mt19937 random{ 42 };
+        std::vector<Run> runs(LIVE);
+        auto fill = [&](size_t slot)
+        {
+            const size_t COUNT = 1 + random() % 8;
+            runs[slot] = Run{ allocator.allocate(COUNT), COUNT };
+            for (size_t i = 0; i < COUNT; ++i) { runs[slot].p[i] = slot; }
+        };
+
+        for (size_t slot = 0; slot < LIVE; ++slot) { fill(slot); }
+        for (size_t step = 0; step < steps; ++step)
+        {
+            const size_t SLOT = random() % LIVE;
+            for (size_t i = 0; i < runs[SLOT].count; ++i)
+            {
+                if (runs[SLOT].p[i] != SLOT) { throw std::runtime_error{ "Live allocations overlap." }; }
+            }
+            allocator.deallocate(runs[SLOT].p, runs[SLOT].count);
+            fill(SLOT);
+        }
+        for (const Run& run : runs) { allocator.deallocate(run.p, run.count); }
+    }
+
+    // Builds a list, removes every other node and refills it
+    template <typename Allocator>
+    std::uint64_t listWork(size_t nodes)
+    {
+        std::list<std::uint64_t, Allocator> list;
+        for (size_t i = 0; i < nodes; ++i) { list.push_back(i); }
+        for (auto it = list.begin(); it != list.end(); ) { it = list.erase(it); if (it != list.end()) { ++it; } }
+        for (size_t i = 0; i < nodes / 2; ++i) { list.push_front(i); }
+
+        std::uint64_t sum = 0;
+        for (std::uint64_t value : list) { sum += value; }
+        return sum;
+    }
+
+    // Random inserts and erases on a map
+    template <typename Allocator>
+    std::uint64_t mapWork(size_t operations)
+    {
+        std::map<std::uint64_t, std::uint64_t, std::less<std::uint64_t>, Allocator> map;
+        std::mt19937 random{ 7 };
+        for (size_t i = 0; i < operations; ++i)
+        {
+            const std::uint64_t KEY = random() % 65536;
+            if (i % 3 == 2) { map.erase(KEY); }
+            else            { map[KEY] = i; }
+        }
+
+        std::uint64_t sum = 0;
+        for (const auto& entry : map) { sum += entry.first ^ entry.second; }
+        return sum;
+    }
+}
+
+int main()
+{
+    constexpr size_t CHURN_STEPS    = 4000000;
+    constexpr size_t LIST_NODES     = 2000000;
+    constexpr size_t MAP_OPERATIONS = 2000000;
+
+    std::cout << std::left << std::setw(28) << "ms, best of 5" << std::right
+              << std::setw(12) << "std" << std::setw(12) << "csd2125" << std::setw(11) << "speedup" << std::endl;
+
+    try
+    {
+        {
+            std::allocator<std::uint64_t> stdAllocator;
+            csd2125::allocator<std::uint64_t, Flags> poolAllocator;
+            compare
+            (
+                "churn, 1-8 elements",
+                [&] { churn(stdAllocator, CHURN_STEPS); },
+                [&] { churn(poolAllocator, CHURN_STEPS); }
+            );
+        }
+
+        {
+            std::uint64_t stdSum = 0, poolSum = 0;
+            compare
+            (
+                "std::list",
+                [&] { stdSum = listWork<std::allocator<std::uint64_t>>(LIST_NODES); },
+                [&] { poolSum = listWork<csd2125::allocator<std::uint64_t, Flags>>(LIST_NODES); }
+            );
+            if (stdSum != poolSum) { throw std::runtime_error{ "Lists disagree." }; }
+        }
+
+        {
+            using Entry = std::pair<const std::uint64_t, std::uint64_t>;
+            std::uint64_t stdSum = 0, poolSum = 0;
+            compare
+            (
+                "std::map",
+                [&] { stdSum = mapWork<std::allocator<Entry>>(MAP_OPERATIONS); },
+                [&] { poolSum = mapWork<csd2125::allocator<Entry, Flags>>(MAP_OPERATIONS); }
+            );
+            if (stdSum != poolSum) { throw std::runtime_error{ "Maps disagree." }; }
+        }
+
+        {
+            // Past 64 elements the vector's buffers come from the global new
+            std::vector<std::uint64_t, csd2125::allocator<std::uint64_t, Flags>> vector;
+            for (size_t i = 0; i < LIST_NODES; ++i) { vector.push_back(i); }
+            sink = vector.back();
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cout << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
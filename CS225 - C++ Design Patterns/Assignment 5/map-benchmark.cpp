@@ -0,0 +1,198 @@
+// Crawls a generated tree of files into file_records, filters, prints and removes the
+// empty ones, and times each against the way it was done before.
+// Build with: make benchmark
+// Run with:   ./map-benchmark.out [files, default 1000000] [scratch directory, default bench-tree]
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <map>
+#include <string>
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <utility>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+#include <stdexcept>
+
+using file_name = std::string;
+using file_size = size_t;
+using file_record = std::pair<file_name, file_size>;
+using file_records = std::map<file_name, file_size>;
+
+// The helpers map-test.cpp gives solution.hpp
+void insert(file_records& records, file_record const& record)
+{
+    records.insert(record);
+}
+
+bool check_if_empty(file_record const& record, bool trueIfIsNot)
+{
+    file_size size;
+    std::tie(std::ignore, size) = record;
+    bool result = (size == 0);
+    result = trueIfIsNot ? !result : result;
+    return result;
+}
+
+file_name split(file_record const& record)
+{
+    file_name name;
+    std::tie(name, std::ignore) = record;
+    return name;
+}
+
+void print_file_name(file_name const& name)
+{
+    std::cout << " * " << name << std::endl;
+}
+
+#include "solution.hpp"
+
+namespace
+{
+    // Counts every allocation, through the replaced global new below, which the
+    // crawler's threads call too
+    std::atomic<size_t> allocations {0};
+}
+
+void* operator new(size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) { return p; }
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* p) noexcept                  { std::free(p); }
+void operator delete(void* p, size_t) noexcept          { std::free(p); }
+
+namespace
+{
+    namespace fs = std::filesystem;
+    using Clock = std::chrono::steady_clock;
+
+    // 1 in 4 files is empty, the rest hold 1 to 64 bytes
+    void generate(const fs::path& root, size_t files)
+    {
+        constexpr size_t PER_DIRECTORY = 1000, PER_PARENT = 10;
+        const std::string BYTES(64, 'x');
+        for (size_t i = 0; i < files; ++i)
+        {
+            const size_t DIRECTORY = i / PER_DIRECTORY;
+            const fs::path PARENT = root / ("d" + std::to_string(DIRECTORY / PER_PARENT)) / ("e" + std::to_string(DIRECTORY % PER_PARENT));
+            if (i % PER_DIRECTORY == 0) { fs::create_directories(PARENT); }
+
+            std::ofstream file {PARENT / ("f" + std::to_string(i) + ".dat"), std::ios::binary};
+            file.write(BYTES.data(), static_cast<std::streamsize>(i % 4 == 0 ? 0 : 1 + i % 64));
+        }
+    }
+
+    struct Timing
+    {
+        double ms;
+        size_t allocations;
+    };
+
+    template <typename Fn>
+    Timing time(Fn fn)
+    {
+        const size_t BEFORE = allocations.load(std::memory_order_relaxed);
+        const auto START = Clock::now();
+        fn();
+        return Timing{std::chrono::duration<double, std::milli>(Clock::now() - START).count(), allocations.load(std::memory_order_relaxed) - BEFORE};
+    }
+
+    void report(const char* name, Timing timing, Timing baseline)
+    {
+        std::cout << std::left << std::setw(34) << name << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(10) << timing.ms << std::setw(14) << timing.allocations
+                  << std::setw(9) << std::setprecision(2) << baseline.ms / timing.ms << "x" << std::endl;
+    }
+
+    // The way a tree was read before: one thread, one insert per file
+    void legacyCrawl(file_records& map, const fs::path& root)
+    {
+        for (const fs::directory_entry& entry : fs::recursive_directory_iterator{root})
+        {
+            if (entry.is_regular_file())
+            {
+                insert(map, file_record{entry.path().lexically_relative(root).generic_string(), entry.file_size()});
+            }
+        }
+    }
+
+    // The previous print_non_empty_files and remove_empty, which copied the records out
+    size_t legacyPrintNonEmpty(const file_records& map)
+    {
+        std::vector<file_record> nonEmptyFiles;
+        std::copy_if(std::cbegin(map), std::cend(map), std::back_inserter(nonEmptyFiles),
+                     std::bind(check_if_empty, std::placeholders::_1, true));
+        std::for_each(std::cbegin(nonEmptyFiles), std::cend(nonEmptyFiles), std::bind(print_file_name, std::bind(split, std::placeholders::_1)));
+        return std::size(nonEmptyFiles);
+    }
+
+    void legacyRemoveEmpty(file_records& map)
+    {
+        std::vector<file_record> nonEmptyFiles;
+        std::copy_if(std::begin(map), std::end(map), std::back_inserter(nonEmptyFiles),
+                     std::bind(check_if_empty, std::placeholders::_1, true));
+        map.clear();
+        std::for_each(std::begin(nonEmptyFiles), std::end(nonEmptyFiles), std::bind(insert, std::ref<file_records>(map), std::placeholders::_1));
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const size_t FILES = argc > 1 ? std::stoull(argv[1]) : 1000000;
+    const fs::path ROOT = argc > 2 ? argv[2] : "bench-tree";
+
+    try
+    {
+        fs::remove_all(ROOT);
+        generate(ROOT, FILES);
+
+        std::cout << FILES << " files" << std::endl;
+        std::cout << std::left << std::setw(34) << "" << std::right
+                  << std::setw(10) << "ms" << std::setw(14) << "allocations" << std::setw(10) << "speedup" << std::endl;
+
+        file_records legacyMap, oneThreadMap, map;
+        const Timing LEGACY_CRAWL = time([&] { legacyCrawl(legacyMap, ROOT); });
+        report("crawl, recursive iterator", LEGACY_CRAWL, LEGACY_CRAWL);
+        report("add_files, 1 thread", time([&] { add_files(oneThreadMap, ROOT, 1); }), LEGACY_CRAWL);
+        report("add_files", time([&] { add_files(map, ROOT); }), LEGACY_CRAWL);
+        if (map.size() != FILES || map != legacyMap || map != oneThreadMap) { throw std::runtime_error{"Crawls disagree."}; }
+        oneThreadMap.clear();
+
+        // Printing goes nowhere, so the time is in the filter and the stream
+        std::ofstream null {"/dev/null"};
+        std::streambuf* const COUT = std::cout.rdbuf(null.rdbuf());
+        size_t legacyPrinted = 0, printed = 0, written = 0;
+        const Timing LEGACY_PRINT = time([&] { legacyPrinted = legacyPrintNonEmpty(map); });
+        const Timing PRINT = time([&] { printed = print_non_empty_files(map); });
+        auto nonEmpty = [](const file_records::value_type& record) { return record.second != 0; };
+        const Timing WRITE = time([&] { written = write_file_names_if(map, nonEmpty, std::cout); });
+        std::cout.rdbuf(COUT);
+        if (printed != legacyPrinted || written != legacyPrinted) { throw std::runtime_error{"Prints disagree."}; }
+
+        report("print non-empty, copied", LEGACY_PRINT, LEGACY_PRINT);
+        report("print_non_empty_files", PRINT, LEGACY_PRINT);
+        report("write_file_names_if", WRITE, LEGACY_PRINT);
+
+        file_records legacyRemoved = map;
+        const Timing LEGACY_REMOVE = time([&] { legacyRemoveEmpty(legacyRemoved); });
+        report("remove empty, copied", LEGACY_REMOVE, LEGACY_REMOVE);
+        report("remove_empty", time([&] { remove_empty(map); }), LEGACY_REMOVE);
+        if (map != legacyRemoved || map.size() != legacyPrinted) { throw std::runtime_error{"Removals disagree."}; }
+
+        fs::remove_all(ROOT);
+    }
+    catch (const std::exception& e)
+    {
+        std::cout << "Error: " << e.what() << std::endl;
+        fs::remove_all(ROOT);
+        return 1;
+    }
+}
@@ -13,6 +13,14 @@ consent of DigiPen Institute of Technology is prohibited.
 
 #pragma once
 
+#include <condition_variable>
+#include <exception>
+#include <filesystem>
+#include <mutex>
+#include <ostream>
+#include <system_error>
+#include <thread>
+
 /************************************************************************************//*!
 \brief      Prints all the file names of a file stored in a map of file records.
 
@@ -24,6 +32,54 @@ void print_file_names(const file_records& map)
     std::for_each(std::cbegin(map), std::cend(map), std::bind(print_file_name, std::bind(split, std::placeholders::_1)));
 }
 
+/************************************************************************************//*!
+\brief      Calls a function on every file record that matches a predicate, as the
+            map is walked, so nothing is copied out of it.
+
+\param      map
+    Reference to an associative container holding all the file records.
+\param      predicate
+    Returns true for the file records to visit. One that takes a file_records::value_type
+    sees the record in the map, where one that takes a file_record gets a copy.
+\param      visit
+    Called with every file record that matches.
+
+\returns    The number of file records that matched
+*//*************************************************************************************/
+template <typename Predicate, typename Visitor>
+size_t for_each_file_if(const file_records& map, Predicate predicate, Visitor visit)
+{
+    size_t count = 0;
+    std::for_each(std::cbegin(map), std::cend(map), [&](const file_records::value_type& record)
+    {
+        if (predicate(record))
+        {
+            visit(record);
+            ++count;
+        }
+    });
+    return count;
+}
+
+/************************************************************************************//*!
+\brief      Writes the file names of the file records that match a predicate to a
+            stream, in the format of print_file_name, without flushing every line.
+
+\param      map
+    Reference to an associative container holding all the file records.
+\param      predicate
+    Returns true for the file records to write.
+\param      os
+    The stream to write to.
+
+\returns    The number of file names written
+*//*************************************************************************************/
+template <typename Predicate>
+size_t write_file_names_if(const file_records& map, Predicate predicate, std::ostream& os)
+{
+    return for_each_file_if(map, predicate, [&os](const file_records::value_type& record) { os << " * " << record.first << '\n'; });
+}
+
 /************************************************************************************//*!
 \brief      Prints all the file names of non-empty files stored in a map of file records.
 
@@ -34,14 +90,7 @@ void print_file_names(const file_records& map)
 *//*************************************************************************************/
 size_t print_non_empty_files(const file_records& map)
 {
-    // get all non-empty files
-    std::vector<file_record> nonEmptyFiles;
-    std::copy_if(std::cbegin(map), std::cend(map), std::back_inserter(nonEmptyFiles), 
-                 std::bind(check_if_empty, std::placeholders::_1, true));
-    
-    // print all non-empty file names
-    std::for_each(std::cbegin(nonEmptyFiles), std::cend(nonEmptyFiles), std::bind(print_file_name, std::bind(split, std::placeholders::_1)));
-    return std::size(nonEmptyFiles);
+    return for_each_file_if(map, std::bind(check_if_empty, std::placeholders::_1, true), std::bind(print_file_name, std::bind(split, std::placeholders::_1)));
 }
 
 /************************************************************************************//*!
@@ -54,14 +103,7 @@ size_t print_non_empty_files(const file_records& map)
 *//*************************************************************************************/
 size_t print_empty_files(const file_records& map)
 {
-    // Get all empty files
-    std::vector<file_record> emptyFiles;
-    std::copy_if(std::cbegin(map), std::cend(map), std::back_inserter(emptyFiles), 
-                 std::bind(check_if_empty, std::placeholders::_1, false));
-    
-    // print all empty file names
-    std::for_each(std::cbegin(emptyFiles), std::cend(emptyFiles), std::bind(print_file_name, std::bind(split, std::placeholders::_1)));
-    return std::size(emptyFiles);
+    return for_each_file_if(map, std::bind(check_if_empty, std::placeholders::_1, false), std::bind(print_file_name, std::bind(split, std::placeholders::_1)));
 }
 
 /************************************************************************************//*!
@@ -76,22 +118,132 @@ std::tuple<file_records&> get_parameters(file_records& map)
 }
 
 /************************************************************************************//*!
-\brief      Removes all empty files from an associative container.
+\brief      Removes all empty files from an associative container, in place. Only the
+            nodes of the empty files are freed, and nothing is allocated.
 
 \param      map
     Reference to an associative container holding all the file records.
 *//*************************************************************************************/
 void remove_empty(file_records& map)
 {
-    // Get all non-empty files
-    std::vector<file_record> nonEmptyFiles;
-    std::copy_if(std::begin(map), std::end(map), std::back_inserter(nonEmptyFiles), 
-                 std::bind(check_if_empty, std::placeholders::_1, true));
+    // check_if_empty takes a file_record, so it would get a copy of every name
+    for (auto it = std::begin(map); it != std::end(map); )
+    {
+        it = it->second == 0 ? map.erase(it) : std::next(it);
+    }
+}
+
+/************************************************************************************//*!
+\brief      Adds every regular file under a directory to an associative container,
+            keyed by its path relative to the directory, with its size in bytes.
 
-    // clear the map
-    std::function<void(file_records&)> mapClear = &file_records::clear;
-    mapClear(map);
+            Threads take directories from a shared queue, queue the directories
+            they find and keep the files in buffers of their own, so they only
+            share the queue. The buffers are sorted together at the end and
+            inserted in order, each at the end of the last, so the map is only
+            locked by one thread and never searched. Symbolic links to directories
+            are not followed.
 
-    // Put non-empty files into map
-    std::for_each(std::begin(nonEmptyFiles), std::end(nonEmptyFiles), std::bind(insert, std::ref<file_records>(map), std::placeholders::_1));
+\param      map
+    Reference to an associative container to add the file records to. Files
+    already in it keep their records.
+\param      root
+    The directory to crawl.
+\param      threadCount
+    The number of threads to crawl with, or 0 for one per hardware thread, at least 2
+    so one crawls while another waits for the disk.
+
+\throws     std::filesystem::filesystem_error
+    If a directory or a file can't be read. map is left unchanged.
+*//*************************************************************************************/
+void add_files(file_records& map, const std::filesystem::path& root, unsigned threadCount = 0)
+{
+    namespace fs = std::filesystem;
+
+    if (threadCount == 0)
+    {
+        threadCount = std::max(std::thread::hardware_concurrency(), 2u);
+    }
+
+    std::mutex                  queueMutex;
+    std::condition_variable     queueChanged;
+    std::vector<std::pair<fs::path, std::string>> queue {{root, ""}};  // Directories, with the prefix of their files' names
+    size_t                      busy = 0;       // Threads reading a directory, which may queue more
+    std::exception_ptr          error;
+
+    std::vector<std::vector<file_record>> found(threadCount);
+    auto crawl = [&](std::vector<file_record>& files)
+    {
+        std::unique_lock<std::mutex> lock {queueMutex};
+        while (true)
+        {
+            queueChanged.wait(lock, [&] { return !queue.empty() || busy == 0 || error; });
+            if (queue.empty() || error) { return; }
+
+            const auto [DIRECTORY, PREFIX] = std::move(queue.back());
+            queue.pop_back();
+            ++busy;
+            lock.unlock();
+
+            std::vector<std::pair<fs::path, std::string>> subdirectories;
+            try
+            {
+                for (const fs::directory_entry& entry : fs::directory_iterator{DIRECTORY})
+                {
+                    std::string name = PREFIX + entry.path().filename().string();
+                    if (entry.is_directory() && !entry.is_symlink())
+                    {
+                        subdirectories.emplace_back(entry.path(), std::move(name += '/'));
+                    }
+                    else if (entry.is_regular_file())
+                    {
+                        files.emplace_back(std::move(name), entry.file_size());
+                    }
+                }
+            }
+            catch (...)
+            {
+                lock.lock();
+                if (!error) { error = std::current_exception(); }
+                --busy;
+                queueChanged.notify_all();
+                return;
+            }
+
+            lock.lock();
+            std::move(std::begin(subdirectories), std::end(subdirectories), std::back_inserter(queue));
+            --busy;
+            queueChanged.notify_all();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount - 1);
+    try
+    {
+        for (unsigned i = 1; i < threadCount; ++i)
+        {
+            threads.emplace_back(crawl, std::ref(found[i]));
+        }
+    }
+    catch (const std::system_error&)
+    {
+        // Crawl with the threads that did start
+    }
+    crawl(found[0]);
+    std::for_each(std::begin(threads), std::end(threads), std::mem_fn(&std::thread::join));
+
+    if (error) { std::rethrow_exception(error); }
+
+    std::vector<file_record> files = std::move(found[0]);
+    std::for_each(std::next(std::begin(found)), std::end(found), [&files](std::vector<file_record>& buffer)
+    {
+        std::move(std::begin(buffer), std::end(buffer), std::back_inserter(files));
+    });
+    std::sort(std::begin(files), std::end(files));
+
+    for (file_record& record : files)
+    {
+        map.emplace_hint(std::end(map), std::move(record));
+    }
 }
\ No newline at end of file
@@ -0,0 +1,550 @@
+/************************************************************************************//*!
+ \file           benchmark.cpp
+ \author         Diren D Bharwani, diren.dbharwani, 390002520
+ \par            email: diren.dbharwani\@digipen.edu
+ \date           Jan 19, 2022
+ \brief          Contains the implementation of the ObjectAllocator benchmarks.
+ 
+ Copyright (C) 2022 DigiPen Institute of Technology.
+ Reproduction or disclosure of this file or its contents without the prior written 
+ consent of DigiPen Institute of Technology is prohibited.
+*//*************************************************************************************/
+
+// Primary Header
+#include "benchmark.h"
+// Standard Libraries
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <cstring>
+// Project Headers
+#include "src/ObjectAllocator.h"
+#include "src/SlabAllocator.h"
+
+/*-------------------------------------------------------------------------------------*/
+/* Local Helpers                                                                       */
+/*-------------------------------------------------------------------------------------*/
+namespace
+{
+    const size_t    OBJECT_SIZE     = 64;       //!< size of each benchmarked object
+    const unsigned  OBJECTS_PER_PAGE= 256;      //!< objects per page for every allocator
+    const unsigned  ROUNDS          = 2000;     //!< allocate/free rounds per thread
+    const unsigned  BATCH           = 128;      //!< objects held live per round
+
+    /********************************************************************************//*!
+    @brief  Runs the same allocate/free pattern on a number of threads and returns the
+            throughput in millions of operations per second.
+
+    @param  threads
+        The number of worker threads.
+    @param  allocate
+        Callable returning a new object.
+    @param  free
+        Callable taking an object to release.
+    @param  flush
+        Callable that each worker calls before it exits.
+    *//*********************************************************************************/
+    template <typename Allocate, typename Free, typename Flush>
+    double runThroughput(unsigned threads, Allocate allocate, Free free, Flush flush)
+    {
+        auto worker = [&]()
+        {
+            std::vector<void*> live(BATCH);
+            for (unsigned r = 0; r < ROUNDS; ++r)
+            {
+                for (unsigned i = 0; i < BATCH; ++i)
+                    live[i] = allocate();
+
+                // Free in reverse so objects don't come back in the order they left
+                for (unsigned i = BATCH; i-- > 0;)
+                    free(live[i]);
+            }
+            flush();
+        };
+
+        const auto start = std::chrono::steady_clock::now();
+
+        std::vector<std::thread> pool;
+        for (unsigned t = 0; t < threads; ++t)
+            pool.emplace_back(worker);
+        for (std::thread& t : pool)
+            t.join();
+
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        const double operations = 2.0 * threads * ROUNDS * BATCH;
+        return operations / elapsed.count() / 1e6;
+    }
+
+    /********************************************************************************//*!
+    @brief  Gets the resident memory of the process. Only available on Linux.
+
+    @return The resident memory in MB. 0 if it is unavailable.
+    *//*********************************************************************************/
+    double residentMB()
+    {
+        std::ifstream statm("/proc/self/statm");
+        size_t pages = 0, resident = 0;
+        if (!(statm >> pages >> resident))
+            return 0.0;
+
+        return resident * 4096.0 / (1024.0 * 1024.0);
+    }
+
+    /********************************************************************************//*!
+    @brief  Allocates a set of objects of the given sizes, frees them in a shuffled 
+            order and repeats. Returns the throughput in millions of operations per
+            second.
+
+    @param  sizes
+        The size of every object in a round.
+    @param  order
+        The order to free the objects in.
+    @param  allocate
+        Callable taking a size and returning a new object.
+    @param  free
+        Callable taking an object to release.
+    *//*********************************************************************************/
+    template <typename Allocate, typename Free>
+    double runMixedSizes(const std::vector<size_t>& sizes, const std::vector<size_t>& order, Allocate allocate, Free free)
+    {
+        std::vector<void*> live(sizes.size());
+
+        const auto start = std::chrono::steady_clock::now();
+        for (unsigned r = 0; r < ROUNDS / 20; ++r)
+        {
+            for (size_t i = 0; i < sizes.size(); ++i)
+                live[i] = allocate(sizes[i]);
+
+            for (size_t i : order)
+                free(live[i]);
+        }
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        const double operations = 2.0 * (ROUNDS / 20) * sizes.size();
+        return operations / elapsed.count() / 1e6;
+    }
+
+    /********************************************************************************//*!
+    @brief  FNV-1a hash of a key, for the hash table benchmark.
+
+    @param  key
+        The key to hash.
+    @param  tableSize
+        The number of slots in the table.
+
+    @return The slot of the key.
+    *//*********************************************************************************/
+    unsigned hashKey(const char* key, unsigned tableSize)
+    {
+        unsigned hash = 2166136261u;
+        for (; *key; ++key)
+            hash = (hash ^ static_cast<unsigned char>(*key)) * 16777619u;
+
+        return hash % tableSize;
+    }
+
+    /********************************************************************************//*!
+    @brief  A chained hash table of string keys, with its nodes from an ObjectAllocator
+            or from new and delete. It grows like the tables of the hashing assignment,
+            so a benchmark of it is dominated by node allocations.
+    *//*********************************************************************************/
+    class NodeTable
+    {
+    public:
+        static const size_t     MAX_KEYLEN      = 16;   //!< longest key, with its terminator
+        static const unsigned   INITIAL_SLOTS   = 1021; //!< slots before the first growth
+        static const unsigned   MAX_LOAD        = 3;    //!< nodes per slot that cause growth
+
+        /****************************************************************************//*!
+        @brief  A node of a chain.
+        *//*****************************************************************************/
+        struct Node
+        {
+            char        Key[MAX_KEYLEN];    //!< the key
+            unsigned    Data;               //!< the value
+            Node*       Next;               //!< the next node in the slot
+        };
+
+        /****************************************************************************//*!
+        @brief  Creates an empty table.
+
+        @param  allocator
+            The allocator for the nodes, or null for new and delete.
+        *//*****************************************************************************/
+        explicit NodeTable(ObjectAllocator* allocator)
+        : allocator { allocator }
+        , slots     (INITIAL_SLOTS, nullptr)
+        , count     { 0 }
+        {}
+
+        NodeTable(const NodeTable&) = delete;
+        NodeTable& operator=(const NodeTable&) = delete;
+
+        /****************************************************************************//*!
+        @brief  Frees every node.
+        *//*****************************************************************************/
+        ~NodeTable()
+        {
+            for (Node* head : slots)
+            {
+                while (head)
+                {
+                    Node* next = head->Next;
+                    freeNode(head);
+                    head = next;
+                }
+            }
+        }
+
+        /****************************************************************************//*!
+        @brief  Adds a key that isn't in the table.
+
+        @param  key
+            The key, shorter than MAX_KEYLEN.
+        @param  data
+            The value of the key.
+        *//*****************************************************************************/
+        void insert(const char* key, unsigned data)
+        {
+            if (count >= MAX_LOAD * slots.size())
+                grow();
+
+            Node* node = allocator ? static_cast<Node*>(allocator->Allocate()) : new Node;
+            std::strncpy(node->Key, key, MAX_KEYLEN - 1);
+            node->Key[MAX_KEYLEN - 1] = '\0';
+            node->Data = data;
+
+            Node*& head = slots[hashKey(key, static_cast<unsigned>(slots.size()))];
+            node->Next = head;
+            head = node;
+            ++count;
+        }
+
+        /****************************************************************************//*!
+        @brief  Removes a key if it is in the table.
+
+        @param  key
+            The key.
+        *//*****************************************************************************/
+        void remove(const char* key)
+        {
+            for (Node** link = &slots[hashKey(key, static_cast<unsigned>(slots.size()))]; *link; link = &(*link)->Next)
+            {
+                if (std::strcmp((*link)->Key, key) == 0)
+                {
+                    Node* node = *link;
+                    *link = node->Next;
+                    freeNode(node);
+                    --count;
+                    return;
+                }
+            }
+        }
+
+    private:
+        ObjectAllocator*    allocator;  //!< the allocator of the nodes, null for new and delete
+        std::vector<Node*>  slots;      //!< the head of every chain
+        size_t              count;      //!< the number of nodes
+
+        /****************************************************************************//*!
+        @brief  Moves the nodes into twice as many slots. Only the links change.
+        *//*****************************************************************************/
+        void grow()
+        {
+            std::vector<Node*> grown(slots.size() * 2 + 1, nullptr);
+            for (Node* head : slots)
+            {
+                while (head)
+                {
+                    Node* next = head->Next;
+                    Node*& slot = grown[hashKey(head->Key, static_cast<unsigned>(grown.size()))];
+                    head->Next = slot;
+                    slot = head;
+                    head = next;
+                }
+            }
+            slots.swap(grown);
+        }
+
+        /****************************************************************************//*!
+        @brief  Frees a node to where it came from.
+
+        @param  node
+            The node to free.
+        *//*****************************************************************************/
+        void freeNode(Node* node)
+        {
+            if (allocator)
+                allocator->Free(node);
+            else
+                delete node;
+        }
+    };
+}
+
+/*-------------------------------------------------------------------------------------*/
+/* Function Definitions                                                                */
+/*-------------------------------------------------------------------------------------*/
+
+/************************************************************************************//*!
+ @brief  Measures multi-threaded allocate/free throughput of the concurrent allocator
+         against the C++ memory manager and a mutex-wrapped allocator.
+*//*************************************************************************************/
+void BenchmarkConcurrent()
+{
+    const unsigned maxThreads = std::thread::hardware_concurrency() ? std::thread::hardware_concurrency() : 4;
+
+    std::cout << "Concurrent allocate/free throughput (Mops/s)\n";
+    std::cout << std::setw(8) << "threads" << std::setw(12) << "new/delete" << std::setw(12) << "mutex OA" << std::setw(12) << "cached OA" << '\n';
+
+    for (unsigned threads = 1; threads <= maxThreads; threads *= 2)
+    {
+        // C++ memory manager
+        OAConfig cppConfig(true, OBJECTS_PER_PAGE, 0, false, 0, OAConfig::HeaderBlockInfo(), 0, true);
+        ObjectAllocator cppOA(OBJECT_SIZE, cppConfig);
+        const double cpp = runThroughput
+        (
+            threads,
+            [&]()            { return cppOA.Allocate(); },
+            [&](void* obj)   { cppOA.Free(obj); },
+            [&]()            { cppOA.FlushThreadCache(); }
+        );
+
+        // Single-threaded allocator behind one global lock
+        OAConfig mutexConfig(false, OBJECTS_PER_PAGE, 0);
+        ObjectAllocator mutexOA(OBJECT_SIZE, mutexConfig);
+        std::mutex lock;
+        const double locked = runThroughput
+        (
+            threads,
+            [&]()            { std::lock_guard<std::mutex> guard(lock); return mutexOA.Allocate(); },
+            [&](void* obj)   { std::lock_guard<std::mutex> guard(lock); mutexOA.Free(obj); },
+            [&]()            {}
+        );
+
+        // Thread-caching allocator
+        OAConfig cachedConfig(false, OBJECTS_PER_PAGE, 0, false, 0, OAConfig::HeaderBlockInfo(), 0, true);
+        ObjectAllocator cachedOA(OBJECT_SIZE, cachedConfig);
+        const double cached = runThroughput
+        (
+            threads,
+            [&]()            { return cachedOA.Allocate(); },
+            [&](void* obj)   { cachedOA.Free(obj); },
+            [&]()            { cachedOA.FlushThreadCache(); }
+        );
+
+        std::cout << std::fixed << std::setprecision(2)
+                  << std::setw(8) << threads << std::setw(12) << cpp << std::setw(12) << locked << std::setw(12) << cached << '\n';
+    }
+}
+
+/************************************************************************************//*!
+ @brief  Measures a mixed-size allocation workload on the SlabAllocator against the
+         C++ memory manager.
+*//*************************************************************************************/
+void BenchmarkSlab()
+{
+    const size_t NUM_OBJECTS = 50000;
+
+    // Mostly node-sized objects (tree, list and hash table nodes) with a tail of larger
+    // records
+    std::mt19937 rng(280);
+    std::discrete_distribution<int> kind({ 40, 30, 20, 10 });
+    std::uniform_int_distribution<size_t> large(100, SlabAllocator::MAX_OBJECT_SIZE);
+    const size_t NODE_SIZES[] = { 24, 40, 56 };
+
+    std::vector<size_t> sizes(NUM_OBJECTS);
+    for (size_t& size : sizes)
+    {
+        const int k = kind(rng);
+        size = k < 3 ? NODE_SIZES[k] : large(rng);
+    }
+
+    std::vector<size_t> order(NUM_OBJECTS);
+    for (size_t i = 0; i < NUM_OBJECTS; ++i)
+        order[i] = i;
+    std::shuffle(order.begin(), order.end(), rng);
+
+    const double cpp = runMixedSizes
+    (
+        sizes, order,
+        [](size_t size)  { return ::operator new(size); },
+        [](void* obj)    { ::operator delete(obj); }
+    );
+
+    SlabAllocator slab(OAConfig(false, 0, 0));
+    const double pooled = runMixedSizes
+    (
+        sizes, order,
+        [&](size_t size) { return slab.Allocate(size); },
+        [&](void* obj)   { slab.Free(obj); }
+    );
+
+    std::cout << "Mixed-size allocate/free throughput (Mops/s)\n";
+    std::cout << std::fixed << std::setprecision(2)
+              << std::setw(12) << "new/delete" << std::setw(12) << cpp << '\n'
+              << std::setw(12) << "slab" << std::setw(12) << pooled << '\n';
+
+    std::cout << std::setw(8) << "class" << std::setw(10) << "pages" << std::setw(10) << "most" << std::setw(12) << "allocs" << '\n';
+    for (unsigned i = 0; i < SlabAllocator::NUM_CLASSES; ++i)
+    {
+        const OAStats classStats = slab.GetStats(i);
+        std::cout << std::setw(8) << slab.GetClassSize(i) << std::setw(10) << classStats.PagesInUse_
+                  << std::setw(10) << classStats.MostObjects_ << std::setw(12) << classStats.Allocations_ << '\n';
+    }
+}
+
+/************************************************************************************//*!
+ @brief  Measures filling and emptying a chained hash table with its nodes from the C++
+         memory manager against its nodes from a size class of the SlabAllocator.
+*//*************************************************************************************/
+void BenchmarkSlabHashTable()
+{
+    const unsigned NUM_KEYS     = 200000;
+    const unsigned NUM_ROUNDS   = 5;
+
+    std::vector<std::string> keys(NUM_KEYS);
+    for (unsigned i = 0; i < NUM_KEYS; ++i)
+        keys[i] = "k" + std::to_string(i);
+
+    std::vector<unsigned> order(NUM_KEYS);
+    for (unsigned i = 0; i < NUM_KEYS; ++i)
+        order[i] = i;
+    std::shuffle(order.begin(), order.end(), std::mt19937(2805));
+
+    auto run = [&](ObjectAllocator* allocator)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        for (unsigned r = 0; r < NUM_ROUNDS; ++r)
+        {
+            NodeTable table{ allocator };
+            for (unsigned i = 0; i < NUM_KEYS; ++i)
+                table.insert(keys[i].c_str(), i);
+
+            for (unsigned i : order)
+                table.remove(keys[i].c_str());
+        }
+        const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+        return elapsed.count() / NUM_ROUNDS;
+    };
+
+    const double cpp = run(nullptr);
+
+    SlabAllocator slab;
+    const size_t NODE_SIZE = sizeof(NodeTable::Node);
+    const double pooled = run(slab.GetAllocator(NODE_SIZE));
+    const OAStats nodeStats = slab.GetAllocator(NODE_SIZE)->GetStats();
+
+    std::cout << "Hash table, " << NUM_KEYS << " inserts and removes (ms)\n";
+    std::cout << std::fixed << std::setprecision(2)
+              << std::setw(12) << "new/delete" << std::setw(12) << cpp << '\n'
+              << std::setw(12) << "slab" << std::setw(12) << pooled
+              << "  (" << NODE_SIZE << " byte nodes in the " << nodeStats.ObjectSize_ << " byte class, "
+              << nodeStats.PagesInUse_ << " pages)\n";
+}
+
+/************************************************************************************//*!
+ @brief  Measures building and tearing down many objects with AllocateN/FreeN 
+         against one Allocate/Free call per object.
+*//*************************************************************************************/
+void BenchmarkBatch()
+{
+    const unsigned NUM_OBJECTS  = 10000;
+    const unsigned REPEATS      = 50;
+
+    struct Setup
+    {
+        const char*                 Name;
+        bool                        DebugOn;
+        OAConfig::HeaderBlockInfo   Header;
+    };
+    const Setup SETUPS[] =
+    {
+        { "none",           false,  OAConfig::HeaderBlockInfo(OAConfig::hbNone)         },
+        { "basic",          false,  OAConfig::HeaderBlockInfo(OAConfig::hbBasic)        },
+        { "extended+debug", true,   OAConfig::HeaderBlockInfo(OAConfig::hbExtended, 4)  },
+        { "external",       false,  OAConfig::HeaderBlockInfo(OAConfig::hbExternal)     },
+    };
+
+    std::cout << "Build/tear down " << NUM_OBJECTS << " objects (ms)\n";
+    std::cout << std::setw(16) << "headers" << std::setw(12) << "single" << std::setw(12) << "batch" << '\n';
+
+    std::vector<void*> objects(NUM_OBJECTS);
+    for (const Setup& setup : SETUPS)
+    {
+        OAConfig config(false, OBJECTS_PER_PAGE, 0, setup.DebugOn, setup.DebugOn ? 4 : 0, setup.Header);
+
+        ObjectAllocator singleOA(OBJECT_SIZE, config);
+        auto start = std::chrono::steady_clock::now();
+        for (unsigned r = 0; r < REPEATS; ++r)
+        {
+            for (unsigned i = 0; i < NUM_OBJECTS; ++i)
+                objects[i] = singleOA.Allocate("node");
+            for (unsigned i = 0; i < NUM_OBJECTS; ++i)
+                singleOA.Free(objects[i]);
+        }
+        const std::chrono::duration<double, std::milli> single = std::chrono::steady_clock::now() - start;
+
+        ObjectAllocator batchOA(OBJECT_SIZE, config);
+        start = std::chrono::steady_clock::now();
+        for (unsigned r = 0; r < REPEATS; ++r)
+        {
+            batchOA.AllocateN(NUM_OBJECTS, objects.data(), "node");
+            batchOA.FreeN(objects.data(), NUM_OBJECTS);
+        }
+        const std::chrono::duration<double, std::milli> batch = std::chrono::steady_clock::now() - start;
+
+        std::cout << std::fixed << std::setprecision(2) << std::setw(16) << setup.Name 
+                  << std::setw(12) << single.count() / REPEATS << std::setw(12) << batch.count() / REPEATS << '\n';
+    }
+}
+
+/************************************************************************************//*!
+ @brief  Measures FreeEmptyPages and the memory given back to the OS after a load 
+         spike, for heap pages against mapped pages.
+*//*************************************************************************************/
+void BenchmarkMappedPages()
+{
+    const unsigned NUM_OBJECTS = 200000;
+
+    std::cout << "Load spike of " << NUM_OBJECTS << " objects, then FreeEmptyPages\n";
+    std::cout << std::setw(8) << "pages" << std::setw(14) << "reclaim (ms)" << std::setw(14) << "peak RSS (MB)" << std::setw(14) << "after (MB)" << '\n';
+
+    std::vector<void*> objects(NUM_OBJECTS);
+    for (bool mapped : { false, true })
+    {
+        OAConfig config(false, OBJECTS_PER_PAGE, 0, false, 0, OAConfig::HeaderBlockInfo(), 0, false, DEFAULT_THREAD_CACHE_SIZE, mapped);
+        ObjectAllocator oa(OBJECT_SIZE, config);
+
+        oa.AllocateN(NUM_OBJECTS, objects.data());
+        const double peak = residentMB();
+
+        // Keep every 8th page alive so the free list is long and interleaved
+        for (unsigned i = 0; i < NUM_OBJECTS; ++i)
+        {
+            if ((i / OBJECTS_PER_PAGE) % 8 != 0)
+                oa.Free(objects[i]);
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        oa.FreeEmptyPages();
+        const std::chrono::duration<double, std::milli> reclaim = std::chrono::steady_clock::now() - start;
+
+        std::cout << std::fixed << std::setprecision(2) << std::setw(8) << (mapped ? "mapped" : "heap")
+                  << std::setw(14) << reclaim.count() << std::setw(14) << peak << std::setw(14) << residentMB() << '\n';
+
+        for (unsigned i = 0; i < NUM_OBJECTS; i += OBJECTS_PER_PAGE * 8)
+        {
+            for (unsigned j = i; j < i + OBJECTS_PER_PAGE && j < NUM_OBJECTS; ++j)
+                oa.Free(objects[j]);
+        }
+    }
+}
@@ -0,0 +1,50 @@
+/************************************************************************************//*!
+ \file           benchmark.h
+ \author         Diren D Bharwani, diren.dbharwani, 390002520
+ \par            email: diren.dbharwani\@digipen.edu
+ \date           Jan 19, 2022
+ \brief          Contains the interface for the ObjectAllocator benchmarks.
+ 
+ Copyright (C) 2022 DigiPen Institute of Technology.
+ Reproduction or disclosure of this file or its contents without the prior written 
+ consent of DigiPen Institute of Technology is prohibited.
+*//*************************************************************************************/
+
+#ifndef BENCHMARKH
+#define BENCHMARKH
+
+/*-------------------------------------------------------------------------------------*/
+/* Function Declarations                                                               */
+/*-------------------------------------------------------------------------------------*/
+
+/************************************************************************************//*!
+ @brief  Measures multi-threaded allocate/free throughput of the concurrent allocator
+         against the C++ memory manager and a mutex-wrapped allocator.
+*//*************************************************************************************/
+void BenchmarkConcurrent();
+
+/************************************************************************************//*!
+ @brief  Measures a mixed-size allocation workload on the SlabAllocator against the
+         C++ memory manager.
+*//*************************************************************************************/
+void BenchmarkSlab();
+
+/************************************************************************************//*!
+ @brief  Measures filling and emptying a chained hash table with its nodes from the C++
+         memory manager against its nodes from a size class of the SlabAllocator.
+*//*************************************************************************************/
+void BenchmarkSlabHashTable();
+
+/************************************************************************************//*!
+ @brief  Measures building and tearing down many objects with AllocateN/FreeN 
+         against one Allocate/Free call per object.
+*//*************************************************************************************/
+void BenchmarkBatch();
+
+/************************************************************************************//*!
+ @brief  Measures FreeEmptyPages and the memory given back to the OS after a load 
+         spike, for heap pages against mapped pages.
+*//*************************************************************************************/
+void BenchmarkMappedPages();
+
+#endif
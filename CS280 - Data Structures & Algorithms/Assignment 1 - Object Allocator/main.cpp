@@ -1,5 +1,10 @@
+#include "benchmark.h"
 
 int main()
 {
-    
-}
\ No newline at end of file
+    BenchmarkConcurrent();
+    BenchmarkSlab();
+    BenchmarkSlabHashTable();
+    BenchmarkBatch();
+    BenchmarkMappedPages();
+}
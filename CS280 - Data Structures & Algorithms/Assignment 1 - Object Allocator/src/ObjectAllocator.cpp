@@ -15,6 +15,19 @@ consent of DigiPen Institute of Technology is prohibited.
 // Standard Libraries
 #include <iostream>
 #include <cstring>
+#include <algorithm>
+#include <functional>
+#include <climits>
+#include <cstdint>
+// Page Source
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+#else
+    #include <sys/mman.h>
+    #include <unistd.h>
+#endif
 
 #define PTR_SIZE sizeof(unsigned char*)
 
@@ -23,6 +36,89 @@ consent of DigiPen Institute of Technology is prohibited.
 
 #define MAX(x, y) x > y ? x : y
 
+/*-------------------------------------------------------------------------------------*/
+/* Static Variables                                                                    */
+/*-------------------------------------------------------------------------------------*/
+
+namespace
+{
+    std::atomic<unsigned long long> nextAllocatorId {1};   //!< ids handed out to allocators
+
+    thread_local bool threadCachesGone = false;             //!< set once a thread's cache entries are destroyed
+
+    /********************************************************************************//*!
+    @brief  The ids of the concurrent allocators that are alive, in ascending order.
+            Never destroyed, so allocators destroyed during static destruction can
+            still remove themselves.
+    *//*********************************************************************************/
+    struct LiveAllocators
+    {
+        std::mutex                      Lock;   //!< guards Ids
+        std::vector<unsigned long long> Ids;    //!< ids of the live allocators
+    };
+
+    /********************************************************************************//*!
+    @brief  Gets the ids of the live concurrent allocators.
+
+    @return The live allocators.
+    *//*********************************************************************************/
+    LiveAllocators& liveAllocators()
+    {
+        static LiveAllocators* live = new LiveAllocators;
+        return *live;
+    }
+
+    const size_t MAPPED_PAGE_HEADER = 64;                   //!< bytes reserved for MappedPage
+    const size_t HUGE_PAGE_SIZE     = 2 * 1024 * 1024;      //!< transparent huge page size
+
+    /********************************************************************************//*!
+    @brief  Gets the size of a page of memory on this system.
+
+    @return The page size in bytes.
+    *//*********************************************************************************/
+    size_t osPageSize()
+    {
+    #ifdef _WIN32
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        return static_cast<size_t>(info.dwPageSize);
+    #else
+        return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    #endif
+    }
+
+    /********************************************************************************//*!
+    @brief  Rounds a value up to a multiple of a power of 2.
+
+    @param  value
+        The value to round.
+    @param  multiple
+        The power of 2 to round to.
+
+    @return The rounded value.
+    *//*********************************************************************************/
+    size_t roundUp(size_t value, size_t multiple)
+    {
+        return (value + multiple - 1) & ~(multiple - 1);
+    }
+}
+
+/*-------------------------------------------------------------------------------------*/
+/* Type  Definitions                                                                   */
+/*-------------------------------------------------------------------------------------*/
+
+/********************************************************************************//*!
+ @brief  Bookkeeping at the start of every mapped page. The mapping is aligned to
+        mapAlignment so any block can get back here by masking its address.
+*//*********************************************************************************/
+struct ObjectAllocator::MappedPage
+{
+    void*       MapBase;    //!< what the OS returned, to give back on release
+    size_t      MapLength;  //!< length of the mapping
+    unsigned    Live;       //!< blocks of this page that are not on the shared free list
+    bool        Releasing;  //!< set while FreeEmptyPages is releasing the page
+};
+
 /*-------------------------------------------------------------------------------------*/
 /* Constructors & Destructors                                                          */
 /*-------------------------------------------------------------------------------------*/
@@ -43,6 +139,9 @@ ObjectAllocator::ObjectAllocator(size_t objectSize, const OAConfig& c)
 , config        (c)
 , stats         ()
 , blockSize     (0)
+, mapAlignment  (0)
+, ThreadCaches_ (nullptr)
+, Id_           (nextAllocatorId++)
 {
     // Populate stats
     stats.ObjectSize_ = objectSize;
@@ -64,10 +163,27 @@ ObjectAllocator::ObjectAllocator(size_t objectSize, const OAConfig& c)
     // Remove one interAlignment
     stats.PageSize_ -= config.InterAlignSize_;
 
-    if (config.UseCPPMemManager_)
-        return;
+    // Mapped pages are aligned to a power of 2 at least as big as the page and its 
+    // bookkeeping
+    if (config.MappedPages_)
+    {
+        mapAlignment = config.HugePages_ ? HUGE_PAGE_SIZE : osPageSize();
+        while (mapAlignment < MAPPED_PAGE_HEADER + stats.PageSize_)
+            mapAlignment <<= 1;
+    }
 
-    createPage();
+    if (!config.UseCPPMemManager_)
+    {
+        createPage();
+    }
+
+    // Threads check this list to drop the cache entries of destroyed allocators
+    if (config.Concurrent_)
+    {
+        LiveAllocators& live = liveAllocators();
+        std::lock_guard<std::mutex> guard(live.Lock);
+        live.Ids.insert(std::lower_bound(live.Ids.begin(), live.Ids.end(), Id_), Id_);
+    }
 }
 
 /********************************************************************************//*!
@@ -77,10 +193,32 @@ ObjectAllocator::ObjectAllocator(size_t objectSize, const OAConfig& c)
 *//*********************************************************************************/
 ObjectAllocator::~ObjectAllocator()
 {
+    // Other threads drop their entries for this allocator on their next new cache
+    if (config.Concurrent_)
+    {
+        {
+            LiveAllocators& live = liveAllocators();
+            std::lock_guard<std::mutex> guard(live.Lock);
+            live.Ids.erase(std::lower_bound(live.Ids.begin(), live.Ids.end(), Id_));
+        }
+
+        if (std::vector<CacheEntry>* entries = cacheEntries())
+        {
+            pruneCacheEntries(*entries);
+        }
+    }
+
+    while (ThreadCaches_ != nullptr)
+    {
+        ThreadCache* next = ThreadCaches_->Next;
+        delete ThreadCaches_;
+        ThreadCaches_ = next;
+    }
+
     while(PageList_ != nullptr)
     {
         GenericObject* next = PageList_->Next;
-        delete[] TO_UCHAR_PTR(PageList_);
+        releasePage(PageList_);
         PageList_ = next;
     }
 }
@@ -101,6 +239,15 @@ ObjectAllocator::~ObjectAllocator()
 *//*********************************************************************************/
 void* ObjectAllocator::Allocate(const char* label)
 {
+    std::unique_lock<std::mutex> guard(Lock_, std::defer_lock);
+    if (config.Concurrent_)
+    {
+        if (useThreadCache())
+            return allocateFromCache();
+
+        guard.lock();
+    }
+
     if (config.UseCPPMemManager_)
     {
         try
@@ -125,8 +272,10 @@ void* ObjectAllocator::Allocate(const char* label)
 
     unsigned char* obj = TO_UCHAR_PTR(FreeList_);
     FreeList_ = FreeList_->Next;
+    trackLive(obj, true);
 
     setPattern(obj, ALLOCATED_PATTERN);
+    markBlock(obj, true);
     incrementStats();
     createHeader(obj, label);
 
@@ -143,6 +292,18 @@ void* ObjectAllocator::Allocate(const char* label)
 *//*********************************************************************************/
 void ObjectAllocator::Free(void* Object)
 {
+    std::unique_lock<std::mutex> guard(Lock_, std::defer_lock);
+    if (config.Concurrent_)
+    {
+        if (useThreadCache())
+        {
+            freeToCache(Object);
+            return;
+        }
+
+        guard.lock();
+    }
+
     if (config.UseCPPMemManager_)
     {
         delete[] TO_UCHAR_PTR(Object);
@@ -158,14 +319,193 @@ void ObjectAllocator::Free(void* Object)
     GenericObject* temp = TO_GENERIC_OBJECT_PTR(Object);
     temp->Next = FreeList_;
     FreeList_ = temp;
+    trackLive(temp, false);
 
     unsigned char* cFL = TO_UCHAR_PTR(FreeList_);
     setPattern(cFL, FREED_PATTERN);
+    markBlock(cFL, false);
     destroyHeader(cFL);
 
     decrementStats();
 }
 
+/********************************************************************************//*!
+ @brief  Takes a number of objects from the free list at once. Either every object 
+        is allocated or none are.
+
+ @param  count
+    The number of objects to allocate.
+ @param  out
+    An array of at least count pointers that receives the objects.
+ @param  label
+    The label for external headers, shared by every object.
+
+ @throws An exception from OAException if the objects can't be allocated.
+*//*********************************************************************************/
+void ObjectAllocator::AllocateN(unsigned count, void* out[], const char* label)
+{
+    if (count == 0)
+        return;
+
+    std::unique_lock<std::mutex> guard(Lock_, std::defer_lock);
+    if (config.Concurrent_)
+        guard.lock();
+
+    if (config.UseCPPMemManager_)
+    {
+        unsigned i = 0;
+        try
+        {
+            for (; i < count; ++i)
+                out[i] = new unsigned char[stats.ObjectSize_];
+        }
+        catch(const std::bad_alloc&)
+        {
+            while (i-- > 0)
+                delete[] TO_UCHAR_PTR(out[i]);
+
+            throw OAException{OAException::E_NO_MEMORY, "No physical memory left."};
+        }
+
+        stats.Allocations_  += count;
+        stats.ObjectsInUse_ += count;
+        stats.MostObjects_  = MAX(stats.MostObjects_, stats.ObjectsInUse_);
+        return;
+    }
+
+    // Put back what was taken so a failed batch allocates nothing
+    auto putBack = [this, out](unsigned taken)
+    {
+        while (taken-- > 0)
+        {
+            GenericObject* temp = TO_GENERIC_OBJECT_PTR(out[taken]);
+            temp->Next = FreeList_;
+            FreeList_ = temp;
+            trackLive(temp, false);
+        }
+    };
+
+    // A page is only created once the free list runs dry, so a large batch takes whole
+    // fresh pages as contiguous runs
+    unsigned taken = 0;
+    try
+    {
+        for (; taken < count; ++taken)
+        {
+            if (FreeList_ == nullptr)
+            {
+                createPage();
+            }
+
+            out[taken] = FreeList_;
+            FreeList_ = FreeList_->Next;
+            trackLive(out[taken], true);
+        }
+    }
+    catch (const OAException&)
+    {
+        putBack(taken);
+        throw;
+    }
+
+    // External headers can run out of memory, so they are made before anything else
+    // about the blocks changes. createHeaders frees the ones it made if it fails.
+    try
+    {
+        createHeaders(out, count, label);
+    }
+    catch (const OAException&)
+    {
+        putBack(count);
+        throw;
+    }
+
+    if (config.DebugOn_)
+    {
+        for (unsigned i = 0; i < count; ++i)
+        {
+            setPattern(TO_UCHAR_PTR(out[i]), ALLOCATED_PATTERN);
+            markBlock(TO_UCHAR_PTR(out[i]), true);
+        }
+    }
+
+    stats.Allocations_  += count;
+    stats.ObjectsInUse_ += count;
+    stats.FreeObjects_  -= count;
+    stats.MostObjects_  = MAX(stats.MostObjects_, stats.ObjectsInUse_);
+}
+
+/********************************************************************************//*!
+ @brief  Returns a number of objects to the free list at once.
+
+ @param  Objects
+    The objects to return to the free list.
+ @param  count
+    The number of objects.
+
+ @throws An exception from OAException if an object can't be freed. The objects
+        before it in the array have been freed by then.
+*//*********************************************************************************/
+void ObjectAllocator::FreeN(void* const Objects[], unsigned count)
+{
+    if (count == 0)
+        return;
+
+    std::unique_lock<std::mutex> guard(Lock_, std::defer_lock);
+    if (config.Concurrent_)
+        guard.lock();
+
+    if (config.UseCPPMemManager_)
+    {
+        for (unsigned i = 0; i < count; ++i)
+            delete[] TO_UCHAR_PTR(Objects[i]);
+
+        stats.Deallocations_    += count;
+        stats.ObjectsInUse_     -= count;
+        return;
+    }
+
+    // Validation has to see the objects freed before it, so debug mode goes one by one
+    if (config.DebugOn_)
+    {
+        for (unsigned i = 0; i < count; ++i)
+        {
+            checkForInvalidFree(Objects[i]);
+
+            GenericObject* temp = TO_GENERIC_OBJECT_PTR(Objects[i]);
+            temp->Next = FreeList_;
+            FreeList_ = temp;
+            trackLive(temp, false);
+
+            unsigned char* cFL = TO_UCHAR_PTR(FreeList_);
+            setPattern(cFL, FREED_PATTERN);
+            markBlock(cFL, false);
+            destroyHeader(cFL);
+
+            decrementStats();
+        }
+        return;
+    }
+
+    // Chain the objects together and splice the chain onto the free list once
+    for (unsigned i = 0; i < count; ++i)
+    {
+        GenericObject* temp = TO_GENERIC_OBJECT_PTR(Objects[i]);
+        temp->Next = i ? TO_GENERIC_OBJECT_PTR(Objects[i - 1]) : FreeList_;
+        trackLive(temp, false);
+
+        if (config.HBlockInfo_.type_ != OAConfig::hbNone)
+        {
+            destroyHeader(TO_UCHAR_PTR(temp));
+        }
+    }
+    FreeList_ = TO_GENERIC_OBJECT_PTR(Objects[count - 1]);
+
+    stats.Deallocations_    += count;
+    stats.FreeObjects_      += count;
+    stats.ObjectsInUse_     -= count;
+}
+
 /********************************************************************************//*!
  @brief  Calls the callback function for each block still in use.
         Returns the number of blocks in use by the client.
@@ -177,6 +517,10 @@ void ObjectAllocator::Free(void* Object)
 *//*********************************************************************************/
 unsigned ObjectAllocator::DumpMemoryInUse(DUMPCALLBACK fn) const
 {
+    std::unique_lock<std::mutex> guard(Lock_, std::defer_lock);
+    if (config.Concurrent_)
+        guard.lock();
+
     if (config.HBlockInfo_.type_ == OAConfig::hbNone)
         return stats.ObjectsInUse_;
 
@@ -185,6 +529,24 @@ unsigned ObjectAllocator::DumpMemoryInUse(DUMPCALLBACK fn) const
     for (size_t i = 0; i < stats.PagesInUse_; ++i)
     {
         unsigned char* block = firstBlock(page);
+
+        // The allocation bits are exact in debug mode, so they stand in for the headers
+        if (config.DebugOn_)
+        {
+            const PageInfo* info = findPage(block);
+            for (size_t j = 0; info && info->ObjectsInUse && j < config.ObjectsPerPage_; ++j)
+            {
+                if (isBlockAllocated(*info, j))
+                {
+                    fn(block, stats.ObjectSize_);
+                }
+                block += blockSize;
+            }
+
+            page = page->Next;
+            continue;
+        }
+
         for (size_t j = 0; j < config.ObjectsPerPage_; ++j)
         {
             switch (config.HBlockInfo_.type_)
@@ -230,6 +592,10 @@ unsigned ObjectAllocator::DumpMemoryInUse(DUMPCALLBACK fn) const
 *//*********************************************************************************/
 unsigned ObjectAllocator::ValidatePages(VALIDATECALLBACK fn) const
 {
+    std::unique_lock<std::mutex> guard(Lock_, std::defer_lock);
+    if (config.Concurrent_)
+        guard.lock();
+
     unsigned int numCorrupted = 0;
 
     // Traverse pages
@@ -258,9 +624,16 @@ unsigned ObjectAllocator::ValidatePages(VALIDATECALLBACK fn) const
 *//*********************************************************************************/
 unsigned ObjectAllocator::FreeEmptyPages()
 {
+    std::unique_lock<std::mutex> guard(Lock_, std::defer_lock);
+    if (config.Concurrent_)
+        guard.lock();
+
     if (PageList_ == nullptr)
         return 0; 
 
+    if (config.MappedPages_)
+        return freeEmptyMappedPages();
+
     unsigned int numFreed = 0;
     
     // Traverse pages
@@ -288,6 +661,22 @@ unsigned ObjectAllocator::FreeEmptyPages()
     return numFreed;
 }
 
+/********************************************************************************//*!
+ @brief  Returns the objects cached by the calling thread to the shared free list and
+        merges its statistics. Only does anything in concurrent mode.
+*//*********************************************************************************/
+void ObjectAllocator::FlushThreadCache()
+{
+    if (!config.Concurrent_)
+        return;
+
+    ThreadCache& cache = threadCache();
+
+    std::lock_guard<std::mutex> guard(Lock_);
+    mergeStats(cache);
+    drainCache(cache, cache.Count);
+}
+
 /*-------------------------------------------------------------------------------------*/
 /* Getter Functions                                                                    */
 /*-------------------------------------------------------------------------------------*/ 
@@ -303,48 +692,348 @@ const void* ObjectAllocator::GetFreeList() const
 /********************************************************************************//*!
  @brief  Gets the page list.
 
- @return A pointer to the page list.
-*//*********************************************************************************/
-const void* ObjectAllocator::GetPageList() const
-{
-    return PageList_;
+ @return A pointer to the page list.
+*//*********************************************************************************/
+const void* ObjectAllocator::GetPageList() const
+{
+    // Pages are pushed onto the list under the lock
+    std::unique_lock<std::mutex> guard(Lock_, std::defer_lock);
+    if (config.Concurrent_)
+        guard.lock();
+
+    return PageList_;
+}
+/********************************************************************************//*!
+ @brief  Gets the configuration of the OA.
+
+ @return The configuration of the OA.
+*//*********************************************************************************/
+OAConfig ObjectAllocator::GetConfig() const
+{
+    return config;
+}
+/********************************************************************************//*!
+ @brief  Gets the statistics of the OA.
+
+ @return The statistics for the OA.
+*//*********************************************************************************/
+OAStats ObjectAllocator::GetStats() const
+{
+    if (!config.Concurrent_)
+        return stats;
+
+    // Add whatever the threads have not merged yet
+    std::lock_guard<std::mutex> guard(Lock_);
+    OAStats result = stats;
+
+    // The merged count can be below zero for a moment, see mergeStats, so the sum is
+    // signed until it is complete
+    long long objectsInUse = static_cast<int>(stats.ObjectsInUse_);
+    for (ThreadCache* cache = ThreadCaches_; cache != nullptr; cache = cache->Next)
+    {
+        const unsigned allocations   = cache->Allocations.load(std::memory_order_relaxed);
+        const unsigned deallocations = cache->Deallocations.load(std::memory_order_relaxed);
+
+        result.Allocations_     += allocations;
+        result.Deallocations_   += deallocations;
+        objectsInUse            += static_cast<long long>(allocations) - deallocations;
+        if (!config.UseCPPMemManager_)
+        {
+            result.FreeObjects_ -= allocations - deallocations;
+        }
+    }
+    result.ObjectsInUse_    = objectsInUse > 0 ? static_cast<unsigned>(objectsInUse) : 0;
+    result.MostObjects_     = MAX(result.MostObjects_, result.ObjectsInUse_);
+
+    return result;
+}
+
+/*-------------------------------------------------------------------------------------*/
+/* Setter Functions                                                                    */
+/*-------------------------------------------------------------------------------------*/
+/********************************************************************************//*!
+ @brief  Sets the debug mode.
+
+ @param  State
+    The state to set the debug mode to.
+*//*********************************************************************************/
+void ObjectAllocator::SetDebugState(bool state)
+{
+    const bool wasOn = config.DebugOn_;
+    config.DebugOn_ = state;
+
+    // Allocation bits are not tracked while debug mode is off
+    if (state && !wasOn)
+    {
+        rebuildPageIndex();
+    }
+}
+
+/*-------------------------------------------------------------------------------------*/
+/* Private Function Members                                                            */
+/*-------------------------------------------------------------------------------------*/
+/********************************************************************************//*!
+ @brief  Checks if the lock-free thread cache path can be used. That is the case in
+        concurrent mode without debugging or headers, which both need shared state.
+
+ @return True if Allocate and Free can go through the thread cache.
+*//*********************************************************************************/
+bool ObjectAllocator::useThreadCache() const
+{
+    if (!config.Concurrent_)
+        return false;
+
+    return config.UseCPPMemManager_ || (!config.DebugOn_ && config.HBlockInfo_.type_ == OAConfig::hbNone);
+}
+/********************************************************************************//*!
+ @brief  Allocate for the thread cache path.
+
+ @return Pointer to the allocated object.
+
+ @throws An exception from OAException if the object can't be allocated.
+*//*********************************************************************************/
+void* ObjectAllocator::allocateFromCache()
+{
+    ThreadCache& cache = threadCache();
+    void* obj = nullptr;
+
+    if (config.UseCPPMemManager_)
+    {
+        try
+        {
+            obj = new unsigned char[stats.ObjectSize_];
+        }
+        catch(const std::bad_alloc&)
+        {
+            throw OAException{OAException::E_NO_MEMORY, "No physical memory left."};
+        }
+    }
+    else
+    {
+        if (cache.Count == 0)
+        {
+            refillCache(cache);
+        }
+
+        obj = cache.FreeList;
+        cache.FreeList = cache.FreeList->Next;
+        --cache.Count;
+    }
+
+    countOperation(cache, true);
+    return obj;
+}
+/********************************************************************************//*!
+ @brief  Free for the thread cache path.
+
+ @param  Object
+    The object to return to the cache.
+*//*********************************************************************************/
+void ObjectAllocator::freeToCache(void* Object)
+{
+    ThreadCache& cache = threadCache();
+
+    if (config.UseCPPMemManager_)
+    {
+        delete[] TO_UCHAR_PTR(Object);
+    }
+    else
+    {
+        // Give half of a full cache back so the next frees don't immediately drain again
+        const unsigned capacity = MAX(config.ThreadCacheSize_, 1u);
+        if (cache.Count >= capacity)
+        {
+            std::lock_guard<std::mutex> guard(Lock_);
+            mergeStats(cache);
+            drainCache(cache, cache.Count - capacity / 2);
+        }
+
+        GenericObject* obj = TO_GENERIC_OBJECT_PTR(Object);
+        obj->Next = cache.FreeList;
+        cache.FreeList = obj;
+        ++cache.Count;
+    }
+
+    countOperation(cache, false);
+}
+/********************************************************************************//*!
+ @brief  Gets the cache of the calling thread, creating it on first use.
+
+ @return The cache of the calling thread.
+*//*********************************************************************************/
+ObjectAllocator::ThreadCache& ObjectAllocator::threadCache()
+{
+    // A thread rarely uses more than a handful of allocators, so a linear search is fine
+    std::vector<CacheEntry>& caches = *cacheEntries();
+    for (const CacheEntry& entry : caches)
+    {
+        if (entry.Id == Id_)
+            return *entry.Cache;
+    }
+
+    // Entries of allocators destroyed on other threads are dropped here
+    pruneCacheEntries(caches);
+
+    ThreadCache* cache = new ThreadCache;
+    cache->FreeList = nullptr;
+    cache->Count    = 0;
+    cache->Pending  = 0;
+    cache->Allocations.store(0, std::memory_order_relaxed);
+    cache->Deallocations.store(0, std::memory_order_relaxed);
+
+    {
+        std::lock_guard<std::mutex> guard(Lock_);
+        cache->Next = ThreadCaches_;
+        ThreadCaches_ = cache;
+    }
+
+    caches.push_back(CacheEntry{Id_, cache});
+    return *cache;
+}
+/********************************************************************************//*!
+ @brief  Gets the cache entries of the calling thread.
+
+ @return The entries. nullptr once the thread has destroyed them on exit.
+*//*********************************************************************************/
+std::vector<ObjectAllocator::CacheEntry>* ObjectAllocator::cacheEntries()
+{
+    struct Entries : std::vector<CacheEntry>
+    {
+        ~Entries() { threadCachesGone = true; }
+    };
+
+    static thread_local Entries entries;
+    return threadCachesGone ? nullptr : &entries;
+}
+/********************************************************************************//*!
+ @brief  Removes the entries of allocators that have been destroyed.
+
+ @param  entries
+    The cache entries of the calling thread.
+*//*********************************************************************************/
+void ObjectAllocator::pruneCacheEntries(std::vector<CacheEntry>& entries)
+{
+    if (entries.empty())
+        return;
+
+    LiveAllocators& live = liveAllocators();
+    std::lock_guard<std::mutex> guard(live.Lock);
+    entries.erase
+    (
+        std::remove_if(entries.begin(), entries.end(), [&live](const CacheEntry& entry)
+        {
+            return !std::binary_search(live.Ids.begin(), live.Ids.end(), entry.Id);
+        }),
+        entries.end()
+    );
+}
+/********************************************************************************//*!
+ @brief  Moves half a cache worth of objects from the shared free list into a cache.
+        Creates a page if the shared free list is empty.
+
+ @param  cache
+    The cache to refill.
+
+ @throws OAException if a page is needed but can't be created.
+*//*********************************************************************************/
+void ObjectAllocator::refillCache(ThreadCache& cache)
+{
+    std::lock_guard<std::mutex> guard(Lock_);
+    mergeStats(cache);
+
+    if (FreeList_ == nullptr)
+    {
+        createPage();
+    }
+
+    // Objects in a cache still count as free objects in the stats
+    const unsigned batch = MAX(config.ThreadCacheSize_ / 2, 1u);
+    for (unsigned i = 0; i < batch && FreeList_ != nullptr; ++i)
+    {
+        GenericObject* obj = FreeList_;
+        FreeList_ = FreeList_->Next;
+        trackLive(obj, true);
+
+        obj->Next = cache.FreeList;
+        cache.FreeList = obj;
+        ++cache.Count;
+    }
 }
 /********************************************************************************//*!
- @brief  Gets the configuration of the OA.
+ @brief  Moves objects from a cache back onto the shared free list. 
+        The caller must hold the lock.
 
- @return The configuration of the OA.
+ @param  cache
+    The cache to drain.
+ @param  count
+    The number of objects to move.
 *//*********************************************************************************/
-OAConfig ObjectAllocator::GetConfig() const
+void ObjectAllocator::drainCache(ThreadCache& cache, unsigned count)
 {
-    return config;
+    for (unsigned i = 0; i < count && cache.FreeList != nullptr; ++i)
+    {
+        GenericObject* obj = cache.FreeList;
+        cache.FreeList = cache.FreeList->Next;
+        --cache.Count;
+
+        obj->Next = FreeList_;
+        FreeList_ = obj;
+        trackLive(obj, false);
+        markBlock(TO_UCHAR_PTR(obj), false);
+    }
 }
 /********************************************************************************//*!
- @brief  Gets the statistics of the OA.
+ @brief  Folds the unmerged counters of a cache into the shared stats.
+        The caller must hold the lock.
 
- @return The statistics for the OA.
+ @param  cache
+    The cache to merge.
 *//*********************************************************************************/
-OAStats ObjectAllocator::GetStats() const
+void ObjectAllocator::mergeStats(ThreadCache& cache)
 {
-    return stats;
-}
+    // Only the owning thread writes the counters, so a load and store is enough
+    const unsigned allocations   = cache.Allocations.load(std::memory_order_relaxed);
+    const unsigned deallocations = cache.Deallocations.load(std::memory_order_relaxed);
+    cache.Allocations.store(0, std::memory_order_relaxed);
+    cache.Deallocations.store(0, std::memory_order_relaxed);
+    cache.Pending = 0;
+
+    stats.Allocations_      += allocations;
+    stats.Deallocations_    += deallocations;
+    stats.ObjectsInUse_     += allocations - deallocations;
+    if (!config.UseCPPMemManager_)
+    {
+        stats.FreeObjects_  -= allocations - deallocations;
+    }
 
-/*-------------------------------------------------------------------------------------*/
-/* Setter Functions                                                                    */
-/*-------------------------------------------------------------------------------------*/
+    // Another thread may have freed objects this thread allocated without merging them
+    // yet, so the running total can briefly wrap below zero
+    if (static_cast<int>(stats.ObjectsInUse_) > 0)
+    {
+        stats.MostObjects_ = MAX(stats.MostObjects_, stats.ObjectsInUse_);
+    }
+}
 /********************************************************************************//*!
- @brief  Sets the debug mode.
+ @brief  Counts an allocation or free against a cache and merges the counters once
+        enough operations have piled up.
 
- @param  State
-    The state to set the debug mode to.
+ @param  cache
+    The cache to count against.
+ @param  allocation 
+    True for an allocation. False for a free.
 *//*********************************************************************************/
-void ObjectAllocator::SetDebugState(bool state)
+void ObjectAllocator::countOperation(ThreadCache& cache, bool allocation)
 {
-    config.DebugOn_ = state;
-}
+    std::atomic<unsigned>& counter = allocation ? cache.Allocations : cache.Deallocations;
+    counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
 
-/*-------------------------------------------------------------------------------------*/
-/* Private Function Members                                                            */
-/*-------------------------------------------------------------------------------------*/
+    const unsigned threshold = MAX(config.ThreadCacheSize_, 1u);
+    if (++cache.Pending >= threshold)
+    {
+        std::lock_guard<std::mutex> guard(Lock_);
+        mergeStats(cache);
+    }
+}
 /********************************************************************************//*!
  @brief  Creates a new page.
 *//*********************************************************************************/
@@ -357,10 +1046,11 @@ void ObjectAllocator::createPage()
 
     try
     {
-        unsigned char* page = new unsigned char[stats.PageSize_];
+        unsigned char* page = config.MappedPages_ ? mapPage() : new unsigned char[stats.PageSize_];
         GenericObject* p = TO_GENERIC_OBJECT_PTR(page);
             
         insertPage(p);
+        indexPage(p);
         setUpBlocks(p);
 
         // Update stats
@@ -474,9 +1164,217 @@ void ObjectAllocator::freePage(GenericObject* page)
         fL = fL->Next;
     }
 
-    delete[] TO_UCHAR_PTR(page);
+    unindexPage(page);
+    releasePage(page);
     --stats.PagesInUse_;
 }
+/********************************************************************************//*!
+ @brief  Maps a new page from the OS. Only used with MappedPages_.
+
+ @return The start of the page, after its MappedPage bookkeeping.
+
+ @throws OAException if the OS has no memory left.
+*//*********************************************************************************/
+unsigned char* ObjectAllocator::mapPage()
+{
+    static_assert(sizeof(MappedPage) <= MAPPED_PAGE_HEADER, "MappedPage does not fit its header.");
+
+    const size_t length = roundUp(MAPPED_PAGE_HEADER + stats.PageSize_, config.HugePages_ ? HUGE_PAGE_SIZE : osPageSize());
+
+    // Over-reserve by one alignment so an aligned start is guaranteed to fit
+#ifdef _WIN32
+    void* base = VirtualAlloc(nullptr, length + mapAlignment, MEM_RESERVE, PAGE_NOACCESS);
+    if (base == nullptr)
+    {
+        throw OAException {OAException::E_NO_MEMORY, "No system memory available."};
+    }
+
+    unsigned char* aligned = reinterpret_cast<unsigned char*>(roundUp(reinterpret_cast<uintptr_t>(base), mapAlignment));
+    if (VirtualAlloc(aligned, length, MEM_COMMIT, PAGE_READWRITE) == nullptr)
+    {
+        VirtualFree(base, 0, MEM_RELEASE);
+        throw OAException {OAException::E_NO_MEMORY, "No system memory available."};
+    }
+#else
+    void* reserved = mmap(nullptr, length + mapAlignment, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (reserved == MAP_FAILED)
+    {
+        throw OAException {OAException::E_NO_MEMORY, "No system memory available."};
+    }
+
+    // Give back the slack on both sides of the aligned range
+    unsigned char* start    = TO_UCHAR_PTR(reserved);
+    unsigned char* aligned  = reinterpret_cast<unsigned char*>(roundUp(reinterpret_cast<uintptr_t>(start), mapAlignment));
+    unsigned char* end      = start + length + mapAlignment;
+
+    if (aligned != start)
+        munmap(start, static_cast<size_t>(aligned - start));
+    if (aligned + length != end)
+        munmap(aligned + length, static_cast<size_t>(end - (aligned + length)));
+
+    #ifdef MADV_HUGEPAGE
+        if (config.HugePages_)
+            madvise(aligned, length, MADV_HUGEPAGE);
+    #endif
+
+    void* base = aligned;
+#endif
+
+    MappedPage* info    = reinterpret_cast<MappedPage*>(aligned);
+    info->MapBase       = base;
+    info->MapLength     = length;
+    info->Live          = 0;
+    info->Releasing     = false;
+
+    return aligned + MAPPED_PAGE_HEADER;
+}
+/********************************************************************************//*!
+ @brief  Gives the memory of a page back to the page source it came from.
+
+ @param  page
+    The page to release.
+*//*********************************************************************************/
+void ObjectAllocator::releasePage(GenericObject* page)
+{
+    if (!config.MappedPages_)
+    {
+        delete[] TO_UCHAR_PTR(page);
+        return;
+    }
+
+    MappedPage* info = mappedPage(page);
+#ifdef _WIN32
+    VirtualFree(info->MapBase, 0, MEM_RELEASE);
+#else
+    munmap(info->MapBase, info->MapLength);
+#endif
+}
+/********************************************************************************//*!
+ @brief  Gets the bookkeeping of the mapped page a block lies in. This is a mask on 
+        the address, so it is O(1). Only used with MappedPages_.
+
+ @param  block
+    Any address inside the page.
+
+ @return The bookkeeping of the page.
+*//*********************************************************************************/
+ObjectAllocator::MappedPage* ObjectAllocator::mappedPage(const void* block) const
+{
+    const uintptr_t address = reinterpret_cast<uintptr_t>(block);
+    return reinterpret_cast<MappedPage*>(address & ~static_cast<uintptr_t>(mapAlignment - 1));
+}
+/********************************************************************************//*!
+ @brief  Counts a block leaving or joining the shared free list against its page.
+        Only does anything with MappedPages_.
+
+ @param  block
+    The block that moved.
+ @param  taken 
+    True if the block left the free list. False if it was put back.
+*//*********************************************************************************/
+void ObjectAllocator::trackLive(void* block, bool taken)
+{
+    if (!config.MappedPages_)
+        return;
+
+    MappedPage* info = mappedPage(block);
+    if (taken)
+        ++info->Live;
+    else
+        --info->Live;
+}
+/********************************************************************************//*!
+ @brief  FreeEmptyPages for mapped pages. Finds every empty page in O(1) each, then
+        unlinks their blocks in one pass over the free list and releases the pages
+        in one batch.
+
+ @return The number of pages freed.
+*//*********************************************************************************/
+unsigned ObjectAllocator::freeEmptyMappedPages()
+{
+    std::vector<MappedPage*> released;
+
+    // Unlink every empty page from the page list
+    GenericObject* page = PageList_;
+    GenericObject* prev = nullptr;
+    while (page != nullptr)
+    {
+        GenericObject* next = page->Next;
+        MappedPage* info = mappedPage(page);
+
+        if (info->Live == 0)
+        {
+            info->Releasing = true;
+            released.push_back(info);
+            (prev ? prev->Next : PageList_) = next;
+            --stats.PagesInUse_;
+        }
+        else
+        {
+            prev = page;
+        }
+        page = next;
+    }
+
+    if (released.empty())
+        return 0;
+
+    // Drop the blocks of every released page from the free list in a single pass
+    GenericObject* fL = FreeList_;
+    prev = nullptr;
+    while (fL != nullptr)
+    {
+        GenericObject* next = fL->Next;
+        if (mappedPage(fL)->Releasing)
+        {
+            (prev ? prev->Next : FreeList_) = next;
+            --stats.FreeObjects_;
+        }
+        else
+        {
+            prev = fL;
+        }
+        fL = next;
+    }
+
+    PageIndex_.erase
+    (
+        std::remove_if(PageIndex_.begin(), PageIndex_.end(), [this](const PageInfo& i) { return mappedPage(i.Page)->Releasing; }),
+        PageIndex_.end()
+    );
+
+    // Give the memory back, merging neighbouring mappings into a single call
+    std::sort(released.begin(), released.end(), std::less<MappedPage*>());
+
+#ifdef _WIN32
+    for (MappedPage* info : released)
+        VirtualFree(info->MapBase, 0, MEM_RELEASE);
+#else
+    unsigned char*  runStart    = nullptr;
+    size_t          runLength   = 0;
+    for (MappedPage* info : released)
+    {
+        // Read the bookkeeping before the page it lives in goes away
+        unsigned char*  base    = TO_UCHAR_PTR(info->MapBase);
+        const size_t    length  = info->MapLength;
+
+        if (runStart && runStart + runLength == base)
+        {
+            runLength += length;
+            continue;
+        }
+
+        if (runStart)
+            munmap(runStart, runLength);
+
+        runStart    = base;
+        runLength   = length;
+    }
+    munmap(runStart, runLength);
+#endif
+
+    return static_cast<unsigned>(released.size());
+}
 /********************************************************************************//*!
  @brief  Creates a header for a given block. Only call this on Allocate.
 
@@ -537,6 +1435,88 @@ void ObjectAllocator::createHeader(unsigned char* block, const char* label)
         default: break;
     }
 }
+/********************************************************************************//*!
+ @brief  Creates the headers for a batch of blocks. Only call this on AllocateN,
+        before the stats count the blocks. The blocks get the next consecutive
+        allocation numbers. If it fails, the headers it made are destroyed.
+
+ @param  blocks
+    The blocks to create the headers for.
+ @param  count
+    The number of blocks.
+ @param  label 
+    The label for external headers. Defaults to a nullptr.
+*//*********************************************************************************/
+void ObjectAllocator::createHeaders(void* const blocks[], unsigned count, const char* label)
+{
+    const unsigned firstAllocNum = stats.Allocations_ + 1;
+
+    switch (config.HBlockInfo_.type_)
+    {
+        case OAConfig::hbBasic:
+        case OAConfig::hbExtended:
+        {
+            // Offsets are the same for every block
+            const size_t flagOffset     = static_cast<size_t>(config.PadBytes_) + sizeof(char);
+            const size_t allocOffset    = flagOffset + sizeof(int);
+            const size_t userBytes      = config.HBlockInfo_.size_ - (OAConfig::BASIC_HEADER_SIZE + sizeof(short));
+            const bool   extended       = config.HBlockInfo_.type_ == OAConfig::hbExtended;
+
+            for (unsigned i = 0; i < count; ++i)
+            {
+                unsigned char* block = TO_UCHAR_PTR(blocks[i]);
+
+                *(block - flagOffset) = 1;
+                *reinterpret_cast<int*>(block - allocOffset) = static_cast<int>(firstAllocNum + i);
+
+                if (extended)
+                {
+                    short* useCount = reinterpret_cast<short*>(header(block) + userBytes);
+                    ++(*useCount);
+                }
+            }
+
+            break;
+        }
+        case OAConfig::hbExternal:
+        {
+            const size_t headerOffset   = static_cast<size_t>(config.PadBytes_) + config.HBlockInfo_.size_;
+            const size_t labelLength    = label ? strlen(label) + 1 : 0;
+
+            unsigned i = 0;
+            try
+            {
+                for (; i < count; ++i)
+                {
+                    MemBlockInfo** info = reinterpret_cast<MemBlockInfo**>(TO_UCHAR_PTR(blocks[i]) - headerOffset);
+
+                    *info = nullptr;
+                    *info = new MemBlockInfo;
+                    (*info)->alloc_num  = firstAllocNum + i;
+                    (*info)->in_use     = true;
+                    (*info)->label      = nullptr;
+
+                    if (label)
+                    {
+                        (*info)->label = new char[labelLength];
+                        memcpy((*info)->label, label, labelLength);
+                    }
+                }
+            }
+            catch(const std::bad_alloc&)
+            {
+                // The object whose info failed may have a half built header
+                for (unsigned j = 0; j <= i && j < count; ++j)
+                    destroyHeader(TO_UCHAR_PTR(blocks[j]));
+
+                throw OAException{OAException::E_NO_MEMORY, "No physical memory available!"};
+            }
+
+            break;
+        }
+        default: break;
+    }
+}
 /********************************************************************************//*!
  @brief  Sets the flag for a header. This is only used for basic and extended headers.
 
@@ -674,6 +1654,15 @@ unsigned char* ObjectAllocator::header(unsigned char* block) const
 *//*********************************************************************************/
 bool ObjectAllocator::isPageEmpty(GenericObject* page) const
 {
+    if (config.MappedPages_)
+        return mappedPage(page)->Live == 0;
+
+    if (config.DebugOn_)
+    {
+        const PageInfo* info = findPage(firstBlock(page));
+        return info && info->ObjectsInUse == 0;
+    }
+
     GenericObject* fL = this->FreeList_;
     unsigned int freeBlocks = 0;
 
@@ -705,39 +1694,146 @@ bool ObjectAllocator::isInPage(GenericObject* page, unsigned char* block) const
     return block > cP && block < (cP + stats.PageSize_);
 }
 /********************************************************************************//*!
- @brief  Checks if a block as been allocated.
+ @brief  Checks if a block as been allocated. For use in debug mode only.
 
- @param  block
-    The block to check for.
+ @param  info
+    The page the block belongs to.
+ @param  index
+    The index of the block in the page.
 
  @return True if the block has been allocated.
 *//*********************************************************************************/
-bool ObjectAllocator::isBlockAllocated(unsigned char* block) const
+bool ObjectAllocator::isBlockAllocated(const PageInfo& info, size_t index) const
 {
-    switch (config.HBlockInfo_.type_)
+    return (info.AllocatedBits[index / CHAR_BIT] >> (index % CHAR_BIT)) & 1u;
+}
+/********************************************************************************//*!
+ @brief  Marks a block as allocated or free in the page index. 
+        For use in debug mode only.
+
+ @param  block
+    The block to mark.
+ @param  allocated 
+    True if the block is being given to the client. False if it is being returned.
+*//*********************************************************************************/
+void ObjectAllocator::markBlock(unsigned char* block, bool allocated)
+{
+    if (!config.DebugOn_)
+        return;
+
+    PageInfo* info = findPage(block);
+    if (info == nullptr)
+        return;
+
+    const size_t index = blockIndex(info->Page, block);
+    const unsigned char mask = static_cast<unsigned char>(1u << (index % CHAR_BIT));
+    unsigned char& bits = info->AllocatedBits[index / CHAR_BIT];
+
+    if (allocated)
     {
-        case OAConfig::hbNone:
-        {
-            GenericObject* b    = TO_GENERIC_OBJECT_PTR(block);
-            GenericObject* fL   = FreeList_;
+        bits |= mask;
+        ++info->ObjectsInUse;
+    }
+    else
+    {
+        bits &= static_cast<unsigned char>(~mask);
+        --info->ObjectsInUse;
+    }
+}
+/********************************************************************************//*!
+ @brief  Adds a newly created page to the page index.
 
-            // Iterate through free list and compare addresses
-            while (fL != nullptr)
-            {
-                // If block is on the free list, it is unallocated
-                if (fL == b)
-                    return false;
-                
-                fL = fL->Next;
-            }
+ @param  page
+    The page to add.
+*//*********************************************************************************/
+void ObjectAllocator::indexPage(GenericObject* page)
+{
+    PageInfo info;
+    info.Page           = page;
+    info.ObjectsInUse   = 0;
+    info.AllocatedBits.assign((config.ObjectsPerPage_ + CHAR_BIT - 1) / CHAR_BIT, 0);
+
+    // Keep the index sorted by address
+    auto it = std::upper_bound
+    (
+        PageIndex_.begin(), PageIndex_.end(), page,
+        [](GenericObject* p, const PageInfo& i) { return std::less<GenericObject*>()(p, i.Page); }
+    );
+    PageIndex_.insert(it, std::move(info));
+}
+/********************************************************************************//*!
+ @brief  Removes a page from the page index.
 
-            // Block cannot be found on the free list, therefore it has been allocated
-            return true;
-        }   
-        default: break;
+ @param  page
+    The page to remove.
+*//*********************************************************************************/
+void ObjectAllocator::unindexPage(GenericObject* page)
+{
+    PageInfo* info = findPage(firstBlock(page));
+    if (info)
+    {
+        PageIndex_.erase(PageIndex_.begin() + (info - PageIndex_.data()));
+    }
+}
+/********************************************************************************//*!
+ @brief  Recomputes the allocation bits of every page from the free list. 
+        Called when debug mode is switched on.
+*//*********************************************************************************/
+void ObjectAllocator::rebuildPageIndex()
+{
+    // Assume everything is in use, then clear whatever is on the free list
+    for (PageInfo& info : PageIndex_)
+    {
+        info.ObjectsInUse = config.ObjectsPerPage_;
+        std::fill(info.AllocatedBits.begin(), info.AllocatedBits.end(), static_cast<unsigned char>(~0u));
     }
 
-    return false;
+    for (GenericObject* fL = FreeList_; fL != nullptr; fL = fL->Next)
+    {
+        markBlock(TO_UCHAR_PTR(fL), false);
+    }
+}
+/********************************************************************************//*!
+ @brief  Finds the page that a block lies in with a binary search on the page index.
+
+ @param  block
+    The block to find the page of.
+
+ @return The index entry of the page. Nullptr if the block is not in any page.
+*//*********************************************************************************/
+const ObjectAllocator::PageInfo* ObjectAllocator::findPage(const unsigned char* block) const
+{
+    // First page that starts after the block, the owner must be the one before it
+    auto it = std::upper_bound
+    (
+        PageIndex_.begin(), PageIndex_.end(), block,
+        [](const unsigned char* b, const PageInfo& i) { return std::less<const unsigned char*>()(b, TO_UCHAR_PTR(i.Page)); }
+    );
+
+    if (it == PageIndex_.begin())
+        return nullptr;
+
+    --it;
+    return isInPage(it->Page, const_cast<unsigned char*>(block)) ? &(*it) : nullptr;
+}
+
+ObjectAllocator::PageInfo* ObjectAllocator::findPage(const unsigned char* block)
+{
+    return const_cast<PageInfo*>(static_cast<const ObjectAllocator*>(this)->findPage(block));
+}
+/********************************************************************************//*!
+ @brief  Gets the index of a block in its page.
+
+ @param  page
+    The page the block is in.
+ @param  block
+    The block to get the index of.
+
+ @return The index of the block in the page.
+*//*********************************************************************************/
+size_t ObjectAllocator::blockIndex(GenericObject* page, const unsigned char* block) const
+{
+    return static_cast<size_t>(block - firstBlock(page)) / blockSize;
 }
 /********************************************************************************//*!
  @brief  Sets a pattern for a block. For use in debug mode only.
@@ -825,18 +1921,17 @@ void ObjectAllocator::checkForInvalidFree(void* block) const
     if (!config.DebugOn_)
         return;
 
-    void* currentPage = nullptr;
     unsigned char* currentBlock = TO_UCHAR_PTR(block);
 
-    checkWithinPages(currentBlock, currentPage);
-    checkAlignment(currentPage, currentBlock);
+    const PageInfo& currentPage = checkWithinPages(currentBlock);
+    checkAlignment(currentPage.Page, currentBlock);
 
     if (checkCorruption(currentBlock))
     {
         throw OAException{OAException::E_CORRUPTED_BLOCK, "Pad bytes have been overwritten."};
     }
 
-    checkMultipleFree(currentBlock);
+    checkMultipleFree(currentPage, currentBlock);
 }
 /********************************************************************************//*!
  @brief  Checks if the data is within any of the allocated pages. 
@@ -845,27 +1940,21 @@ void ObjectAllocator::checkForInvalidFree(void* block) const
 
  @param  data
     The data to check for.
- @param  currentPage
-    An out parameter that indicates the page to check in.
+
+ @return The index entry of the page the data is in.
 
  @throws OAException for bad boundary.
 *//*********************************************************************************/
-void ObjectAllocator::checkWithinPages(unsigned char* block, void*& currentPage) const
+const ObjectAllocator::PageInfo& ObjectAllocator::checkWithinPages(unsigned char* block) const
 {
-    // Check if block is within a pages
-    GenericObject* page = PageList_;
-    while(page != nullptr)
+    // Check if block is within a page
+    const PageInfo* info = findPage(block);
+    if (info == nullptr)
     {
-        if (isInPage(page, block))
-        {
-            currentPage = page;
-            return;
-        }
-
-        page = page->Next;
+        throw OAException{OAException::E_BAD_BOUNDARY, "Object address is not within a page."};
     }
-    // return false;
-    throw OAException{OAException::E_BAD_BOUNDARY, "Object address is not within a page."};
+
+    return *info;
 }
 /********************************************************************************//*!
  @brief  Checks if the data is aligned within a page or to the specified alignment.
@@ -879,20 +1968,17 @@ void ObjectAllocator::checkWithinPages(unsigned char* block, void*& currentPage)
 
  @throws OAException for bad boundary.
 *//*********************************************************************************/
-void ObjectAllocator::checkAlignment(void* currentPage, unsigned char* block) const
+void ObjectAllocator::checkAlignment(GenericObject* currentPage, unsigned char* block) const
 {
-    const unsigned char* CP = TO_UCHAR_PTR(currentPage);
-    bool isAligned = true;
+    // Blocks are blockSize apart starting from the first block, which covers both the
+    // left and inter-block alignment
+    const unsigned char* first = firstBlock(currentPage);
+    bool isAligned = block >= first;
 
-    if (config.Alignment_ > 1)
+    if (isAligned)
     {
-        ptrdiff_t offset = block - (CP);
-        isAligned = (static_cast<size_t>(offset) % config.Alignment_ == 0);
-    }
-    else
-    {
-        ptrdiff_t offset = header(block) - (CP) - PTR_SIZE;
-        isAligned = (static_cast<size_t>(offset) % blockSize == 0);
+        size_t offset = static_cast<size_t>(block - first);
+        isAligned = (offset % blockSize == 0) && (offset / blockSize < config.ObjectsPerPage_);
     }
 
     if (!isAligned)
@@ -934,23 +2020,17 @@ bool ObjectAllocator::checkPadding(unsigned char* padPtr) const
 /********************************************************************************//*!
  @brief  Checks if the block has already been freed.
 
+ @param  info
+    The page the block belongs to.
  @param  block
     The block to check for.
     
  @throws OAException for multiple frees.
 *//*********************************************************************************/
-void ObjectAllocator::checkMultipleFree(unsigned char* block) const
+void ObjectAllocator::checkMultipleFree(const PageInfo& info, unsigned char* block) const
 {
-    // Compare against all items in the free list
-    GenericObject* b = TO_GENERIC_OBJECT_PTR(block);
-    GenericObject* fL = FreeList_;
-
-    while(fL != nullptr)
+    if (!isBlockAllocated(info, blockIndex(info.Page, block)))
     {
-        if (b == fL)
-        {
-            throw OAException{OAException::E_MULTIPLE_FREE, "Object has already been freed."};
-        }
-        fL = fL->Next;
+        throw OAException{OAException::E_MULTIPLE_FREE, "Object has already been freed."};
     }
 }
\ No newline at end of file
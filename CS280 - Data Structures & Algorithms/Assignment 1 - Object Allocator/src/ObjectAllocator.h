@@ -16,6 +16,9 @@
 
 // Standard Libraries
 #include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
 
 /*-------------------------------------------------------------------------------------*/
 /* Global Variables                                                                    */
@@ -25,6 +28,7 @@
 
 static const int DEFAULT_OBJECTS_PER_PAGE   = 4;  
 static const int DEFAULT_MAX_PAGES          = 3;
+static const int DEFAULT_THREAD_CACHE_SIZE  = 64;
 
 /*-------------------------------------------------------------------------------------*/
 /* Type  Definitions                                                                   */
@@ -188,9 +192,21 @@ struct OAConfig
         Information about the header blocks used. 
     @param  Alignment
         The number of bytes to align on. Defaults to 0.
+    @param  Concurrent
+        Allows Allocate and Free to be called from multiple threads. Defaults to false.
+    @param  ThreadCacheSize
+        Maximum number of free objects each thread keeps locally in concurrent mode.
+        Defaults to 64.
+    @param  MappedPages
+        Gets pages straight from the OS with mmap/VirtualAlloc instead of new, so that
+        FreeEmptyPages gives the memory back to the OS. Defaults to false.
+    @param  HugePages
+        Asks for transparent huge pages on mapped pages. Only useful when a page is
+        a few MB. Defaults to false.
     *//*********************************************************************************/
     OAConfig(bool UseCPPMemManager = false, unsigned ObjectsPerPage = DEFAULT_OBJECTS_PER_PAGE, unsigned MaxPages = DEFAULT_MAX_PAGES, 
-             bool DebugOn = false, unsigned PadBytes = 0, const HeaderBlockInfo &HBInfo = HeaderBlockInfo(), unsigned Alignment = 0) 
+             bool DebugOn = false, unsigned PadBytes = 0, const HeaderBlockInfo &HBInfo = HeaderBlockInfo(), unsigned Alignment = 0,
+             bool Concurrent = false, unsigned ThreadCacheSize = DEFAULT_THREAD_CACHE_SIZE, bool MappedPages = false, bool HugePages = false) 
     : UseCPPMemManager_ (UseCPPMemManager)
     , ObjectsPerPage_   (ObjectsPerPage)
     , MaxPages_         (MaxPages)
@@ -198,6 +214,10 @@ struct OAConfig
     , PadBytes_         (PadBytes)
     , HBlockInfo_       (HBInfo)
     , Alignment_        (Alignment)
+    , Concurrent_       (Concurrent)
+    , ThreadCacheSize_  (ThreadCacheSize)
+    , MappedPages_      (MappedPages)
+    , HugePages_        (HugePages)
     {
         HBlockInfo_     = HBInfo;
         LeftAlignSize_  = 0;  
@@ -216,6 +236,10 @@ struct OAConfig
     unsigned        Alignment_;         //!< address alignment of each block
     unsigned        LeftAlignSize_;     //!< number of alignment bytes required to align first block
     unsigned        InterAlignSize_;    //!< number of alignment bytes required between remaining blocks
+    bool            Concurrent_;        //!< allow Allocate/Free from multiple threads
+    unsigned        ThreadCacheSize_;   //!< max free objects cached per thread in concurrent mode
+    bool            MappedPages_;       //!< get pages from the OS instead of new
+    bool            HugePages_;         //!< ask for huge pages on mapped pages
 };
 
 /************************************************************************************//*!
@@ -352,6 +376,34 @@ public:
     *//*********************************************************************************/
     void Free(void *Object);
 
+    /********************************************************************************//*!
+    @brief  Takes a number of objects from the free list at once. Either every object 
+            is allocated or none are.
+
+    @param  count
+        The number of objects to allocate.
+    @param  out
+        An array of at least count pointers that receives the objects.
+    @param  label
+        The label for external headers, shared by every object.
+
+    @throws An exception from OAException if the objects can't be allocated.
+    *//*********************************************************************************/
+    void AllocateN(unsigned count, void* out[], const char* label = 0);
+
+    /********************************************************************************//*!
+    @brief  Returns a number of objects to the free list at once.
+
+    @param  Objects
+        The objects to return to the free list.
+    @param  count
+        The number of objects.
+
+    @throws An exception from OAException if an object can't be freed. The objects
+            before it in the array have been freed by then.
+    *//*********************************************************************************/
+    void FreeN(void* const Objects[], unsigned count);
+
     /********************************************************************************//*!
     @brief  Calls the callback function for each block still in use.
             Returns the number of blocks in use by the client.
@@ -378,6 +430,14 @@ public:
     *//*********************************************************************************/
     unsigned FreeEmptyPages();
 
+    /********************************************************************************//*!
+    @brief  Returns the objects cached by the calling thread to the shared free list and
+            merges its statistics. Only does anything in concurrent mode.
+            Worker threads should call this before they exit, otherwise their cached
+            objects stay unusable until the allocator is destroyed.
+    *//*********************************************************************************/
+    void FlushThreadCache();
+
     /*---------------------------------------------------------------------------------*/
     /* Getter Functions                                                                */
     /*---------------------------------------------------------------------------------*/
@@ -411,7 +471,9 @@ public:
     /* Setter Functions                                                                */
     /*---------------------------------------------------------------------------------*/
     /********************************************************************************//*!
-    @brief  Sets the debug mode.
+    @brief  Sets the debug mode. 
+            In concurrent mode, this must not be called while other threads are using
+            the allocator.
 
     @param  State
         The state to set the debug mode to.
@@ -419,6 +481,51 @@ public:
     void SetDebugState(bool State);
 
 private:
+    /*---------------------------------------------------------------------------------*/
+    /* Type  Definitions                                                               */
+    /*---------------------------------------------------------------------------------*/
+    /********************************************************************************//*!
+    @brief  Debug metadata kept for every page. The page index is sorted by address so
+            the owner of a block can be found with a binary search, and the allocation 
+            bits are only kept up to date while debug mode is on.
+    *//*********************************************************************************/
+    struct PageInfo
+    {
+        GenericObject*              Page;           //!< the page this entry describes
+        unsigned                    ObjectsInUse;   //!< number of blocks given to the client
+        std::vector<unsigned char>  AllocatedBits;  //!< one bit per block, set if in use
+    };
+
+    /********************************************************************************//*!
+    @brief  Bookkeeping at the start of every mapped page. Defined in the source file.
+    *//*********************************************************************************/
+    struct MappedPage;
+
+    /********************************************************************************//*!
+    @brief  Free objects and unmerged statistics owned by one thread in concurrent mode.
+            Only the owning thread touches the list. The counters are atomic so that
+            GetStats can read them from any thread.
+    *//*********************************************************************************/
+    struct ThreadCache
+    {
+        GenericObject*          FreeList;       //!< objects cached by this thread
+        unsigned                Count;          //!< number of objects in FreeList
+        unsigned                Pending;        //!< operations since the last merge
+        std::atomic<unsigned>   Allocations;    //!< allocations not merged into stats yet
+        std::atomic<unsigned>   Deallocations;  //!< frees not merged into stats yet
+        ThreadCache*            Next;           //!< the next cache owned by the allocator
+    };
+
+    /********************************************************************************//*!
+    @brief  Where a thread finds its cache for one allocator. Ids are never reused, so
+            an entry left behind by a destroyed allocator can't match a new one.
+    *//*********************************************************************************/
+    struct CacheEntry
+    {
+        unsigned long long      Id;             //!< the id of the allocator
+        ThreadCache*            Cache;          //!< the cache of the thread for it
+    };
+
     /*---------------------------------------------------------------------------------*/
     /* Data Members                                                                    */
     /*---------------------------------------------------------------------------------*/ 
@@ -429,14 +536,144 @@ private:
     OAStats         stats;      //!< the statistics of the allocator
     size_t          blockSize;  //!< the size of a block in a page
 
+    std::vector<PageInfo> PageIndex_;   //!< page metadata, sorted by page address
+
+    size_t              mapAlignment;   //!< alignment of mapped pages, so a block can find its page
+
+    mutable std::mutex  Lock_;          //!< guards the shared lists and stats in concurrent mode
+    ThreadCache*        ThreadCaches_;  //!< every thread cache created for this allocator
+    unsigned long long  Id_;            //!< unique id used by threads to find their cache
+
     /*---------------------------------------------------------------------------------*/
     /* Function Members                                                                */
     /*---------------------------------------------------------------------------------*/
     /********************************************************************************//*!
+    @brief  Checks if the lock-free thread cache path can be used. That is the case in
+            concurrent mode without debugging or headers, which both need shared state.
+
+    @return True if Allocate and Free can go through the thread cache.
+    *//*********************************************************************************/
+    bool useThreadCache() const;
+    /********************************************************************************//*!
+    @brief  Allocate for the thread cache path.
+
+    @return Pointer to the allocated object.
+
+    @throws An exception from OAException if the object can't be allocated.
+    *//*********************************************************************************/
+    void* allocateFromCache();
+    /********************************************************************************//*!
+    @brief  Free for the thread cache path.
+
+    @param  Object
+        The object to return to the cache.
+    *//*********************************************************************************/
+    void freeToCache(void* Object);
+    /********************************************************************************//*!
+    @brief  Gets the cache of the calling thread, creating it on first use.
+
+    @return The cache of the calling thread.
+    *//*********************************************************************************/
+    ThreadCache& threadCache();
+    /********************************************************************************//*!
+    @brief  Gets the cache entries of the calling thread.
+
+    @return The entries. nullptr once the thread has destroyed them on exit.
+    *//*********************************************************************************/
+    static std::vector<CacheEntry>* cacheEntries();
+    /********************************************************************************//*!
+    @brief  Removes the entries of allocators that have been destroyed.
+
+    @param  entries
+        The cache entries of the calling thread.
+    *//*********************************************************************************/
+    static void pruneCacheEntries(std::vector<CacheEntry>& entries);
+    /********************************************************************************//*!
+    @brief  Moves half a cache worth of objects from the shared free list into a cache.
+            Creates a page if the shared free list is empty.
+
+    @param  cache
+        The cache to refill.
+
+    @throws OAException if a page is needed but can't be created.
+    *//*********************************************************************************/
+    void refillCache(ThreadCache& cache);
+    /********************************************************************************//*!
+    @brief  Moves objects from a cache back onto the shared free list. 
+            The caller must hold the lock.
+
+    @param  cache
+        The cache to drain.
+    @param  count
+        The number of objects to move.
+    *//*********************************************************************************/
+    void drainCache(ThreadCache& cache, unsigned count);
+    /********************************************************************************//*!
+    @brief  Folds the unmerged counters of a cache into the shared stats.
+            The caller must hold the lock.
+
+    @param  cache
+        The cache to merge.
+    *//*********************************************************************************/
+    void mergeStats(ThreadCache& cache);
+    /********************************************************************************//*!
+    @brief  Counts an allocation or free against a cache and merges the counters once
+            enough operations have piled up.
+
+    @param  cache
+        The cache to count against.
+    @param  allocation 
+        True for an allocation. False for a free.
+    *//*********************************************************************************/
+    void countOperation(ThreadCache& cache, bool allocation);
+    /********************************************************************************//*!
     @brief  Creates a new page.
     *//*********************************************************************************/
     void createPage();
     /********************************************************************************//*!
+    @brief  Maps a new page from the OS. Only used with MappedPages_.
+
+    @return The start of the page, after its MappedPage bookkeeping.
+
+    @throws OAException if the OS has no memory left.
+    *//*********************************************************************************/
+    unsigned char* mapPage();
+    /********************************************************************************//*!
+    @brief  Gives the memory of a page back to the page source it came from.
+
+    @param  page
+        The page to release.
+    *//*********************************************************************************/
+    void releasePage(GenericObject* page);
+    /********************************************************************************//*!
+    @brief  Gets the bookkeeping of the mapped page a block lies in. This is a mask on 
+            the address, so it is O(1). Only used with MappedPages_.
+
+    @param  block
+        Any address inside the page.
+
+    @return The bookkeeping of the page.
+    *//*********************************************************************************/
+    MappedPage* mappedPage(const void* block) const;
+    /********************************************************************************//*!
+    @brief  Counts a block leaving or joining the shared free list against its page.
+            Only does anything with MappedPages_.
+
+    @param  block
+        The block that moved.
+    @param  taken 
+        True if the block left the free list. False if it was put back.
+    *//*********************************************************************************/
+    void trackLive(void* block, bool taken);
+    /********************************************************************************//*!
+    @brief  FreeEmptyPages for mapped pages. Finds every empty page in O(1) each, then
+            unlinks their blocks in one pass over the free list and releases the pages
+            in one batch.
+
+    @return The number of pages freed.
+    *//*********************************************************************************/
+    unsigned freeEmptyMappedPages();
+    /********************************************************************************//*!
     @brief  Inserts a page into the page list.
 
     @param  page
@@ -467,6 +704,19 @@ private:
     *//*********************************************************************************/
     void createHeader(unsigned char* block, const char* label = nullptr);
     /********************************************************************************//*!
+    @brief  Creates the headers for a batch of blocks. Only call this on AllocateN,
+            before the stats count the blocks. The blocks get the next consecutive
+            allocation numbers. If it fails, the headers it made are destroyed.
+
+    @param  blocks
+        The blocks to create the headers for.
+    @param  count
+        The number of blocks.
+    @param  label 
+        The label for external headers. Defaults to a nullptr.
+    *//*********************************************************************************/
+    void createHeaders(void* const blocks[], unsigned count, const char* label = nullptr);
+    /********************************************************************************//*!
     @brief  Sets the flag for a header. This is only used for basic and extended headers.
 
     @param  block
@@ -550,14 +800,66 @@ private:
     *//*********************************************************************************/
     bool isInPage(GenericObject* page, unsigned char* block) const;
     /********************************************************************************//*!
-    @brief  Checks if a block as been allocated.
+    @brief  Checks if a block as been allocated. For use in debug mode only.
 
-    @param  block
-        The block to check for.
+    @param  info
+        The page the block belongs to.
+    @param  index
+        The index of the block in the page.
 
     @return True if the block has been allocated.
     *//*********************************************************************************/
-    bool isBlockAllocated(unsigned char* block) const;
+    bool isBlockAllocated(const PageInfo& info, size_t index) const;
+    /********************************************************************************//*!
+    @brief  Marks a block as allocated or free in the page index. 
+            For use in debug mode only.
+
+    @param  block
+        The block to mark.
+    @param  allocated 
+        True if the block is being given to the client. False if it is being returned.
+    *//*********************************************************************************/
+    void markBlock(unsigned char* block, bool allocated);
+    /********************************************************************************//*!
+    @brief  Adds a newly created page to the page index.
+
+    @param  page
+        The page to add.
+    *//*********************************************************************************/
+    void indexPage(GenericObject* page);
+    /********************************************************************************//*!
+    @brief  Removes a page from the page index.
+
+    @param  page
+        The page to remove.
+    *//*********************************************************************************/
+    void unindexPage(GenericObject* page);
+    /********************************************************************************//*!
+    @brief  Recomputes the allocation bits of every page from the free list. 
+            Called when debug mode is switched on.
+    *//*********************************************************************************/
+    void rebuildPageIndex();
+    /********************************************************************************//*!
+    @brief  Finds the page that a block lies in with a binary search on the page index.
+
+    @param  block
+        The block to find the page of.
+
+    @return The index entry of the page. Nullptr if the block is not in any page.
+    *//*********************************************************************************/
+    const PageInfo* findPage(const unsigned char* block) const;
+    PageInfo*       findPage(const unsigned char* block);
+    /********************************************************************************//*!
+    @brief  Gets the index of a block in its page.
+
+    @param  page
+        The page the block is in.
+    @param  block
+        The block to get the index of.
+
+    @return The index of the block in the page.
+    *//*********************************************************************************/
+    size_t blockIndex(GenericObject* page, const unsigned char* block) const;
     /********************************************************************************//*!
     @brief  Sets a pattern for a block. For use in debug mode only.
 
@@ -597,12 +899,12 @@ private:
 
     @param  data
         The data to check for.
-    @param  currentPage
-        An out parameter that indicates the page to check in.
+
+    @return The index entry of the page the data is in.
 
     @throws OAException for bad boundary.
     *//*********************************************************************************/
-    void checkWithinPages(unsigned char* data, void*& currentPage) const;
+    const PageInfo& checkWithinPages(unsigned char* data) const;
     /********************************************************************************//*!
     @brief  Checks if the data is aligned within a page or to the specified alignment.
             For use in debug mode only.
@@ -615,7 +917,7 @@ private:
 
     @throws OAException for bad boundary.
     *//*********************************************************************************/
-    void checkAlignment(void* currentPage, unsigned char* data) const;
+    void checkAlignment(GenericObject* currentPage, unsigned char* data) const;
     /********************************************************************************//*!
     @brief  Checks if left or right padding has been corrupted.
 
@@ -637,12 +939,14 @@ private:
     /********************************************************************************//*!
     @brief  Checks if the block has already been freed.
 
+    @param  info
+        The page the block belongs to.
     @param  block
         The block to check for.
         
     @throws OAException for multiple frees.
     *//*********************************************************************************/
-    void checkMultipleFree(unsigned char* block) const;
+    void checkMultipleFree(const PageInfo& info, unsigned char* block) const;
 };
 
 #endif
@@ -0,0 +1,337 @@
+/************************************************************************************//*!
+\file           SlabAllocator.cpp
+\author         Diren D Bharwani, diren.dbharwani, 390002520
+\par            email: diren.dbharwani\@digipen.edu
+\date           Jan 19, 2022
+\brief          Contains the implementation of the SlabAllocator class.
+
+Copyright (C) 2022 DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the prior written
+consent of DigiPen Institute of Technology is prohibited.
+*//*************************************************************************************/
+
+// Primary Header
+#include "SlabAllocator.h"
+// Standard Libraries
+#include <algorithm>
+#include <functional>
+
+/*-------------------------------------------------------------------------------------*/
+/* Static Variables                                                                    */
+/*-------------------------------------------------------------------------------------*/
+
+namespace
+{
+    //! Object size of each class. Spaced closer for small sizes, where most nodes are.
+    const size_t CLASS_SIZES[SlabAllocator::NUM_CLASSES] = { 16, 32, 48, 64, 96, 128, 192, 256 };
+
+    //! Size class for every multiple of SIZE_GRANULARITY up to MAX_OBJECT_SIZE
+    const unsigned CLASS_LOOKUP[SlabAllocator::MAX_OBJECT_SIZE / SlabAllocator::SIZE_GRANULARITY + 1] =
+    {
+        0, 0, 1, 2, 3, 4, 4, 5, 5, 6, 6, 6, 6, 7, 7, 7, 7
+    };
+}
+
+/*-------------------------------------------------------------------------------------*/
+/* Constructors & Destructors                                                          */
+/*-------------------------------------------------------------------------------------*/
+
+/********************************************************************************//*!
+ @brief  Creates an ObjectAllocator for every size class.
+
+ @param  config
+    The configuration shared by every size class.
+ @param  pageBytes
+    The approximate size of a page for every class.
+
+ @throws An exception from OAException if any of the allocators can't be created.
+*//*********************************************************************************/
+SlabAllocator::SlabAllocator(const OAConfig& config, size_t pageBytes)
+: allocators    ()
+, pageSizes     ()
+, knownPages    ()
+, pageMap       ()
+, pageLock      ()
+, concurrent    (config.Concurrent_)
+{
+    try
+    {
+        for (unsigned i = 0; i < NUM_CLASSES; ++i)
+        {
+            OAConfig classConfig = config;
+            classConfig.UseCPPMemManager_   = false;
+            classConfig.ObjectsPerPage_     = static_cast<unsigned>(std::max<size_t>(pageBytes / CLASS_SIZES[i], 1));
+
+            allocators[i]   = new ObjectAllocator(CLASS_SIZES[i], classConfig);
+            pageSizes[i]    = allocators[i]->GetStats().PageSize_;
+            addNewPages(i);
+        }
+    }
+    catch (...)
+    {
+        for (ObjectAllocator* oa : allocators)
+            delete oa;
+
+        throw;
+    }
+}
+
+/********************************************************************************//*!
+ @brief  Destructor for SlabAllocator.
+*//*********************************************************************************/
+SlabAllocator::~SlabAllocator()
+{
+    for (ObjectAllocator* oa : allocators)
+        delete oa;
+}
+
+/*-------------------------------------------------------------------------------------*/
+/* Function Members                                                                    */
+/*-------------------------------------------------------------------------------------*/
+
+/********************************************************************************//*!
+ @brief  Allocates an object from the smallest size class that fits it.
+
+ @param  size
+    The size of the object in bytes.
+ @param  label
+    The label for an external header.
+
+ @return Pointer to the allocated object.
+
+ @throws OAException if the size is larger than MAX_OBJECT_SIZE or the size class
+        can't allocate.
+*//*********************************************************************************/
+void* SlabAllocator::Allocate(size_t size, const char* label)
+{
+    return GetAllocator(size)->Allocate(label);
+}
+
+/********************************************************************************//*!
+ @brief  Returns an object to the size class whose page it lies in.
+
+ @param  Object
+    The object to free.
+
+ @throws OAException for bad boundary if the object is not in any page, or whatever
+        the owning ObjectAllocator throws.
+*//*********************************************************************************/
+void SlabAllocator::Free(void* Object)
+{
+    // Another thread may be adding pages to the map. The object itself is freed after
+    // the lock is let go, as its size class locks itself.
+    std::unique_lock<std::mutex> guard(pageLock, std::defer_lock);
+    if (concurrent)
+        guard.lock();
+
+    unsigned sizeClass = findClass(Object);
+
+    // The object may be in a page created since the page map last saw its class
+    if (sizeClass == NUM_CLASSES)
+    {
+        bool newPages = false;
+        for (unsigned i = 0; i < NUM_CLASSES; ++i)
+            newPages = addNewPages(i) || newPages;
+
+        if (newPages)
+            sizeClass = findClass(Object);
+    }
+
+    if (guard.owns_lock())
+        guard.unlock();
+
+    if (sizeClass == NUM_CLASSES)
+    {
+        throw OAException{OAException::E_BAD_BOUNDARY, "Object address is not within a page."};
+    }
+
+    allocators[sizeClass]->Free(Object);
+}
+
+/********************************************************************************//*!
+ @brief  Frees the empty pages of every size class.
+
+ @return The number of pages freed.
+*//*********************************************************************************/
+unsigned SlabAllocator::FreeEmptyPages()
+{
+    std::unique_lock<std::mutex> guard(pageLock, std::defer_lock);
+    if (concurrent)
+        guard.lock();
+
+    unsigned numFreed = 0;
+    for (unsigned i = 0; i < NUM_CLASSES; ++i)
+    {
+        const unsigned classFreed = allocators[i]->FreeEmptyPages();
+        if (classFreed > 0)
+            rebuildPages(i);
+
+        numFreed += classFreed;
+    }
+
+    return numFreed;
+}
+
+/*-------------------------------------------------------------------------------------*/
+/* Getter Functions                                                                    */
+/*-------------------------------------------------------------------------------------*/
+
+/********************************************************************************//*!
+ @brief  Gets the allocator of the smallest size class that fits an object.
+
+ @param  size
+    The size of the object in bytes.
+
+ @return The allocator of the size class.
+
+ @throws OAException if the size is larger than MAX_OBJECT_SIZE.
+*//*********************************************************************************/
+ObjectAllocator* SlabAllocator::GetAllocator(size_t size)
+{
+    if (size > MAX_OBJECT_SIZE)
+    {
+        throw OAException{OAException::E_NO_MEMORY, "Object is larger than the largest size class."};
+    }
+
+    return allocators[classOf(size)];
+}
+/********************************************************************************//*!
+ @brief  Gets the object size of a size class.
+
+ @param  sizeClass
+    The index of the size class.
+
+ @return The object size of the class.
+*//*********************************************************************************/
+size_t SlabAllocator::GetClassSize(unsigned sizeClass) const
+{
+    return CLASS_SIZES[sizeClass];
+}
+/********************************************************************************//*!
+ @brief  Gets the statistics of a size class.
+
+ @param  sizeClass
+    The index of the size class.
+
+ @return The statistics of the class.
+*//*********************************************************************************/
+OAStats SlabAllocator::GetStats(unsigned sizeClass) const
+{
+    return allocators[sizeClass]->GetStats();
+}
+/********************************************************************************//*!
+ @brief  Gets the statistics of every size class added together.
+
+ @return The aggregated statistics.
+*//*********************************************************************************/
+OAStats SlabAllocator::GetStats() const
+{
+    OAStats total;
+    for (unsigned i = 0; i < NUM_CLASSES; ++i)
+    {
+        const OAStats classStats = allocators[i]->GetStats();
+
+        total.ObjectSize_       = std::max(total.ObjectSize_, classStats.ObjectSize_);
+        total.PageSize_         = std::max(total.PageSize_, classStats.PageSize_);
+        total.FreeObjects_      += classStats.FreeObjects_;
+        total.ObjectsInUse_     += classStats.ObjectsInUse_;
+        total.PagesInUse_       += classStats.PagesInUse_;
+        total.MostObjects_      += classStats.MostObjects_;
+        total.Allocations_      += classStats.Allocations_;
+        total.Deallocations_    += classStats.Deallocations_;
+    }
+
+    return total;
+}
+
+/*-------------------------------------------------------------------------------------*/
+/* Private Function Members                                                            */
+/*-------------------------------------------------------------------------------------*/
+
+/********************************************************************************//*!
+ @brief  Gets the size class for a request size.
+
+ @param  size
+    The size of the request.
+
+ @return The index of the smallest class that fits the request.
+*//*********************************************************************************/
+unsigned SlabAllocator::classOf(size_t size) const
+{
+    return CLASS_LOOKUP[(size + SIZE_GRANULARITY - 1) / SIZE_GRANULARITY];
+}
+/********************************************************************************//*!
+ @brief  Finds the size class that owns an object through the page map.
+
+ @param  Object
+    The object to find the class of.
+
+ @return The index of the class. NUM_CLASSES if the object is in no page.
+*//*********************************************************************************/
+unsigned SlabAllocator::findClass(const void* Object) const
+{
+    const unsigned char* obj = static_cast<const unsigned char*>(Object);
+
+    // First page that starts after the object, the owner must be the one before it
+    auto it = std::upper_bound
+    (
+        pageMap.begin(), pageMap.end(), obj,
+        [](const unsigned char* o, const PageEntry& e) { return std::less<const unsigned char*>()(o, e.Page); }
+    );
+
+    if (it == pageMap.begin())
+        return NUM_CLASSES;
+
+    --it;
+    const bool inPage = std::less<const unsigned char*>()(obj, it->Page + pageSizes[it->Class]);
+    return inPage ? it->Class : NUM_CLASSES;
+}
+/********************************************************************************//*!
+ @brief  Adds the pages a size class created since the page map last saw it.
+
+ @param  sizeClass
+    The index of the size class to update.
+
+ @return True if the class had new pages.
+*//*********************************************************************************/
+bool SlabAllocator::addNewPages(unsigned sizeClass)
+{
+    const GenericObject* newest = static_cast<const GenericObject*>(allocators[sizeClass]->GetPageList());
+    if (newest == knownPages[sizeClass])
+        return false;
+
+    // New pages are in front of the newest one already known
+    for (const GenericObject* page = newest; page != nullptr && page != knownPages[sizeClass]; page = page->Next)
+    {
+        const PageEntry entry{reinterpret_cast<const unsigned char*>(page), sizeClass};
+        pageMap.insert
+        (
+            std::upper_bound
+            (
+                pageMap.begin(), pageMap.end(), entry,
+                [](const PageEntry& lhs, const PageEntry& rhs) { return std::less<const unsigned char*>()(lhs.Page, rhs.Page); }
+            ),
+            entry
+        );
+    }
+
+    knownPages[sizeClass] = newest;
+    return true;
+}
+/********************************************************************************//*!
+ @brief  Replaces the pages of a size class in the page map, after it freed some.
+
+ @param  sizeClass
+    The index of the size class to update.
+*//*********************************************************************************/
+void SlabAllocator::rebuildPages(unsigned sizeClass)
+{
+    pageMap.erase
+    (
+        std::remove_if(pageMap.begin(), pageMap.end(), [sizeClass](const PageEntry& e) { return e.Class == sizeClass; }),
+        pageMap.end()
+    );
+
+    knownPages[sizeClass] = nullptr;
+    addNewPages(sizeClass);
+}
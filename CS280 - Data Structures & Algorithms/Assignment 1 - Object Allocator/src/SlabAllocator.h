@@ -0,0 +1,229 @@
+/************************************************************************************//*!
+ \file           SlabAllocator.h
+ \author         Diren D Bharwani, diren.dbharwani, 390002520
+ \par            email: diren.dbharwani\@digipen.edu
+ \date           Jan 19, 2022
+ \brief          Contains the interface for the SlabAllocator class, a front-end that
+                routes variable sized requests to a family of ObjectAllocators.
+
+ Copyright (C) 2022 DigiPen Institute of Technology.
+ Reproduction or disclosure of this file or its contents without the prior written
+ consent of DigiPen Institute of Technology is prohibited.
+*//*************************************************************************************/
+
+#ifndef SLABALLOCATORH
+#define SLABALLOCATORH
+
+// Standard Libraries
+#include <vector>
+#include <mutex>
+// Project Headers
+#include "ObjectAllocator.h"
+
+/*-------------------------------------------------------------------------------------*/
+/* Global Variables                                                                    */
+/*-------------------------------------------------------------------------------------*/
+
+// If the client doesn't specify these:
+
+static const size_t DEFAULT_SLAB_PAGE_BYTES = 16384;
+static const unsigned DEFAULT_SLAB_MAX_PAGES = 0;   // unlimited
+
+/*-------------------------------------------------------------------------------------*/
+/* Type  Definitions                                                                   */
+/*-------------------------------------------------------------------------------------*/
+
+/************************************************************************************//*!
+ @brief  Encapsulates a slab allocator that owns one ObjectAllocator per size class.
+
+         Allocate goes straight to the allocator of its class. Free finds the class of
+         an object in a map of every page by address, which only learns of new pages
+         when an object isn't in any page it knows. An allocator only ever puts new
+         pages at the front of its page list, so the new pages of a class are the ones
+         before the newest the map knows. With Concurrent_ set, the map is guarded by a
+         lock of its own, and every size class locks itself.
+*//*************************************************************************************/
+class SlabAllocator
+{
+public:
+    /*---------------------------------------------------------------------------------*/
+    /* Static Data Members                                                             */
+    /*---------------------------------------------------------------------------------*/
+    static const size_t     SIZE_GRANULARITY    = 16;   //!< requests are rounded up to this
+    static const size_t     MAX_OBJECT_SIZE     = 256;  //!< the largest size class
+    static const unsigned   NUM_CLASSES         = 8;    //!< number of size classes
+
+    /*---------------------------------------------------------------------------------*/
+    /* Constructors & Destructors                                                      */
+    /*---------------------------------------------------------------------------------*/
+    /********************************************************************************//*!
+    @brief  Creates an ObjectAllocator for every size class.
+
+    @param  config
+        The configuration shared by every size class. ObjectsPerPage_ is replaced so
+        that every class gets pages of roughly pageBytes, and UseCPPMemManager_ is
+        ignored since Free needs the pages to find the class of an object. Every
+        class may have as many pages as it needs unless MaxPages_ is set. Concurrent_
+        also makes Free and FreeEmptyPages lock the page map.
+    @param  pageBytes
+        The approximate size of a page for every class.
+
+    @throws An exception from OAException if any of the allocators can't be created.
+    *//*********************************************************************************/
+    SlabAllocator
+    (
+        const OAConfig& config      = OAConfig(false, DEFAULT_OBJECTS_PER_PAGE, DEFAULT_SLAB_MAX_PAGES),
+        size_t          pageBytes   = DEFAULT_SLAB_PAGE_BYTES
+    );
+
+    // Prevent copy construction and assignment
+    SlabAllocator(const SlabAllocator&) = delete;               //!< Do not implement!
+    SlabAllocator& operator=(const SlabAllocator&) = delete;    //!< Do not implement!
+
+    /********************************************************************************//*!
+    @brief  Destructor for SlabAllocator.
+    *//*********************************************************************************/
+    ~SlabAllocator();
+
+    /*---------------------------------------------------------------------------------*/
+    /* Function Members                                                                */
+    /*---------------------------------------------------------------------------------*/
+    /********************************************************************************//*!
+    @brief  Allocates an object from the smallest size class that fits it.
+
+    @param  size
+        The size of the object in bytes.
+    @param  label
+        The label for an external header.
+
+    @return Pointer to the allocated object.
+
+    @throws OAException if the size is larger than MAX_OBJECT_SIZE or the size class
+            can't allocate.
+    *//*********************************************************************************/
+    void* Allocate(size_t size, const char* label = 0);
+
+    /********************************************************************************//*!
+    @brief  Returns an object to the size class whose page it lies in.
+
+    @param  Object
+        The object to free.
+
+    @throws OAException for bad boundary if the object is not in any page, or whatever
+            the owning ObjectAllocator throws.
+    *//*********************************************************************************/
+    void Free(void* Object);
+
+    /********************************************************************************//*!
+    @brief  Frees the empty pages of every size class.
+
+    @return The number of pages freed.
+    *//*********************************************************************************/
+    unsigned FreeEmptyPages();
+
+    /*---------------------------------------------------------------------------------*/
+    /* Getter Functions                                                                */
+    /*---------------------------------------------------------------------------------*/
+    /********************************************************************************//*!
+    @brief  Gets the allocator of the smallest size class that fits an object, for
+            containers that take an ObjectAllocator for their nodes. Its objects can be
+            freed through it or through Free, but its pages must only be freed through
+            FreeEmptyPages of the SlabAllocator.
+
+    @param  size
+        The size of the object in bytes.
+
+    @return The allocator of the size class.
+
+    @throws OAException if the size is larger than MAX_OBJECT_SIZE.
+    *//*********************************************************************************/
+    ObjectAllocator* GetAllocator(size_t size);
+    /********************************************************************************//*!
+    @brief  Gets the object size of a size class.
+
+    @param  sizeClass
+        The index of the size class.
+
+    @return The object size of the class.
+    *//*********************************************************************************/
+    size_t GetClassSize(unsigned sizeClass) const;
+    /********************************************************************************//*!
+    @brief  Gets the statistics of a size class.
+
+    @param  sizeClass
+        The index of the size class.
+
+    @return The statistics of the class.
+    *//*********************************************************************************/
+    OAStats GetStats(unsigned sizeClass) const;
+    /********************************************************************************//*!
+    @brief  Gets the statistics of every size class added together. ObjectSize_ is the
+            largest class size and MostObjects_ is the sum of each class' peak.
+
+    @return The aggregated statistics.
+    *//*********************************************************************************/
+    OAStats GetStats() const;
+
+private:
+    /*---------------------------------------------------------------------------------*/
+    /* Type  Definitions                                                               */
+    /*---------------------------------------------------------------------------------*/
+    /********************************************************************************//*!
+    @brief  Maps the address range of a page to the size class that owns it.
+    *//*********************************************************************************/
+    struct PageEntry
+    {
+        const unsigned char*    Page;   //!< the start of the page
+        unsigned                Class;  //!< the index of the owning size class
+    };
+
+    /*---------------------------------------------------------------------------------*/
+    /* Data Members                                                                    */
+    /*---------------------------------------------------------------------------------*/
+    ObjectAllocator*        allocators[NUM_CLASSES];    //!< one allocator per size class
+    size_t                  pageSizes[NUM_CLASSES];     //!< page size of each class
+    const void*             knownPages[NUM_CLASSES];    //!< newest page of each class in pageMap
+    std::vector<PageEntry>  pageMap;                    //!< every page, sorted by address
+    std::mutex              pageLock;                   //!< guards knownPages and pageMap
+    bool                    concurrent;                 //!< true if pageLock is used
+
+    /*---------------------------------------------------------------------------------*/
+    /* Function Members                                                                */
+    /*---------------------------------------------------------------------------------*/
+    /********************************************************************************//*!
+    @brief  Gets the size class for a request size.
+
+    @param  size
+        The size of the request.
+
+    @return The index of the smallest class that fits the request.
+    *//*********************************************************************************/
+    unsigned classOf(size_t size) const;
+    /********************************************************************************//*!
+    @brief  Finds the size class that owns an object through the page map.
+
+    @param  Object
+        The object to find the class of.
+
+    @return The index of the class. NUM_CLASSES if the object is in no page.
+    *//*********************************************************************************/
+    unsigned findClass(const void* Object) const;
+    /********************************************************************************//*!
+    @brief  Adds the pages a size class created since the page map last saw it.
+
+    @param  sizeClass
+        The index of the size class to update.
+
+    @return True if the class had new pages.
+    *//*********************************************************************************/
+    bool addNewPages(unsigned sizeClass);
+    /********************************************************************************//*!
+    @brief  Replaces the pages of a size class in the page map, after it freed some.
+
+    @param  sizeClass
+        The index of the size class to update.
+    *//*********************************************************************************/
+    void rebuildPages(unsigned sizeClass);
+};
+
+#endif
@@ -0,0 +1,158 @@
+/************************************************************************************//*!
+ \file           benchmark.cpp
+ \author         Diren D Bharwani, diren.dbharwani, 390002520
+ \par            email: diren.dbharwani\@digipen.edu
+ \date           Feb 2, 2022
+ \brief          Contains the implementation of the BList benchmarks.
+ 
+ Copyright (C) 2022 DigiPen Institute of Technology.
+ Reproduction or disclosure of this file or its contents without the prior written 
+ consent of DigiPen Institute of Technology is prohibited.
+*//*************************************************************************************/
+
+// Primary Header
+#include "benchmark.h"
+// Standard Libraries
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <random>
+#include <algorithm>
+// Project Headers
+#include "src/BList.h"
+
+/*-------------------------------------------------------------------------------------*/
+/* Local Helpers                                                                       */
+/*-------------------------------------------------------------------------------------*/
+namespace
+{
+    const unsigned  NODE_SIZE   = 16;       //!< values per node of every benchmarked list
+    const int       BULK_ITEMS  = 1000000;  //!< values loaded by the build benchmark
+    const int       MERGE_ITEMS = 100000;   //!< values in both lists of the merge benchmark
+
+    using List = BList<int, NODE_SIZE>;
+
+    /********************************************************************************//*!
+    @brief  Times a callable.
+
+    @param  work
+        The callable to time.
+
+    @return The elapsed time in seconds.
+    *//*********************************************************************************/
+    template <typename Work>
+    double timeSeconds(Work work)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        work();
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        return elapsed.count();
+    }
+
+    /********************************************************************************//*!
+    @brief  Prints one row of results.
+
+    @param  name
+        The name of the operation.
+    @param  items
+        The number of values the operation handled.
+    @param  seconds
+        The time the operation took.
+    @param  list
+        The list the operation produced.
+    *//*********************************************************************************/
+    void printRow(const char* name, int items, double seconds, const List& list)
+    {
+        std::cout << std::fixed << std::setprecision(2)
+                  << std::setw(24) << name
+                  << std::setw(14) << items / seconds / 1e6
+                  << std::setw(12) << list.GetStats().NodeCount << '\n';
+    }
+}
+
+/*-------------------------------------------------------------------------------------*/
+/* Function Definitions                                                                */
+/*-------------------------------------------------------------------------------------*/
+
+/************************************************************************************//*!
+ @brief  Measures assign_sorted, merge and split_at against building the same lists
+         with repeated insert, reporting throughput and the node count of the result.
+*//*************************************************************************************/
+void BenchmarkBulkOperations()
+{
+    std::mt19937 rng(280);
+    std::uniform_int_distribution<int> value(0, 1 << 30);
+
+    std::vector<int> sorted(BULK_ITEMS);
+    for (int& v : sorted)
+        v = value(rng);
+    std::sort(sorted.begin(), sorted.end());
+
+    std::cout << "BList bulk operations, " << NODE_SIZE << " values per node\n";
+    std::cout << std::setw(24) << "operation" << std::setw(14) << "Mitems/s" << std::setw(12) << "nodes" << '\n';
+
+    // Build: every sorted insert lands in the tail, which is split once it is full. The
+    // directory keeps each insert from walking the whole list.
+    {
+        List inserted;
+        inserted.SetDirectoryState(true);
+        const double insertTime = timeSeconds([&]() { for (int v : sorted) inserted.insert(v); });
+        printRow("insert (sorted)", BULK_ITEMS, insertTime, inserted);
+
+        List packed;
+        const double assignTime = timeSeconds([&]() { packed.assign_sorted(sorted.begin(), sorted.end()); });
+        printRow("assign_sorted", BULK_ITEMS, assignTime, packed);
+
+        List loose;
+        const double looseTime = timeSeconds([&]() { loose.assign_sorted(sorted.begin(), sorted.end(), 0.75f); });
+        printRow("assign_sorted (0.75)", BULK_ITEMS, looseTime, loose);
+    }
+
+    // Merge: two interleaved halves
+    {
+        std::vector<int> left, right;
+        for (int i = 0; i < MERGE_ITEMS; ++i)
+            (i % 2 ? right : left).push_back(sorted[i * (BULK_ITEMS / MERGE_ITEMS)]);
+
+        List inserted;
+        inserted.SetDirectoryState(true);
+        inserted.assign_sorted(left.begin(), left.end());
+        const double insertTime = timeSeconds([&]() { for (int v : right) inserted.insert(v); });
+        printRow("insert (merge)", static_cast<int>(right.size()), insertTime, inserted);
+
+        List merged, other;
+        merged.assign_sorted(left.begin(), left.end());
+        other.assign_sorted(right.begin(), right.end());
+        const double mergeTime = timeSeconds([&]() { merged.merge(std::move(other)); });
+        printRow("merge", MERGE_ITEMS, mergeTime, merged);
+    }
+
+    // Split: moving the back half out one value at a time against splicing its nodes
+    {
+        const int half = BULK_ITEMS / 2;
+
+        List source;
+        source.SetDirectoryState(true);
+        source.assign_sorted(sorted.begin(), sorted.end());
+        List moved;
+        const double copyTime = timeSeconds
+        (
+            [&]()
+            {
+                for (int i = half; i < BULK_ITEMS; ++i)
+                    moved.push_back(source[i]);
+                for (int i = BULK_ITEMS; i-- > half;)
+                    source.remove(i);
+            }
+        );
+        printRow("push_back + remove", half, copyTime, moved);
+
+        List spliced;
+        spliced.assign_sorted(sorted.begin(), sorted.end());
+        List back;
+        const double splitTime = timeSeconds([&]() { back = spliced.split_at(half); });
+        printRow("split_at", half, splitTime, back);
+    }
+}
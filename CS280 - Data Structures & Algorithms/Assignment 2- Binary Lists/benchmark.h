@@ -0,0 +1,26 @@
+/************************************************************************************//*!
+ \file           benchmark.h
+ \author         Diren D Bharwani, diren.dbharwani, 390002520
+ \par            email: diren.dbharwani\@digipen.edu
+ \date           Feb 2, 2022
+ \brief          Contains the interface for the BList benchmarks.
+ 
+ Copyright (C) 2022 DigiPen Institute of Technology.
+ Reproduction or disclosure of this file or its contents without the prior written 
+ consent of DigiPen Institute of Technology is prohibited.
+*//*************************************************************************************/
+
+#ifndef BENCHMARKH
+#define BENCHMARKH
+
+/*-------------------------------------------------------------------------------------*/
+/* Function Declarations                                                               */
+/*-------------------------------------------------------------------------------------*/
+
+/************************************************************************************//*!
+ @brief  Measures assign_sorted, merge and split_at against building the same lists
+         with repeated insert, reporting throughput and the node count of the result.
+*//*************************************************************************************/
+void BenchmarkBulkOperations();
+
+#endif
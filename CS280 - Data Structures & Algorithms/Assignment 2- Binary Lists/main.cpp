@@ -1,5 +1,6 @@
+#include "benchmark.h"
 
 int main()
 {
-    
-}
\ No newline at end of file
+    BenchmarkBulkOperations();
+}
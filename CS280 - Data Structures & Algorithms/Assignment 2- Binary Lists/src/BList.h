@@ -15,6 +15,7 @@
 
 // Standard Libraries
 #include <string>
+#include <vector>
 
 /*-------------------------------------------------------------------------------------*/
 /* Type  Definitions                                                                   */
@@ -96,6 +97,7 @@ public:
     int     NodeCount;  //!< Number of nodes in the list
     int     ArraySize;  //!< Max number of items in each node
     int     ItemCount;  //!< Number of items in the entire list
+    size_t  DirectorySize;  //!< Bytes reserved by the node directory, 0 if disabled
 
     /*---------------------------------------------------------------------------------*/
     /* Constructors & Destructor                                                       */
@@ -104,10 +106,11 @@ public:
     @brief      Default Constructor for BListStats.
     *//*********************************************************************************/
     BListStats() 
-    : NodeSize  (0)
-    , NodeCount (0)
-    , ArraySize (0)
-    , ItemCount (0)
+    : NodeSize      (0)
+    , NodeCount     (0)
+    , ArraySize     (0)
+    , ItemCount     (0)
+    , DirectorySize (0)
     {};
 
     /********************************************************************************//*!
@@ -123,10 +126,11 @@ public:
         Number of elements in the list.
     *//*********************************************************************************/
     BListStats(size_t nodeSize, int nodeCount, int arraySize, int numElems) 
-    : NodeSize  (nodeSize)
-    , NodeCount (nodeCount)
-    , ArraySize (arraySize)
-    , ItemCount (numElems)
+    : NodeSize      (nodeSize)
+    , NodeCount     (nodeCount)
+    , ArraySize     (arraySize)
+    , ItemCount     (numElems)
+    , DirectorySize (0)
     {};
 };  
 
@@ -193,6 +197,17 @@ public:
     *//*********************************************************************************/
     BList(const BList &rhs);
     /********************************************************************************//*!
+    @brief      Move Constructor for a BList. Takes the nodes of rhs, leaving it as an
+                empty list.
+
+    @param      rhs
+        A BList to take the nodes from.
+
+    @throws     BListException::E_NO_MEMORY, if there is no physical memory left for
+                the empty node of rhs.
+    *//*********************************************************************************/
+    BList(BList &&rhs);
+    /********************************************************************************//*!
     @brief      Destructor for a BList.
     *//*********************************************************************************/
     ~BList();
@@ -213,6 +228,19 @@ public:
     *//*********************************************************************************/
     BList& operator=(const BList &rhs);
     /********************************************************************************//*!
+    @brief      Move Assignment for a BList. Takes the nodes of rhs, leaving it as an
+                empty list.
+
+    @param      rhs
+        A BList to take the nodes from.
+
+    @return     Reference to this BList.
+
+    @throws     BListException::E_NO_MEMORY, if there is no physical memory left for
+                the empty node of rhs.
+    *//*********************************************************************************/
+    BList& operator=(BList &&rhs);
+    /********************************************************************************//*!
     @brief      Gets an element from the BList.
 
     @param      index
@@ -262,6 +290,12 @@ public:
     @returns    The size of a node in the BList.
     *//*********************************************************************************/
     static size_t nodesize();
+    /********************************************************************************//*!
+    @brief      Checks if the node directory is in use.
+
+    @returns    True if the node directory is in use.
+    *//*********************************************************************************/
+    bool GetDirectoryState() const;
 
     /*---------------------------------------------------------------------------------*/
     /* Function Memebrs                                                                */
@@ -320,6 +354,69 @@ public:
     @brief      Deletes all nodes in the BList.
     *//*********************************************************************************/
     void clear();
+    /********************************************************************************//*!
+    @brief      Enables or disables the node directory. The directory keeps the first
+                value and the index of the first value of every node in an array, so
+                operator[], remove, find and insert can binary search for their node
+                instead of walking the list. Searches by value are only used while the
+                list is sorted, i.e. it has not been given out of order values through
+                push_back or push_front.
+
+    @param      State
+        True to build the directory, false to release it.
+
+    @throws     BListException::E_NO_MEMORY, if there is no physical memory left for
+                the directory.
+    *//*********************************************************************************/
+    void SetDirectoryState(bool State);
+    /********************************************************************************//*!
+    @brief      Replaces the contents of the BList with a sorted range. Nodes are filled
+                in order up to the fill factor, so no node is ever split.
+
+    @tparam     InputIt
+        An input iterator to values convertible to T.
+    @param      first
+        The start of the range.
+    @param      last
+        The end of the range.
+    @param      fill_factor
+        The fraction of each node to fill, clamped to hold between 1 and Size values.
+        Less than 1 leaves room for later inserts.
+
+    @throws     BListException::E_DATA_ERROR if the range is not sorted.
+                BListException::E_NO_MEMORY, if there is no physical memory left for
+                allocation.
+                In both cases the BList keeps the values loaded before the error.
+    *//*********************************************************************************/
+    template <typename InputIt>
+    void assign_sorted(InputIt first, InputIt last, float fill_factor = 1.0f);
+    /********************************************************************************//*!
+    @brief      Merges another sorted BList into this one in linear time. The result is
+                packed into full nodes, reusing the nodes of both lists, and equal 
+                values from this list come first. rhs is left as an empty list.
+
+    @param      rhs
+        The BList to merge in.
+
+    @throws     BListException::E_NO_MEMORY, if there is no physical memory left for
+                allocation. Both lists are unchanged in that case.
+    *//*********************************************************************************/
+    void merge(BList&& rhs);
+    /********************************************************************************//*!
+    @brief      Splits the BList in two. Only the node holding the index is divided, the
+                nodes after it are moved over as they are.
+
+    @param      index
+        The index of the first element to move. May be the size of the BList.
+
+    @returns    A BList with the elements from index onwards. This BList keeps the
+                elements before index.
+
+    @throws     BListException::E_BAD_INDEX if the index specified was out of range.
+                BListException::E_NO_MEMORY, if there is no physical memory left for
+                allocation.
+    *//*********************************************************************************/
+    BList split_at(int index);
     
 private:
     /*---------------------------------------------------------------------------------*/
@@ -335,6 +432,15 @@ private:
         L_FULL_R_NFULL,     //!< left is full but right is not full 
         L_FULL_R_FULL,      //!< both left and right are full
     };
+    /********************************************************************************//*!
+    @brief      An entry of the node directory. Entries are kept in list order.
+    *//*********************************************************************************/
+    struct DirectoryEntry
+    {
+        T       first;      //!< the first value in the node
+        int     offset;     //!< index of the first value in the node within the list
+        BNode*  node;       //!< the node this entry describes
+    };
 
     /*---------------------------------------------------------------------------------*/
     /* Data Memebrs                                                                    */
@@ -344,6 +450,11 @@ private:
 
     BListStats  stats;  //!< stats for the BList
 
+    std::vector<DirectoryEntry> directory;      //!< one entry per node, if enabled
+    mutable int                 directoryHint;  //!< the position of the entry last looked up
+    bool                        useDirectory;   //!< true if the directory is maintained
+    bool                        isSorted;       //!< false once values are pushed out of order
+
     /*---------------------------------------------------------------------------------*/
     /* Function Memebrs                                                                */
     /*---------------------------------------------------------------------------------*/
@@ -449,6 +560,69 @@ private:
     @returns    True if the value is in the range.
     *//*********************************************************************************/
     bool inRange(const T& value, const BNode* left, const BNode* right) const;
+    /********************************************************************************//*!
+    @brief      Rebuilds the node directory from the list.
+    *//*********************************************************************************/
+    void rebuildDirectory();
+    /********************************************************************************//*!
+    @brief      Makes room for one more directory entry, so that adding it can't fail.
+                Called before a node is linked, so nothing has changed if it throws.
+
+    @throws     std::bad_alloc if there is no memory left for the directory.
+    *//*********************************************************************************/
+    void reserveDirectoryEntry();
+    /********************************************************************************//*!
+    @brief      Gets the position of a node in the directory.
+    
+    @param      node
+        The node to look for.
+
+    @returns    The position of the node's entry. -1 if the node has no entry.
+    *//*********************************************************************************/
+    int directorySlot(const BNode* node) const;
+    /********************************************************************************//*!
+    @brief      Adds an entry for a node that was just linked into the list. Room for
+                it must have been reserved with reserveDirectoryEntry.
+    
+    @param      node
+        The new node.
+    *//*********************************************************************************/
+    void addToDirectory(BNode* node);
+    /********************************************************************************//*!
+    @brief      Updates the entry of a node after its values changed.
+    
+    @param      node
+        The node which changed.
+    @param      delta
+        The change in the node's count.
+    *//*********************************************************************************/
+    void updateDirectory(const BNode* node, int delta);
+    /********************************************************************************//*!
+    @brief      Removes the entry of a node that is about to be deleted.
+    
+    @param      node
+        The node to remove.
+    *//*********************************************************************************/
+    void removeFromDirectory(const BNode* node);
+    /********************************************************************************//*!
+    @brief      Finds the directory entry of the node holding an index.
+    
+    @param      index
+        An index in the range of the list.
+
+    @returns    The position of the entry.
+    *//*********************************************************************************/
+    int slotOfIndex(int index) const;
+    /********************************************************************************//*!
+    @brief      Finds the last directory entry whose first value is not greater than a
+                value.
+    
+    @param      value
+        The value to look for.
+
+    @returns    The position of the entry. -1 if the value is smaller than every entry.
+    *//*********************************************************************************/
+    int slotOfValue(const T& value) const;
 };
 
 #include "BList.hpp"
@@ -16,6 +16,7 @@ consent of DigiPen Institute of Technology is prohibited.
 #include <iostream>     // For debugging only
 #include <exception>
 #include <cstring>
+#include <algorithm>
 
 /*-------------------------------------------------------------------------------------*/
 /* Constructors & Destructors                                                          */
@@ -28,9 +29,13 @@ consent of DigiPen Institute of Technology is prohibited.
 *//*************************************************************************************/
 template <typename T, unsigned int Size>
 BList<T, Size>::BList()
-: head  { nullptr }
-, tail  { nullptr }
-, stats {}
+: head          { nullptr }
+, tail          { nullptr }
+, stats         {}
+, directory     {}
+, directoryHint { 0 }
+, useDirectory  { false }
+, isSorted      { true }
 {
     try
     {
@@ -58,9 +63,13 @@ BList<T, Size>::BList()
 *//*************************************************************************************/
 template <typename T, unsigned int Size>
 BList<T, Size>::BList(const BList<T, Size>& rhs)
-: head  { nullptr }
-, tail  { nullptr }
-, stats {}
+: head          { nullptr }
+, tail          { nullptr }
+, stats         {}
+, directory     {}
+, directoryHint { 0 }
+, useDirectory  { false }
+, isSorted      { rhs.isSorted }
 {
     try
     {
@@ -75,7 +84,7 @@ BList<T, Size>::BList(const BList<T, Size>& rhs)
         {
             BNode* node = allocateNodeAtBack();
             node->count = rNode->count;
-            memcpy(node->values, rNode->values, sizeof(T) * rhs.head->count);
+            memcpy(node->values, rNode->values, sizeof(T) * rNode->count);
 
             rNode = rNode->next;
         }
@@ -84,12 +93,60 @@ BList<T, Size>::BList(const BList<T, Size>& rhs)
         stats.ItemCount = rhs.stats.ItemCount;
         stats.ArraySize = Size;
         stats.NodeCount = rhs.stats.NodeCount;
+
+        // Entries are only valid once the counts are copied, so build them at the end
+        useDirectory = rhs.useDirectory;
+        rebuildDirectory();
     }
     catch(const std::bad_alloc&)
     {
         throw BListException{BListException::E_NO_MEMORY, "No physical memory left for allocation!"};
     }
 }
+/************************************************************************************//*!
+ @brief     Move Constructor for a BList. Takes the nodes of rhs, leaving it as an
+            empty list.
+
+ @param     rhs
+    A BList to take the nodes from.
+
+ @throws    BListException::E_NO_MEMORY, if there is no physical memory left for
+            the empty node of rhs.
+*//*************************************************************************************/
+template <typename T, unsigned int Size>
+BList<T, Size>::BList(BList<T, Size>&& rhs)
+: head          { nullptr }
+, tail          { nullptr }
+, stats         {}
+, directory     {}
+, directoryHint { 0 }
+, useDirectory  { false }
+, isSorted      { true }
+{
+    BNode* empty = nullptr;
+    try
+    {
+        empty = new BNode;
+    }
+    catch(const std::bad_alloc&)
+    {
+        throw BListException{BListException::E_NO_MEMORY, "No physical memory left for allocation!"};
+    }
+
+    head            = rhs.head;
+    tail            = rhs.tail;
+    stats           = rhs.stats;
+    useDirectory    = rhs.useDirectory;
+    isSorted        = rhs.isSorted;
+    directory.swap(rhs.directory);
+    directoryHint   = rhs.directoryHint;
+
+    rhs.head = rhs.tail     = empty;
+    rhs.stats.NodeCount     = 1;
+    rhs.stats.ItemCount     = 0;
+    rhs.isSorted            = true;
+    rhs.rebuildDirectory();
+}
 /************************************************************************************//*!
  @brief      Destructor for a BList.
 *//*************************************************************************************/
@@ -117,6 +174,8 @@ BList<T, Size>& BList<T, Size>::operator=(const BList<T, Size>& rhs)
 {
     // Clear the BList and reallocate to copy data from rhs
     clear();
+    useDirectory    = false;
+    isSorted        = rhs.isSorted;
 
     // Copy stats over
     try
@@ -132,7 +191,7 @@ BList<T, Size>& BList<T, Size>::operator=(const BList<T, Size>& rhs)
         {
             BNode* node = allocateNodeAtBack();
             node->count = rNode->count;
-            memcpy(node->values, rNode->values, sizeof(T) * rhs.head->count);
+            memcpy(node->values, rNode->values, sizeof(T) * rNode->count);
 
             rNode = rNode->next;
         }
@@ -141,6 +200,10 @@ BList<T, Size>& BList<T, Size>::operator=(const BList<T, Size>& rhs)
         stats.ItemCount = rhs.stats.ItemCount;
         stats.ArraySize = Size;
         stats.NodeCount = rhs.stats.NodeCount;
+
+        // Entries are only valid once the counts are copied, so build them at the end
+        useDirectory = rhs.useDirectory;
+        rebuildDirectory();
     }
     catch(const std::bad_alloc&)
     {
@@ -149,6 +212,40 @@ BList<T, Size>& BList<T, Size>::operator=(const BList<T, Size>& rhs)
 
     return *this;
 }
+/************************************************************************************//*!
+ @brief     Move Assignment for a BList. Takes the nodes of rhs, leaving it as an
+            empty list.
+
+ @param     rhs
+    A BList to take the nodes from.
+
+ @return    Reference to this BList.
+
+ @throws    BListException::E_NO_MEMORY, if there is no physical memory left for
+            the empty node of rhs.
+*//*************************************************************************************/
+template <typename T, unsigned int Size>
+BList<T, Size>& BList<T, Size>::operator=(BList<T, Size>&& rhs)
+{
+    if (&rhs == this)
+        return *this;
+
+    // Take the nodes through a temporary so rhs is emptied the same way as a move
+    BList<T, Size> taken(std::move(rhs));
+
+    clear();
+    head            = taken.head;
+    tail            = taken.tail;
+    stats           = taken.stats;
+    useDirectory    = taken.useDirectory;
+    isSorted        = taken.isSorted;
+    directory.swap(taken.directory);
+    directoryHint   = taken.directoryHint;
+
+    taken.head = taken.tail = nullptr;
+
+    return *this;
+}
 /************************************************************************************//*!
  @brief     Gets an element from the BList.
 
@@ -162,6 +259,15 @@ BList<T, Size>& BList<T, Size>::operator=(const BList<T, Size>& rhs)
 template <typename T, unsigned int Size>
 T& BList<T, Size>::operator[](int index)
 {
+    if (useDirectory)
+    {
+        if (index < 0 || index >= stats.ItemCount)
+            throw BListException{BListException::E_BAD_INDEX, "Index out of range."};
+
+        const DirectoryEntry& entry = directory[slotOfIndex(index)];
+        return entry.node->values[index - entry.offset];
+    }
+
     if (index < stats.ItemCount)
     {
         int counter = -1;
@@ -195,6 +301,15 @@ T& BList<T, Size>::operator[](int index)
 template <typename T, unsigned int Size>
 const T& BList<T, Size>::operator[](int index) const
 {
+    if (useDirectory)
+    {
+        if (index < 0 || index >= stats.ItemCount)
+            throw BListException{BListException::E_BAD_INDEX, "Index out of range."};
+
+        const DirectoryEntry& entry = directory[slotOfIndex(index)];
+        return entry.node->values[index - entry.offset];
+    }
+
     if (index < stats.ItemCount)
     {
         int counter = -1;
@@ -236,7 +351,10 @@ const typename BList<T, Size>::BNode* BList<T, Size>::GetHead() const
 template <typename T, unsigned int Size>
 BListStats BList<T,Size>::GetStats() const
 {
-    return stats;
+    BListStats result = stats;
+    result.DirectorySize = directory.capacity() * sizeof(DirectoryEntry);
+
+    return result;
 }
 /************************************************************************************//*!
  @brief     Gets the size of the BList.
@@ -258,6 +376,16 @@ size_t BList<T, Size>::nodesize(void)
 {
     return sizeof(BNode);
 }
+/************************************************************************************//*!
+ @brief     Checks if the node directory is in use.
+
+ @return    True if the node directory is in use.
+*//*************************************************************************************/
+template <typename T, unsigned int Size>
+bool BList<T, Size>::GetDirectoryState() const
+{
+    return useDirectory;
+}
 /*-------------------------------------------------------------------------------------*/
 /* Public Function Members                                                             */
 /*-------------------------------------------------------------------------------------*/
@@ -271,6 +399,9 @@ size_t BList<T, Size>::nodesize(void)
 template <typename T, unsigned int Size>
 void BList<T, Size>::push_back(const T& value)
 {
+    if (tail->count > 0 && value < tail->values[tail->count - 1])
+        isSorted = false;
+
     if (tail->count == Size)
     {
         allocateNodeAtBack();
@@ -282,6 +413,7 @@ void BList<T, Size>::push_back(const T& value)
     // Increment stats
     ++tail->count;
     ++stats.ItemCount;
+    updateDirectory(tail, 1);
 }
 /************************************************************************************//*!
  @brief     Copies an element into the front of the BList.
@@ -293,6 +425,9 @@ void BList<T, Size>::push_back(const T& value)
 template <typename T, unsigned int Size>
 void BList<T, Size>::push_front(const T& value)
 {
+    if (head->count > 0 && head->values[0] < value)
+        isSorted = false;
+
     if (head->count == Size)
     {
         allocateNodeInFront();
@@ -308,6 +443,7 @@ void BList<T, Size>::push_front(const T& value)
     // Increment stats
     ++head->count;
     ++stats.ItemCount;
+    updateDirectory(head, 1);
 }
 /************************************************************************************//*!
  @brief     Copies an element into the BList.
@@ -326,11 +462,18 @@ void BList<T, Size>::insert(const T& value)
 
         ++head->count;
         ++stats.ItemCount;
+        updateDirectory(head, 1);
 
         return;
     }
 
+    // The walk below only moves past a node if the value is not smaller than the first
+    // value of the next node, so it can start at the last node that satisfies this.
     BNode* node = head;
+    if (useDirectory && isSorted)
+    {
+        node = directory[std::max(slotOfValue(value), 0)].node;
+    }
 
     while (node)
     {
@@ -424,6 +567,16 @@ void BList<T, Size>::remove(int index)
     if (index >= stats.ItemCount)
         throw BListException{BListException::E_BAD_INDEX, "Index out of range"};
 
+    if (useDirectory)
+    {
+        if (index < 0)
+            throw BListException{BListException::E_BAD_INDEX, "Index out of range"};
+
+        const DirectoryEntry& entry = directory[slotOfIndex(index)];
+        removeElement(index - entry.offset, entry.node);
+        return;
+    }
+
     int counter = 0;
 
     BNode* node = head;
@@ -450,6 +603,15 @@ void BList<T, Size>::remove(int index)
 template <typename T, unsigned int Size>
 void BList<T, Size>::remove_by_value(const T& value)
 {
+    if (useDirectory && isSorted)
+    {
+        const int index = find(value);
+        if (index >= 0)
+            remove(index);
+
+        return;
+    }
+
     BNode* node = head;
     while (node)
     {
@@ -476,6 +638,31 @@ void BList<T, Size>::remove_by_value(const T& value)
 template <typename T, unsigned int Size>
 int BList<T, Size>::find(const T& value) const
 {
+    if (useDirectory && isSorted && stats.ItemCount > 0)
+    {
+        // Earlier nodes end before the value, so the first match is either in the last
+        // node that starts below the value or at the start of the node after it.
+        auto it = std::lower_bound
+        (
+            directory.begin(), directory.end(), value,
+            [](const DirectoryEntry& e, const T& v) { return e.first < v; }
+        );
+
+        const int next = static_cast<int>(it - directory.begin());
+        for (int s = std::max(next - 1, 0); s <= next && s < static_cast<int>(directory.size()); ++s)
+        {
+            const DirectoryEntry& entry = directory[s];
+            const T* begin  = entry.node->values;
+            const T* end    = begin + entry.node->count;
+            const T* pos    = std::lower_bound(begin, end, value);
+
+            if (pos != end && *pos == value)
+                return entry.offset + static_cast<int>(pos - begin);
+        }
+
+        return -1;
+    }
+
     int valuePos = -1;
 
     BNode* node = head;
@@ -508,8 +695,309 @@ void BList<T, Size>::clear()
 
     stats.NodeCount = 0;
     stats.ItemCount = 0;
-} 
 
+    directory.clear();
+    isSorted = true;
+}
+/************************************************************************************//*!
+ @brief     Enables or disables the node directory.
+
+ @param     State
+    True to build the directory, false to release it.
+
+ @throws    BListException::E_NO_MEMORY, if there is no physical memory left for
+            the directory.
+*//*************************************************************************************/
+template <typename T, unsigned int Size>
+void BList<T, Size>::SetDirectoryState(bool State)
+{
+    useDirectory = State;
+
+    if (useDirectory)
+    {
+        rebuildDirectory();
+    }
+    else
+    {
+        std::vector<DirectoryEntry>().swap(directory);
+    }
+}
+
+
+/************************************************************************************//*!
+ @brief     Replaces the contents of the BList with a sorted range.
+
+ @tparam    InputIt
+    An input iterator to values convertible to T.
+ @param     first
+    The start of the range.
+ @param     last
+    The end of the range.
+ @param     fill_factor
+    The fraction of each node to fill.
+
+ @throws    BListException::E_DATA_ERROR if the range is not sorted.
+            BListException::E_NO_MEMORY, if there is no physical memory left for
+            allocation.
+*//*************************************************************************************/
+template <typename T, unsigned int Size>
+template <typename InputIt>
+void BList<T, Size>::assign_sorted(InputIt first, InputIt last, float fill_factor)
+{
+    clear();
+
+    try
+    {
+        head = tail = new BNode;
+        ++stats.NodeCount;
+    }
+    catch(const std::bad_alloc&)
+    {
+        throw BListException{BListException::E_NO_MEMORY, "No physical memory left for allocation!"};
+    }
+
+    const int PerNode = std::max(1, std::min(static_cast<int>(Size), static_cast<int>(fill_factor * Size + 0.5f)));
+
+    // Entries are built once at the end rather than updated for every value
+    const bool UseDirectory = useDirectory;
+    useDirectory = false;
+
+    try
+    {
+        for (; first != last; ++first)
+        {
+            const T value = *first;
+            if (tail->count > 0 && value < tail->values[tail->count - 1])
+                throw BListException{BListException::E_DATA_ERROR, "Values are not sorted."};
+
+            if (tail->count == PerNode)
+                allocateNodeAtBack();
+
+            tail->values[tail->count++] = value;
+            ++stats.ItemCount;
+        }
+    }
+    catch(...)
+    {
+        useDirectory = UseDirectory;
+        rebuildDirectory();
+        throw;
+    }
+
+    useDirectory = UseDirectory;
+    rebuildDirectory();
+}
+/************************************************************************************//*!
+ @brief     Merges another sorted BList into this one in linear time.
+
+ @param     rhs
+    The BList to merge in.
+
+ @throws    BListException::E_NO_MEMORY, if there is no physical memory left for
+            allocation.
+*//*************************************************************************************/
+template <typename T, unsigned int Size>
+void BList<T, Size>::merge(BList<T, Size>&& rhs)
+{
+    if (&rhs == this)
+        return;
+
+    // Output nodes come from input nodes that have been fully copied out. The output is
+    // packed tighter than the inputs, so it can only ever get ahead of them by two nodes,
+    // and nothing needs to be allocated once values start moving.
+    std::vector<BNode*> spare;
+    try
+    {
+        spare.reserve(static_cast<size_t>(stats.NodeCount + rhs.stats.NodeCount) + 2);
+        spare.push_back(new BNode);
+        spare.push_back(new BNode);
+    }
+    catch(const std::bad_alloc&)
+    {
+        for (BNode* node : spare)
+            delete node;
+
+        throw BListException{BListException::E_NO_MEMORY, "No physical memory left for allocation!"};
+    }
+
+    auto skipConsumed = [&spare](BNode*& node, int& pos)
+    {
+        while (node && pos == node->count)
+        {
+            BNode* next = node->next;
+            spare.push_back(node);
+
+            node = next;
+            pos  = 0;
+        }
+    };
+    auto takeSpare = [&spare]()
+    {
+        BNode* node = spare.back();
+        spare.pop_back();
+
+        node->next  = nullptr;
+        node->prev  = nullptr;
+        node->count = 0;
+        return node;
+    };
+
+    BNode*  lNode = head;
+    BNode*  rNode = rhs.head;
+    int     lPos  = 0;
+    int     rPos  = 0;
+    skipConsumed(lNode, lPos);
+    skipConsumed(rNode, rPos);
+
+    BNode*  outHead  = nullptr;
+    BNode*  outTail  = nullptr;
+    int     outNodes = 0;
+    while (lNode || rNode)
+    {
+        if (!outTail || isNodeFull(outTail))
+        {
+            BNode* node = takeSpare();
+            node->prev = outTail;
+            (outTail ? outTail->next : outHead) = node;
+
+            outTail = node;
+            ++outNodes;
+        }
+
+        // Ties take from this list so equal values keep their order
+        if (!lNode || (rNode && rNode->values[rPos] < lNode->values[lPos]))
+        {
+            outTail->values[outTail->count++] = rNode->values[rPos++];
+            skipConsumed(rNode, rPos);
+        }
+        else
+        {
+            outTail->values[outTail->count++] = lNode->values[lPos++];
+            skipConsumed(lNode, lPos);
+        }
+    }
+
+    // Both lists need a node even when empty
+    if (!outHead)
+    {
+        outHead = outTail = takeSpare();
+        outNodes = 1;
+    }
+    BNode* rhsHead = takeSpare();
+
+    for (BNode* node : spare)
+        delete node;
+
+    head = outHead;
+    tail = outTail;
+    stats.NodeCount = outNodes;
+    stats.ItemCount += rhs.stats.ItemCount;
+    isSorted = isSorted && rhs.isSorted;
+
+    rhs.head = rhs.tail     = rhsHead;
+    rhs.stats.NodeCount     = 1;
+    rhs.stats.ItemCount     = 0;
+    rhs.isSorted            = true;
+
+    rebuildDirectory();
+    rhs.rebuildDirectory();
+}
+/************************************************************************************//*!
+ @brief     Splits the BList in two.
+
+ @param     index
+    The index of the first element to move. May be the size of the BList.
+
+ @returns   A BList with the elements from index onwards.
+
+ @throws    BListException::E_BAD_INDEX if the index specified was out of range.
+            BListException::E_NO_MEMORY, if there is no physical memory left for
+            allocation.
+*//*************************************************************************************/
+template <typename T, unsigned int Size>
+BList<T, Size> BList<T, Size>::split_at(int index)
+{
+    if (index < 0 || index > stats.ItemCount)
+        throw BListException{BListException::E_BAD_INDEX, "Index out of range."};
+
+    // The result starts with one empty node, which either takes the second half of the
+    // divided node or becomes the only node of this list.
+    BList result;
+    result.isSorted = isSorted;
+
+    if (index < stats.ItemCount)
+    {
+        // Find the node holding the index
+        BNode*  node = head;
+        int     pos  = index;
+        if (useDirectory)
+        {
+            const DirectoryEntry& entry = directory[slotOfIndex(index)];
+            node = entry.node;
+            pos  = index - entry.offset;
+        }
+        else
+        {
+            while (pos >= node->count)
+            {
+                pos -= node->count;
+                node = node->next;
+            }
+        }
+
+        BNode* empty = result.head;
+        result.tail = tail;
+
+        if (pos > 0)
+        {
+            std::copy(node->values + pos, node->values + node->count, empty->values);
+            empty->count = node->count - pos;
+            node->count  = pos;
+
+            empty->next = node->next;
+            if (empty->next)
+                empty->next->prev = empty;
+            else
+                result.tail = empty;
+
+            node->next  = nullptr;
+            tail        = node;
+        }
+        else if (node == head)
+        {
+            result.head = node;
+            head = tail = empty;
+        }
+        else
+        {
+            delete empty;
+            result.head = node;
+
+            tail        = node->prev;
+            tail->next  = nullptr;
+            node->prev  = nullptr;
+        }
+
+        auto countNodes = [](const BNode* node)
+        {
+            int count = 0;
+            for (; node; node = node->next)
+                ++count;
+
+            return count;
+        };
+
+        result.stats.NodeCount = countNodes(result.head);
+        result.stats.ItemCount = stats.ItemCount - index;
+        stats.NodeCount        = countNodes(head);
+        stats.ItemCount        = index;
+    }
+
+    rebuildDirectory();
+    result.SetDirectoryState(useDirectory);
+
+    return result;
+}
 
 /*-------------------------------------------------------------------------------------*/
 /* Private Function Members                                                            */
@@ -524,6 +1012,8 @@ typename BList<T, Size>::BNode* BList<T, Size>::allocateNodeInFront()
 {
     try
     {
+        reserveDirectoryEntry();
+
         BNode* temp = head;
         head = new BNode;
         temp->prev = head;
@@ -531,6 +1021,7 @@ typename BList<T, Size>::BNode* BList<T, Size>::allocateNodeInFront()
 
         head->count = 0;
         ++stats.NodeCount;
+        addToDirectory(head);
 
         return head;
     }
@@ -549,6 +1040,8 @@ typename BList<T, Size>::BNode* BList<T, Size>::allocateNodeAtBack()
 {
     try
     {
+        reserveDirectoryEntry();
+
         BNode* temp = tail;
         tail = new BNode;
         temp->next = tail;
@@ -556,6 +1049,7 @@ typename BList<T, Size>::BNode* BList<T, Size>::allocateNodeAtBack()
 
         tail->count = 0;
         ++stats.NodeCount;
+        addToDirectory(tail);
 
         return tail;
     }
@@ -575,6 +1069,7 @@ void BList<T, Size>::splitNode(BNode* node)
 {
     const unsigned int HalfSize = (Size > 1) ? Size >> 1 : 1;
 
+    reserveDirectoryEntry();
     BNode* newNode = new BNode;
 
     // Split Data
@@ -582,11 +1077,12 @@ void BList<T, Size>::splitNode(BNode* node)
 
     // Edge case where size is 1, so data cannot be split. 
     // An empty node is created instead.
+    // For odd sizes the new node takes the extra element.
     if (Size > 1)
     {
         const T* secondHalf = node->values + HalfSize;
-        memcpy(newNode->values, secondHalf, sizeof(T) * HalfSize);
-        newNode->count = static_cast<int>(HalfSize);
+        memcpy(newNode->values, secondHalf, sizeof(T) * (Size - HalfSize));
+        newNode->count = static_cast<int>(Size - HalfSize);
     }
 
     if (node != tail)
@@ -604,6 +1100,7 @@ void BList<T, Size>::splitNode(BNode* node)
     newNode->prev = node;
 
     ++stats.NodeCount;
+    addToDirectory(newNode);
 }
 /************************************************************************************//*!
  @brief     Removes a node from the BList.
@@ -637,6 +1134,7 @@ void BList<T, Size>::removeNode(BNode* node)
         tail = prev;
     }
 
+    removeFromDirectory(node);
     delete node;
     --stats.NodeCount;
 }
@@ -669,6 +1167,7 @@ void BList<T, Size>::insertIntoNode(const T& value, BNode* node)
 
     ++node->count;
     ++stats.ItemCount;
+    updateDirectory(node, 1);
 }
 /************************************************************************************//*!
  @brief     Inserts a value into the head node. If the head node is full, it will be
@@ -745,6 +1244,8 @@ void BList<T, Size>::insertAfterSplit(const T& value, BNode* left, BNode* right)
 
         ++right->count;
         ++stats.ItemCount;
+        updateDirectory(left, 0);
+        updateDirectory(right, 1);
     }
 }
 /************************************************************************************//*!
@@ -758,19 +1259,21 @@ void BList<T, Size>::insertAfterSplit(const T& value, BNode* left, BNode* right)
 template <typename T, unsigned int Size>
 void BList<T, Size>::removeElement(int pos, BNode* node)
 {
-    const int PrevCount = node->count--;
+    --node->count;
     --stats.ItemCount;
 
     if (node->count == 0)
     {
+        updateDirectory(node, -1);
         removeNode(node);
         return;
     }
 
-    for (int i = pos; i < PrevCount; ++i)
+    for (int i = pos; i < node->count; ++i)
     {
         node->values[i] = node->values[i + 1];
     }
+    updateDirectory(node, -1);
 }
 /************************************************************************************//*!
  @brief     Checks if a node is full.
@@ -820,4 +1323,184 @@ bool BList<T, Size>::inRange(const T& value, const BNode* left, const BNode* rig
     const T& Max = right->values[right->count - 1];
 
     return (!(value < Min) && value < Max) || value == Max;
-}
\ No newline at end of file
+}
+/************************************************************************************//*!
+ @brief     Rebuilds the node directory from the list.
+*//*************************************************************************************/
+template <typename T, unsigned int Size>
+void BList<T, Size>::rebuildDirectory()
+{
+    directory.clear();
+    directoryHint = 0;
+    if (!useDirectory)
+        return;
+
+    try
+    {
+        directory.reserve(static_cast<size_t>(stats.NodeCount));
+
+        int offset = 0;
+        for (BNode* node = head; node; node = node->next)
+        {
+            directory.push_back(DirectoryEntry{ node->count > 0 ? node->values[0] : T(), offset, node });
+            offset += node->count;
+        }
+    }
+    catch(const std::bad_alloc&)
+    {
+        throw BListException{BListException::E_NO_MEMORY, "No physical memory left for allocation!"};
+    }
+}
+/************************************************************************************//*!
+ @brief     Makes room for one more directory entry, so that adding it can't fail.
+            Called before a node is linked, so nothing has changed if it throws.
+
+ @throws    std::bad_alloc if there is no memory left for the directory.
+*//*************************************************************************************/
+template <typename T, unsigned int Size>
+void BList<T, Size>::reserveDirectoryEntry()
+{
+    if (!useDirectory || directory.size() < directory.capacity())
+        return;
+
+    // Grow geometrically, as push_back would
+    directory.reserve(std::max(directory.capacity() * 2, static_cast<size_t>(1)));
+}
+/************************************************************************************//*!
+ @brief     Gets the position of a node in the directory.
+
+ @param     node
+    The node to look for.
+
+ @returns   The position of the node's entry. -1 if the node has no entry.
+*//*************************************************************************************/
+template <typename T, unsigned int Size>
+int BList<T, Size>::directorySlot(const BNode* node) const
+{
+    // A node is nearly always changed right after a lookup found it or its neighbour,
+    // so only a walk through the list, which is linear anyway, needs the scan
+    const int last = static_cast<int>(directory.size()) - 1;
+    for (int slot : { directoryHint, directoryHint + 1, directoryHint - 1, last })
+    {
+        if (slot >= 0 && slot <= last && directory[slot].node == node)
+            return directoryHint = slot;
+    }
+
+    for (int i = 0; i <= last; ++i)
+    {
+        if (directory[i].node == node)
+            return directoryHint = i;
+    }
+
+    return -1;
+}
+/************************************************************************************//*!
+ @brief     Adds an entry for a node that was just linked into the list. Room for it
+            must have been reserved with reserveDirectoryEntry.
+
+ @param     node
+    The new node.
+*//*************************************************************************************/
+template <typename T, unsigned int Size>
+void BList<T, Size>::addToDirectory(BNode* node)
+{
+    if (!useDirectory)
+        return;
+
+    // The entry goes right after the previous node's, which is already up to date
+    int slot    = 0;
+    int offset  = 0;
+    if (node != head)
+    {
+        slot    = directorySlot(node->prev) + 1;
+        offset  = directory[slot - 1].offset + node->prev->count;
+    }
+
+    directory.insert(directory.begin() + slot, DirectoryEntry{ node->count > 0 ? node->values[0] : T(), offset, node });
+    directoryHint = slot;
+}
+/************************************************************************************//*!
+ @brief     Updates the entry of a node after its values changed.
+
+ @param     node
+    The node which changed.
+ @param     delta
+    The change in the node's count.
+*//*************************************************************************************/
+template <typename T, unsigned int Size>
+void BList<T, Size>::updateDirectory(const BNode* node, int delta)
+{
+    if (!useDirectory)
+        return;
+
+    const int slot = directorySlot(node);
+    if (node->count > 0)
+    {
+        directory[slot].first = node->values[0];
+    }
+
+    for (size_t i = static_cast<size_t>(slot) + 1; i < directory.size(); ++i)
+    {
+        directory[i].offset += delta;
+    }
+}
+/************************************************************************************//*!
+ @brief     Removes the entry of a node that is about to be deleted.
+
+ @param     node
+    The node to remove.
+*//*************************************************************************************/
+template <typename T, unsigned int Size>
+void BList<T, Size>::removeFromDirectory(const BNode* node)
+{
+    if (!useDirectory)
+        return;
+
+    const int slot = directorySlot(node);
+    for (size_t i = static_cast<size_t>(slot) + 1; i < directory.size(); ++i)
+    {
+        directory[i].offset -= node->count;
+    }
+
+    directory.erase(directory.begin() + slot);
+}
+/************************************************************************************//*!
+ @brief     Finds the directory entry of the node holding an index.
+
+ @param     index
+    An index in the range of the list.
+
+ @returns   The position of the entry.
+*//*************************************************************************************/
+template <typename T, unsigned int Size>
+int BList<T, Size>::slotOfIndex(int index) const
+{
+    // First node that starts after the index, the owner must be the one before it
+    auto it = std::upper_bound
+    (
+        directory.begin(), directory.end(), index,
+        [](int i, const DirectoryEntry& e) { return i < e.offset; }
+    );
+
+    return directoryHint = static_cast<int>(it - directory.begin()) - 1;
+}
+/************************************************************************************//*!
+ @brief     Finds the last directory entry whose first value is not greater than a
+            value.
+
+ @param     value
+    The value to look for.
+
+ @returns   The position of the entry. -1 if the value is smaller than every entry.
+*//*************************************************************************************/
+template <typename T, unsigned int Size>
+int BList<T, Size>::slotOfValue(const T& value) const
+{
+    auto it = std::upper_bound
+    (
+        directory.begin(), directory.end(), value,
+        [](const T& v, const DirectoryEntry& e) { return v < e.first; }
+    );
+
+    return directoryHint = static_cast<int>(it - directory.begin()) - 1;
+}
@@ -0,0 +1,230 @@
+/************************************************************************************//*!
+ @file    benchmark.cpp
+ @author  Diren D Bharwani, 2002216, diren.dbharwani, diren.dbharwani@digipen.edu
+ @date    Mar 3, 2022
+ @brief   Contains the implementation of the BSTree and AVLTree benchmarks.
+ 
+ Copyright (C) 2022 DigiPen Institute of Technology.
+ Reproduction or disclosure of this file or its contents without the prior written 
+ consent of DigiPen Institute of Technology is prohibited.
+*//*************************************************************************************/
+
+// Primary Header
+#include "benchmark.h"
+// Standard Libraries
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <random>
+#include <algorithm>
+// Project Headers
+#include "src/BSTree.h"
+#include "src/AVLTree.h"
+
+/*-------------------------------------------------------------------------------------*/
+/* Local Helpers                                                                       */
+/*-------------------------------------------------------------------------------------*/
+namespace
+{
+    const int   NUM_QUERIES = 1000000;  //!< lookups timed at every tree size
+    const int   RANGE_SIZE  = 64;       //!< elements visited by each range query
+    const int   NUM_RANGES  = 20000;    //!< range queries timed at every tree size
+
+    /********************************************************************************//*!
+    @brief      Times a callable.
+
+    @param      work
+        The callable to time.
+
+    @returns    The elapsed time in nanoseconds.
+    *//*********************************************************************************/
+    template <typename Work>
+    double timeNanoseconds(Work work)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        work();
+        const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+        return elapsed.count();
+    }
+}
+
+/*-------------------------------------------------------------------------------------*/
+/* Function Definitions                                                                */
+/*-------------------------------------------------------------------------------------*/
+
+/************************************************************************************//*!
+ @brief     Measures find, indexed access and range iteration on a live BSTree against
+            its frozen snapshot, from 10^4 to 10^7 keys.
+*//*************************************************************************************/
+void BenchmarkFrozenLookup()
+{
+    std::mt19937 rng(280);
+
+    std::cout << "Lookup latency (ns/query), live BSTree against frozen snapshot\n";
+    std::cout << std::setw(10) << "keys"
+              << std::setw(12) << "find"      << std::setw(12) << "frozen"
+              << std::setw(12) << "index"     << std::setw(12) << "frozen"
+              << std::setw(12) << "range"     << std::setw(12) << "frozen" << '\n';
+
+    // The results are summed and printed so the lookups can't be optimised out
+    size_t checksum = 0;
+
+    for (int n = 10000; n <= 10000000; n *= 10)
+    {
+        // Even keys inserted in random order, so the tree is reasonably balanced and
+        // half of the queries miss
+        std::vector<int> keys(n);
+        for (int i = 0; i < n; ++i)
+            keys[i] = 2 * i;
+        std::shuffle(keys.begin(), keys.end(), rng);
+
+        BSTree<int> tree;
+        for (int key : keys)
+            tree.insert(key);
+
+        const FrozenTree<int> frozen = tree.freeze();
+
+        std::uniform_int_distribution<int> valueDist(0, 2 * n);
+        std::uniform_int_distribution<int> indexDist(0, n - RANGE_SIZE);
+        std::vector<int> values(NUM_QUERIES), indices(NUM_QUERIES);
+        for (int i = 0; i < NUM_QUERIES; ++i)
+        {
+            values[i]   = valueDist(rng);
+            indices[i]  = indexDist(rng);
+        }
+
+        const double liveFind = timeNanoseconds
+        (
+            [&]()
+            {
+                unsigned compares = 0;
+                for (int v : values)
+                    checksum += tree.find(v, compares);
+            }
+        );
+        const double frozenFind = timeNanoseconds([&]() { for (int v : values) checksum += frozen.find(v); });
+
+        const double liveIndex = timeNanoseconds([&]() { for (int i : indices) checksum += tree[i]->data; });
+        const double frozenIndex = timeNanoseconds([&]() { for (int i : indices) checksum += *frozen[i]; });
+
+        // The live tree has no iterators, so a range is walked through indexed access
+        const double liveRange = timeNanoseconds
+        (
+            [&]()
+            {
+                for (int q = 0; q < NUM_RANGES; ++q)
+                {
+                    const int first = indices[q];
+                    for (int i = first; i < first + RANGE_SIZE; ++i)
+                        checksum += tree[i]->data;
+                }
+            }
+        );
+        const double frozenRange = timeNanoseconds
+        (
+            [&]()
+            {
+                for (int q = 0; q < NUM_RANGES; ++q)
+                {
+                    const int low = 2 * indices[q];
+                    const int* last = nullptr;
+                    for (const int* it = frozen.range(low, low + 2 * (RANGE_SIZE - 1), last); it != last; ++it)
+                        checksum += *it;
+                }
+            }
+        );
+
+        std::cout << std::fixed << std::setprecision(1)
+                  << std::setw(10) << n
+                  << std::setw(12) << liveFind / NUM_QUERIES    << std::setw(12) << frozenFind / NUM_QUERIES
+                  << std::setw(12) << liveIndex / NUM_QUERIES   << std::setw(12) << frozenIndex / NUM_QUERIES
+                  << std::setw(12) << liveRange / NUM_RANGES    << std::setw(12) << frozenRange / NUM_RANGES << '\n';
+    }
+
+    std::cout << "(checksum " << checksum << ")\n";
+}
+/************************************************************************************//*!
+ @brief     Measures AVLTree union, intersection and difference against inserting or
+            removing the elements of one tree one at a time, from 10^4 to 10^6 keys.
+*//*************************************************************************************/
+void BenchmarkSetOperations()
+{
+    std::mt19937 rng(280);
+
+    std::cout << "Set operation time (ms), element by element against split and join\n";
+    std::cout << std::setw(10) << "keys"
+              << std::setw(12) << "insert"    << std::setw(12) << "union"
+              << std::setw(12) << "find"      << std::setw(12) << "intersect"
+              << std::setw(12) << "remove"    << std::setw(12) << "difference" << '\n';
+
+    size_t checksum = 0;
+
+    for (int n = 10000; n <= 1000000; n *= 10)
+    {
+        // Two overlapping sets, each drawn from twice as many values as they hold
+        std::uniform_int_distribution<int> valueDist(0, 2 * n);
+        std::vector<int> first(n), second(n);
+        for (int i = 0; i < n; ++i)
+        {
+            first[i]    = valueDist(rng);
+            second[i]   = valueDist(rng);
+        }
+        std::sort(first.begin(), first.end());
+        first.erase(std::unique(first.begin(), first.end()), first.end());
+        std::sort(second.begin(), second.end());
+        second.erase(std::unique(second.begin(), second.end()), second.end());
+
+        // The trees are rebuilt outside the timings, as the operations consume them. They
+        // share an allocator, so the set operations move nodes instead of copying them.
+        ObjectAllocator allocator{ sizeof(AVLTree<int>::BinTreeNode), OAConfig{true} };
+        AVLTree<int> tree{ &allocator, true }, other{ &allocator, true };
+
+        tree.build_from_sorted(first.begin(), first.end());
+        const double insertTime = timeNanoseconds([&]() { for (int v : second) tree.insert(v); });
+        checksum += tree.size();
+
+        tree.build_from_sorted(first.begin(), first.end());
+        other.build_from_sorted(second.begin(), second.end());
+        const double unionTime = timeNanoseconds([&]() { tree.set_union(other); });
+        checksum += tree.size();
+
+        tree.build_from_sorted(first.begin(), first.end());
+        other.build_from_sorted(second.begin(), second.end());
+        const double findTime = timeNanoseconds
+        (
+            [&]()
+            {
+                unsigned compares = 0;
+                for (int v : first)
+                {
+                    if (!other.find(v, compares))
+                        tree.remove(v);
+                }
+            }
+        );
+        checksum += tree.size();
+
+        tree.build_from_sorted(first.begin(), first.end());
+        const double intersectTime = timeNanoseconds([&]() { tree.set_intersection(other); });
+        checksum += tree.size();
+
+        tree.build_from_sorted(first.begin(), first.end());
+        const double removeTime = timeNanoseconds([&]() { for (int v : second) tree.remove(v); });
+        checksum += tree.size();
+
+        tree.build_from_sorted(first.begin(), first.end());
+        other.build_from_sorted(second.begin(), second.end());
+        const double differenceTime = timeNanoseconds([&]() { tree.set_difference(other); });
+        checksum += tree.size();
+
+        std::cout << std::fixed << std::setprecision(2)
+                  << std::setw(10) << n
+                  << std::setw(12) << insertTime / 1e6  << std::setw(12) << unionTime / 1e6
+                  << std::setw(12) << findTime / 1e6    << std::setw(12) << intersectTime / 1e6
+                  << std::setw(12) << removeTime / 1e6  << std::setw(12) << differenceTime / 1e6 << '\n';
+    }
+
+    std::cout << "(checksum " << checksum << ")\n";
+}
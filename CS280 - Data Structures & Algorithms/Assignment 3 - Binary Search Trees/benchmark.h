@@ -0,0 +1,30 @@
+/************************************************************************************//*!
+ @file    benchmark.h
+ @author  Diren D Bharwani, 2002216, diren.dbharwani, diren.dbharwani@digipen.edu
+ @date    Mar 3, 2022
+ @brief   Contains the interface for the BSTree and AVLTree benchmarks.
+ 
+ Copyright (C) 2022 DigiPen Institute of Technology.
+ Reproduction or disclosure of this file or its contents without the prior written 
+ consent of DigiPen Institute of Technology is prohibited.
+*//*************************************************************************************/
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+/*-------------------------------------------------------------------------------------*/
+/* Function Declarations                                                               */
+/*-------------------------------------------------------------------------------------*/
+
+/************************************************************************************//*!
+ @brief     Measures find, indexed access and range iteration on a live BSTree against
+            its frozen snapshot, from 10^4 to 10^7 keys.
+*//*************************************************************************************/
+void BenchmarkFrozenLookup();
+/************************************************************************************//*!
+ @brief     Measures AVLTree union, intersection and difference against inserting or
+            removing the elements of one tree one at a time, from 10^4 to 10^6 keys.
+*//*************************************************************************************/
+void BenchmarkSetOperations();
+
+#endif
@@ -1,5 +1,7 @@
+#include "benchmark.h"
 
 int main()
 {
-    
-}
\ No newline at end of file
+    BenchmarkFrozenLookup();
+    BenchmarkSetOperations();
+}
@@ -12,6 +12,7 @@
 #ifndef AVLTREE_H
 #define AVLTREE_H
 #include <stack>
+#include <vector>
 #include "BSTree.h"
 
 /************************************************************************************//*!
@@ -35,7 +36,7 @@ public:
     @param      oa
         A pointer to the object allocator to use for memory management.
     @param      ShareOA
-        I don't know what this is for rn.
+        If the allocator is shared with copies of the tree.
     *//*********************************************************************************/
     AVLTree(ObjectAllocator* oa = nullptr, bool ShareOA = false);
     /********************************************************************************//*!
@@ -66,6 +67,91 @@ public:
     @returns    True if balancing is active.
     *//*********************************************************************************/
     static bool ImplementedBalanceFactor(void);
+    /********************************************************************************//*!
+    @brief      Replaces the contents of the tree with a sorted range in linear time.
+                The tree is built directly in balanced form, without any rotations.
+
+    @tparam     RandomIt
+        A random access iterator to values of type T.
+    @param      first
+        The start of the range.
+    @param      last
+        The end of the range.
+
+    @throws     BSTException::E_DATA_ERROR if the range is not strictly ascending.
+                BSTException::E_NO_MEMORY if there is no memory for the nodes. The
+                tree is unchanged in both cases.
+    *//*********************************************************************************/
+    template <typename RandomIt>
+    void build_from_sorted(RandomIt first, RandomIt last);
+    /********************************************************************************//*!
+    @brief      Replaces the contents of the tree with every element of left, the key
+                and every element of right in O(log n). left and right are emptied, and
+                may be this tree. A tree with an allocator other than this tree's has
+                its nodes copied first, in O(n).
+
+    @param      left
+        A tree whose elements are all smaller than key.
+    @param      key
+        The value joining the two trees.
+    @param      right
+        A tree whose elements are all larger than key.
+
+    @throws     BSTException::E_DATA_ERROR if the elements are not ordered around key.
+                BSTException::E_NO_MEMORY if there is no memory for the key, or for
+                copying a tree that uses a different allocator.
+    *//*********************************************************************************/
+    void join(AVLTree& left, const T& key, AVLTree& right);
+    /********************************************************************************//*!
+    @brief      Splits the tree at a key in O(log n). This tree keeps the elements less
+                than key and the rest are moved to right. If right has another
+                allocator, the moved elements are copied into it in O(n).
+
+    @param      key
+        The value to split at.
+    @param      right
+        The tree to receive the elements not less than key. Its previous contents are
+        removed.
+
+    @throws     BSTException::E_NO_MEMORY if right uses a different allocator and there
+                is no memory to copy the elements into it.
+    *//*********************************************************************************/
+    void split(const T& key, AVLTree& right);
+    /********************************************************************************//*!
+    @brief      Adds every element of other to this tree. Takes O(m log(n/m + 1)) work
+                for trees of size m <= n, and large trees are divided between threads.
+                other is emptied. If other has another allocator, its nodes are copied
+                first in O(m), so share one to get the bound.
+
+    @param      other
+        The tree to take the elements from.
+
+    @throws     BSTException::E_NO_MEMORY if other uses a different allocator and there
+                is no memory to copy its elements.
+    *//*********************************************************************************/
+    void set_union(AVLTree& other);
+    /********************************************************************************//*!
+    @brief      Keeps only the elements of this tree that are also in other, with the
+                same cost as set_union. other is emptied.
+
+    @param      other
+        The tree to intersect with.
+
+    @throws     BSTException::E_NO_MEMORY if other uses a different allocator and there
+                is no memory to copy its elements.
+    *//*********************************************************************************/
+    void set_intersection(AVLTree& other);
+    /********************************************************************************//*!
+    @brief      Removes every element of other from this tree, with the same cost as
+                set_union. other is emptied.
+
+    @param      other
+        The tree of elements to remove.
+
+    @throws     BSTException::E_NO_MEMORY if other uses a different allocator and there
+                is no memory to copy its elements.
+    *//*********************************************************************************/
+    void set_difference(AVLTree& other);
 
 protected:
     /*---------------------------------------------------------------------------------*/
@@ -95,6 +181,36 @@ protected:
     virtual BinTree remove_node (BinTree& tree, const T& value) override;
 
 private:
+    /*---------------------------------------------------------------------------------*/
+    /* Type Definitions                                                                */
+    /*---------------------------------------------------------------------------------*/
+    /********************************************************************************//*!
+    @brief      A subtree along with its height, so join and split don't need to
+                recompute heights.
+    *//*********************************************************************************/
+    struct Subtree
+    {
+        BinTree root;       //!< The root of the subtree
+        int     height;     //!< The height of the subtree, -1 if it is empty
+    };
+    /********************************************************************************//*!
+    @brief      Nodes dropped by the set operations. They are linked through their
+                right pointers and freed once every thread has finished.
+    *//*********************************************************************************/
+    struct NodeList
+    {
+        BinTree head = nullptr;     //!< The first node in the list
+        BinTree tail = nullptr;     //!< The last node in the list
+
+        void push   (BinTree node);
+        void append (NodeList& other);
+    };
+
+    /*---------------------------------------------------------------------------------*/
+    /* Static Data Members                                                             */
+    /*---------------------------------------------------------------------------------*/
+    static const unsigned PARALLEL_GRAIN = 16384;   //!< Smallest set operation split between threads
+
     /*---------------------------------------------------------------------------------*/
     /* Function Members                                                                */
     /*---------------------------------------------------------------------------------*/
@@ -125,6 +241,265 @@ private:
     @returns    The balanced tree.
     *//*********************************************************************************/
     BinTree     rotate_right    (BinTree tree);
+    /********************************************************************************//*!
+    @brief      Recalculates the count and balance factor of a node from its children.
+
+    @param      tree
+        The node to update.
+    *//*********************************************************************************/
+    void        update_node     (BinTree tree)                                  const;
+    /********************************************************************************//*!
+    @brief      Gets the height of a subtree in O(log n) by following the taller child,
+                which the balance factors point to.
+
+    @param      tree
+        The root of the subtree.
+
+    @returns    The height of the subtree, -1 if it is empty.
+    *//*********************************************************************************/
+    int         node_height     (const typename BSTree<T>::BinTreeNode* tree)   const;
+    /********************************************************************************//*!
+    @brief      Creates a balanced subtree from a sorted range. Every node is allocated
+                before any are linked, so nothing is kept if an allocation fails.
+
+    @tparam     RandomIt
+        A random access iterator to values of type T.
+    @param      first
+        The start of the range.
+    @param      last
+        The end of the range.
+
+    @returns    The subtree.
+
+    @throws     BSTException::E_NO_MEMORY if there is no memory for the nodes.
+    *//*********************************************************************************/
+    template <typename RandomIt>
+    Subtree     build_nodes     (RandomIt first, RandomIt last)                 const;
+    /********************************************************************************//*!
+    @brief      Links nodes into a balanced subtree, in order.
+
+    @param      nodes
+        The nodes, holding their values in ascending order.
+    @param      first
+        The index of the first node of the subtree.
+    @param      last
+        The index past the last node of the subtree.
+
+    @returns    The subtree.
+    *//*********************************************************************************/
+    Subtree     link_balanced   (const std::vector<BinTree>& nodes, size_t first, size_t last) const;
+    /********************************************************************************//*!
+    @brief      Copies a subtree, possibly from another allocator, into this tree's
+                allocator.
+
+    @param      tree
+        The root of the subtree to copy.
+
+    @returns    The copy.
+
+    @throws     BSTException::E_NO_MEMORY if there is no memory for the copy.
+    *//*********************************************************************************/
+    Subtree     copy_nodes      (const typename BSTree<T>::BinTreeNode* tree)   const;
+    /********************************************************************************//*!
+    @brief      Gets the nodes of another tree in this tree's allocator. They are the
+                other tree's own nodes if the allocator is the same, or a copy
+                otherwise. The other tree is not changed.
+
+    @param      other
+        The tree to get the nodes of.
+
+    @returns    The nodes as a subtree.
+
+    @throws     BSTException::E_NO_MEMORY if there is no memory for the copy.
+    *//*********************************************************************************/
+    Subtree     borrow_nodes    (AVLTree& other)                                const;
+    /********************************************************************************//*!
+    @brief      Empties a tree whose nodes were taken with borrow_nodes.
+
+    @param      other
+        The tree the nodes were taken from.
+    *//*********************************************************************************/
+    void        release_source  (AVLTree& other);
+    /********************************************************************************//*!
+    @brief      Detaches the whole tree from the root.
+
+    @returns    The tree as a subtree.
+    *//*********************************************************************************/
+    Subtree     take_root       ();
+    /********************************************************************************//*!
+    @brief      Frees every node in a list.
+
+    @param      garbage
+        The nodes to free.
+    *//*********************************************************************************/
+    void        free_list       (NodeList& garbage);
+    /********************************************************************************//*!
+    @brief      Gets the children of a subtree along with their heights.
+
+    @param      tree
+        The subtree. Must not be empty.
+    @param      left
+        Receives the left child.
+    @param      right
+        Receives the right child.
+    *//*********************************************************************************/
+    void        expose          (Subtree tree, Subtree& left, Subtree& right)   const;
+    /********************************************************************************//*!
+    @brief      Puts a node on top of two subtrees and sets its count and balance
+                factor.
+
+    @param      left
+        The left subtree.
+    @param      node
+        The node to use as the root.
+    @param      right
+        The right subtree.
+
+    @returns    The combined subtree.
+    *//*********************************************************************************/
+    Subtree     attach          (Subtree left, BinTree node, Subtree right)     const;
+    /********************************************************************************//*!
+    @brief      Puts a node on top of two subtrees whose heights differ by up to 2,
+                rotating once or twice if they differ by 2.
+
+    @param      left
+        The left subtree.
+    @param      node
+        The node to use as the root.
+    @param      right
+        The right subtree.
+
+    @returns    The balanced subtree.
+    *//*********************************************************************************/
+    Subtree     balance         (Subtree left, BinTree node, Subtree right)     const;
+    /********************************************************************************//*!
+    @brief      Joins two subtrees with a node between them by walking down the spine
+                of the taller one. Takes O(difference in height).
+
+    @param      left
+        A subtree of values smaller than node.
+    @param      node
+        The node to join with.
+    @param      right
+        A subtree of values larger than node.
+
+    @returns    The joined subtree.
+    *//*********************************************************************************/
+    Subtree     join_trees      (Subtree left, BinTree node, Subtree right)     const;
+    /********************************************************************************//*!
+    @brief      Joins two subtrees without a node between them.
+
+    @param      left
+        A subtree of smaller values.
+    @param      right
+        A subtree of larger values.
+
+    @returns    The joined subtree.
+    *//*********************************************************************************/
+    Subtree     join_pair       (Subtree left, Subtree right)                   const;
+    /********************************************************************************//*!
+    @brief      Splits a subtree at a key.
+
+    @param      tree
+        The subtree to split.
+    @param      key
+        The value to split at.
+    @param      left
+        Receives the values less than key.
+    @param      found
+        Receives the node holding key, or nullptr. Its children are stale.
+    @param      right
+        Receives the values greater than key.
+    *//*********************************************************************************/
+    void        split_tree      (Subtree tree, const T& key, Subtree& left, BinTree& found, Subtree& right) const;
+    /********************************************************************************//*!
+    @brief      Removes the largest node from a subtree.
+
+    @param      tree
+        The subtree. Must not be empty.
+    @param      last
+        Receives the largest node. Its children are stale.
+
+    @returns    The rest of the subtree.
+    *//*********************************************************************************/
+    Subtree     split_last      (Subtree tree, BinTree& last)                   const;
+    /********************************************************************************//*!
+    @brief      Moves every node of a subtree to a list.
+
+    @param      tree
+        The root of the subtree.
+    @param      garbage
+        The list to move the nodes to.
+    *//*********************************************************************************/
+    void        discard         (BinTree tree, NodeList& garbage)               const;
+    /********************************************************************************//*!
+    @brief      Runs the two halves of a set operation, on another thread for the first
+                half if the operation is large enough and threads are left to use.
+
+    @param      size
+        The number of nodes the halves cover.
+    @param      depth
+        How many more times the work may be divided between threads.
+    @param      garbage
+        The list for the nodes the halves drop.
+    @param      leftWork
+        The first half, called with the depth and list to pass on.
+    @param      rightWork
+        The second half, called with the depth and list to pass on.
+    *//*********************************************************************************/
+    template <typename LeftWork, typename RightWork>
+    void        fork            (unsigned size, int depth, NodeList& garbage, LeftWork leftWork, RightWork rightWork) const;
+    /********************************************************************************//*!
+    @brief      Unites two subtrees.
+
+    @param      a
+        The first subtree.
+    @param      b
+        The second subtree, whose nodes are kept for values in both.
+    @param      garbage
+        Receives the duplicate nodes.
+    @param      depth
+        How many more times the work may be divided between threads.
+
+    @returns    The union.
+    *//*********************************************************************************/
+    Subtree     unite           (Subtree a, Subtree b, NodeList& garbage, int depth) const;
+    /********************************************************************************//*!
+    @brief      Intersects two subtrees.
+
+    @param      a
+        The first subtree.
+    @param      b
+        The second subtree, whose nodes are kept.
+    @param      garbage
+        Receives the nodes that are not kept.
+    @param      depth
+        How many more times the work may be divided between threads.
+
+    @returns    The intersection.
+    *//*********************************************************************************/
+    Subtree     intersect       (Subtree a, Subtree b, NodeList& garbage, int depth) const;
+    /********************************************************************************//*!
+    @brief      Subtracts one subtree from another.
+
+    @param      a
+        The subtree to subtract from.
+    @param      b
+        The subtree of values to remove.
+    @param      garbage
+        Receives the nodes that are not kept.
+    @param      depth
+        How many more times the work may be divided between threads.
+
+    @returns    The difference.
+    *//*********************************************************************************/
+    Subtree     subtract        (Subtree a, Subtree b, NodeList& garbage, int depth) const;
+    /********************************************************************************//*!
+    @brief      Gets how many times a set operation may divide its work between threads.
+
+    @returns    The depth, enough to give every hardware thread a share of the work.
+    *//*********************************************************************************/
+    static int  parallel_depth  ();
 };
 
 #include "AVLTree.hpp"
@@ -12,6 +12,9 @@
 // Primary Header
 #include "AVLTree.h"
 // Standard Libraries
+#include <algorithm>
+#include <system_error>
+#include <thread>
 
 /*-------------------------------------------------------------------------------------*/
 /* Constructors & Destructors                                                          */
@@ -22,7 +25,7 @@
  @param      oa
     A pointer to the object allocator to use for memory management.
  @param      ShareOA
-    I don't know what this is for rn.
+    If the allocator is shared with copies of the tree.
 *//*************************************************************************************/
 template <typename T>
 AVLTree<T>::AVLTree(ObjectAllocator* oa, bool ShareOA)
@@ -65,6 +68,211 @@ bool AVLTree<T>::ImplementedBalanceFactor()
     return true;
 }
 
+/************************************************************************************//*!
+ @brief      Replaces the contents of the tree with a sorted range in linear time.
+
+ @tparam     RandomIt
+    A random access iterator to values of type T.
+ @param      first
+    The start of the range.
+ @param      last
+    The end of the range.
+
+ @throws     BSTException::E_DATA_ERROR if the range is not strictly ascending.
+             BSTException::E_NO_MEMORY if there is no memory for the nodes.
+*//*************************************************************************************/
+template <typename T>
+template <typename RandomIt>
+void AVLTree<T>::build_from_sorted(RandomIt first, RandomIt last)
+{
+    for (RandomIt it = first; it != last && it + 1 != last; ++it)
+    {
+        if (!(*it < *(it + 1)))
+            throw BSTException{BSTException::BST_EXCEPTION::E_DATA_ERROR, "Values are not strictly ascending!"};
+    }
+
+    const Subtree tree = build_nodes(first, last);
+
+    this->clear();
+    this->rootNode = tree.root;
+}
+/************************************************************************************//*!
+ @brief      Replaces the contents of the tree with every element of left, the key and
+             every element of right in O(log n), or O(n) if a tree's nodes are copied
+             from another allocator.
+
+ @param      left
+    A tree whose elements are all smaller than key.
+ @param      key
+    The value joining the two trees.
+ @param      right
+    A tree whose elements are all larger than key.
+
+ @throws     BSTException::E_DATA_ERROR if the elements are not ordered around key.
+             BSTException::E_NO_MEMORY if there is no memory for the key, or for
+             copying a tree that uses a different allocator.
+*//*************************************************************************************/
+template <typename T>
+void AVLTree<T>::join(AVLTree& left, const T& key, AVLTree& right)
+{
+    BinTree largest = left.rootNode;
+    while (largest && largest->right)
+        largest = largest->right;
+
+    BinTree smallest = right.rootNode;
+    while (smallest && smallest->left)
+        smallest = smallest->left;
+
+    if ((largest && !(largest->data < key)) || (smallest && !(key < smallest->data)))
+        throw BSTException{BSTException::BST_EXCEPTION::E_DATA_ERROR, "Trees are not ordered around the key!"};
+
+    // Everything that can fail happens before any tree is changed
+    BinTree node = this->make_node(key);
+    Subtree lower{ nullptr, -1 };
+    Subtree upper{ nullptr, -1 };
+    try
+    {
+        lower = borrow_nodes(left);
+        upper = borrow_nodes(right);
+    }
+    catch (...)
+    {
+        NodeList garbage;
+        if (left.allocator != this->allocator)
+            discard(lower.root, garbage);
+        garbage.push(node);
+        free_list(garbage);
+        throw;
+    }
+
+    if (this != &left && this != &right)
+        this->clear();
+
+    release_source(left);
+    release_source(right);
+    this->rootNode = join_trees(lower, node, upper).root;
+}
+/************************************************************************************//*!
+ @brief      Splits the tree at a key in O(log n), or O(n) if right has another
+             allocator. This tree keeps the elements less than key and the rest are
+             moved to right.
+
+ @param      key
+    The value to split at.
+ @param      right
+    The tree to receive the elements not less than key.
+
+ @throws     BSTException::E_NO_MEMORY if right uses a different allocator and there is
+             no memory to copy the elements into it.
+*//*************************************************************************************/
+template <typename T>
+void AVLTree<T>::split(const T& key, AVLTree& right)
+{
+    if (this == &right)
+        return;
+
+    Subtree lower, upper;
+    BinTree found = nullptr;
+    split_tree(take_root(), key, lower, found, upper);
+
+    // The key itself belongs on the right, as its smallest element
+    if (found)
+        upper = join_trees(Subtree{ nullptr, -1 }, found, upper);
+
+    if (right.allocator != this->allocator)
+    {
+        Subtree copy;
+        try
+        {
+            copy = right.copy_nodes(upper.root);
+        }
+        catch (...)
+        {
+            this->rootNode = join_pair(lower, upper).root;
+            throw;
+        }
+
+        NodeList garbage;
+        discard(upper.root, garbage);
+        free_list(garbage);
+        upper = copy;
+    }
+
+    right.clear();
+    right.rootNode  = upper.root;
+    this->rootNode  = lower.root;
+}
+/************************************************************************************//*!
+ @brief      Adds every element of other to this tree. other is emptied.
+
+ @param      other
+    The tree to take the elements from.
+
+ @throws     BSTException::E_NO_MEMORY if other uses a different allocator and there is
+             no memory to copy its elements.
+*//*************************************************************************************/
+template <typename T>
+void AVLTree<T>::set_union(AVLTree& other)
+{
+    if (this == &other)
+        return;
+
+    const Subtree taken = borrow_nodes(other);
+    release_source(other);
+
+    NodeList garbage;
+    this->rootNode = unite(take_root(), taken, garbage, parallel_depth()).root;
+    free_list(garbage);
+}
+/************************************************************************************//*!
+ @brief      Keeps only the elements of this tree that are also in other. other is
+             emptied.
+
+ @param      other
+    The tree to intersect with.
+
+ @throws     BSTException::E_NO_MEMORY if other uses a different allocator and there is
+             no memory to copy its elements.
+*//*************************************************************************************/
+template <typename T>
+void AVLTree<T>::set_intersection(AVLTree& other)
+{
+    if (this == &other)
+        return;
+
+    const Subtree taken = borrow_nodes(other);
+    release_source(other);
+
+    NodeList garbage;
+    this->rootNode = intersect(take_root(), taken, garbage, parallel_depth()).root;
+    free_list(garbage);
+}
+/************************************************************************************//*!
+ @brief      Removes every element of other from this tree. other is emptied.
+
+ @param      other
+    The tree of elements to remove.
+
+ @throws     BSTException::E_NO_MEMORY if other uses a different allocator and there is
+             no memory to copy its elements.
+*//*************************************************************************************/
+template <typename T>
+void AVLTree<T>::set_difference(AVLTree& other)
+{
+    if (this == &other)
+    {
+        this->clear();
+        return;
+    }
+
+    const Subtree taken = borrow_nodes(other);
+    release_source(other);
+
+    NodeList garbage;
+    this->rootNode = subtract(take_root(), taken, garbage, parallel_depth()).root;
+    free_list(garbage);
+}
+
 /*-------------------------------------------------------------------------------------*/
 /* Protected Function Members                                                          */
 /*-------------------------------------------------------------------------------------*/
@@ -86,18 +294,17 @@ typename AVLTree<T>::BinTree AVLTree<T>::insert_node(typename AVLTree<T>::BinTre
         
     if (value < tree->data)
     {
-        ++(tree->count);
         tree->left = insert_node(tree->left, value);
     }
     else if (value > tree->data)
     {
-        ++(tree->count);
         tree->right = insert_node(tree->right, value);
     }
     else
         return tree;
     
-    tree->balance_factor = get_balance(tree);
+    // Counted after the insert, so a duplicate doesn't change it
+    update_node(tree);
     
     // Rotate Right
     if (tree->balance_factor > 1)
@@ -141,12 +348,10 @@ typename AVLTree<T>::BinTree AVLTree<T>::remove_node(typename AVLTree<T>::BinTre
     if (value < tree->data)
     {
         tree->left = remove_node(tree->left, value);
-        --(tree->count);
     }
     else if (value > tree->data)
     {
         tree->right = remove_node(tree->right, value);
-        --(tree->count);
     }
     else 
     {
@@ -173,19 +378,19 @@ typename AVLTree<T>::BinTree AVLTree<T>::remove_node(typename AVLTree<T>::BinTre
             this->find_predecessor(tree->left, predecessor);
             tree->data = predecessor->data;
             tree->left= remove_node(tree->left, predecessor->data);
-            --(tree->count);
         }
     }
 
     if (tree == nullptr)
         return tree;
     
-    tree->balance_factor = get_balance(tree);
+    // Counted after the removal, so a missing value doesn't change it
+    update_node(tree);
 
     // Rotate Right
     if (tree->balance_factor > 1)
     {
-        if (get_balance(tree->left) < 0)
+        if (tree->left->balance_factor < 0)
         {
             tree->left = rotate_left(tree->left);
         }
@@ -195,7 +400,7 @@ typename AVLTree<T>::BinTree AVLTree<T>::remove_node(typename AVLTree<T>::BinTre
     // Rotate Left
     if (tree->balance_factor < -1)
     {
-        if (get_balance(tree->right) > 0)
+        if (tree->right->balance_factor > 0)
         {
             tree->right = rotate_right(tree->right);
         }
@@ -223,7 +428,7 @@ int AVLTree<T>::get_balance(const typename BSTree<T>::BinTreeNode* tree) const
     if (tree == nullptr)
         return 0;
 
-    return this->tree_height(tree->left) - this->tree_height(tree->right);
+    return node_height(tree->left) - node_height(tree->right);
 }
 /************************************************************************************//*!
  @brief      Rotates a subtree on the left.
@@ -256,6 +461,10 @@ typename AVLTree<T>::BinTree AVLTree<T>::rotate_left(typename AVLTree<T>::BinTre
     tree->count = (tree->left ? tree->left->count : 0) + (tree->right ? tree->right->count : 0) + 1;
     x->count    = (x->left ? x->left->count : 0) + (x->right ? x->right->count : 0) + 1;
 
+    // Fix balance factors from the old ones, as y moves from under x to under n
+    tree->balance_factor    += 1 + std::max(0, -x->balance_factor);
+    x->balance_factor       += 1 + std::max(tree->balance_factor, 0);
+
     return x;
 }
 /************************************************************************************//*!
@@ -289,5 +498,684 @@ typename AVLTree<T>::BinTree AVLTree<T>::rotate_right(typename AVLTree<T>::BinTr
     tree->count = (tree->left ? tree->left->count : 0) + (tree->right ? tree->right->count : 0) + 1;
     x->count    = (x->left ? x->left->count : 0) + (x->right ? x->right->count : 0) + 1;
 
+    // Fix balance factors from the old ones, as y moves from under x to under n
+    tree->balance_factor    -= 1 + std::max(0, x->balance_factor);
+    x->balance_factor       += std::min(tree->balance_factor, 0) - 1;
+
     return x;
-}
\ No newline at end of file
+}
+
+/************************************************************************************//*!
+ @brief      Recalculates the count and balance factor of a node from its children.
+
+ @param      tree
+    The node to update.
+*//*************************************************************************************/
+template <typename T>
+void AVLTree<T>::update_node(typename AVLTree<T>::BinTree tree) const
+{
+    tree->count             = (tree->left ? tree->left->count : 0) + (tree->right ? tree->right->count : 0) + 1;
+    tree->balance_factor    = get_balance(tree);
+}
+/************************************************************************************//*!
+ @brief      Gets the height of a subtree in O(log n) by following the taller child.
+
+ @param      tree
+    The root of the subtree.
+
+ @returns    The height of the subtree, -1 if it is empty.
+*//*************************************************************************************/
+template <typename T>
+int AVLTree<T>::node_height(const typename BSTree<T>::BinTreeNode* tree) const
+{
+    int height = -1;
+    while (tree)
+    {
+        ++height;
+        tree = tree->balance_factor >= 0 ? tree->left : tree->right;
+    }
+
+    return height;
+}
+/************************************************************************************//*!
+ @brief      Creates a balanced subtree from a sorted range.
+
+ @tparam     RandomIt
+    A random access iterator to values of type T.
+ @param      first
+    The start of the range.
+ @param      last
+    The end of the range.
+
+ @returns    The subtree.
+
+ @throws     BSTException::E_NO_MEMORY if there is no memory for the nodes.
+*//*************************************************************************************/
+template <typename T>
+template <typename RandomIt>
+typename AVLTree<T>::Subtree AVLTree<T>::build_nodes(RandomIt first, RandomIt last) const
+{
+    std::vector<BinTree> nodes;
+    nodes.reserve(static_cast<size_t>(last - first));
+
+    try
+    {
+        for (RandomIt it = first; it != last; ++it)
+            nodes.push_back(this->make_node(*it));
+    }
+    catch (...)
+    {
+        for (BinTree node : nodes)
+            this->allocator->Free(node);
+
+        throw;
+    }
+
+    return link_balanced(nodes, 0, nodes.size());
+}
+/************************************************************************************//*!
+ @brief      Links nodes into a balanced subtree, in order. Both halves under a node
+             differ in size by at most one, so they differ in height by at most one.
+
+ @param      nodes
+    The nodes, holding their values in ascending order.
+ @param      first
+    The index of the first node of the subtree.
+ @param      last
+    The index past the last node of the subtree.
+
+ @returns    The subtree.
+*//*************************************************************************************/
+template <typename T>
+typename AVLTree<T>::Subtree AVLTree<T>::link_balanced(const std::vector<BinTree>& nodes, size_t first, size_t last) const
+{
+    if (first == last)
+        return Subtree{ nullptr, -1 };
+
+    const size_t middle = first + (last - first) / 2;
+    return attach(link_balanced(nodes, first, middle), nodes[middle], link_balanced(nodes, middle + 1, last));
+}
+/************************************************************************************//*!
+ @brief      Copies a subtree into this tree's allocator.
+
+ @param      tree
+    The root of the subtree to copy.
+
+ @returns    The copy.
+
+ @throws     BSTException::E_NO_MEMORY if there is no memory for the copy.
+*//*************************************************************************************/
+template <typename T>
+typename AVLTree<T>::Subtree AVLTree<T>::copy_nodes(const typename BSTree<T>::BinTreeNode* tree) const
+{
+    std::vector<T> values;
+    values.reserve(tree ? tree->count : 0);
+
+    // In-order walk
+    std::stack<const typename BSTree<T>::BinTreeNode*> path;
+    while (tree || !path.empty())
+    {
+        while (tree)
+        {
+            path.push(tree);
+            tree = tree->left;
+        }
+
+        tree = path.top();
+        path.pop();
+        values.push_back(tree->data);
+        tree = tree->right;
+    }
+
+    return build_nodes(values.begin(), values.end());
+}
+/************************************************************************************//*!
+ @brief      Gets the nodes of another tree in this tree's allocator.
+
+ @param      other
+    The tree to get the nodes of.
+
+ @returns    The nodes as a subtree.
+
+ @throws     BSTException::E_NO_MEMORY if there is no memory for the copy.
+*//*************************************************************************************/
+template <typename T>
+typename AVLTree<T>::Subtree AVLTree<T>::borrow_nodes(AVLTree& other) const
+{
+    if (other.allocator != this->allocator)
+        return copy_nodes(other.rootNode);
+
+    return Subtree{ other.rootNode, node_height(other.rootNode) };
+}
+/************************************************************************************//*!
+ @brief      Empties a tree whose nodes were taken with borrow_nodes.
+
+ @param      other
+    The tree the nodes were taken from.
+*//*************************************************************************************/
+template <typename T>
+void AVLTree<T>::release_source(AVLTree& other)
+{
+    // Copied nodes leave the originals with the other tree
+    if (other.allocator != this->allocator)
+        other.clear();
+    else
+        other.rootNode = nullptr;
+}
+/************************************************************************************//*!
+ @brief      Detaches the whole tree from the root.
+
+ @returns    The tree as a subtree.
+*//*************************************************************************************/
+template <typename T>
+typename AVLTree<T>::Subtree AVLTree<T>::take_root()
+{
+    const Subtree tree{ this->rootNode, node_height(this->rootNode) };
+    this->rootNode = nullptr;
+    return tree;
+}
+/************************************************************************************//*!
+ @brief      Frees every node in a list.
+
+ @param      garbage
+    The nodes to free.
+*//*************************************************************************************/
+template <typename T>
+void AVLTree<T>::free_list(NodeList& garbage)
+{
+    BinTree node = garbage.head;
+    while (node)
+    {
+        BinTree next = node->right;
+        this->free_node(node);
+        node = next;
+    }
+
+    garbage.head = garbage.tail = nullptr;
+}
+/************************************************************************************//*!
+ @brief      Gets the children of a subtree along with their heights. The taller child
+             is one shorter than the subtree, and the balance factor gives the other.
+
+ @param      tree
+    The subtree. Must not be empty.
+ @param      left
+    Receives the left child.
+ @param      right
+    Receives the right child.
+*//*************************************************************************************/
+template <typename T>
+void AVLTree<T>::expose(Subtree tree, Subtree& left, Subtree& right) const
+{
+    const int balance = tree.root->balance_factor;
+
+    left    = Subtree{ tree.root->left,  tree.height - 1 + std::min(balance, 0) };
+    right   = Subtree{ tree.root->right, tree.height - 1 - std::max(balance, 0) };
+}
+/************************************************************************************//*!
+ @brief      Puts a node on top of two subtrees and sets its count and balance factor.
+
+ @param      left
+    The left subtree.
+ @param      node
+    The node to use as the root.
+ @param      right
+    The right subtree.
+
+ @returns    The combined subtree.
+*//*************************************************************************************/
+template <typename T>
+typename AVLTree<T>::Subtree AVLTree<T>::attach(Subtree left, BinTree node, Subtree right) const
+{
+    node->left              = left.root;
+    node->right             = right.root;
+    node->count             = (left.root ? left.root->count : 0) + (right.root ? right.root->count : 0) + 1;
+    node->balance_factor    = left.height - right.height;
+
+    return Subtree{ node, std::max(left.height, right.height) + 1 };
+}
+/************************************************************************************//*!
+ @brief      Puts a node on top of two subtrees whose heights differ by up to 2.
+
+ @param      left
+    The left subtree.
+ @param      node
+    The node to use as the root.
+ @param      right
+    The right subtree.
+
+ @returns    The balanced subtree.
+*//*************************************************************************************/
+template <typename T>
+typename AVLTree<T>::Subtree AVLTree<T>::balance(Subtree left, BinTree node, Subtree right) const
+{
+    Subtree inner, outer;
+
+    // Rotate Left
+    if (right.height > left.height + 1)
+    {
+        expose(right, inner, outer);
+
+        // Rotate the inner grandchild up first if it is the taller one
+        if (inner.height > outer.height)
+        {
+            Subtree innerLeft, innerRight;
+            expose(inner, innerLeft, innerRight);
+
+            return attach(attach(left, node, innerLeft), inner.root, attach(innerRight, right.root, outer));
+        }
+
+        return attach(attach(left, node, inner), right.root, outer);
+    }
+
+    // Rotate Right
+    if (left.height > right.height + 1)
+    {
+        expose(left, outer, inner);
+
+        if (inner.height > outer.height)
+        {
+            Subtree innerLeft, innerRight;
+            expose(inner, innerLeft, innerRight);
+
+            return attach(attach(outer, left.root, innerLeft), inner.root, attach(innerRight, node, right));
+        }
+
+        return attach(outer, left.root, attach(inner, node, right));
+    }
+
+    return attach(left, node, right);
+}
+/************************************************************************************//*!
+ @brief      Joins two subtrees with a node between them. The shorter subtree is
+             joined at the first node on the spine of the taller one that it nearly
+             matches in height, and the spine is rebalanced on the way back up.
+
+ @param      left
+    A subtree of values smaller than node.
+ @param      node
+    The node to join with.
+ @param      right
+    A subtree of values larger than node.
+
+ @returns    The joined subtree.
+*//*************************************************************************************/
+template <typename T>
+typename AVLTree<T>::Subtree AVLTree<T>::join_trees(Subtree left, BinTree node, Subtree right) const
+{
+    Subtree outer, inner;
+
+    if (left.height > right.height + 1)
+    {
+        expose(left, outer, inner);
+        return balance(outer, left.root, join_trees(inner, node, right));
+    }
+
+    if (right.height > left.height + 1)
+    {
+        expose(right, inner, outer);
+        return balance(join_trees(left, node, inner), right.root, outer);
+    }
+
+    return attach(left, node, right);
+}
+/************************************************************************************//*!
+ @brief      Joins two subtrees without a node between them, using the largest node
+             of the left subtree to join them.
+
+ @param      left
+    A subtree of smaller values.
+ @param      right
+    A subtree of larger values.
+
+ @returns    The joined subtree.
+*//*************************************************************************************/
+template <typename T>
+typename AVLTree<T>::Subtree AVLTree<T>::join_pair(Subtree left, Subtree right) const
+{
+    if (left.root == nullptr)
+        return right;
+
+    BinTree last = nullptr;
+    const Subtree rest = split_last(left, last);
+    return join_trees(rest, last, right);
+}
+/************************************************************************************//*!
+ @brief      Splits a subtree at a key by joining the pieces hanging off the search
+             path on either side of it.
+
+ @param      tree
+    The subtree to split.
+ @param      key
+    The value to split at.
+ @param      left
+    Receives the values less than key.
+ @param      found
+    Receives the node holding key, or nullptr.
+ @param      right
+    Receives the values greater than key.
+*//*************************************************************************************/
+template <typename T>
+void AVLTree<T>::split_tree(Subtree tree, const T& key, Subtree& left, BinTree& found, Subtree& right) const
+{
+    if (tree.root == nullptr)
+    {
+        left = right = Subtree{ nullptr, -1 };
+        found = nullptr;
+        return;
+    }
+
+    Subtree lower, upper;
+    expose(tree, lower, upper);
+
+    if (key < tree.root->data)
+    {
+        Subtree rest;
+        split_tree(lower, key, left, found, rest);
+        right = join_trees(rest, tree.root, upper);
+    }
+    else if (tree.root->data < key)
+    {
+        Subtree rest;
+        split_tree(upper, key, rest, found, right);
+        left = join_trees(lower, tree.root, rest);
+    }
+    else
+    {
+        left    = lower;
+        found   = tree.root;
+        right   = upper;
+    }
+}
+/************************************************************************************//*!
+ @brief      Removes the largest node from a subtree.
+
+ @param      tree
+    The subtree. Must not be empty.
+ @param      last
+    Receives the largest node.
+
+ @returns    The rest of the subtree.
+*//*************************************************************************************/
+template <typename T>
+typename AVLTree<T>::Subtree AVLTree<T>::split_last(Subtree tree, BinTree& last) const
+{
+    Subtree lower, upper;
+    expose(tree, lower, upper);
+
+    if (upper.root == nullptr)
+    {
+        last = tree.root;
+        return lower;
+    }
+
+    return join_trees(lower, tree.root, split_last(upper, last));
+}
+/************************************************************************************//*!
+ @brief      Moves every node of a subtree to a list.
+
+ @param      tree
+    The root of the subtree.
+ @param      garbage
+    The list to move the nodes to.
+*//*************************************************************************************/
+template <typename T>
+void AVLTree<T>::discard(BinTree tree, NodeList& garbage) const
+{
+    if (tree == nullptr)
+        return;
+
+    // The list reuses the right pointer, so the children are read first
+    BinTree left    = tree->left;
+    BinTree right   = tree->right;
+
+    garbage.push(tree);
+    discard(left, garbage);
+    discard(right, garbage);
+}
+/************************************************************************************//*!
+ @brief      Runs the two halves of a set operation. The halves share no nodes, so the
+             first half can run on another thread without any locking, with its own
+             list for the nodes it drops.
+
+ @param      size
+    The number of nodes the halves cover.
+ @param      depth
+    How many more times the work may be divided between threads.
+ @param      garbage
+    The list for the nodes the halves drop.
+ @param      leftWork
+    The first half, called with the depth and list to pass on.
+ @param      rightWork
+    The second half, called with the depth and list to pass on.
+*//*************************************************************************************/
+template <typename T>
+template <typename LeftWork, typename RightWork>
+void AVLTree<T>::fork(unsigned size, int depth, NodeList& garbage, LeftWork leftWork, RightWork rightWork) const
+{
+    if (depth > 0 && size >= PARALLEL_GRAIN)
+    {
+        NodeList leftGarbage;
+        std::thread worker;
+        try
+        {
+            worker = std::thread{ [&]() { leftWork(depth - 1, leftGarbage); } };
+        }
+        catch (const std::system_error&)
+        {
+            // No threads left, so carry on here
+            depth = 0;
+        }
+
+        if (worker.joinable())
+        {
+            rightWork(depth - 1, garbage);
+            worker.join();
+            garbage.append(leftGarbage);
+            return;
+        }
+    }
+
+    leftWork(depth, garbage);
+    rightWork(depth, garbage);
+}
+/************************************************************************************//*!
+ @brief      Unites two subtrees by splitting the first at the root of the second and
+             uniting each side.
+
+ @param      a
+    The first subtree.
+ @param      b
+    The second subtree, whose nodes are kept for values in both.
+ @param      garbage
+    Receives the duplicate nodes.
+ @param      depth
+    How many more times the work may be divided between threads.
+
+ @returns    The union.
+*//*************************************************************************************/
+template <typename T>
+typename AVLTree<T>::Subtree AVLTree<T>::unite(Subtree a, Subtree b, NodeList& garbage, int depth) const
+{
+    if (a.root == nullptr)
+        return b;
+    if (b.root == nullptr)
+        return a;
+
+    const unsigned size = a.root->count + b.root->count;
+
+    Subtree bLeft, bRight;
+    expose(b, bLeft, bRight);
+
+    Subtree aLeft, aRight;
+    BinTree found = nullptr;
+    split_tree(a, b.root->data, aLeft, found, aRight);
+    if (found)
+        garbage.push(found);
+
+    Subtree lower, upper;
+    fork
+    (
+        size, depth, garbage,
+        [&](int d, NodeList& g) { lower = unite(aLeft, bLeft, g, d); },
+        [&](int d, NodeList& g) { upper = unite(aRight, bRight, g, d); }
+    );
+
+    return join_trees(lower, b.root, upper);
+}
+/************************************************************************************//*!
+ @brief      Intersects two subtrees by splitting the first at the root of the second
+             and intersecting each side.
+
+ @param      a
+    The first subtree.
+ @param      b
+    The second subtree, whose nodes are kept.
+ @param      garbage
+    Receives the nodes that are not kept.
+ @param      depth
+    How many more times the work may be divided between threads.
+
+ @returns    The intersection.
+*//*************************************************************************************/
+template <typename T>
+typename AVLTree<T>::Subtree AVLTree<T>::intersect(Subtree a, Subtree b, NodeList& garbage, int depth) const
+{
+    if (a.root == nullptr || b.root == nullptr)
+    {
+        discard(a.root, garbage);
+        discard(b.root, garbage);
+        return Subtree{ nullptr, -1 };
+    }
+
+    const unsigned size = a.root->count + b.root->count;
+
+    Subtree bLeft, bRight;
+    expose(b, bLeft, bRight);
+
+    Subtree aLeft, aRight;
+    BinTree found = nullptr;
+    split_tree(a, b.root->data, aLeft, found, aRight);
+
+    Subtree lower, upper;
+    fork
+    (
+        size, depth, garbage,
+        [&](int d, NodeList& g) { lower = intersect(aLeft, bLeft, g, d); },
+        [&](int d, NodeList& g) { upper = intersect(aRight, bRight, g, d); }
+    );
+
+    if (found)
+    {
+        garbage.push(found);
+        return join_trees(lower, b.root, upper);
+    }
+
+    garbage.push(b.root);
+    return join_pair(lower, upper);
+}
+/************************************************************************************//*!
+ @brief      Subtracts one subtree from another by splitting the first at the root of
+             the second and subtracting each side.
+
+ @param      a
+    The subtree to subtract from.
+ @param      b
+    The subtree of values to remove.
+ @param      garbage
+    Receives the nodes that are not kept.
+ @param      depth
+    How many more times the work may be divided between threads.
+
+ @returns    The difference.
+*//*************************************************************************************/
+template <typename T>
+typename AVLTree<T>::Subtree AVLTree<T>::subtract(Subtree a, Subtree b, NodeList& garbage, int depth) const
+{
+    if (a.root == nullptr || b.root == nullptr)
+    {
+        discard(b.root, garbage);
+        return a;
+    }
+
+    const unsigned size = a.root->count + b.root->count;
+
+    Subtree bLeft, bRight;
+    expose(b, bLeft, bRight);
+
+    Subtree aLeft, aRight;
+    BinTree found = nullptr;
+    split_tree(a, b.root->data, aLeft, found, aRight);
+
+    Subtree lower, upper;
+    fork
+    (
+        size, depth, garbage,
+        [&](int d, NodeList& g) { lower = subtract(aLeft, bLeft, g, d); },
+        [&](int d, NodeList& g) { upper = subtract(aRight, bRight, g, d); }
+    );
+
+    garbage.push(b.root);
+    if (found)
+        garbage.push(found);
+
+    return join_pair(lower, upper);
+}
+/************************************************************************************//*!
+ @brief      Gets how many times a set operation may divide its work between threads.
+
+ @returns    The depth, enough to give every hardware thread a share of the work.
+*//*************************************************************************************/
+template <typename T>
+int AVLTree<T>::parallel_depth()
+{
+    const unsigned threads = std::thread::hardware_concurrency();
+
+    int depth = 0;
+    while ((1u << depth) < threads)
+        ++depth;
+
+    return depth;
+}
+
+/*-------------------------------------------------------------------------------------*/
+/* NodeList Function Members                                                           */
+/*-------------------------------------------------------------------------------------*/
+/************************************************************************************//*!
+ @brief      Adds a node to the end of the list.
+
+ @param      node
+    The node to add. Its right pointer is overwritten.
+*//*************************************************************************************/
+template <typename T>
+void AVLTree<T>::NodeList::push(BinTree node)
+{
+    node->right = nullptr;
+
+    if (tail)
+        tail->right = node;
+    else
+        head = node;
+
+    tail = node;
+}
+/************************************************************************************//*!
+ @brief      Moves every node of another list to the end of this list.
+
+ @param      other
+    The list to move the nodes from.
+*//*************************************************************************************/
+template <typename T>
+void AVLTree<T>::NodeList::append(NodeList& other)
+{
+    if (other.head == nullptr)
+        return;
+
+    if (tail)
+        tail->right = other.head;
+    else
+        head = other.head;
+
+    tail = other.tail;
+    other.head = other.tail = nullptr;
+}
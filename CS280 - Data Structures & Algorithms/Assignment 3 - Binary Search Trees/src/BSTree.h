@@ -17,6 +17,7 @@
 #include <stdexcept>
 // Project Headers
 #include "ObjectAllocator.h"
+#include "FrozenTree.h"
 
 /*-------------------------------------------------------------------------------------*/
 /* Type  Definitions                                                                   */
@@ -35,7 +36,8 @@ public:
     *//*********************************************************************************/
     enum BST_EXCEPTION
     {
-        E_NO_MEMORY
+        E_NO_MEMORY,
+        E_DATA_ERROR
     };
 
     /*---------------------------------------------------------------------------------*/
@@ -144,7 +146,8 @@ public:
     @brief      Default Constructor for a BSTree.
 
     @param      oa
-        A pointer to the object allocator to use for memory management.
+        A pointer to the object allocator to use for memory management. The tree
+        doesn't free it. If null, the tree makes and frees its own.
     @param      ShareOA
         If the allocator is shared with others
     *//*********************************************************************************/
@@ -243,6 +246,15 @@ public:
     @returns    True if the value is found.
     *//*********************************************************************************/
     bool            find    (const T& value, unsigned& compares)    const;
+    /********************************************************************************//*!
+    @brief      Takes a read-only snapshot of the tree. The snapshot does not change
+                when the tree does, so it has to be taken again after updates.
+
+    @returns    The snapshot, holding the elements of the tree in sorted order.
+
+    @throws     std::bad_alloc if there is no memory for the snapshot.
+    *//*********************************************************************************/
+    FrozenTree<T>   freeze  ()                                      const;
 
   protected:
     /*---------------------------------------------------------------------------------*/
@@ -250,6 +262,7 @@ public:
     /*---------------------------------------------------------------------------------*/
     ObjectAllocator*    allocator;
     bool                shareOA;
+    bool                ownsOA;     //!< If the tree made the allocator, and frees it
     BinTree             rootNode;
 
     /*---------------------------------------------------------------------------------*/
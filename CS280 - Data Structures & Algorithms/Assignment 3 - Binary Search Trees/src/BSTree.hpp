@@ -14,6 +14,7 @@
 // Standard Libraries
 #include <iostream>     // For debugging only
 #include <exception>
+#include <vector>
 
 /*-------------------------------------------------------------------------------------*/
 /* Constructors & Destructors                                                          */
@@ -22,7 +23,8 @@
  @brief      Default Constructor for a BSTree.
  
  @param      oa
-     A pointer to the object allocator to use for memory management.
+     A pointer to the object allocator to use for memory management. The tree
+     doesn't free it. If null, the tree makes and frees its own.
  @param      ShareOA
     If the allocator is shared with others
 *//*************************************************************************************/
@@ -30,6 +32,7 @@ template <typename T>
 BSTree<T>::BSTree(ObjectAllocator* oa, bool ShareOA)
 : allocator { oa }
 , shareOA   { ShareOA }
+, ownsOA    { oa == nullptr }
 , rootNode  { nullptr }
 {
     if (!allocator)
@@ -47,6 +50,7 @@ BSTree<T>::BSTree(ObjectAllocator* oa, bool ShareOA)
 template <typename T>
 BSTree<T>::BSTree(const BSTree& rhs)
 : shareOA   { rhs.shareOA }
+, ownsOA    { !rhs.shareOA }
 , rootNode  { nullptr }
 {
     if (shareOA)
@@ -69,7 +73,12 @@ template <typename T>
 BSTree<T>::~BSTree()
 {
     clear();
-    delete allocator;
+
+    // A shared allocator, or one passed in, belongs to someone else
+    if (ownsOA)
+    {
+        delete allocator;
+    }
     allocator = nullptr;
 }
 
@@ -87,13 +96,22 @@ BSTree<T>::~BSTree()
 template <typename T>
 BSTree<T>& BSTree<T>::operator=(const BSTree& rhs)
 {
+    if (&rhs == this)
+        return *this;
+
+    // The nodes go back to the allocator they came from before it is replaced
+    clear();
+
     if (shareOA)
     {
-        delete allocator;
-        allocator = rhs.allocator;
+        if (ownsOA)
+        {
+            delete allocator;
+        }
+        allocator   = rhs.allocator;
+        ownsOA      = false;
     }
 
-    clear();
     recursive_copy(rootNode, rhs.rootNode);
     return *this;
 }
@@ -201,6 +219,40 @@ bool BSTree<T>::find(const T& value, unsigned& compares) const
     compares = 0;
     return find_value(rootNode, value, compares);
 }
+/************************************************************************************//*!
+ @brief      Takes a read-only snapshot of the tree.
+
+ @returns    The snapshot, holding the elements of the tree in sorted order.
+
+ @throws     std::bad_alloc if there is no memory for the snapshot.
+*//*************************************************************************************/
+template <typename T>
+FrozenTree<T> BSTree<T>::freeze() const
+{
+    std::vector<T> sorted;
+    sorted.reserve(size());
+
+    // In-order walk with an explicit stack, an unbalanced BSTree can be too deep to
+    // recurse through
+    std::vector<BinTree> path;
+    BinTree node = rootNode;
+    while (node || !path.empty())
+    {
+        while (node)
+        {
+            path.push_back(node);
+            node = node->left;
+        }
+
+        node = path.back();
+        path.pop_back();
+
+        sorted.push_back(node->data);
+        node = node->right;
+    }
+
+    return FrozenTree<T>{std::move(sorted)};
+}
 
 /*-------------------------------------------------------------------------------------*/
 /* Protected Function Members                                                          */
@@ -328,12 +380,19 @@ typename BSTree<T>::BinTree BSTree<T>::insert_node(BinTree& tree, const T& value
     }
 
     // Larger values traverse to the right
-    if (value > tree->data)
+    else if (value > tree->data)
     {
         tree->right = insert_node(tree->right, value);
     }
 
-    ++(tree->count);
+    // Duplicates are not inserted
+    else
+    {
+        return tree;
+    }
+
+    // Recounted rather than incremented, a duplicate further down adds nothing
+    tree->count = (tree->left ? tree->left->count : 0) + (tree->right ? tree->right->count : 0) + 1;
     return tree;
 }
 /************************************************************************************//*!
@@ -414,7 +473,8 @@ void BSTree<T>::recursive_copy(BinTree& dest, const BinTree src)
         return;
 
     dest = make_node(src->data);
-    dest->count = src->count;
+    dest->count             = src->count;
+    dest->balance_factor    = src->balance_factor;
     
     recursive_copy(dest->left, src->left);
     recursive_copy(dest->right, src->right);
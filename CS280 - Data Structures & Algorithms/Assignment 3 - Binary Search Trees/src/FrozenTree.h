@@ -0,0 +1,223 @@
+/************************************************************************************//*!
+ @file    FrozenTree.h
+ @author  Diren D Bharwani, 2002216, diren.dbharwani, diren.dbharwani@digipen.edu
+ @date    Mar 3, 2022
+ @brief   Contains the interface for the FrozenTree object, an immutable snapshot of a
+          BSTree laid out for fast reads.
+
+ Copyright (C) 2022 DigiPen Institute of Technology.
+ Reproduction or disclosure of this file or its contents without the prior written
+ consent of DigiPen Institute of Technology is prohibited.
+*//*************************************************************************************/
+
+#ifndef FROZENTREE_H
+#define FROZENTREE_H
+
+// Standard Libraries
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace frozen_tree_detail
+{
+    /********************************************************************************//*!
+    @brief     Allocates arrays that start on a cache line.
+
+    @tparam    T
+        The type of an element in the array.
+    *//*********************************************************************************/
+    template <typename T>
+    struct LineAllocator
+    {
+        using value_type = T;
+
+        static constexpr size_t Alignment = alignof(T) > 64 ? alignof(T) : 64;
+
+        LineAllocator() = default;
+        template <typename U>
+        LineAllocator(const LineAllocator<U>&) {}
+
+        /****************************************************************************//*!
+        @brief      Allocates an array with room in front for the address to free, which
+                    sits just before the aligned start.
+        *//*****************************************************************************/
+        T* allocate(size_t n)
+        {
+            char* raw       = static_cast<char*>(::operator new(n * sizeof(T) + Alignment + sizeof(void*)));
+            uintptr_t start = reinterpret_cast<uintptr_t>(raw + sizeof(void*) + Alignment - 1) & ~(Alignment - 1);
+            char* aligned   = reinterpret_cast<char*>(start);
+
+            reinterpret_cast<void**>(aligned)[-1] = raw;
+            return reinterpret_cast<T*>(aligned);
+        }
+        void deallocate(T* p, size_t)
+        {
+            ::operator delete(reinterpret_cast<void**>(p)[-1]);
+        }
+
+        template <typename U>
+        bool    operator==  (const LineAllocator<U>&) const { return true; }
+        template <typename U>
+        bool    operator!=  (const LineAllocator<U>&) const { return false; }
+    };
+}
+
+/************************************************************************************//*!
+ @brief     Encapsulates an immutable, pointer-free snapshot of a search tree.
+
+            The keys are stored twice. The search copy is in Eytzinger (breadth-first)
+            order, so a lookup walks down one array. The array starts on a cache line
+            and the root is at position 1, so the descendants log2(B) levels below a
+            key are the B keys that fill one line, when B keys are exactly a line
+            long. That line is fetched ahead of time.
+            The sorted copy answers rank queries and range iteration by indexing.
+
+ @tparam    T
+    The type of an element in the snapshot.
+*//*************************************************************************************/
+template <typename T>
+class FrozenTree
+{
+public:
+    /*---------------------------------------------------------------------------------*/
+    /* Constructors & Destructor                                                       */
+    /*---------------------------------------------------------------------------------*/
+    /********************************************************************************//*!
+    @brief      Default Constructor for an empty FrozenTree.
+    *//*********************************************************************************/
+    FrozenTree() = default;
+    /********************************************************************************//*!
+    @brief      Constructs a FrozenTree from sorted values.
+
+    @param      sorted
+        The values of the snapshot in ascending order, without duplicates.
+    *//*********************************************************************************/
+    explicit FrozenTree(std::vector<T>&& sorted);
+
+    /*---------------------------------------------------------------------------------*/
+    /* Operator Overloads                                                              */
+    /*---------------------------------------------------------------------------------*/
+    /********************************************************************************//*!
+    @brief      Index access operator for the FrozenTree.
+
+    @param      index
+        The index of the element in sorted order.
+
+    @returns    A pointer to the element at the index. nullptr if the index is out of
+                range, like BSTree::operator[].
+    *//*********************************************************************************/
+    const T*    operator[]  (int index)     const;
+
+    /*---------------------------------------------------------------------------------*/
+    /* Getter Functions                                                                */
+    /*---------------------------------------------------------------------------------*/
+    /********************************************************************************//*!
+    @brief      Gets the size of the snapshot.
+
+    @returns    The number of elements in the snapshot.
+    *//*********************************************************************************/
+    unsigned int    size    ()  const;
+    /********************************************************************************//*!
+    @brief      Checks if the snapshot is empty.
+
+    @returns    True if the snapshot is empty.
+    *//*********************************************************************************/
+    bool            empty   ()  const;
+    /********************************************************************************//*!
+    @brief      Gets the start of the elements in sorted order.
+
+    @returns    A pointer to the smallest element.
+    *//*********************************************************************************/
+    const T*        begin   ()  const;
+    /********************************************************************************//*!
+    @brief      Gets the end of the elements in sorted order.
+
+    @returns    A pointer past the largest element.
+    *//*********************************************************************************/
+    const T*        end     ()  const;
+
+    /*---------------------------------------------------------------------------------*/
+    /* Function Members                                                                */
+    /*---------------------------------------------------------------------------------*/
+    /********************************************************************************//*!
+    @brief      Finds an element in the snapshot.
+
+    @param      value
+        The value to search for.
+
+    @returns    True if the value is found.
+    *//*********************************************************************************/
+    bool        find        (const T& value)                        const;
+    /********************************************************************************//*!
+    @brief      Gets the rank of the first element that is not less than a value.
+
+    @param      value
+        The value to search for.
+
+    @returns    The index of the element. size() if every element is less than value.
+    *//*********************************************************************************/
+    unsigned    lower_bound (const T& value)                        const;
+    /********************************************************************************//*!
+    @brief      Gets the rank of the first element that is greater than a value.
+
+    @param      value
+        The value to search for.
+
+    @returns    The index of the element. size() if no element is greater than value.
+    *//*********************************************************************************/
+    unsigned    upper_bound (const T& value)                        const;
+    /********************************************************************************//*!
+    @brief      Gets the first element that is not less than low. Iterating from it up
+                to the returned end visits every element in [low, high].
+
+    @param      low
+        The smallest value in the range.
+    @param      high
+        The largest value in the range.
+    @param      last
+        Set to a pointer past the last element in the range.
+
+    @returns    A pointer to the first element in the range.
+    *//*********************************************************************************/
+    const T*    range       (const T& low, const T& high, const T*& last)   const;
+
+private:
+    /*---------------------------------------------------------------------------------*/
+    /* Data Members                                                                    */
+    /*---------------------------------------------------------------------------------*/
+    std::vector<T>          sortedKeys;     //!< The elements in ascending order
+    std::vector<T, frozen_tree_detail::LineAllocator<T>>
+                            searchKeys;     //!< The elements in Eytzinger order from 1
+    std::vector<unsigned>   searchRanks;    //!< The rank of each element in searchKeys
+
+    /*---------------------------------------------------------------------------------*/
+    /* Function Members                                                                */
+    /*---------------------------------------------------------------------------------*/
+    /********************************************************************************//*!
+    @brief      Fills the Eytzinger arrays with an in-order walk of the implicit tree.
+
+    @param      node
+        The position of the node in the Eytzinger arrays.
+    @param      rank
+        The next rank to place.
+    *//*********************************************************************************/
+    void        layout      (size_t node, unsigned& rank);
+    /********************************************************************************//*!
+    @brief      Searches the Eytzinger array for the first element that is not less
+                than (or greater than) a value.
+
+    @param      value
+        The value to search for.
+    @param      inclusive
+        True to find the first element not less than value, false for the first
+        element greater than value.
+
+    @returns    The position of the element in the Eytzinger arrays. 0 if there is no
+                such element.
+    *//*********************************************************************************/
+    size_t      search      (const T& value, bool inclusive)        const;
+};
+
+#include "FrozenTree.hpp"
+
+#endif
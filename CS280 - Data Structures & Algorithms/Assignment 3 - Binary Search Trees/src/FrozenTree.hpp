@@ -0,0 +1,276 @@
+/************************************************************************************//*!
+ @file    FrozenTree.cpp
+ @author  Diren D Bharwani, 2002216, diren.dbharwani, diren.dbharwani@digipen.edu
+ @date    Mar 3, 2022
+ @brief   Contains the implementation for the FrozenTree object.
+
+ Copyright (C) 2022 DigiPen Institute of Technology.
+ Reproduction or disclosure of this file or its contents without the prior written
+ consent of DigiPen Institute of Technology is prohibited.
+*//*************************************************************************************/
+
+// Primary Header
+#include "FrozenTree.h"
+// Standard Libraries
+#include <algorithm>
+#if defined(_MSC_VER)
+#include <xmmintrin.h>
+#endif
+
+/*-------------------------------------------------------------------------------------*/
+/* Local Helpers                                                                       */
+/*-------------------------------------------------------------------------------------*/
+namespace frozen_tree_detail
+{
+    /********************************************************************************//*!
+    @brief      Gets the number of keys of a given size that fit in a cache line,
+                rounded down to a power of two.
+
+    @param      keySize
+        The size of a key.
+
+    @returns    The number of keys. At least 1.
+    *//*********************************************************************************/
+    constexpr size_t keysPerLine(size_t keySize, size_t line = 64)
+    {
+        return (keySize * 2 > line) ? 1 : 2 * keysPerLine(keySize * 2, line);
+    }
+
+    /********************************************************************************//*!
+    @brief      Hints the processor to load an address into the cache.
+
+    @param      address
+        The address to load.
+    *//*********************************************************************************/
+    inline void prefetch(const void* address)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(address);
+#elif defined(_MSC_VER)
+        _mm_prefetch(static_cast<const char*>(address), _MM_HINT_T0);
+#else
+        (void)address;
+#endif
+    }
+}
+
+/*-------------------------------------------------------------------------------------*/
+/* Constructors & Destructors                                                          */
+/*-------------------------------------------------------------------------------------*/
+/************************************************************************************//*!
+ @brief      Constructs a FrozenTree from sorted values.
+
+ @param      sorted
+    The values of the snapshot in ascending order, without duplicates.
+*//*************************************************************************************/
+template <typename T>
+FrozenTree<T>::FrozenTree(std::vector<T>&& sorted)
+: sortedKeys    { std::move(sorted) }
+, searchKeys    ( sortedKeys.size() + 1 )
+, searchRanks   ( sortedKeys.size() + 1 )
+{
+    unsigned rank = 0;
+    layout(1, rank);
+}
+
+/*-------------------------------------------------------------------------------------*/
+/* Operator Overloads                                                                  */
+/*-------------------------------------------------------------------------------------*/
+/************************************************************************************//*!
+ @brief      Index access operator for the FrozenTree.
+
+ @param      index
+    The index of the element in sorted order.
+
+ @returns    A pointer to the element at the index. nullptr if the index is out of
+             range.
+*//*************************************************************************************/
+template <typename T>
+const T* FrozenTree<T>::operator[](int index) const
+{
+    if (index < 0 || static_cast<size_t>(index) >= sortedKeys.size())
+        return nullptr;
+
+    return &sortedKeys[index];
+}
+
+/*-------------------------------------------------------------------------------------*/
+/* Public Function Members                                                             */
+/*-------------------------------------------------------------------------------------*/
+/************************************************************************************//*!
+ @brief      Gets the size of the snapshot.
+
+ @returns    The number of elements in the snapshot.
+*//*************************************************************************************/
+template <typename T>
+unsigned int FrozenTree<T>::size() const
+{
+    return static_cast<unsigned>(sortedKeys.size());
+}
+/************************************************************************************//*!
+ @brief      Checks if the snapshot is empty.
+
+ @returns    True if the snapshot is empty.
+*//*************************************************************************************/
+template <typename T>
+bool FrozenTree<T>::empty() const
+{
+    return sortedKeys.empty();
+}
+/************************************************************************************//*!
+ @brief      Gets the start of the elements in sorted order.
+
+ @returns    A pointer to the smallest element.
+*//*************************************************************************************/
+template <typename T>
+const T* FrozenTree<T>::begin() const
+{
+    return sortedKeys.data();
+}
+/************************************************************************************//*!
+ @brief      Gets the end of the elements in sorted order.
+
+ @returns    A pointer past the largest element.
+*//*************************************************************************************/
+template <typename T>
+const T* FrozenTree<T>::end() const
+{
+    return sortedKeys.data() + sortedKeys.size();
+}
+/************************************************************************************//*!
+ @brief      Finds an element in the snapshot.
+
+ @param      value
+    The value to search for.
+
+ @returns    True if the value is found.
+*//*************************************************************************************/
+template <typename T>
+bool FrozenTree<T>::find(const T& value) const
+{
+    const size_t node = search(value, true);
+    return node != 0 && !(value < searchKeys[node]);
+}
+/************************************************************************************//*!
+ @brief      Gets the rank of the first element that is not less than a value.
+
+ @param      value
+    The value to search for.
+
+ @returns    The index of the element. size() if every element is less than value.
+*//*************************************************************************************/
+template <typename T>
+unsigned FrozenTree<T>::lower_bound(const T& value) const
+{
+    const size_t node = search(value, true);
+    return node ? searchRanks[node] : size();
+}
+/************************************************************************************//*!
+ @brief      Gets the rank of the first element that is greater than a value.
+
+ @param      value
+    The value to search for.
+
+ @returns    The index of the element. size() if no element is greater than value.
+*//*************************************************************************************/
+template <typename T>
+unsigned FrozenTree<T>::upper_bound(const T& value) const
+{
+    const size_t node = search(value, false);
+    return node ? searchRanks[node] : size();
+}
+/************************************************************************************//*!
+ @brief      Gets the first element that is not less than low.
+
+ @param      low
+    The smallest value in the range.
+ @param      high
+    The largest value in the range.
+ @param      last
+    Set to a pointer past the last element in the range.
+
+ @returns    A pointer to the first element in the range.
+*//*************************************************************************************/
+template <typename T>
+const T* FrozenTree<T>::range(const T& low, const T& high, const T*& last) const
+{
+    const T* first = begin() + lower_bound(low);
+    last = std::max(first, begin() + upper_bound(high));
+
+    return first;
+}
+
+/*-------------------------------------------------------------------------------------*/
+/* Private Function Members                                                            */
+/*-------------------------------------------------------------------------------------*/
+/************************************************************************************//*!
+ @brief      Fills the Eytzinger arrays with an in-order walk of the implicit tree.
+
+ @param      node
+    The position of the node in the Eytzinger arrays.
+ @param      rank
+    The next rank to place.
+*//*************************************************************************************/
+template <typename T>
+void FrozenTree<T>::layout(size_t node, unsigned& rank)
+{
+    if (node > sortedKeys.size())
+        return;
+
+    layout(2 * node, rank);
+
+    searchKeys[node]    = sortedKeys[rank];
+    searchRanks[node]   = rank;
+    ++rank;
+
+    layout(2 * node + 1, rank);
+}
+/************************************************************************************//*!
+ @brief      Searches the Eytzinger array for the first element that is not less than
+             (or greater than) a value.
+
+ @param      value
+    The value to search for.
+ @param      inclusive
+    True to find the first element not less than value, false for the first element
+    greater than value.
+
+ @returns    The position of the element in the Eytzinger arrays. 0 if there is no
+             such element.
+*//*************************************************************************************/
+template <typename T>
+size_t FrozenTree<T>::search(const T& value, bool inclusive) const
+{
+    // The descendants of node k that are log2(Block) levels down are the Block keys
+    // starting at k * Block, so they are fetched while the levels above are compared.
+    const size_t    Block   = frozen_tree_detail::keysPerLine(sizeof(T));
+    const size_t    Count   = sortedKeys.size();
+    const T*        keys    = searchKeys.data();
+
+    size_t node = 1;
+    if (inclusive)
+    {
+        while (node <= Count)
+        {
+            frozen_tree_detail::prefetch(keys + std::min(node * Block, Count));
+
+            // No branch on the comparison, the next node is picked arithmetically
+            node = 2 * node + (keys[node] < value);
+        }
+    }
+    else
+    {
+        while (node <= Count)
+        {
+            frozen_tree_detail::prefetch(keys + std::min(node * Block, Count));
+            node = 2 * node + !(value < keys[node]);
+        }
+    }
+
+    // The answer is the last node where the walk went left. Every right turn after it
+    // appended a 1 to node, and the left turn itself appended a 0.
+    while (node & 1)
+        node >>= 1;
+
+    return node >> 1;
+}
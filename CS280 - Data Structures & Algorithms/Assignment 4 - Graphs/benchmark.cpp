@@ -0,0 +1,566 @@
+/************************************************************************************//*!
+ @file    benchmark.cpp
+ @author  Diren D Bharwani, 2002216, diren.dbharwani, diren.dbharwani@digipen.edu
+ @date    Mar 3, 2022
+ @brief   Contains the implementation of the ALGraph benchmarks.
+ 
+ Copyright (C) 2022 DigiPen Institute of Technology.
+ Reproduction or disclosure of this file or its contents without the prior written 
+ consent of DigiPen Institute of Technology is prohibited.
+*//*************************************************************************************/
+
+// Primary Header
+#include "benchmark.h"
+// Standard Libraries
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <memory>
+#include <string>
+#include <cstdio>
+// Project Headers
+#include "src/ALGraph.h"
+#include "src/FrozenGraph.h"
+#include "src/ContractionHierarchy.h"
+
+/*-------------------------------------------------------------------------------------*/
+/* Local Helpers                                                                       */
+/*-------------------------------------------------------------------------------------*/
+namespace
+{
+    const int   NUM_SOURCES = 3;    //!< searches timed on every graph
+    const int   NUM_QUERIES = 200;  //!< point-to-point queries timed on every graph
+    const int   NUM_CHECKS  = 3;    //!< sources whose every query is checked
+    const int   NUM_DEPOTS  = 256;  //!< sources of every distance matrix
+    const int   NUM_DROPS   = 2048; //!< targets of every distance matrix
+
+    /********************************************************************************//*!
+    @brief      Times a callable.
+
+    @param      work
+        The callable to time.
+
+    @returns    The elapsed time in milliseconds.
+    *//*********************************************************************************/
+    template <typename Work>
+    double timeMilliseconds(Work work)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        work();
+        const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+        return elapsed.count();
+    }
+
+    /********************************************************************************//*!
+    @brief      Creates a square grid with random weights, like a road network.
+
+    @param      side
+        The number of vertices along each side.
+    @param      rng
+        The random number generator for the weights.
+
+    @returns    The graph.
+    *//*********************************************************************************/
+    std::unique_ptr<ALGraph> makeGrid(unsigned side, std::mt19937& rng)
+    {
+        std::uniform_int_distribution<unsigned> weightDist(1, 100);
+        std::unique_ptr<ALGraph> graph{ new ALGraph(side * side) };
+
+        for (unsigned y = 0; y < side; ++y)
+        {
+            for (unsigned x = 0; x < side; ++x)
+            {
+                const unsigned id = y * side + x + 1;
+                if (x + 1 < side)
+                    graph->AddUEdge(id, id + 1, weightDist(rng));
+                if (y + 1 < side)
+                    graph->AddUEdge(id, id + side, weightDist(rng));
+            }
+        }
+
+        return graph;
+    }
+    /********************************************************************************//*!
+    @brief      Creates a random sparse graph with random weights.
+
+    @param      vertices
+        The number of vertices.
+    @param      degree
+        The average number of undirected edges at each vertex.
+    @param      rng
+        The random number generator for the edges and weights.
+
+    @returns    The graph.
+    *//*********************************************************************************/
+    std::unique_ptr<ALGraph> makeRandom(unsigned vertices, unsigned degree, std::mt19937& rng)
+    {
+        std::uniform_int_distribution<unsigned> vertexDist(1, vertices);
+        std::uniform_int_distribution<unsigned> weightDist(1, 1000);
+        std::unique_ptr<ALGraph> graph{ new ALGraph(vertices) };
+
+        for (unsigned i = 0; i < vertices * degree / 2; ++i)
+            graph->AddUEdge(vertexDist(rng), vertexDist(rng), weightDist(rng));
+
+        return graph;
+    }
+    /********************************************************************************//*!
+    @brief      Creates a dense directed graph with random weights.
+
+    @param      vertices
+        The number of vertices.
+    @param      degree
+        The number of edges out of every vertex.
+    @param      rng
+        The random number generator for the edges and weights.
+
+    @returns    The graph.
+    *//*********************************************************************************/
+    std::unique_ptr<ALGraph> makeDense(unsigned vertices, unsigned degree, std::mt19937& rng)
+    {
+        std::uniform_int_distribution<unsigned> vertexDist(1, vertices);
+        std::uniform_int_distribution<unsigned> weightDist(1, 100);
+        std::unique_ptr<ALGraph> graph{ new ALGraph(vertices) };
+
+        for (unsigned v = 1; v <= vertices; ++v)
+        {
+            for (unsigned i = 0; i < degree; ++i)
+                graph->AddDEdge(v, vertexDist(rng), weightDist(rng));
+        }
+
+        return graph;
+    }
+    /********************************************************************************//*!
+    @brief      Times every search on a graph and prints a row of results.
+
+    @param      name
+        The name of the graph.
+    @param      graph
+        The graph to search.
+    @param      rng
+        The random number generator for the sources.
+    *//*********************************************************************************/
+    void benchmarkGraph(const std::string& name, const ALGraph& graph, std::mt19937& rng)
+    {
+        FrozenGraph frozen;
+        const double freezeTime = timeMilliseconds([&]() { frozen = graph.Freeze(); });
+
+        const unsigned threads = std::max(std::thread::hardware_concurrency(), 1u);
+        std::uniform_int_distribution<unsigned> sourceDist(1, frozen.VertexCount());
+
+        double dijkstraTime = 0.0, singleTime = 0.0, parallelTime = 0.0;
+        bool same = true;
+
+        for (int i = 0; i < NUM_SOURCES; ++i)
+        {
+            const unsigned source = sourceDist(rng);
+            ALGraph::DijkstraResult expected, single, parallel;
+
+            dijkstraTime    += timeMilliseconds([&]() { expected = graph.Dijkstra(source); });
+            singleTime      += timeMilliseconds([&]() { single = frozen.DeltaStepping(source, 0, 1); });
+            parallelTime    += timeMilliseconds([&]() { parallel = frozen.DeltaStepping(source, 0, threads); });
+
+            for (size_t v = 0; v < expected.size(); ++v)
+            {
+                same = same && expected[v].cost == single[v].cost   && expected[v].path == single[v].path
+                            && expected[v].cost == parallel[v].cost && expected[v].path == parallel[v].path;
+            }
+        }
+
+        std::cout << std::fixed << std::setprecision(1)
+                  << std::setw(14) << name
+                  << std::setw(10) << frozen.VertexCount()
+                  << std::setw(10) << frozen.EdgeCount()
+                  << std::setw(10) << freezeTime
+                  << std::setw(12) << dijkstraTime / NUM_SOURCES
+                  << std::setw(12) << singleTime / NUM_SOURCES
+                  << std::setw(12) << parallelTime / NUM_SOURCES
+                  << std::setw(8)  << (same ? "yes" : "NO") << '\n';
+    }
+    /********************************************************************************//*!
+    @brief      Checks delta-stepping against ALGraph::Dijkstra on small graphs with
+                ties through zero weight edges, and with weights far wider than delta.
+
+    @returns    True if every cost and path is the same.
+    *//*********************************************************************************/
+    bool checkDeltaStepping()
+    {
+        // Vertex 5 is as short through 3 as through 4. Dijkstra reaches 3 through a
+        // zero weight edge from 2, and settles it before 4.
+        ALGraph ties(5);
+        ties.AddDEdge(1, 2, 1);
+        ties.AddDEdge(1, 4, 1);
+        ties.AddDEdge(2, 3, 0);
+        ties.AddDEdge(3, 5, 1);
+        ties.AddDEdge(4, 5, 1);
+
+        // With a delta of 1, these weights span hundreds of millions of buckets
+        ALGraph wide(4);
+        wide.AddUEdge(1, 2, 1u << 28);
+        wide.AddUEdge(2, 3, (1u << 28) - 1);
+        wide.AddUEdge(1, 3, 3);
+        wide.AddUEdge(3, 4, 1u << 27);
+
+        bool same = true;
+        for (const ALGraph* graph : { &ties, &wide })
+        {
+            const FrozenGraph               frozen      = graph->Freeze();
+            const ALGraph::DijkstraResult   expected    = graph->Dijkstra(1);
+
+            for (unsigned threads : { 1u, 4u })
+            {
+                const ALGraph::DijkstraResult result = frozen.DeltaStepping(1, 1, threads);
+                for (size_t v = 0; v < expected.size(); ++v)
+                    same = same && expected[v].cost == result[v].cost && expected[v].path == result[v].path;
+            }
+        }
+
+        return same;
+    }
+    /********************************************************************************//*!
+    @brief      Checks that a path is made of edges of the graph and costs what it
+                claims to.
+
+    @param      list
+        The adjacency list of the graph.
+    @param      info
+        The cost and path to check.
+    @param      source
+        The first node the path must have.
+    @param      target
+        The last node the path must have.
+
+    @returns    True if the path is valid.
+    *//*********************************************************************************/
+    bool isValidPath(const ALIST& list, const DijkstraInfo& info, unsigned source, unsigned target)
+    {
+        if (info.cost == static_cast<unsigned>(-1))
+            return info.path.empty();
+        if (info.path.empty() || info.path.front() != source || info.path.back() != target)
+            return false;
+
+        unsigned long long cost = 0;
+        for (size_t i = 0; i + 1 < info.path.size(); ++i)
+        {
+            unsigned best = static_cast<unsigned>(-1);
+            for (const AdjacencyInfo& edge : list[info.path[i] - 1])
+            {
+                if (edge.id == info.path[i + 1])
+                    best = std::min(best, edge.weight);
+            }
+
+            if (best == static_cast<unsigned>(-1))
+                return false;
+            cost += best;
+        }
+
+        return cost == info.cost;
+    }
+    /********************************************************************************//*!
+    @brief      Times point-to-point queries on a graph and prints a row of results.
+                Every query is checked against ALGraph::Dijkstra, by cost, since
+                several paths can be as short.
+
+    @param      name
+        The name of the graph.
+    @param      graph
+        The graph to search.
+    @param      rng
+        The random number generator for the queries.
+    @param      withDijkstra
+        False to skip timing ALGraph::Dijkstra, whose paths to every vertex don't
+        fit in memory on large grids.
+    *//*********************************************************************************/
+    void benchmarkQueries(const std::string& name, const ALGraph& graph, std::mt19937& rng, bool withDijkstra)
+    {
+        const FrozenGraph frozen = graph.Freeze();
+        const ALIST list = graph.GetAList();
+        std::uniform_int_distribution<unsigned> vertexDist(1, frozen.VertexCount());
+
+        ContractionHierarchy hierarchy;
+        const double buildTime = timeMilliseconds([&]() { hierarchy = ContractionHierarchy(frozen); });
+
+        const std::string fileName = "ch_benchmark.bin";
+        ContractionHierarchy loaded;
+        const double saveLoadTime = timeMilliseconds([&]() { hierarchy.Save(fileName) && loaded.Load(fileName); });
+        std::remove(fileName.c_str());
+
+        bool same = loaded.VertexCount() == hierarchy.VertexCount();
+
+        // Every query from a few sources is checked against a full search
+        for (int i = 0; i < NUM_CHECKS && withDijkstra; ++i)
+        {
+            const unsigned source = vertexDist(rng);
+            const ALGraph::DijkstraResult expected = graph.Dijkstra(source);
+
+            for (unsigned target = 1; target <= frozen.VertexCount(); target += 1 + frozen.VertexCount() / 512)
+            {
+                const DijkstraInfo bidirectional    = frozen.ShortestPath(source, target);
+                const DijkstraInfo contracted       = loaded.Query(source, target);
+
+                same = same && bidirectional.cost == expected[target - 1].cost && isValidPath(list, bidirectional, source, target)
+                            && contracted.cost == expected[target - 1].cost    && isValidPath(list, contracted, source, target);
+            }
+        }
+
+        std::vector<std::pair<unsigned, unsigned>> queries(NUM_QUERIES);
+        for (auto& query : queries)
+            query = std::make_pair(vertexDist(rng), vertexDist(rng));
+
+        double dijkstraTime = 0.0;
+        for (int i = 0; i < NUM_SOURCES && withDijkstra; ++i)
+            dijkstraTime += timeMilliseconds([&]() { graph.Dijkstra(queries[i].first); });
+
+        std::vector<DijkstraInfo> bidirectional(NUM_QUERIES), contracted(NUM_QUERIES);
+        const double bidirectionalTime = timeMilliseconds([&]()
+        {
+            for (int i = 0; i < NUM_QUERIES; ++i)
+                bidirectional[i] = frozen.ShortestPath(queries[i].first, queries[i].second);
+        });
+        const double contractedTime = timeMilliseconds([&]()
+        {
+            for (int i = 0; i < NUM_QUERIES; ++i)
+                contracted[i] = hierarchy.Query(queries[i].first, queries[i].second);
+        });
+
+        for (int i = 0; i < NUM_QUERIES; ++i)
+            same = same && bidirectional[i].cost == contracted[i].cost;
+
+        std::cout << std::fixed << std::setprecision(1)
+                  << std::setw(14) << name
+                  << std::setw(10) << frozen.VertexCount();
+        if (withDijkstra)
+            std::cout << std::setw(12) << dijkstraTime / NUM_SOURCES * 1000.0;
+        else
+            std::cout << std::setw(12) << "-";
+        std::cout << std::setw(10) << bidirectionalTime / NUM_QUERIES * 1000.0
+                  << std::setw(10) << buildTime
+                  << std::setw(11) << hierarchy.ShortcutCount()
+                  << std::setw(10) << saveLoadTime
+                  << std::setw(8)  << contractedTime / NUM_QUERIES * 1000.0
+                  << std::setw(8)  << (same ? "yes" : "NO") << '\n';
+    }
+    /********************************************************************************//*!
+    @brief      Times ALGraph::Dijkstra and ALGraph::DijkstraTree on every queue, and
+                prints a row of results with the memory each result takes.
+
+    @param      name
+        The name of the graph.
+    @param      graph
+        The graph to search.
+    @param      rng
+        The random number generator for the sources.
+    *//*********************************************************************************/
+    void benchmarkQueues(const std::string& name, const ALGraph& graph, std::mt19937& rng)
+    {
+        using QueueType = ALGraph::QueueType;
+        const QueueType QUEUES[] = { QueueType::BINARY_HEAP, QueueType::DARY_HEAP, QueueType::DIAL_BUCKETS, QueueType::RADIX_HEAP };
+
+        const ALIST list = graph.GetAList();
+        size_t edges = 0;
+        for (const auto& EDGES : list)
+            edges += EDGES.size();
+
+        std::uniform_int_distribution<unsigned> sourceDist(1, static_cast<unsigned>(list.size()));
+
+        double dijkstraTime = 0.0, queueTimes[4] = {};
+        size_t dijkstraBytes = 0, treeBytes = 0;
+        bool same = true;
+
+        for (int i = 0; i < NUM_SOURCES; ++i)
+        {
+            const unsigned source = sourceDist(rng);
+            ALGraph::DijkstraResult expected;
+            dijkstraTime += timeMilliseconds([&]() { expected = graph.Dijkstra(source); });
+
+            dijkstraBytes = expected.capacity() * sizeof(DijkstraInfo);
+            for (const DijkstraInfo& INFO : expected)
+                dijkstraBytes += INFO.path.capacity() * sizeof(unsigned);
+
+            for (int q = 0; q < 4; ++q)
+            {
+                ShortestPathTree tree;
+                queueTimes[q] += timeMilliseconds([&]() { tree = graph.DijkstraTree(source, QUEUES[q]); });
+                treeBytes = (tree.costs.capacity() + tree.predecessors.capacity()) * sizeof(unsigned);
+
+                // Only the heaps settle ties in the same order as Dijkstra
+                const bool SAME_PATHS = QUEUES[q] == QueueType::BINARY_HEAP || QUEUES[q] == QueueType::DARY_HEAP;
+                for (unsigned v = 1; v <= expected.size(); ++v)
+                {
+                    same = same && tree.costs[v - 1] == expected[v - 1].cost;
+                    if (SAME_PATHS && i == 0)
+                        same = same && tree.Path(v) == expected[v - 1].path;
+                }
+            }
+        }
+
+        std::cout << std::fixed << std::setprecision(1)
+                  << std::setw(14) << name
+                  << std::setw(10) << list.size()
+                  << std::setw(10) << edges
+                  << std::setw(10) << dijkstraTime / NUM_SOURCES
+                  << std::setw(10) << dijkstraBytes / (1024.0 * 1024.0);
+        for (double time : queueTimes)
+            std::cout << std::setw(9) << time / NUM_SOURCES;
+        std::cout << std::setw(9)  << treeBytes / (1024.0 * 1024.0)
+                  << std::setw(8)  << (same ? "yes" : "NO") << '\n';
+    }
+    /********************************************************************************//*!
+    @brief      Times a distance matrix on a growing number of threads, and prints a
+                row of results. Calling ALGraph::Dijkstra once per source is timed on
+                a few sources and scaled up, and the rows of those sources are checked.
+
+    @param      name
+        The name of the graph.
+    @param      graph
+        The graph to search.
+    @param      rng
+        The random number generator for the sources and targets.
+    *//*********************************************************************************/
+    void benchmarkMatrix(const std::string& name, const ALGraph& graph, std::mt19937& rng)
+    {
+        const FrozenGraph frozen = graph.Freeze();
+        std::uniform_int_distribution<unsigned> vertexDist(1, frozen.VertexCount());
+
+        std::vector<unsigned> sources(NUM_DEPOTS), targets(NUM_DROPS);
+        for (unsigned& source : sources)
+            source = vertexDist(rng);
+        for (unsigned& target : targets)
+            target = vertexDist(rng);
+
+        std::vector<unsigned> matrix;
+        const double singleTime = timeMilliseconds([&]() { matrix = frozen.DistanceMatrix(sources, targets, 1); });
+
+        bool same = true;
+        double dijkstraTime = 0.0;
+        for (int i = 0; i < NUM_SOURCES; ++i)
+        {
+            ALGraph::DijkstraResult expected;
+            dijkstraTime += timeMilliseconds([&]() { expected = graph.Dijkstra(sources[i]); });
+
+            for (int j = 0; j < NUM_DROPS; ++j)
+                same = same && matrix[i * NUM_DROPS + j] == expected[targets[j] - 1].cost;
+        }
+
+        std::cout << std::fixed << std::setprecision(1)
+                  << std::setw(14) << name
+                  << std::setw(10) << frozen.VertexCount()
+                  << std::setw(12) << dijkstraTime / NUM_SOURCES * NUM_DEPOTS
+                  << std::setw(10) << singleTime;
+
+        const unsigned hardware = std::max(std::thread::hardware_concurrency(), 1u);
+        double parallelTime = singleTime;
+        for (unsigned threads : { 2u, 4u, hardware })
+        {
+            std::vector<unsigned> parallel;
+            parallelTime = timeMilliseconds([&]() { parallel = frozen.DistanceMatrix(sources, targets, threads); });
+            same = same && parallel == matrix;
+
+            std::cout << std::setw(10) << parallelTime;
+        }
+
+        std::cout << std::setw(9) << singleTime / parallelTime
+                  << std::setw(8) << (same ? "yes" : "NO") << '\n';
+    }
+}
+
+/*-------------------------------------------------------------------------------------*/
+/* Function Definitions                                                                */
+/*-------------------------------------------------------------------------------------*/
+
+/************************************************************************************//*!
+ @brief     Measures ALGraph::Dijkstra against delta-stepping on a frozen snapshot, on
+            synthetic road-like grids and random sparse graphs.
+*//*************************************************************************************/
+void BenchmarkDeltaStepping()
+{
+    std::mt19937 rng(280);
+
+    // Every search copies a path for every vertex, so grids, with their long paths,
+    // are kept small enough for the results to fit in memory
+    std::cout << "Single source shortest paths (ms/search), "
+              << std::max(std::thread::hardware_concurrency(), 1u) << " hardware threads\n";
+    std::cout << std::setw(14) << "graph"
+              << std::setw(10) << "vertices"  << std::setw(10) << "edges"
+              << std::setw(10) << "freeze"    << std::setw(12) << "dijkstra"
+              << std::setw(12) << "delta x1"  << std::setw(12) << "delta xN"
+              << std::setw(8)  << "same" << '\n';
+
+    for (unsigned side : { 64u, 128u, 256u })
+        benchmarkGraph("grid " + std::to_string(side), *makeGrid(side, rng), rng);
+
+    for (unsigned power : { 14u, 17u, 20u })
+        benchmarkGraph("random 2^" + std::to_string(power), *makeRandom(1u << power, 8, rng), rng);
+
+    std::cout << "Zero weight ties and wide weights, same: " << (checkDeltaStepping() ? "yes" : "NO") << '\n';
+}
+/************************************************************************************//*!
+ @brief     Measures point-to-point queries with ALGraph::Dijkstra, bidirectional
+            Dijkstra and a contraction hierarchy, and checks every query against
+            ALGraph::Dijkstra.
+*//*************************************************************************************/
+void BenchmarkPointToPoint()
+{
+    std::mt19937 rng(2803);
+
+    std::cout << "\nPoint-to-point queries (us/query), hierarchy build and save+load (ms)\n";
+    std::cout << std::setw(14) << "graph"
+              << std::setw(10) << "vertices"  << std::setw(12) << "dijkstra"
+              << std::setw(10) << "bidir"     << std::setw(10) << "ch build"
+              << std::setw(11) << "shortcuts" << std::setw(10) << "save+load"
+              << std::setw(8)  << "ch"        << std::setw(8)  << "same" << '\n';
+
+    for (unsigned side : { 64u, 128u, 256u, 512u })
+        benchmarkQueries("grid " + std::to_string(side), *makeGrid(side, rng), rng, side <= 256);
+
+    // Random graphs have no hierarchy to find, so the hierarchy is slow to build and
+    // they are kept small
+    for (unsigned power : { 10u, 12u })
+        benchmarkQueries("random 2^" + std::to_string(power), *makeRandom(1u << power, 4, rng), rng, true);
+}
+/************************************************************************************//*!
+ @brief     Measures the time and result memory of ALGraph::Dijkstra against
+            ALGraph::DijkstraTree on every priority queue, on dense and sparse graphs.
+*//*************************************************************************************/
+void BenchmarkDijkstraQueues()
+{
+    std::mt19937 rng(2804);
+
+    std::cout << "\nSingle source shortest paths (ms/search, MB/result)\n";
+    std::cout << std::setw(14) << "graph"
+              << std::setw(10) << "vertices"  << std::setw(10) << "edges"
+              << std::setw(10) << "dijkstra"  << std::setw(10) << "MB"
+              << std::setw(9)  << "binary"    << std::setw(9)  << "4-ary"
+              << std::setw(9)  << "dial"      << std::setw(9)  << "radix"
+              << std::setw(9)  << "tree MB"   << std::setw(8)  << "same" << '\n';
+
+    for (unsigned side : { 128u, 256u })
+        benchmarkQueues("grid " + std::to_string(side), *makeGrid(side, rng), rng);
+
+    for (unsigned power : { 16u, 18u })
+        benchmarkQueues("random 2^" + std::to_string(power), *makeRandom(1u << power, 8, rng), rng);
+
+    for (unsigned vertices : { 1024u, 2048u })
+        benchmarkQueues("dense " + std::to_string(vertices), *makeDense(vertices, vertices / 8, rng), rng);
+}
+/************************************************************************************//*!
+ @brief     Measures FrozenGraph::DistanceMatrix on a growing number of threads against
+            calling ALGraph::Dijkstra once per source.
+*//*************************************************************************************/
+void BenchmarkDistanceMatrix()
+{
+    std::mt19937 rng(2805);
+
+    std::cout << "\n" << NUM_DEPOTS << " x " << NUM_DROPS << " distance matrix (ms), "
+              << std::max(std::thread::hardware_concurrency(), 1u) << " hardware threads\n";
+    std::cout << std::setw(14) << "graph"
+              << std::setw(10) << "vertices"  << std::setw(12) << "dijkstra"
+              << std::setw(10) << "x1"        << std::setw(10) << "x2"
+              << std::setw(10) << "x4"        << std::setw(10) << "xN"
+              << std::setw(9)  << "speedup"   << std::setw(8)  << "same" << '\n';
+
+    benchmarkMatrix("grid 512", *makeGrid(512, rng), rng);
+    benchmarkMatrix("random 2^18", *makeRandom(1u << 18, 8, rng), rng);
+}
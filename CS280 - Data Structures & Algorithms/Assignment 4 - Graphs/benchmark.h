@@ -0,0 +1,41 @@
+/************************************************************************************//*!
+ @file    benchmark.h
+ @author  Diren D Bharwani, 2002216, diren.dbharwani, diren.dbharwani@digipen.edu
+ @date    Mar 3, 2022
+ @brief   Contains the interface for the ALGraph benchmarks.
+ 
+ Copyright (C) 2022 DigiPen Institute of Technology.
+ Reproduction or disclosure of this file or its contents without the prior written 
+ consent of DigiPen Institute of Technology is prohibited.
+*//*************************************************************************************/
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+/*-------------------------------------------------------------------------------------*/
+/* Function Declarations                                                               */
+/*-------------------------------------------------------------------------------------*/
+
+/************************************************************************************//*!
+ @brief     Measures ALGraph::Dijkstra against delta-stepping on a frozen snapshot, on
+            synthetic road-like grids and random sparse graphs.
+*//*************************************************************************************/
+void BenchmarkDeltaStepping();
+/************************************************************************************//*!
+ @brief     Measures point-to-point queries with ALGraph::Dijkstra, bidirectional
+            Dijkstra and a contraction hierarchy, and checks every query against
+            ALGraph::Dijkstra.
+*//*************************************************************************************/
+void BenchmarkPointToPoint();
+/************************************************************************************//*!
+ @brief     Measures the time and result memory of ALGraph::Dijkstra against
+            ALGraph::DijkstraTree on every priority queue, on dense and sparse graphs.
+*//*************************************************************************************/
+void BenchmarkDijkstraQueues();
+/************************************************************************************//*!
+ @brief     Measures FrozenGraph::DistanceMatrix on a growing number of threads against
+            calling ALGraph::Dijkstra once per source.
+*//*************************************************************************************/
+void BenchmarkDistanceMatrix();
+
+#endif
@@ -1,5 +1,9 @@
+#include "benchmark.h"
 
 int main()
 {
-    
-}
\ No newline at end of file
+    BenchmarkDeltaStepping();
+    BenchmarkPointToPoint();
+    BenchmarkDijkstraQueues();
+    BenchmarkDistanceMatrix();
+}
@@ -14,6 +14,15 @@
 #include <queue>
 // Primary Header
 #include "ALGraph.h"
+// Project Headers
+#include "FrozenGraph.h"
+#include "IntegerQueues.h"
+
+/*-------------------------------------------------------------------------------------*/
+/* Static Data Members                                                                 */
+/*-------------------------------------------------------------------------------------*/
+constexpr unsigned ALGraph::INF;
+constexpr unsigned ALGraph::DIAL_LIMIT;
 
 /*-------------------------------------------------------------------------------------*/
 /* Constructors & Destructors                                                          */
@@ -27,6 +36,7 @@
 ALGraph::ALGraph(unsigned int size)
 : NUM_VERTEX    { size }
 , adjacencyList { NUM_VERTEX }
+, maxWeight     { 0 }
 {}
 
 /************************************************************************************//*!
@@ -74,6 +84,7 @@ ALGraph::~ALGraph()
 void ALGraph::AddDEdge(unsigned int source, unsigned int destination, unsigned int weight)
 {
     --source;
+    maxWeight = std::max(maxWeight, weight);
     Node srcToDest{ destination, weight };
     adjacencyList[source].emplace_back(srcToDest);
 
@@ -181,6 +192,35 @@ ALGraph::DijkstraResult ALGraph::Dijkstra(unsigned int startNode) const
 
     return result;
 }
+/************************************************************************************//*!
+ @brief     Finds the shortest path from a given node to all the other nodes in
+            the graph, keeping only the node before every node on its path.
+
+ @param     startNode
+    The source node.
+ @param     queue
+    The priority queue to use.
+
+ @returns   The costs and predecessors of every node.
+*//*************************************************************************************/
+ShortestPathTree ALGraph::DijkstraTree(unsigned int startNode, QueueType queue) const
+{
+    ShortestPathTree tree;
+    tree.start = startNode;
+
+    if (queue == QueueType::DIAL_BUCKETS && maxWeight >= DIAL_LIMIT)
+        queue = QueueType::RADIX_HEAP;
+
+    switch (queue)
+    {
+        case QueueType::BINARY_HEAP:    growTree<BinaryHeap>(tree);         break;
+        case QueueType::DARY_HEAP:      growTree<IndexedDAryHeap<4>>(tree); break;
+        case QueueType::DIAL_BUCKETS:   growTree<DialBuckets>(tree);        break;
+        case QueueType::RADIX_HEAP:     growTree<RadixHeap>(tree);          break;
+    }
+
+    return tree;
+}
 /************************************************************************************//*!
  @brief     Gets the adjacency list representation of the graph
 
@@ -204,10 +244,105 @@ ALIST ALGraph::GetAList() const
 
     return adjList;
 }
+/************************************************************************************//*!
+ @brief     Copies the graph into a compressed sparse row snapshot.
+
+ @returns   The snapshot.
+*//*************************************************************************************/
+FrozenGraph ALGraph::Freeze() const
+{
+    std::vector<unsigned> offsets(NUM_VERTEX + 1, 0);
+    for (unsigned int i = 0; i < NUM_VERTEX; ++i)
+    {
+        offsets[i + 1] = offsets[i] + static_cast<unsigned>(adjacencyList[i].size());
+    }
+
+    std::vector<unsigned> targets, weights;
+    targets.reserve(offsets[NUM_VERTEX]);
+    weights.reserve(offsets[NUM_VERTEX]);
+
+    for (const auto& NODE_LIST : adjacencyList)
+    {
+        for (const auto& EDGE : NODE_LIST)
+        {
+            targets.emplace_back(EDGE.destination - 1);
+            weights.emplace_back(EDGE.cost);
+        }
+    }
+
+    return FrozenGraph{ std::move(offsets), std::move(targets), std::move(weights) };
+}
 
 /*-------------------------------------------------------------------------------------*/
 /* Private Function Members                                                            */
 /*-------------------------------------------------------------------------------------*/
+/************************************************************************************//*!
+ @brief     Runs Dijkstra's algorithm on a priority queue.
+
+ @tparam    Queue
+    One of the queues in IntegerQueues.h.
+
+ @param     tree
+    The tree to fill. Its start must be set.
+*//*************************************************************************************/
+template <typename Queue>
+void ALGraph::growTree(ShortestPathTree& tree) const
+{
+    tree.costs.assign(NUM_VERTEX, INF);
+    tree.predecessors.assign(NUM_VERTEX, 0);
+
+    // To prevent duplicate checks
+    std::vector<bool> evaluated(NUM_VERTEX, false);
+
+    Queue queue{ NUM_VERTEX, maxWeight };
+    tree.costs[tree.start - 1] = 0;
+    queue.Push(0, tree.start - 1);
+
+    while (!queue.Empty())
+    {
+        const unsigned int START = queue.Pop().second;
+
+        // If node has already been evaluated, skip
+        if (evaluated[START])
+            continue;
+        evaluated[START] = true;
+
+        const unsigned int START_COST = tree.costs[START];
+        for (const Node& EDGE : adjacencyList[START])
+        {
+            const unsigned int DST          = EDGE.destination - 1;
+            const unsigned int CURRENT_COST = START_COST + EDGE.cost;
+
+            if (tree.costs[DST] > CURRENT_COST)
+            {
+                tree.costs[DST]         = CURRENT_COST;
+                tree.predecessors[DST]  = START + 1;
+                queue.Push(CURRENT_COST, DST);
+            }
+        }
+    }
+}
+/************************************************************************************//*!
+ @brief     Builds the path to a node.
+
+ @param     node
+    The target node.
+
+ @returns   The nodes from the source to the target. Empty if the target can't be
+            reached.
+*//*************************************************************************************/
+std::vector<unsigned> ShortestPathTree::Path(unsigned int node) const
+{
+    std::vector<unsigned> path;
+    if (costs[node - 1] == static_cast<unsigned>(-1))
+        return path;
+
+    for (unsigned int current = node; current != 0; current = predecessors[current - 1])
+        path.emplace_back(current);
+
+    std::reverse(path.begin(), path.end());
+    return path;
+}
 /************************************************************************************//*!
  @brief     Compares two nodes.
 
@@ -34,6 +34,36 @@ public:
     std::vector<unsigned>   path;
 };
 
+/************************************************************************************//*!
+ @brief     Encapsulates the shortest paths from one node to every node, as the node
+            before every node on its path. A path is only built when it is asked for,
+            so the tree takes two numbers per node instead of a copy of every path.
+*//*************************************************************************************/
+struct ShortestPathTree
+{
+public:
+    /*---------------------------------------------------------------------------------*/
+    /* Data Members                                                                    */
+    /*---------------------------------------------------------------------------------*/
+    unsigned                start;          //!< The source node
+    std::vector<unsigned>   costs;          //!< The cost to every node, from 0. -1 if unreachable
+    std::vector<unsigned>   predecessors;   //!< The node before every node, 0 for the source or if unreachable
+
+    /*---------------------------------------------------------------------------------*/
+    /* Function Members                                                                */
+    /*---------------------------------------------------------------------------------*/
+    /********************************************************************************//*!
+    @brief      Builds the path to a node.
+
+    @param      node
+        The target node.
+
+    @returns    The nodes from the source to the target, like DijkstraInfo::path.
+                Empty if the target can't be reached.
+    *//*********************************************************************************/
+    std::vector<unsigned> Path(unsigned int node) const;
+};
+
 /************************************************************************************//*!
  @brief     Encapsulates the information of an edge in an adjacency list.
 *//*************************************************************************************/
@@ -52,6 +82,8 @@ public:
 *//*************************************************************************************/
 typedef std::vector<std::vector<AdjacencyInfo>> ALIST;
 
+class FrozenGraph;
+
 /************************************************************************************//*!
  @brief     Encapsulates a Graph represented as an Adjacency List
 *//*************************************************************************************/
@@ -63,6 +95,17 @@ public:
     /*---------------------------------------------------------------------------------*/
     using DijkstraResult = std::vector<DijkstraInfo>;
 
+    /********************************************************************************//*!
+    @brief      The priority queues DijkstraTree can run on.
+    *//*********************************************************************************/
+    enum class QueueType
+    {
+        BINARY_HEAP,    //!< std::priority_queue, like Dijkstra
+        DARY_HEAP,      //!< An indexed 4-ary heap with decrease key
+        DIAL_BUCKETS,   //!< A ring of one bucket per cost, for small weights
+        RADIX_HEAP      //!< Buckets by the highest bit that differs from the last cost
+    };
+
     /*---------------------------------------------------------------------------------*/
     /* Constructors & Destructor                                                       */
     /*---------------------------------------------------------------------------------*/
@@ -114,11 +157,36 @@ public:
     *//*********************************************************************************/
     DijkstraResult  Dijkstra    (unsigned int startNode) const;
     /********************************************************************************//*!
+    @brief      Finds the shortest path from a given node to all the other nodes in
+                the graph, keeping only the node before every node on its path.
+
+                The costs are the same as Dijkstra. BINARY_HEAP and DARY_HEAP settle
+                nodes in the same order as Dijkstra, so they build the same paths.
+                The bucket queues may take another path when several are as short.
+                DIAL_BUCKETS needs a bucket per unit of the largest weight, so it falls
+                back to RADIX_HEAP for weights above 2^20.
+
+    @param      startNode
+        The source node.
+    @param      queue
+        The priority queue to use.
+
+    @returns    The costs and predecessors of every node.
+    *//*********************************************************************************/
+    ShortestPathTree DijkstraTree(unsigned int startNode, QueueType queue = QueueType::RADIX_HEAP) const;
+    /********************************************************************************//*!
     @brief      Gets the adjacency list representation of the graph
 
     @returns    The adjacency list representation of the graph.
     *//*********************************************************************************/
     ALIST           GetAList    () const;
+    /********************************************************************************//*!
+    @brief      Copies the graph into a compressed sparse row snapshot. Include
+                FrozenGraph.h to use it.
+
+    @returns    The snapshot.
+    *//*********************************************************************************/
+    FrozenGraph     Freeze      () const;
         
 private:
     /*---------------------------------------------------------------------------------*/
@@ -172,9 +240,26 @@ private:
     /* Data Members                                                                    */
     /*---------------------------------------------------------------------------------*/
     static constexpr unsigned   INF             = static_cast<unsigned>(-1);
+    static constexpr unsigned   DIAL_LIMIT      = 1u << 20;
 
     const unsigned int          NUM_VERTEX;
     AdjacencyList               adjacencyList;
+    unsigned int                maxWeight;
+
+    /*---------------------------------------------------------------------------------*/
+    /* Function Members                                                                */
+    /*---------------------------------------------------------------------------------*/
+    /********************************************************************************//*!
+    @brief      Runs Dijkstra's algorithm on a priority queue.
+
+    @tparam     Queue
+        One of the queues in IntegerQueues.h.
+
+    @param      tree
+        The tree to fill. Its start must be set.
+    *//*********************************************************************************/
+    template <typename Queue>
+    void            growTree    (ShortestPathTree& tree) const;
 };
 
 #endif
@@ -0,0 +1,669 @@
+/************************************************************************************//*!
+ @file    ContractionHierarchy.cpp
+ @author  Diren D Bharwani, 2002216, diren.dbharwani, diren.dbharwani@digipen.edu
+ @date    Mar 3, 2022
+ @brief   Contains the implementation for the ContractionHierarchy object.
+
+ Copyright (C) 2022 DigiPen Institute of Technology.
+ Reproduction or disclosure of this file or its contents without the prior written
+ consent of DigiPen Institute of Technology is prohibited.
+*//*************************************************************************************/
+
+// Standard Libraries
+#include <algorithm>
+#include <fstream>
+#include <queue>
+#include <utility>
+// Primary Header
+#include "ContractionHierarchy.h"
+// Project Headers
+#include "SearchSpace.h"
+
+/*-------------------------------------------------------------------------------------*/
+/* Local Helpers                                                                       */
+/*-------------------------------------------------------------------------------------*/
+namespace
+{
+    const unsigned  WITNESS_LIMIT   = 500;          //!< Vertices a witness search settles before giving up
+    const unsigned  SCORE_LIMIT     = 50;           //!< Vertices settled by the witness searches that score a vertex
+    const unsigned  FILE_MAGIC      = 0x48434C41;   //!< "ALCH" at the start of a saved hierarchy
+    const unsigned  FILE_VERSION    = 1;            //!< The layout of a saved hierarchy
+
+    /********************************************************************************//*!
+    @brief      Encapsulates an edge of the graph while it is being contracted.
+    *//*********************************************************************************/
+    struct Arc
+    {
+        unsigned other;     //!< The vertex at the other end
+        unsigned weight;    //!< The weight of the edge
+        unsigned middle;    //!< The vertex a shortcut skips, or INF
+    };
+
+    /********************************************************************************//*!
+    @brief      Encapsulates a graph that vertices are contracted out of one at a time.
+                A contracted vertex keeps the edges it had to the rest of the graph,
+                which are all to higher ranks, and leaves the graph.
+    *//*********************************************************************************/
+    class Contractor
+    {
+    public:
+        std::vector<std::vector<Arc>>   upward;     //!< The edges out of every contracted vertex
+        std::vector<std::vector<Arc>>   downward;   //!< The edges into every contracted vertex
+
+        /****************************************************************************//*!
+        @brief      Constructor for a Contractor.
+
+        @param      vertices
+            The number of vertices in the graph.
+        *//*****************************************************************************/
+        explicit Contractor(unsigned vertices)
+        : upward            ( vertices )
+        , downward          ( vertices )
+        , outgoing          ( vertices )
+        , incoming          ( vertices )
+        , removedNeighbours ( vertices, 0 )
+        , space             { SearchSpace::ForThread(0) }
+        {
+            space.Prepare(vertices);
+        }
+
+        /****************************************************************************//*!
+        @brief      Adds an edge, or lowers the weight of the edge already there.
+
+        @param      source
+            The source of the edge.
+        @param      destination
+            The destination of the edge.
+        @param      weight
+            The weight of the edge.
+        @param      middle
+            The vertex a shortcut skips, or INF.
+        *//*****************************************************************************/
+        void AddArc(unsigned source, unsigned destination, unsigned weight, unsigned middle)
+        {
+            for (Arc& arc : outgoing[source])
+            {
+                if (arc.other != destination)
+                    continue;
+
+                if (weight < arc.weight)
+                {
+                    arc = Arc{ destination, weight, middle };
+                    for (Arc& back : incoming[destination])
+                    {
+                        if (back.other == source)
+                            back = Arc{ source, weight, middle };
+                    }
+                }
+                return;
+            }
+
+            outgoing[source].emplace_back(Arc{ destination, weight, middle });
+            incoming[destination].emplace_back(Arc{ source, weight, middle });
+        }
+        /****************************************************************************//*!
+        @brief      Contracts every vertex, the one whose removal changes the graph the
+                    least first.
+
+        @param      shortcuts
+            Set to the number of shortcuts added.
+
+        @returns    The rank of every vertex.
+        *//*****************************************************************************/
+        std::vector<unsigned> Contract(unsigned& shortcuts)
+        {
+            using Entry = std::pair<int, unsigned>;
+            std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+
+            const unsigned NUM_VERTEX = static_cast<unsigned>(outgoing.size());
+            for (unsigned v = 0; v < NUM_VERTEX; ++v)
+                queue.emplace(priority(v), v);
+
+            std::vector<unsigned> ranks(NUM_VERTEX);
+            unsigned rank = 0;
+            shortcuts = 0;
+
+            while (!queue.empty())
+            {
+                const unsigned VERTEX = queue.top().second;
+                queue.pop();
+
+                // Priorities go stale as neighbours are contracted, so the vertex is
+                // only contracted if it is still the best after updating
+                const int CURRENT = priority(VERTEX);
+                if (!queue.empty() && CURRENT > queue.top().first)
+                {
+                    queue.emplace(CURRENT, VERTEX);
+                    continue;
+                }
+
+                shortcuts += contract(VERTEX, WITNESS_LIMIT, true);
+                ranks[VERTEX] = rank++;
+                detach(VERTEX);
+            }
+
+            return ranks;
+        }
+
+    private:
+        std::vector<std::vector<Arc>>   outgoing;           //!< The edges out of every vertex left
+        std::vector<std::vector<Arc>>   incoming;           //!< The edges into every vertex left
+        std::vector<int>                removedNeighbours;  //!< Contracted neighbours of every vertex
+        SearchSpace&                    space;              //!< The state of a witness search
+
+        /****************************************************************************//*!
+        @brief      Scores how much contracting a vertex would change the graph. Fewer
+                    shortcuts than edges removed is best, and spreading contractions
+                    out keeps the hierarchy shallow.
+
+        @param      vertex
+            The vertex to score.
+
+        @returns    The score. Lower is contracted first.
+        *//*****************************************************************************/
+        int priority(unsigned vertex)
+        {
+            const int REMOVED = static_cast<int>(outgoing[vertex].size() + incoming[vertex].size());
+            return static_cast<int>(contract(vertex, SCORE_LIMIT, false)) - REMOVED + removedNeighbours[vertex];
+        }
+        /****************************************************************************//*!
+        @brief      Finds the shortcuts needed to contract a vertex. A path from an
+                    incoming to an outgoing neighbour through the vertex needs one
+                    unless a witness search finds a path as short without it.
+
+        @param      vertex
+            The vertex to contract.
+        @param      limit
+            The number of vertices each witness search may settle. A shorter search
+            finds fewer witnesses, so it can only overcount.
+        @param      add
+            True to add the shortcuts, false to only count them.
+
+        @returns    The number of shortcuts.
+        *//*****************************************************************************/
+        unsigned contract(unsigned vertex, unsigned limit, bool add)
+        {
+            unsigned longestOut = 0;
+            for (const Arc& arc : outgoing[vertex])
+                longestOut = std::max(longestOut, arc.weight);
+
+            unsigned count = 0;
+            for (const Arc& in : incoming[vertex])
+            {
+                const unsigned long long MAX_COST = static_cast<unsigned long long>(in.weight) + longestOut;
+                witnessSearch(in.other, vertex, MAX_COST, limit);
+
+                for (const Arc& out : outgoing[vertex])
+                {
+                    if (out.other == in.other)
+                        continue;
+
+                    const unsigned long long VIA = static_cast<unsigned long long>(in.weight) + out.weight;
+                    if (VIA >= SearchSpace::INF || space.cost[out.other] <= VIA)
+                        continue;
+
+                    ++count;
+                    if (add)
+                        AddArc(in.other, out.other, static_cast<unsigned>(VIA), vertex);
+                }
+
+                space.Clear();
+            }
+
+            return count;
+        }
+        /****************************************************************************//*!
+        @brief      Removes a contracted vertex from the graph, keeping its edges.
+
+        @param      vertex
+            The contracted vertex.
+        *//*****************************************************************************/
+        void detach(unsigned vertex)
+        {
+            const auto IS_VERTEX = [vertex](const Arc& arc) { return arc.other == vertex; };
+
+            for (const Arc& arc : outgoing[vertex])
+            {
+                std::vector<Arc>& back = incoming[arc.other];
+                back.erase(std::remove_if(back.begin(), back.end(), IS_VERTEX), back.end());
+                ++removedNeighbours[arc.other];
+            }
+            for (const Arc& arc : incoming[vertex])
+            {
+                std::vector<Arc>& back = outgoing[arc.other];
+                back.erase(std::remove_if(back.begin(), back.end(), IS_VERTEX), back.end());
+                ++removedNeighbours[arc.other];
+            }
+
+            upward[vertex].swap(outgoing[vertex]);
+            downward[vertex].swap(incoming[vertex]);
+        }
+        /****************************************************************************//*!
+        @brief      Searches for paths that avoid a vertex, up to a cost. The costs are
+                    left in the search space.
+
+        @param      source
+            The vertex to search from.
+        @param      skip
+            The vertex to avoid.
+        @param      maxCost
+            The largest cost worth searching to.
+        @param      limit
+            The number of vertices to settle before giving up.
+        *//*****************************************************************************/
+        void witnessSearch(unsigned source, unsigned skip, unsigned long long maxCost, unsigned limit)
+        {
+            space.Reach(source, 0, SearchSpace::INF, SearchSpace::INF);
+
+            unsigned settled = 0;
+            while (!space.queue.empty() && settled < limit)
+            {
+                const SearchSpace::Entry TOP = space.queue.top();
+                space.queue.pop();
+
+                if (TOP.first != space.cost[TOP.second])
+                    continue;
+                if (TOP.first > maxCost)
+                    break;
+
+                ++settled;
+                for (const Arc& arc : outgoing[TOP.second])
+                {
+                    if (arc.other == skip)
+                        continue;
+
+                    const unsigned long long CURRENT_COST = static_cast<unsigned long long>(TOP.first) + arc.weight;
+                    if (CURRENT_COST < space.cost[arc.other])
+                        space.Reach(arc.other, static_cast<unsigned>(CURRENT_COST), TOP.second, SearchSpace::INF);
+                }
+            }
+        }
+    };
+
+    /********************************************************************************//*!
+    @brief      Writes an array to a binary file, after its size.
+
+    @param      file
+        The file to write to.
+    @param      values
+        The array to write.
+    *//*********************************************************************************/
+    void writeArray(std::ofstream& file, const std::vector<unsigned>& values)
+    {
+        const unsigned SIZE = static_cast<unsigned>(values.size());
+        file.write(reinterpret_cast<const char*>(&SIZE), sizeof(SIZE));
+        file.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(SIZE * sizeof(unsigned)));
+    }
+    /********************************************************************************//*!
+    @brief      Reads an array written by writeArray.
+
+    @param      file
+        The file to read from.
+    @param      remaining
+        The number of bytes left in the file. Reduced by the bytes read.
+    @param      values
+        Set to the array.
+
+    @returns    True if the array was read.
+    *//*********************************************************************************/
+    bool readArray(std::ifstream& file, unsigned long long& remaining, std::vector<unsigned>& values)
+    {
+        unsigned size = 0;
+        if (remaining < sizeof(size) || !file.read(reinterpret_cast<char*>(&size), sizeof(size)))
+            return false;
+        remaining -= sizeof(size);
+
+        // A damaged size must not allocate more than the file holds
+        const unsigned long long BYTES = static_cast<unsigned long long>(size) * sizeof(unsigned);
+        if (BYTES > remaining)
+            return false;
+
+        values.resize(size);
+        remaining -= BYTES;
+        return static_cast<bool>(file.read(reinterpret_cast<char*>(values.data()), static_cast<std::streamsize>(BYTES)));
+    }
+}
+
+/*-------------------------------------------------------------------------------------*/
+/* Static Data Members                                                                 */
+/*-------------------------------------------------------------------------------------*/
+constexpr unsigned ContractionHierarchy::INF;
+
+/*-------------------------------------------------------------------------------------*/
+/* Constructors & Destructors                                                          */
+/*-------------------------------------------------------------------------------------*/
+/************************************************************************************//*!
+ @brief     Builds the contraction hierarchy of a graph.
+
+ @param     graph
+    The graph to build the hierarchy of.
+*//*************************************************************************************/
+ContractionHierarchy::ContractionHierarchy(const FrozenGraph& graph)
+{
+    const unsigned NUM_VERTEX = graph.VertexCount();
+
+    Contractor contractor{ NUM_VERTEX };
+    for (unsigned src = 0; src < NUM_VERTEX; ++src)
+    {
+        for (unsigned e = graph.offsets[src]; e < graph.offsets[src + 1]; ++e)
+        {
+            // A loop is never part of a shortest path
+            if (graph.targets[e] != src)
+                contractor.AddArc(src, graph.targets[e], graph.weights[e], INF);
+        }
+    }
+
+    ranks = contractor.Contract(shortcuts);
+
+    // Lay the edges every vertex kept when it was contracted out flat
+    for (EdgeSet* edges : { &upward, &downward })
+    {
+        const std::vector<std::vector<Arc>>& ARCS = edges == &upward ? contractor.upward : contractor.downward;
+
+        edges->offsets.assign(1, 0);
+        for (unsigned v = 0; v < NUM_VERTEX; ++v)
+        {
+            for (const Arc& arc : ARCS[v])
+            {
+                edges->neighbours.emplace_back(arc.other);
+                edges->weights.emplace_back(arc.weight);
+                edges->middles.emplace_back(arc.middle);
+            }
+            edges->offsets.emplace_back(static_cast<unsigned>(edges->neighbours.size()));
+        }
+    }
+}
+
+/*-------------------------------------------------------------------------------------*/
+/* Getter Functions                                                                    */
+/*-------------------------------------------------------------------------------------*/
+/************************************************************************************//*!
+ @brief     Gets the number of vertices in the hierarchy.
+
+ @returns   The number of vertices.
+*//*************************************************************************************/
+unsigned ContractionHierarchy::VertexCount() const
+{
+    return static_cast<unsigned>(ranks.size());
+}
+/************************************************************************************//*!
+ @brief     Gets the number of shortcut edges added to the graph.
+
+ @returns   The number of shortcuts.
+*//*************************************************************************************/
+unsigned ContractionHierarchy::ShortcutCount() const
+{
+    return shortcuts;
+}
+
+/*-------------------------------------------------------------------------------------*/
+/* Public Function Members                                                             */
+/*-------------------------------------------------------------------------------------*/
+/************************************************************************************//*!
+ @brief     Finds the shortest path between two nodes with an upward search from each
+            end.
+
+ @param     startNode
+    The source node.
+ @param     endNode
+    The target node.
+
+ @returns   The cost and path from source to target. The cost is -1 and the path empty
+            if the target can't be reached.
+*//*************************************************************************************/
+DijkstraInfo ContractionHierarchy::Query(unsigned int startNode, unsigned int endNode) const
+{
+    DijkstraInfo result{ INF, {} };
+
+    const unsigned SOURCE = startNode - 1;
+    const unsigned TARGET = endNode - 1;
+    if (SOURCE == TARGET)
+    {
+        result.cost = 0;
+        result.path.emplace_back(startNode);
+        return result;
+    }
+
+    SearchSpace& forward    = SearchSpace::ForThread(0);
+    SearchSpace& backward   = SearchSpace::ForThread(1);
+    forward.Prepare(VertexCount());
+    backward.Prepare(VertexCount());
+
+    forward.Reach(SOURCE, 0, INF, INF);
+    backward.Reach(TARGET, 0, INF, INF);
+
+    unsigned long long  best    = INF;
+    unsigned            meeting = INF;
+
+    while (!forward.queue.empty() || !backward.queue.empty())
+    {
+        const unsigned FORWARD_MIN  = forward.queue.empty()  ? INF : forward.queue.top().first;
+        const unsigned BACKWARD_MIN = backward.queue.empty() ? INF : backward.queue.top().first;
+
+        // Grow whichever search is behind. Once it can't beat the best path, neither can.
+        const bool IS_FORWARD = FORWARD_MIN <= BACKWARD_MIN;
+        if (std::min(FORWARD_MIN, BACKWARD_MIN) >= best)
+            break;
+
+        SearchSpace&    space   = IS_FORWARD ? forward  : backward;
+        SearchSpace&    other   = IS_FORWARD ? backward : forward;
+        const EdgeSet&  EDGES   = IS_FORWARD ? upward   : downward;
+        const EdgeSet&  STALL   = IS_FORWARD ? downward : upward;
+
+        const SearchSpace::Entry TOP = space.queue.top();
+        space.queue.pop();
+
+        const unsigned START = TOP.second;
+        if (TOP.first != space.cost[START])
+            continue;
+
+        if (other.cost[START] != INF && static_cast<unsigned long long>(TOP.first) + other.cost[START] < best)
+        {
+            best    = static_cast<unsigned long long>(TOP.first) + other.cost[START];
+            meeting = START;
+        }
+
+        // A higher vertex that reaches this one more cheaply means no shortest path
+        // goes up through it, so there is no point searching on from it
+        bool stalled = false;
+        for (unsigned e = STALL.offsets[START]; e < STALL.offsets[START + 1] && !stalled; ++e)
+        {
+            const unsigned HIGHER = STALL.neighbours[e];
+            stalled = space.cost[HIGHER] != INF && static_cast<unsigned long long>(space.cost[HIGHER]) + STALL.weights[e] < TOP.first;
+        }
+        if (stalled)
+            continue;
+
+        for (unsigned e = EDGES.offsets[START]; e < EDGES.offsets[START + 1]; ++e)
+        {
+            const unsigned              DST             = EDGES.neighbours[e];
+            const unsigned long long    CURRENT_COST    = static_cast<unsigned long long>(TOP.first) + EDGES.weights[e];
+
+            if (CURRENT_COST < space.cost[DST])
+                space.Reach(DST, static_cast<unsigned>(CURRENT_COST), START, e);
+        }
+    }
+
+    if (meeting != INF)
+    {
+        result.cost = static_cast<unsigned>(best);
+        result.path.emplace_back(startNode);
+
+        // Hierarchy edges from the source up to the meeting vertex, then down to the target
+        std::vector<unsigned> climb;
+        for (unsigned v = meeting; forward.parent[v] != INF; v = forward.parent[v])
+            climb.emplace_back(v);
+
+        for (auto it = climb.rbegin(); it != climb.rend(); ++it)
+            unpack(forward.parent[*it], *it, upward.middles[forward.via[*it]], result.path);
+
+        for (unsigned v = meeting; backward.parent[v] != INF; v = backward.parent[v])
+            unpack(v, backward.parent[v], downward.middles[backward.via[v]], result.path);
+    }
+
+    forward.Clear();
+    backward.Clear();
+    return result;
+}
+/************************************************************************************//*!
+ @brief     Saves the hierarchy to a binary file.
+
+ @param     fileName
+    The path of the file.
+
+ @returns   True if the file was written.
+*//*************************************************************************************/
+bool ContractionHierarchy::Save(const std::string& fileName) const
+{
+    std::ofstream file{ fileName, std::ios::binary | std::ios::trunc };
+    if (!file)
+        return false;
+
+    file.write(reinterpret_cast<const char*>(&FILE_MAGIC), sizeof(FILE_MAGIC));
+    file.write(reinterpret_cast<const char*>(&FILE_VERSION), sizeof(FILE_VERSION));
+    file.write(reinterpret_cast<const char*>(&shortcuts), sizeof(shortcuts));
+
+    writeArray(file, ranks);
+    for (const EdgeSet* edges : { &upward, &downward })
+    {
+        writeArray(file, edges->offsets);
+        writeArray(file, edges->neighbours);
+        writeArray(file, edges->weights);
+        writeArray(file, edges->middles);
+    }
+
+    return static_cast<bool>(file);
+}
+/************************************************************************************//*!
+ @brief     Replaces the hierarchy with one saved to a binary file. The file is checked
+            for consistency, so a damaged file can't make queries read out of bounds or
+            unpack shortcuts forever.
+
+ @param     fileName
+    The path of the file.
+
+ @returns   True if the file was read. The hierarchy is unchanged otherwise.
+*//*************************************************************************************/
+bool ContractionHierarchy::Load(const std::string& fileName)
+{
+    std::ifstream file{ fileName, std::ios::binary | std::ios::ate };
+    if (!file)
+        return false;
+
+    unsigned long long remaining = static_cast<unsigned long long>(file.tellg());
+    file.seekg(0);
+
+    unsigned header[3] = {};
+    if (remaining < sizeof(header) || !file.read(reinterpret_cast<char*>(header), sizeof(header)))
+        return false;
+    remaining -= sizeof(header);
+
+    if (header[0] != FILE_MAGIC || header[1] != FILE_VERSION)
+        return false;
+
+    ContractionHierarchy loaded;
+    loaded.shortcuts = header[2];
+
+    if (!readArray(file, remaining, loaded.ranks))
+        return false;
+
+    // Every rank is used once, so the ranks order the vertices
+    const size_t NUM_VERTEX = loaded.ranks.size();
+    std::vector<bool> ranked(NUM_VERTEX, false);
+    for (const unsigned RANK : loaded.ranks)
+    {
+        if (RANK >= NUM_VERTEX || ranked[RANK])
+            return false;
+
+        ranked[RANK] = true;
+    }
+
+    for (EdgeSet* edges : { &loaded.upward, &loaded.downward })
+    {
+        if (!readArray(file, remaining, edges->offsets)    || !readArray(file, remaining, edges->neighbours) ||
+            !readArray(file, remaining, edges->weights)    || !readArray(file, remaining, edges->middles))
+            return false;
+
+        const size_t NUM_EDGE = edges->neighbours.size();
+        if (edges->offsets.size() != NUM_VERTEX + 1 || edges->offsets.front() != 0 || edges->offsets.back() != NUM_EDGE ||
+            edges->weights.size() != NUM_EDGE       || edges->middles.size() != NUM_EDGE)
+            return false;
+
+        if (!std::is_sorted(edges->offsets.begin(), edges->offsets.end()))
+            return false;
+
+        // Every edge leads up from its owner, and a shortcut skips a vertex ranked below
+        // both of its ends. The middle of every edge unpack recurses into then ranks lower
+        // than the last, so unpacking always ends.
+        for (unsigned owner = 0; owner < NUM_VERTEX; ++owner)
+        {
+            for (unsigned e = edges->offsets[owner]; e < edges->offsets[owner + 1]; ++e)
+            {
+                const unsigned NEIGHBOUR    = edges->neighbours[e];
+                const unsigned MIDDLE       = edges->middles[e];
+
+                if (NEIGHBOUR >= NUM_VERTEX || loaded.ranks[owner] >= loaded.ranks[NEIGHBOUR])
+                    return false;
+
+                if (MIDDLE != INF && (MIDDLE >= NUM_VERTEX || loaded.ranks[MIDDLE] >= loaded.ranks[owner]))
+                    return false;
+            }
+        }
+    }
+
+    *this = std::move(loaded);
+    return true;
+}
+
+/*-------------------------------------------------------------------------------------*/
+/* Private Function Members                                                            */
+/*-------------------------------------------------------------------------------------*/
+/************************************************************************************//*!
+ @brief     Finds the vertex a hierarchy edge skips. The edge is kept by whichever end
+            is ranked lower.
+
+ @param     source
+    The source of the edge.
+ @param     destination
+    The destination of the edge.
+
+ @returns   The skipped vertex, or INF if the edge is in the graph.
+*//*************************************************************************************/
+unsigned ContractionHierarchy::middleOf(unsigned source, unsigned destination) const
+{
+    const bool      IS_UP   = ranks[source] < ranks[destination];
+    const EdgeSet&  EDGES   = IS_UP ? upward : downward;
+    const unsigned  OWNER   = IS_UP ? source : destination;
+    const unsigned  OTHER   = IS_UP ? destination : source;
+
+    for (unsigned e = EDGES.offsets[OWNER]; e < EDGES.offsets[OWNER + 1]; ++e)
+    {
+        if (EDGES.neighbours[e] == OTHER)
+            return EDGES.middles[e];
+    }
+
+    return INF;
+}
+/************************************************************************************//*!
+ @brief     Expands a hierarchy edge into the edges of the graph.
+
+ @param     source
+    The source of the edge.
+ @param     destination
+    The destination of the edge.
+ @param     middle
+    The vertex the edge skips, or INF.
+ @param     path
+    The path to add every vertex after source to, numbered from 1.
+*//*************************************************************************************/
+void ContractionHierarchy::unpack(unsigned source, unsigned destination, unsigned middle, std::vector<unsigned>& path) const
+{
+    if (middle == INF)
+    {
+        path.emplace_back(destination + 1);
+        return;
+    }
+
+    unpack(source, middle, middleOf(source, middle), path);
+    unpack(middle, destination, middleOf(middle, destination), path);
+}
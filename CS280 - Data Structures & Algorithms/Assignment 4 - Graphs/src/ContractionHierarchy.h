@@ -0,0 +1,160 @@
+/************************************************************************************//*!
+ @file    ContractionHierarchy.h
+ @author  Diren D Bharwani, 2002216, diren.dbharwani, diren.dbharwani@digipen.edu
+ @date    Mar 3, 2022
+ @brief   Contains the interface for the ContractionHierarchy object, a preprocessed
+          FrozenGraph for fast point-to-point queries.
+
+ Copyright (C) 2022 DigiPen Institute of Technology.
+ Reproduction or disclosure of this file or its contents without the prior written
+ consent of DigiPen Institute of Technology is prohibited.
+*//*************************************************************************************/
+
+#ifndef CONTRACTIONHIERARCHY_H
+#define CONTRACTIONHIERARCHY_H
+
+// Standard Libraries
+#include <vector>
+#include <string>
+// Project Headers
+#include "FrozenGraph.h"
+
+/************************************************************************************//*!
+ @brief     Encapsulates a contraction hierarchy of a graph.
+
+            Every vertex is given a rank, and removed from the graph in that order.
+            When a vertex is removed, a shortcut edge replaces each shortest path that
+            went through it. Every shortest path then has a version that only goes up
+            in rank and then down, so a query searches upwards from both ends and only
+            visits a few hundred vertices, even on large road networks.
+
+            The hierarchy only depends on the graph, so it can be built once, saved
+            and loaded for later runs.
+*//*************************************************************************************/
+class ContractionHierarchy
+{
+public:
+    /*---------------------------------------------------------------------------------*/
+    /* Constructors & Destructor                                                       */
+    /*---------------------------------------------------------------------------------*/
+    /********************************************************************************//*!
+    @brief      Default Constructor for an empty ContractionHierarchy. Load one from a
+                file before querying it.
+    *//*********************************************************************************/
+    ContractionHierarchy() = default;
+    /********************************************************************************//*!
+    @brief      Builds the contraction hierarchy of a graph.
+
+    @param      graph
+        The graph to build the hierarchy of.
+    *//*********************************************************************************/
+    explicit ContractionHierarchy(const FrozenGraph& graph);
+
+    /*---------------------------------------------------------------------------------*/
+    /* Getter Functions                                                                */
+    /*---------------------------------------------------------------------------------*/
+    /********************************************************************************//*!
+    @brief      Gets the number of vertices in the hierarchy.
+
+    @returns    The number of vertices.
+    *//*********************************************************************************/
+    unsigned    VertexCount     ()  const;
+    /********************************************************************************//*!
+    @brief      Gets the number of shortcut edges added to the graph.
+
+    @returns    The number of shortcuts.
+    *//*********************************************************************************/
+    unsigned    ShortcutCount   ()  const;
+
+    /*---------------------------------------------------------------------------------*/
+    /* Function Members                                                                */
+    /*---------------------------------------------------------------------------------*/
+    /********************************************************************************//*!
+    @brief      Finds the shortest path between two nodes.
+
+    @param      startNode
+        The source node.
+    @param      endNode
+        The target node.
+
+    @returns    The cost and path from source to target, with shortcuts expanded back
+                into the edges of the graph. If several paths are as short, any of
+                them. The cost is -1 and the path empty if the target can't be reached.
+    *//*********************************************************************************/
+    DijkstraInfo    Query   (unsigned int startNode, unsigned int endNode)  const;
+    /********************************************************************************//*!
+    @brief      Saves the hierarchy to a binary file.
+
+    @param      fileName
+        The path of the file.
+
+    @returns    True if the file was written.
+    *//*********************************************************************************/
+    bool            Save    (const std::string& fileName)                   const;
+    /********************************************************************************//*!
+    @brief      Replaces the hierarchy with one saved to a binary file.
+
+    @param      fileName
+        The path of the file.
+
+    @returns    True if the file was read. The hierarchy is unchanged otherwise.
+    *//*********************************************************************************/
+    bool            Load    (const std::string& fileName);
+
+private:
+    /*---------------------------------------------------------------------------------*/
+    /* Type Definitions                                                                */
+    /*---------------------------------------------------------------------------------*/
+    /********************************************************************************//*!
+    @brief      Edges of the hierarchy that lead to higher ranked vertices, in compressed
+                sparse row form. Upward edges are kept by source and downward edges by
+                destination, so both searches of a query walk up.
+    *//*********************************************************************************/
+    struct EdgeSet
+    {
+        std::vector<unsigned>   offsets;    //!< The index of the first edge of every vertex
+        std::vector<unsigned>   neighbours; //!< The higher ranked end of every edge
+        std::vector<unsigned>   weights;    //!< The weight of every edge
+        std::vector<unsigned>   middles;    //!< The vertex a shortcut skips, or INF
+    };
+
+    /*---------------------------------------------------------------------------------*/
+    /* Data Members                                                                    */
+    /*---------------------------------------------------------------------------------*/
+    static constexpr unsigned   INF             = static_cast<unsigned>(-1);
+
+    std::vector<unsigned>   ranks;      //!< The order every vertex was contracted in
+    EdgeSet                 upward;     //!< Edges to higher ranks, by source
+    EdgeSet                 downward;   //!< Edges from higher ranks, by destination
+    unsigned                shortcuts = 0;  //!< The number of shortcuts added
+
+    /*---------------------------------------------------------------------------------*/
+    /* Function Members                                                                */
+    /*---------------------------------------------------------------------------------*/
+    /********************************************************************************//*!
+    @brief      Finds the vertex a hierarchy edge skips.
+
+    @param      source
+        The source of the edge.
+    @param      destination
+        The destination of the edge.
+
+    @returns    The skipped vertex, or INF if the edge is in the graph.
+    *//*********************************************************************************/
+    unsigned        middleOf    (unsigned source, unsigned destination)         const;
+    /********************************************************************************//*!
+    @brief      Expands a hierarchy edge into the edges of the graph.
+
+    @param      source
+        The source of the edge.
+    @param      destination
+        The destination of the edge.
+    @param      middle
+        The vertex the edge skips, or INF.
+    @param      path
+        The path to add every vertex after source to, numbered from 1.
+    *//*********************************************************************************/
+    void            unpack      (unsigned source, unsigned destination, unsigned middle, std::vector<unsigned>& path) const;
+};
+
+#endif
@@ -0,0 +1,746 @@
+/************************************************************************************//*!
+ @file    FrozenGraph.cpp
+ @author  Diren D Bharwani, 2002216, diren.dbharwani, diren.dbharwani@digipen.edu
+ @date    Mar 3, 2022
+ @brief   Contains the implementation for the FrozenGraph object.
+
+ Copyright (C) 2022 DigiPen Institute of Technology.
+ Reproduction or disclosure of this file or its contents without the prior written
+ consent of DigiPen Institute of Technology is prohibited.
+*//*************************************************************************************/
+
+// Standard Libraries
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <system_error>
+#include <thread>
+// Primary Header
+#include "FrozenGraph.h"
+// Project Headers
+#include "SearchSpace.h"
+
+/*-------------------------------------------------------------------------------------*/
+/* Local Helpers                                                                       */
+/*-------------------------------------------------------------------------------------*/
+namespace
+{
+    const size_t    NO_BUCKET   = static_cast<size_t>(-1);  //!< No bucket has vertices left
+    const size_t    CHUNK_SIZE  = 64;                       //!< Vertices a thread takes at a time
+    const size_t    MAX_BUCKETS = 4096;                     //!< Buckets a thread keeps at most
+
+    /********************************************************************************//*!
+    @brief      Encapsulates a barrier that spins while it waits. A delta-stepping search
+                passes through one several times per bucket, too often to sleep.
+    *//*********************************************************************************/
+    class SpinBarrier
+    {
+    public:
+        /****************************************************************************//*!
+        @brief      Constructor for a SpinBarrier.
+
+        @param      count
+            The number of threads that wait on the barrier.
+        *//*****************************************************************************/
+        explicit SpinBarrier(unsigned count)
+        : threads       { count }
+        , waiting       { 0 }
+        , generation    { 0 }
+        {}
+
+        /****************************************************************************//*!
+        @brief      Sets the number of threads that wait on the barrier. Only safe while
+                    no thread is waiting.
+
+        @param      count
+            The number of threads that wait on the barrier.
+        *//*****************************************************************************/
+        void Reset(unsigned count)
+        {
+            threads = count;
+        }
+        /****************************************************************************//*!
+        @brief      Blocks until every thread has reached the barrier. Everything written
+                    before it is visible to every thread after it.
+        *//*****************************************************************************/
+        void Wait()
+        {
+            const unsigned current = generation.load(std::memory_order_acquire);
+
+            if (waiting.fetch_add(1, std::memory_order_acq_rel) + 1 == threads)
+            {
+                waiting.store(0, std::memory_order_relaxed);
+                generation.fetch_add(1, std::memory_order_release);
+                return;
+            }
+
+            while (generation.load(std::memory_order_acquire) == current)
+                std::this_thread::yield();
+        }
+
+    private:
+        unsigned                threads;
+        std::atomic<unsigned>   waiting;
+        std::atomic<unsigned>   generation;
+    };
+
+    /********************************************************************************//*!
+    @brief      Encapsulates threads that live as long as the program and run one job at
+                a time. The SearchSpace of every thread lives as long, so its buffers
+                are only allocated once, however many jobs it runs.
+    *//*********************************************************************************/
+    class WorkerPool
+    {
+    public:
+        using Job = std::function<void()>;
+
+        /****************************************************************************//*!
+        @brief      Gets the pool every search shares.
+
+        @returns    The pool.
+        *//*****************************************************************************/
+        static WorkerPool& Instance()
+        {
+            static WorkerPool pool;
+            return pool;
+        }
+
+        /****************************************************************************//*!
+        @brief      Destructor for a WorkerPool. Stops and joins every thread.
+        *//*****************************************************************************/
+        ~WorkerPool()
+        {
+            {
+                std::lock_guard<std::mutex> lock{ mutex };
+                stopping = true;
+            }
+            wake.notify_all();
+
+            for (std::thread& thread : threads)
+                thread.join();
+        }
+
+        /****************************************************************************//*!
+        @brief      Runs a job on several threads at once, the calling thread among
+                    them, and waits for all of them to finish it.
+
+        @param      count
+            The number of threads to run the job on. Fewer if the pool can't start
+            enough.
+        @param      job
+            The job to run.
+        *//*****************************************************************************/
+        void Run(unsigned count, const Job& job)
+        {
+            // One job at a time, so callers on several threads take turns
+            std::lock_guard<std::mutex> turn{ running };
+
+            {
+                std::lock_guard<std::mutex> lock{ mutex };
+                try
+                {
+                    while (threads.size() + 1 < count)
+                        threads.emplace_back(&WorkerPool::work, this, static_cast<unsigned>(threads.size()));
+                }
+                catch (const std::system_error&)
+                {
+                    // Carry on with the threads there are
+                }
+
+                current = &job;
+                helpers = std::min(count - 1, static_cast<unsigned>(threads.size()));
+                pending = helpers;
+                ++generation;
+            }
+            wake.notify_all();
+
+            job();
+
+            std::unique_lock<std::mutex> lock{ mutex };
+            done.wait(lock, [this]() { return pending == 0; });
+            current = nullptr;
+        }
+
+    private:
+        std::mutex                  running;            //!< Held by the caller running a job
+        std::mutex                  mutex;              //!< Guards everything below
+        std::condition_variable     wake;               //!< Signalled when a job or stop is posted
+        std::condition_variable     done;               //!< Signalled when the last helper finishes
+        std::vector<std::thread>    threads;
+        const Job*                  current     = nullptr;
+        unsigned                    helpers     = 0;    //!< Threads the current job runs on, besides the caller
+        unsigned                    pending     = 0;    //!< Helpers still running the current job
+        unsigned long long          generation  = 0;    //!< Jobs posted so far
+        bool                        stopping    = false;
+
+        WorkerPool() = default;
+
+        /****************************************************************************//*!
+        @brief      Runs the jobs posted to a thread of the pool until it stops.
+
+        @param      index
+            The index of the thread in the pool.
+        *//*****************************************************************************/
+        void work(unsigned index)
+        {
+            unsigned long long seen = 0;
+
+            std::unique_lock<std::mutex> lock{ mutex };
+            while (true)
+            {
+                wake.wait(lock, [&]() { return stopping || generation != seen; });
+                if (stopping)
+                    return;
+
+                seen = generation;
+                if (index >= helpers)
+                    continue;
+
+                const Job* job = current;
+                lock.unlock();
+                (*job)();
+                lock.lock();
+
+                if (--pending == 0)
+                    done.notify_one();
+            }
+        }
+    };
+}
+
+/*-------------------------------------------------------------------------------------*/
+/* Static Data Members                                                                 */
+/*-------------------------------------------------------------------------------------*/
+constexpr unsigned FrozenGraph::INF;
+constexpr unsigned SearchSpace::INF;
+
+/*-------------------------------------------------------------------------------------*/
+/* Constructors & Destructors                                                          */
+/*-------------------------------------------------------------------------------------*/
+/************************************************************************************//*!
+ @brief     Constructs a FrozenGraph from compressed sparse row arrays.
+
+ @param     edgeOffsets
+    The index of the first edge of every vertex, followed by the number of edges.
+ @param     edgeTargets
+    The destination of every edge, numbered from 0.
+ @param     edgeWeights
+    The weight of every edge.
+*//*************************************************************************************/
+FrozenGraph::FrozenGraph
+(
+    std::vector<unsigned>&& edgeOffsets,
+    std::vector<unsigned>&& edgeTargets,
+    std::vector<unsigned>&& edgeWeights
+)
+: offsets           { std::move(edgeOffsets) }
+, targets           { std::move(edgeTargets) }
+, weights           { std::move(edgeWeights) }
+, reverseOffsets    ( offsets.size(), 0 )
+, reverseSources    ( targets.size() )
+, reverseWeights    ( weights.size() )
+{
+    // Count the edges into every vertex, then place each edge after the ones before it
+    for (unsigned dst : targets)
+        ++reverseOffsets[dst + 1];
+    for (size_t v = 1; v < reverseOffsets.size(); ++v)
+        reverseOffsets[v] += reverseOffsets[v - 1];
+
+    std::vector<unsigned> next(reverseOffsets.begin(), reverseOffsets.end() - (reverseOffsets.empty() ? 0 : 1));
+    for (unsigned src = 0; src < VertexCount(); ++src)
+    {
+        for (unsigned e = offsets[src]; e < offsets[src + 1]; ++e)
+        {
+            const unsigned SLOT = next[targets[e]]++;
+            reverseSources[SLOT] = src;
+            reverseWeights[SLOT] = weights[e];
+        }
+    }
+}
+
+/*-------------------------------------------------------------------------------------*/
+/* Getter Functions                                                                    */
+/*-------------------------------------------------------------------------------------*/
+/************************************************************************************//*!
+ @brief     Gets the number of vertices in the graph.
+
+ @returns   The number of vertices.
+*//*************************************************************************************/
+unsigned FrozenGraph::VertexCount() const
+{
+    return offsets.empty() ? 0 : static_cast<unsigned>(offsets.size() - 1);
+}
+/************************************************************************************//*!
+ @brief     Gets the number of directed edges in the graph.
+
+ @returns   The number of edges.
+*//*************************************************************************************/
+unsigned FrozenGraph::EdgeCount() const
+{
+    return static_cast<unsigned>(targets.size());
+}
+
+/*-------------------------------------------------------------------------------------*/
+/* Public Function Members                                                             */
+/*-------------------------------------------------------------------------------------*/
+/************************************************************************************//*!
+ @brief     Finds the shortest path from a given node to all the other nodes in the
+            graph with delta-stepping, on several threads.
+
+ @param     startNode
+    The source node.
+ @param     delta
+    The width of a bucket. 0 picks one from the weights and degrees of the graph.
+ @param     threads
+    The number of threads to use. 0 uses every hardware thread.
+
+ @returns   A vector of DijkstraInfo structs.
+*//*************************************************************************************/
+FrozenGraph::DijkstraResult FrozenGraph::DeltaStepping(unsigned int startNode, unsigned int delta, unsigned int threads) const
+{
+    const unsigned NUM_VERTEX = VertexCount();
+
+    if (delta == 0)
+        delta = defaultDelta();
+    if (threads == 0)
+        threads = std::max(std::thread::hardware_concurrency(), 1u);
+
+    // Relaxing a vertex only adds to its own bucket and the next ceil(maxWeight / delta),
+    // so that many buckets are kept and reused in a cycle. delta is widened if that
+    // would be too many.
+    const unsigned long long MAX_WEIGHT = weights.empty() ? 0 : *std::max_element(weights.begin(), weights.end());
+    if ((MAX_WEIGHT + delta - 1) / delta >= MAX_BUCKETS)
+        delta = static_cast<unsigned>((MAX_WEIGHT + MAX_BUCKETS - 2) / (MAX_BUCKETS - 1));
+    const size_t NUM_BUCKETS = static_cast<size_t>((MAX_WEIGHT + delta - 1) / delta) + 1;
+
+    std::unique_ptr<std::atomic<unsigned>[]> distances{ new std::atomic<unsigned>[NUM_VERTEX] };
+    for (unsigned i = 0; i < NUM_VERTEX; ++i)
+        distances[i].store(INF, std::memory_order_relaxed);
+    distances[startNode - 1].store(0, std::memory_order_relaxed);
+
+    // The vertices of the bucket being relaxed, gathered from every thread. A vertex
+    // can be in it more than once if it got shorter more than once.
+    std::vector<unsigned> frontier(std::max(NUM_VERTEX, 1u));
+    frontier[0] = startNode - 1;
+
+    // Every step reads one set of counters while the other set is reset for the next
+    // step, so the threads only need to meet once between each part of a step
+    std::atomic<size_t> cursor[2];      // Next frontier vertex to relax
+    std::atomic<size_t> gathered[2];    // Number of vertices gathered into the frontier
+    std::atomic<size_t> nextBucket[2];  // Smallest bucket any thread still has vertices in
+    cursor[0]       = cursor[1]     = 0;
+    gathered[0]     = 0;
+    gathered[1]     = 1;
+    nextBucket[0]   = nextBucket[1] = NO_BUCKET;
+
+    SpinBarrier         barrier{ threads };
+    std::atomic<bool>   ready{ false };
+
+    auto search = [&](unsigned id)
+    {
+        while (!ready.load(std::memory_order_acquire))
+            std::this_thread::yield();
+
+        // Vertices this thread made shorter, by bucket modulo NUM_BUCKETS
+        std::vector<std::vector<unsigned>> buckets(NUM_BUCKETS);
+        size_t bucket = 0;
+
+        for (unsigned step = 0; ; ++step)
+        {
+            const unsigned  CURR = step & 1;
+            const unsigned  NEXT = CURR ^ 1;
+            const size_t    SIZE = gathered[NEXT].load(std::memory_order_relaxed);
+
+            // Relax the edges of every vertex in the bucket
+            for (size_t first; (first = cursor[CURR].fetch_add(CHUNK_SIZE, std::memory_order_relaxed)) < SIZE; )
+            {
+                const size_t LAST = std::min(first + CHUNK_SIZE, SIZE);
+                for (size_t i = first; i < LAST; ++i)
+                {
+                    const unsigned START        = frontier[i];
+                    const unsigned START_COST   = distances[START].load(std::memory_order_relaxed);
+
+                    // Already relaxed in an earlier bucket after getting shorter
+                    if (START_COST / delta < bucket)
+                        continue;
+
+                    for (unsigned e = offsets[START]; e < offsets[START + 1]; ++e)
+                    {
+                        const unsigned long long CURRENT_COST = static_cast<unsigned long long>(START_COST) + weights[e];
+                        if (CURRENT_COST >= INF)
+                            continue;
+
+                        std::atomic<unsigned>& dstCost = distances[targets[e]];
+                        unsigned cost = dstCost.load(std::memory_order_relaxed);
+                        while (CURRENT_COST < cost)
+                        {
+                            if (dstCost.compare_exchange_weak(cost, static_cast<unsigned>(CURRENT_COST), std::memory_order_relaxed))
+                            {
+                                const size_t DST_BUCKET = static_cast<size_t>(CURRENT_COST / delta);
+                                buckets[DST_BUCKET % NUM_BUCKETS].emplace_back(targets[e]);
+                                break;
+                            }
+                        }
+                    }
+                }
+            }
+            barrier.Wait();
+
+            // Everyone has read this step's size and finished with the last step's
+            // counters
+            if (id == 0)
+            {
+                cursor[NEXT]        = 0;
+                gathered[NEXT]      = 0;
+                nextBucket[NEXT]    = NO_BUCKET;
+            }
+
+            // The same bucket comes up again if relaxing it added to it
+            size_t smallest = bucket;
+            while (smallest < bucket + NUM_BUCKETS && buckets[smallest % NUM_BUCKETS].empty())
+                ++smallest;
+
+            if (smallest < bucket + NUM_BUCKETS)
+            {
+                size_t seen = nextBucket[CURR].load(std::memory_order_relaxed);
+                while (smallest < seen && !nextBucket[CURR].compare_exchange_weak(seen, smallest, std::memory_order_relaxed))
+                {}
+            }
+            barrier.Wait();
+
+            bucket = nextBucket[CURR].load(std::memory_order_relaxed);
+            if (bucket == NO_BUCKET)
+                break;
+
+            // Gather the bucket from every thread into the frontier
+            std::vector<unsigned>& mine     = buckets[bucket % NUM_BUCKETS];
+            const size_t           CAPACITY = frontier.size();
+            const size_t           OFFSET   = gathered[CURR].fetch_add(mine.size(), std::memory_order_relaxed);
+            barrier.Wait();
+
+            const size_t TOTAL = gathered[CURR].load(std::memory_order_relaxed);
+            if (TOTAL > CAPACITY)
+            {
+                if (id == 0)
+                    frontier.resize(std::max(TOTAL, 2 * frontier.size()));
+                barrier.Wait();
+            }
+
+            std::copy(mine.begin(), mine.end(), frontier.begin() + OFFSET);
+            mine.clear();
+            barrier.Wait();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    try
+    {
+        for (unsigned i = 1; i < threads; ++i)
+            workers.emplace_back(search, i);
+    }
+    catch (const std::system_error&)
+    {
+        // Carry on with the threads that did start
+    }
+
+    barrier.Reset(static_cast<unsigned>(workers.size()) + 1);
+    ready.store(true, std::memory_order_release);
+
+    search(0);
+    for (std::thread& worker : workers)
+        worker.join();
+
+    std::vector<unsigned> costs(NUM_VERTEX);
+    for (unsigned i = 0; i < NUM_VERTEX; ++i)
+        costs[i] = distances[i].load(std::memory_order_relaxed);
+
+    return buildPaths(startNode, costs);
+}
+
+/************************************************************************************//*!
+ @brief     Finds the shortest path between two nodes with bidirectional Dijkstra.
+
+ @param     startNode
+    The source node.
+ @param     endNode
+    The target node.
+
+ @returns   The cost and path from source to target. The cost is -1 and the path empty
+            if the target can't be reached.
+*//*************************************************************************************/
+DijkstraInfo FrozenGraph::ShortestPath(unsigned int startNode, unsigned int endNode) const
+{
+    DijkstraInfo result{ INF, {} };
+
+    const unsigned SOURCE = startNode - 1;
+    const unsigned TARGET = endNode - 1;
+    if (SOURCE == TARGET)
+    {
+        result.cost = 0;
+        result.path.emplace_back(startNode);
+        return result;
+    }
+
+    SearchSpace& forward    = SearchSpace::ForThread(0);
+    SearchSpace& backward   = SearchSpace::ForThread(1);
+    forward.Prepare(VertexCount());
+    backward.Prepare(VertexCount());
+
+    forward.Reach(SOURCE, 0, INF, INF);
+    backward.Reach(TARGET, 0, INF, INF);
+
+    unsigned long long  best    = INF;
+    unsigned            meeting = INF;
+
+    while (!forward.queue.empty() || !backward.queue.empty())
+    {
+        const unsigned long long FORWARD_MIN    = forward.queue.empty()  ? INF : forward.queue.top().first;
+        const unsigned long long BACKWARD_MIN   = backward.queue.empty() ? INF : backward.queue.top().first;
+
+        // Any path through an unsettled vertex costs at least both minimums together
+        if (FORWARD_MIN + BACKWARD_MIN >= best)
+            break;
+
+        // Grow whichever search is behind, over edges out of or into the vertex
+        const bool      IS_FORWARD  = FORWARD_MIN <= BACKWARD_MIN;
+        SearchSpace&    space       = IS_FORWARD ? forward  : backward;
+        SearchSpace&    other       = IS_FORWARD ? backward : forward;
+        const auto&     OFFSETS     = IS_FORWARD ? offsets  : reverseOffsets;
+        const auto&     NEIGHBOURS  = IS_FORWARD ? targets  : reverseSources;
+        const auto&     WEIGHTS     = IS_FORWARD ? weights  : reverseWeights;
+
+        const SearchSpace::Entry TOP = space.queue.top();
+        space.queue.pop();
+
+        const unsigned START = TOP.second;
+        if (TOP.first != space.cost[START])
+            continue;
+
+        for (unsigned e = OFFSETS[START]; e < OFFSETS[START + 1]; ++e)
+        {
+            const unsigned              DST             = NEIGHBOURS[e];
+            const unsigned long long    CURRENT_COST    = static_cast<unsigned long long>(TOP.first) + WEIGHTS[e];
+            if (CURRENT_COST >= space.cost[DST])
+                continue;
+
+            space.Reach(DST, static_cast<unsigned>(CURRENT_COST), START, e);
+
+            if (other.cost[DST] != INF && CURRENT_COST + other.cost[DST] < best)
+            {
+                best    = CURRENT_COST + other.cost[DST];
+                meeting = DST;
+            }
+        }
+    }
+
+    if (meeting != INF)
+    {
+        result.cost = static_cast<unsigned>(best);
+
+        for (unsigned v = meeting; v != INF; v = forward.parent[v])
+            result.path.emplace_back(v + 1);
+        std::reverse(result.path.begin(), result.path.end());
+
+        for (unsigned v = backward.parent[meeting]; v != INF; v = backward.parent[v])
+            result.path.emplace_back(v + 1);
+    }
+
+    forward.Clear();
+    backward.Clear();
+    return result;
+}
+
+/************************************************************************************//*!
+ @brief     Finds the shortest distance from every source to every target, with one
+            search per source on a pool of threads.
+
+ @param     sourceNodes
+    The source nodes.
+ @param     targetNodes
+    The target nodes.
+ @param     threads
+    The number of threads to use. 0 uses every hardware thread.
+
+ @returns   The distances, row by row.
+*//*************************************************************************************/
+std::vector<unsigned> FrozenGraph::DistanceMatrix
+(
+    const std::vector<unsigned>&    sourceNodes,
+    const std::vector<unsigned>&    targetNodes,
+    unsigned int                    threads
+) const
+{
+    const size_t ROWS       = sourceNodes.size();
+    const size_t COLUMNS    = targetNodes.size();
+    std::vector<unsigned> matrix(ROWS * COLUMNS, INF);
+    if (ROWS == 0 || COLUMNS == 0)
+        return matrix;
+
+    const unsigned NUM_VERTEX = VertexCount();
+
+    // A search can stop once every distinct target is settled
+    std::vector<bool> isTarget(NUM_VERTEX, false);
+    unsigned distinctTargets = 0;
+    for (unsigned target : targetNodes)
+    {
+        if (!isTarget[target - 1])
+        {
+            isTarget[target - 1] = true;
+            ++distinctTargets;
+        }
+    }
+
+    std::atomic<size_t> nextRow{ 0 };
+    const auto search = [&]()
+    {
+        SearchSpace& space = SearchSpace::ForThread(0);
+        space.Prepare(NUM_VERTEX);
+
+        for (size_t row = nextRow.fetch_add(1, std::memory_order_relaxed); row < ROWS; row = nextRow.fetch_add(1, std::memory_order_relaxed))
+        {
+            space.Reach(sourceNodes[row] - 1, 0, INF, INF);
+
+            unsigned remaining = distinctTargets;
+            while (!space.queue.empty() && remaining > 0)
+            {
+                const SearchSpace::Entry TOP = space.queue.top();
+                space.queue.pop();
+
+                const unsigned START = TOP.second;
+                if (TOP.first != space.cost[START])
+                    continue;
+
+                if (isTarget[START])
+                    --remaining;
+
+                for (unsigned e = offsets[START]; e < offsets[START + 1]; ++e)
+                {
+                    const unsigned long long CURRENT_COST = static_cast<unsigned long long>(TOP.first) + weights[e];
+                    if (CURRENT_COST < space.cost[targets[e]])
+                        space.Reach(targets[e], static_cast<unsigned>(CURRENT_COST), START, e);
+                }
+            }
+
+            unsigned* distances = matrix.data() + row * COLUMNS;
+            for (size_t column = 0; column < COLUMNS; ++column)
+                distances[column] = space.cost[targetNodes[column] - 1];
+
+            space.Clear();
+        }
+    };
+
+    if (threads == 0)
+        threads = std::max(std::thread::hardware_concurrency(), 1u);
+    threads = static_cast<unsigned>(std::min<size_t>(threads, ROWS));
+
+    WorkerPool::Instance().Run(threads, search);
+    return matrix;
+}
+
+/*-------------------------------------------------------------------------------------*/
+/* Private Function Members                                                            */
+/*-------------------------------------------------------------------------------------*/
+/************************************************************************************//*!
+ @brief     Picks a bucket width from the largest weight over the average degree.
+
+ @returns   The bucket width. At least 1.
+*//*************************************************************************************/
+unsigned FrozenGraph::defaultDelta() const
+{
+    if (targets.empty())
+        return 1;
+
+    const unsigned long long MAX_WEIGHT = *std::max_element(weights.begin(), weights.end());
+    const unsigned long long DELTA      = MAX_WEIGHT * VertexCount() / targets.size();
+
+    return static_cast<unsigned>(std::min<unsigned long long>(std::max<unsigned long long>(DELTA, 1), INF - 1));
+}
+/************************************************************************************//*!
+ @brief     Builds the paths to every vertex from its final distance.
+
+ @param     startNode
+    The source node.
+ @param     distances
+    The shortest distance to every vertex, numbered from 0.
+
+ @returns   A vector of DijkstraInfo structs.
+*//*************************************************************************************/
+FrozenGraph::DijkstraResult FrozenGraph::buildPaths(unsigned int startNode, const std::vector<unsigned>& distances) const
+{
+    const unsigned NUM_VERTEX = VertexCount();
+
+    // Dijkstra settles the reachable vertices by distance, then by number
+    std::vector<unsigned> order;
+    for (unsigned i = 0; i < NUM_VERTEX; ++i)
+    {
+        if (distances[i] != INF)
+            order.emplace_back(i);
+    }
+    std::sort(order.begin(), order.end(), [&distances](unsigned lhs, unsigned rhs)->bool
+    {
+        return distances[lhs] < distances[rhs] || (distances[lhs] == distances[rhs] && lhs < rhs);
+    });
+
+    std::vector<unsigned> parent(NUM_VERTEX, INF);
+    parent[startNode - 1] = startNode - 1;
+
+    // Dijkstra settles a group of vertices at the same distance by number, but only
+    // among those it has reached. A vertex only reachable through a zero weight edge
+    // inside its group joins the group once the vertex that reaches it is settled.
+    std::vector<unsigned> settled;
+    settled.reserve(order.size());
+    std::priority_queue<unsigned, std::vector<unsigned>, std::greater<unsigned>> reached;
+
+    for (size_t first = 0; first < order.size(); )
+    {
+        const unsigned GROUP_COST = distances[order[first]];
+
+        size_t last = first;
+        for (; last < order.size() && distances[order[last]] == GROUP_COST; ++last)
+        {
+            if (parent[order[last]] != INF)
+                reached.emplace(order[last]);
+        }
+
+        while (!reached.empty())
+        {
+            const unsigned START = reached.top();
+            reached.pop();
+            settled.emplace_back(START);
+
+            for (unsigned e = offsets[START]; e < offsets[START + 1]; ++e)
+            {
+                const unsigned DST = targets[e];
+                if (parent[DST] != INF || static_cast<unsigned long long>(GROUP_COST) + weights[e] != distances[DST])
+                    continue;
+
+                parent[DST] = START;
+                if (distances[DST] == GROUP_COST)
+                    reached.emplace(DST);
+            }
+        }
+
+        first = last;
+    }
+
+    DijkstraResult result{ NUM_VERTEX };
+    for (DijkstraInfo& info : result)
+        info.cost = INF;
+
+    // Parents are settled before their children
+    for (unsigned v : settled)
+    {
+        DijkstraInfo& info = result[v];
+        info.cost = distances[v];
+
+        if (parent[v] != v)
+            info.path = result[parent[v]].path;
+        info.path.emplace_back(v + 1);
+    }
+
+    return result;
+}
@@ -0,0 +1,185 @@
+/************************************************************************************//*!
+ @file    FrozenGraph.h
+ @author  Diren D Bharwani, 2002216, diren.dbharwani, diren.dbharwani@digipen.edu
+ @date    Mar 3, 2022
+ @brief   Contains the interface for the FrozenGraph object, an immutable snapshot of an
+          ALGraph in compressed sparse row form.
+
+ Copyright (C) 2022 DigiPen Institute of Technology.
+ Reproduction or disclosure of this file or its contents without the prior written
+ consent of DigiPen Institute of Technology is prohibited.
+*//*************************************************************************************/
+
+#ifndef FROZENGRAPH_H
+#define FROZENGRAPH_H
+
+// Standard Libraries
+#include <vector>
+// Project Headers
+#include "ALGraph.h"
+
+/************************************************************************************//*!
+ @brief     Encapsulates an immutable graph in compressed sparse row form.
+
+            The edges of every vertex sit next to each other in two flat arrays, in the
+            same order as the ALGraph they came from. The edges of vertex v are at
+            [offsets[v], offsets[v + 1]). The same edges are also kept by destination,
+            so searches can walk backwards from a target. Vertices are numbered from 1
+            in the interface, like ALGraph, and from 0 in the arrays.
+*//*************************************************************************************/
+class FrozenGraph
+{
+public:
+    /*---------------------------------------------------------------------------------*/
+    /* Type Definitions                                                                */
+    /*---------------------------------------------------------------------------------*/
+    using DijkstraResult = ALGraph::DijkstraResult;
+
+    /*---------------------------------------------------------------------------------*/
+    /* Constructors & Destructor                                                       */
+    /*---------------------------------------------------------------------------------*/
+    /********************************************************************************//*!
+    @brief      Default Constructor for an empty FrozenGraph.
+    *//*********************************************************************************/
+    FrozenGraph() = default;
+    /********************************************************************************//*!
+    @brief      Constructs a FrozenGraph from compressed sparse row arrays.
+
+    @param      edgeOffsets
+        The index of the first edge of every vertex, followed by the number of edges.
+    @param      edgeTargets
+        The destination of every edge, numbered from 0.
+    @param      edgeWeights
+        The weight of every edge.
+    *//*********************************************************************************/
+    FrozenGraph
+    (
+        std::vector<unsigned>&& edgeOffsets,
+        std::vector<unsigned>&& edgeTargets,
+        std::vector<unsigned>&& edgeWeights
+    );
+
+    /*---------------------------------------------------------------------------------*/
+    /* Getter Functions                                                                */
+    /*---------------------------------------------------------------------------------*/
+    /********************************************************************************//*!
+    @brief      Gets the number of vertices in the graph.
+
+    @returns    The number of vertices.
+    *//*********************************************************************************/
+    unsigned    VertexCount ()  const;
+    /********************************************************************************//*!
+    @brief      Gets the number of directed edges in the graph.
+
+    @returns    The number of edges. An undirected edge counts twice.
+    *//*********************************************************************************/
+    unsigned    EdgeCount   ()  const;
+
+    /*---------------------------------------------------------------------------------*/
+    /* Function Members                                                                */
+    /*---------------------------------------------------------------------------------*/
+    /********************************************************************************//*!
+    @brief      Finds the shortest path from a given node to all the other nodes in
+                the graph with delta-stepping, on several threads.
+
+                Vertices are settled in buckets of distances delta wide instead of one
+                at a time, and each bucket is relaxed by every thread at once. The
+                costs and paths are the same as ALGraph::Dijkstra, which takes the
+                path through the earliest settled vertex when several are as short.
+
+    @param      startNode
+        The source node.
+    @param      delta
+        The width of a bucket. 0 picks one from the weights and degrees of the graph.
+        It is widened if the largest weight spans more than 4095 buckets.
+    @param      threads
+        The number of threads to use. 0 uses every hardware thread.
+
+    @returns    A vector of DijkstraInfo structs.
+    *//*********************************************************************************/
+    DijkstraResult  DeltaStepping   (unsigned int startNode, unsigned int delta = 0, unsigned int threads = 0) const;
+    /********************************************************************************//*!
+    @brief      Finds the shortest path between two nodes with bidirectional Dijkstra.
+                A search from each end stops once the two have met on a path that
+                neither can improve, usually long before the whole graph is searched.
+
+    @param      startNode
+        The source node.
+    @param      endNode
+        The target node.
+
+    @returns    The cost and path from source to target. If several paths are as
+                short, any of them. The cost is -1 and the path empty if the target
+                can't be reached.
+    *//*********************************************************************************/
+    DijkstraInfo    ShortestPath    (unsigned int startNode, unsigned int endNode) const;
+    /********************************************************************************//*!
+    @brief      Finds the shortest distance from every source to every target.
+
+                Sources are handed out one at a time to a pool of threads that lives
+                as long as the program, so the search buffers of every thread are
+                reused by every call. Each search stops once every target is settled.
+
+    @param      sourceNodes
+        The source nodes.
+    @param      targetNodes
+        The target nodes.
+    @param      threads
+        The number of threads to use. 0 uses every hardware thread.
+
+    @returns    The distances, row by row. The distance from sourceNodes[i] to
+                targetNodes[j] is at i * targetNodes.size() + j, and is -1 if the
+                target can't be reached.
+    *//*********************************************************************************/
+    std::vector<unsigned> DistanceMatrix
+    (
+        const std::vector<unsigned>&    sourceNodes,
+        const std::vector<unsigned>&    targetNodes,
+        unsigned int                    threads = 0
+    ) const;
+
+private:
+    /*---------------------------------------------------------------------------------*/
+    /* Friends                                                                         */
+    /*---------------------------------------------------------------------------------*/
+    friend class ContractionHierarchy;
+
+    /*---------------------------------------------------------------------------------*/
+    /* Data Members                                                                    */
+    /*---------------------------------------------------------------------------------*/
+    static constexpr unsigned   INF             = static_cast<unsigned>(-1);
+
+    std::vector<unsigned>   offsets;    //!< The index of the first edge of every vertex
+    std::vector<unsigned>   targets;    //!< The destination of every edge, from 0
+    std::vector<unsigned>   weights;    //!< The weight of every edge
+
+    std::vector<unsigned>   reverseOffsets; //!< The index of the first edge into every vertex
+    std::vector<unsigned>   reverseSources; //!< The source of every edge, by destination
+    std::vector<unsigned>   reverseWeights; //!< The weight of every edge, by destination
+
+    /*---------------------------------------------------------------------------------*/
+    /* Function Members                                                                */
+    /*---------------------------------------------------------------------------------*/
+    /********************************************************************************//*!
+    @brief      Picks a bucket width. Around the largest weight over the average degree,
+                each bucket holds about one relaxation per vertex in it.
+
+    @returns    The bucket width. At least 1.
+    *//*********************************************************************************/
+    unsigned        defaultDelta    ()  const;
+    /********************************************************************************//*!
+    @brief      Builds the paths to every vertex from its final distance. Vertices are
+                visited in the order ALGraph::Dijkstra settles them, and each takes the
+                path of the first visited vertex with an edge that makes it as short.
+
+    @param      startNode
+        The source node.
+    @param      distances
+        The shortest distance to every vertex, numbered from 0.
+
+    @returns    A vector of DijkstraInfo structs.
+    *//*********************************************************************************/
+    DijkstraResult  buildPaths      (unsigned int startNode, const std::vector<unsigned>& distances) const;
+};
+
+#endif
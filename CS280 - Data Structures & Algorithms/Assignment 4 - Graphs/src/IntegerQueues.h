@@ -0,0 +1,276 @@
+/************************************************************************************//*!
+ @file    IntegerQueues.h
+ @author  Diren D Bharwani, 2002216, diren.dbharwani, diren.dbharwani@digipen.edu
+ @date    Mar 3, 2022
+ @brief   Contains min-queues of vertices keyed by unsigned costs, for Dijkstra's
+          algorithm.
+
+ Copyright (C) 2022 DigiPen Institute of Technology.
+ Reproduction or disclosure of this file or its contents without the prior written
+ consent of DigiPen Institute of Technology is prohibited.
+*//*************************************************************************************/
+
+#ifndef INTEGERQUEUES_H
+#define INTEGERQUEUES_H
+
+// Standard Libraries
+#include <vector>
+#include <queue>
+#include <utility>      // std::pair
+#include <functional>   // std::greater
+#include <algorithm>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/*-------------------------------------------------------------------------------------*/
+/* Type Definitions                                                                    */
+/*-------------------------------------------------------------------------------------*/
+/************************************************************************************//*!
+ @brief     Every queue holds entries of a cost and a vertex, and takes the number of
+            vertices and the largest edge weight of the graph when it is constructed.
+
+            Costs only ever increase from one pop to the next in Dijkstra's algorithm,
+            which the bucket queues rely on. Only the indexed heap supports decrease
+            key. The others queue a vertex again, and the search skips the old entry.
+*//*************************************************************************************/
+using QueueEntry = std::pair<unsigned, unsigned>;  //!< A cost and a vertex
+
+/************************************************************************************//*!
+ @brief     A binary heap of entries, like std::priority_queue in ALGraph::Dijkstra.
+            Ties are broken by vertex.
+*//*************************************************************************************/
+class BinaryHeap
+{
+public:
+    BinaryHeap(unsigned, unsigned) {}
+
+    bool        Empty   () const                        { return heap.empty(); }
+    void        Push    (unsigned cost, unsigned vertex) { heap.emplace(cost, vertex); }
+    QueueEntry  Pop     ()
+    {
+        const QueueEntry TOP = heap.top();
+        heap.pop();
+        return TOP;
+    }
+
+private:
+    std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> heap;
+};
+
+/************************************************************************************//*!
+ @brief     A heap of vertices with D children per node, and the position of every
+            vertex in it, so a vertex is queued once and moved up when its cost drops.
+            Ties are broken by vertex, so vertices leave in the same order as from a
+            BinaryHeap.
+*//*************************************************************************************/
+template <unsigned D>
+class IndexedDAryHeap
+{
+public:
+    IndexedDAryHeap(unsigned vertices, unsigned)
+    : costs     ( vertices )
+    , positions ( vertices, ABSENT )
+    {}
+
+    bool Empty() const
+    {
+        return heap.empty();
+    }
+    void Push(unsigned cost, unsigned vertex)
+    {
+        if (positions[vertex] == ABSENT)
+        {
+            positions[vertex] = static_cast<unsigned>(heap.size());
+            heap.emplace_back(vertex);
+        }
+        else if (cost >= costs[vertex])
+        {
+            return;
+        }
+
+        costs[vertex] = cost;
+        siftUp(positions[vertex]);
+    }
+    QueueEntry Pop()
+    {
+        const unsigned TOP = heap.front();
+        positions[TOP] = ABSENT;
+
+        const unsigned LAST = heap.back();
+        heap.pop_back();
+        if (!heap.empty())
+        {
+            heap.front() = LAST;
+            positions[LAST] = 0;
+            siftDown(0);
+        }
+
+        return QueueEntry{ costs[TOP], TOP };
+    }
+
+private:
+    static constexpr unsigned ABSENT = static_cast<unsigned>(-1);
+
+    std::vector<unsigned>   heap;       //!< The queued vertices, in heap order
+    std::vector<unsigned>   costs;      //!< The cost of every queued vertex
+    std::vector<unsigned>   positions;  //!< The index of every vertex in the heap, or ABSENT
+
+    bool less(unsigned lhs, unsigned rhs) const
+    {
+        return costs[lhs] < costs[rhs] || (costs[lhs] == costs[rhs] && lhs < rhs);
+    }
+    void place(unsigned index, unsigned vertex)
+    {
+        heap[index] = vertex;
+        positions[vertex] = index;
+    }
+    void siftUp(unsigned index)
+    {
+        const unsigned VERTEX = heap[index];
+        while (index > 0)
+        {
+            const unsigned PARENT = (index - 1) / D;
+            if (!less(VERTEX, heap[PARENT]))
+                break;
+
+            place(index, heap[PARENT]);
+            index = PARENT;
+        }
+        place(index, VERTEX);
+    }
+    void siftDown(unsigned index)
+    {
+        const unsigned VERTEX   = heap[index];
+        const unsigned SIZE     = static_cast<unsigned>(heap.size());
+        while (true)
+        {
+            const unsigned FIRST = index * D + 1;
+            if (FIRST >= SIZE)
+                break;
+
+            unsigned best = FIRST;
+            for (unsigned child = FIRST + 1; child < std::min(FIRST + D, SIZE); ++child)
+            {
+                if (less(heap[child], heap[best]))
+                    best = child;
+            }
+
+            if (!less(heap[best], VERTEX))
+                break;
+
+            place(index, heap[best]);
+            index = best;
+        }
+        place(index, VERTEX);
+    }
+};
+
+template <unsigned D>
+constexpr unsigned IndexedDAryHeap<D>::ABSENT;
+
+/************************************************************************************//*!
+ @brief     Dial's buckets. Every queued cost is within the largest edge weight of the
+            last cost popped, so a ring of one bucket per cost covers them all and a
+            pop only steps forward to the next full bucket. The ring is as long as the
+            largest weight, so it suits small weights.
+*//*************************************************************************************/
+class DialBuckets
+{
+public:
+    DialBuckets(unsigned, unsigned maxWeight)
+    : buckets   ( static_cast<size_t>(maxWeight) + 1 )
+    {}
+
+    bool Empty() const
+    {
+        return count == 0;
+    }
+    void Push(unsigned cost, unsigned vertex)
+    {
+        buckets[cost % buckets.size()].emplace_back(vertex);
+        ++count;
+    }
+    QueueEntry Pop()
+    {
+        while (buckets[current % buckets.size()].empty())
+            ++current;
+
+        std::vector<unsigned>& bucket = buckets[current % buckets.size()];
+        const unsigned VERTEX = bucket.back();
+        bucket.pop_back();
+        --count;
+
+        return QueueEntry{ current, VERTEX };
+    }
+
+private:
+    std::vector<std::vector<unsigned>>  buckets;        //!< The vertices queued at every cost
+    unsigned                            current = 0;    //!< The last cost popped
+    size_t                              count   = 0;    //!< The number of queued vertices
+};
+
+/************************************************************************************//*!
+ @brief     A radix heap. An entry goes in the bucket of the highest bit where its cost
+            differs from the last cost popped. When the bucket of equal costs runs out,
+            the next full bucket is spread over the buckets below it around its
+            smallest cost, so every entry moves at most once per bit, 32 times.
+*//*************************************************************************************/
+class RadixHeap
+{
+public:
+    RadixHeap(unsigned, unsigned) {}
+
+    bool Empty() const
+    {
+        return count == 0;
+    }
+    void Push(unsigned cost, unsigned vertex)
+    {
+        buckets[bucketOf(cost)].emplace_back(cost, vertex);
+        ++count;
+    }
+    QueueEntry Pop()
+    {
+        if (buckets[0].empty())
+        {
+            unsigned full = 1;
+            while (buckets[full].empty())
+                ++full;
+
+            std::vector<QueueEntry>& spread = buckets[full];
+            last = std::min_element(spread.begin(), spread.end())->first;
+            for (const QueueEntry& entry : spread)
+                buckets[bucketOf(entry.first)].emplace_back(entry);
+            spread.clear();
+        }
+
+        const QueueEntry TOP = buckets[0].back();
+        buckets[0].pop_back();
+        --count;
+
+        return TOP;
+    }
+
+private:
+    std::vector<QueueEntry> buckets[33];    //!< Entries by the highest bit that differs from last
+    unsigned                last    = 0;    //!< The last cost popped
+    size_t                  count   = 0;    //!< The number of queued entries
+
+    unsigned bucketOf(unsigned cost) const
+    {
+        const unsigned DIFFERENT = cost ^ last;
+        if (DIFFERENT == 0)
+            return 0;
+
+#if defined(_MSC_VER)
+        unsigned long bit;
+        _BitScanReverse(&bit, DIFFERENT);
+        return static_cast<unsigned>(bit) + 1;
+#else
+        return 32 - static_cast<unsigned>(__builtin_clz(DIFFERENT));
+#endif
+    }
+};
+
+#endif
@@ -0,0 +1,126 @@
+/************************************************************************************//*!
+ @file    SearchSpace.h
+ @author  Diren D Bharwani, 2002216, diren.dbharwani, diren.dbharwani@digipen.edu
+ @date    Mar 3, 2022
+ @brief   Contains the SearchSpace object, the reusable state of a shortest path search.
+
+ Copyright (C) 2022 DigiPen Institute of Technology.
+ Reproduction or disclosure of this file or its contents without the prior written
+ consent of DigiPen Institute of Technology is prohibited.
+*//*************************************************************************************/
+
+#ifndef SEARCHSPACE_H
+#define SEARCHSPACE_H
+
+// Standard Libraries
+#include <vector>
+#include <queue>
+#include <utility>      // std::pair
+#include <functional>   // std::greater
+
+/************************************************************************************//*!
+ @brief     Encapsulates the costs and parents of a search that stops early.
+
+            Every vertex starts unreached. The vertices a search reaches are listed,
+            so clearing costs as much as the search did instead of the whole graph,
+            and one SearchSpace can serve many searches.
+*//*************************************************************************************/
+class SearchSpace
+{
+public:
+    /*---------------------------------------------------------------------------------*/
+    /* Type Definitions                                                                */
+    /*---------------------------------------------------------------------------------*/
+    using Entry = std::pair<unsigned, unsigned>;   //!< A cost and a vertex
+
+    /********************************************************************************//*!
+    @brief      A min-queue of entries that keeps its memory when it is cleared.
+    *//*********************************************************************************/
+    class Queue : public std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>>
+    {
+    public:
+        void clear() { c.clear(); }
+    };
+
+    /*---------------------------------------------------------------------------------*/
+    /* Data Members                                                                    */
+    /*---------------------------------------------------------------------------------*/
+    static constexpr unsigned   INF     = static_cast<unsigned>(-1);
+
+    std::vector<unsigned>   cost;       //!< The best cost found to every vertex
+    std::vector<unsigned>   parent;     //!< The vertex before every vertex on its path
+    std::vector<unsigned>   via;        //!< The edge from the parent to every vertex
+    Queue                   queue;      //!< The vertices to settle
+
+    /*---------------------------------------------------------------------------------*/
+    /* Function Members                                                                */
+    /*---------------------------------------------------------------------------------*/
+    /********************************************************************************//*!
+    @brief      Gets a SearchSpace owned by the calling thread, so searches on several
+                threads never share one.
+
+    @param      slot
+        Which of the thread's SearchSpaces to get, 0 or 1. A bidirectional search
+        uses both.
+
+    @returns    The SearchSpace, with every vertex unreached.
+    *//*********************************************************************************/
+    static SearchSpace& ForThread(unsigned slot)
+    {
+        static thread_local SearchSpace spaces[2];
+        return spaces[slot];
+    }
+    /********************************************************************************//*!
+    @brief      Makes room for a graph. Every vertex must be unreached.
+
+    @param      vertices
+        The number of vertices in the graph.
+    *//*********************************************************************************/
+    void Prepare(unsigned vertices)
+    {
+        if (cost.size() < vertices)
+        {
+            cost.resize(vertices, INF);
+            parent.resize(vertices, INF);
+            via.resize(vertices, INF);
+        }
+    }
+    /********************************************************************************//*!
+    @brief      Records a path to a vertex and queues it to be settled.
+
+    @param      vertex
+        The vertex reached.
+    @param      vertexCost
+        The cost of the path.
+    @param      from
+        The vertex before it on the path.
+    @param      edge
+        The edge from the vertex before it.
+    *//*********************************************************************************/
+    void Reach(unsigned vertex, unsigned vertexCost, unsigned from, unsigned edge)
+    {
+        if (cost[vertex] == INF)
+            reached.emplace_back(vertex);
+
+        cost[vertex]    = vertexCost;
+        parent[vertex]  = from;
+        via[vertex]     = edge;
+        queue.emplace(vertexCost, vertex);
+    }
+    /********************************************************************************//*!
+    @brief      Marks every reached vertex unreached again and empties the queue.
+    *//*********************************************************************************/
+    void Clear()
+    {
+        for (unsigned vertex : reached)
+            cost[vertex] = parent[vertex] = via[vertex] = INF;
+
+        reached.clear();
+        queue.clear();
+    }
+
+private:
+    std::vector<unsigned>   reached;    //!< Every vertex with a cost
+};
+
+#endif
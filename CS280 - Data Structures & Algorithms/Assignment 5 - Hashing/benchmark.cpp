@@ -0,0 +1,520 @@
+/************************************************************************************//*!
+ @file    benchmark.cpp
+ @author  Diren D Bharwani, 2002216, diren.dbharwani, diren.dbharwani@digipen.edu
+ @date    Apr 10, 2022
+ @brief   Contains the implementation of the hash table benchmarks.
+ 
+ Copyright (C) 2022 DigiPen Institute of Technology.
+ Reproduction or disclosure of this file or its contents without the prior written 
+ consent of DigiPen Institute of Technology is prohibited.
+*//*************************************************************************************/
+
+// Primary Header
+#include "benchmark.h"
+// Standard Libraries
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <array>
+#include <string>
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <limits>
+#include <stdexcept>
+// Project Headers
+#include "src/ChHashTable.h"
+#include "src/OAHashTable.h"
+#include "src/ConcurrentChHashTable.h"
+
+/*-------------------------------------------------------------------------------------*/
+/* Local Helpers                                                                       */
+/*-------------------------------------------------------------------------------------*/
+namespace
+{
+    const unsigned  NUM_INSERTS     = 4000000;  //!< keys inserted into every table
+    const unsigned  INITIAL_SIZE    = 1009;     //!< slots every table starts with
+    const unsigned  NUM_LOOKUPS     = 4000000;  //!< finds timed on every table
+    const unsigned  NUM_PROBES      = 2000000;  //!< lookups timed per hit ratio
+    const unsigned  NUM_SHARED      = 1000000;  //!< keys every thread looks up
+    const unsigned  OPS_PER_THREAD  = 500000;   //!< operations timed on every thread
+    const unsigned  KEYS_PER_THREAD = 65536;    //!< keys made up front per thread, cycled
+
+    /********************************************************************************//*!
+    @brief      Hashes a key with FNV-1a.
+
+    @param      key
+        The key to hash.
+    @param      tableSize
+        The size of the table.
+
+    @returns    The index of the key in the table.
+    *//*********************************************************************************/
+    unsigned fnvHash(const char* key, unsigned tableSize)
+    {
+        unsigned hash = 2166136261u;
+        while (*key)
+        {
+            hash ^= static_cast<unsigned char>(*key++);
+            hash *= 16777619u;
+        }
+
+        return hash % tableSize;
+    }
+    /********************************************************************************//*!
+    @brief      Raises 10 to a power.
+
+    @param      exponent
+        The power.
+
+    @returns    10 to the power of exponent.
+    *//*********************************************************************************/
+    constexpr unsigned powerOf10(unsigned exponent)
+    {
+        unsigned result = 1;
+        for (unsigned i = 0; i < exponent; ++i)
+        {
+            result *= 10;
+        }
+        return result;
+    }
+    /********************************************************************************//*!
+    @brief      Writes the key of a number.
+
+    @param      number
+        The number, of at most MAX_KEYLEN - 1 digits, as the tables hold no longer key.
+    @param      key
+        The buffer to write to, MAX_KEYLEN long.
+
+    @throws     std::out_of_range
+        If the number has too many digits, rather than cut its key short.
+    *//*********************************************************************************/
+    void makeKey(unsigned number, char* key)
+    {
+        static_assert(MAX_KEYLEN - 1 <= std::numeric_limits<unsigned>::digits10, "Every key number must fit an unsigned.");
+        static constexpr unsigned KEY_LIMIT = powerOf10(MAX_KEYLEN - 1);
+
+        if (number >= KEY_LIMIT)
+        {
+            throw std::out_of_range{ "Key number " + std::to_string(number) + " is too long for a key." };
+        }
+        std::snprintf(key, MAX_KEYLEN, "%u", number);
+    }
+
+    /********************************************************************************//*!
+    @brief      Inserts keys into a table one at a time, timing every insert, and
+                prints a row of latency percentiles.
+
+    @param      name
+        The name of the configuration.
+    @param      migrationRate
+        The number of slots moved per operation while growing, 0 for all at once.
+    *//*********************************************************************************/
+    void benchmarkInserts(const std::string& name, unsigned migrationRate)
+    {
+        using Clock = std::chrono::steady_clock;
+
+        ChHashTable<unsigned>::HTConfig config{ INITIAL_SIZE, fnvHash, 3.0, 2.0, nullptr, migrationRate };
+        ChHashTable<unsigned> table{ config };
+
+        std::vector<float> latencies(NUM_INSERTS);
+        char key[MAX_KEYLEN];
+
+        const Clock::time_point START = Clock::now();
+        for (unsigned i = 0; i < NUM_INSERTS; ++i)
+        {
+            makeKey(i, key);
+
+            const Clock::time_point BEFORE = Clock::now();
+            table.insert(key, i);
+            const std::chrono::duration<float, std::micro> ELAPSED = Clock::now() - BEFORE;
+
+            latencies[i] = ELAPSED.count();
+        }
+        const std::chrono::duration<double, std::milli> TOTAL = Clock::now() - START;
+
+        std::sort(latencies.begin(), latencies.end());
+        const auto percentile = [&latencies](double fraction)
+        {
+            return latencies[std::min(latencies.size() - 1, static_cast<size_t>(fraction * latencies.size()))];
+        };
+
+        std::cout << std::fixed << std::setprecision(2)
+                  << std::setw(14) << name
+                  << std::setw(10) << table.GetStats().Expansions_
+                  << std::setw(10) << percentile(0.5)
+                  << std::setw(10) << percentile(0.99)
+                  << std::setw(10) << percentile(0.999)
+                  << std::setw(10) << percentile(0.9999)
+                  << std::setw(12) << latencies.back()
+                  << std::setw(10) << std::setprecision(0) << TOTAL.count() << '\n';
+    }
+    /********************************************************************************//*!
+    @brief      Fills a table, timing the inserts that grow it, then times finds of
+                random keys in it, and prints a row of results.
+
+    @param      size
+        The number of keys to insert.
+    *//*********************************************************************************/
+    void benchmarkGrowth(unsigned size)
+    {
+        using Clock = std::chrono::steady_clock;
+
+        ChHashTable<unsigned>::HTConfig config{ INITIAL_SIZE, fnvHash };
+        ChHashTable<unsigned> table{ config };
+        char key[MAX_KEYLEN];
+
+        // Only the inserts that grow the table are counted
+        double growthTime = 0.0;
+        for (unsigned i = 0; i < size; ++i)
+        {
+            makeKey(i, key);
+
+            const unsigned              EXPANSIONS  = table.GetStats().Expansions_;
+            const Clock::time_point     BEFORE      = Clock::now();
+            table.insert(key, i);
+            const std::chrono::duration<double, std::milli> ELAPSED = Clock::now() - BEFORE;
+
+            if (table.GetStats().Expansions_ != EXPANSIONS)
+                growthTime += ELAPSED.count();
+        }
+
+        // Keys to find, made up front so only the finds are timed
+        std::vector<std::array<char, MAX_KEYLEN>> keys(NUM_LOOKUPS);
+        for (unsigned i = 0; i < NUM_LOOKUPS; ++i)
+            makeKey(static_cast<unsigned>((i * 2654435761ull) % size), keys[i].data());
+
+        bool valid = true;
+        const Clock::time_point START = Clock::now();
+        for (unsigned i = 0; i < NUM_LOOKUPS; ++i)
+            valid &= table.find(keys[i].data()) == static_cast<unsigned>((i * 2654435761ull) % size);
+        const std::chrono::duration<double> LOOKUP_TIME = Clock::now() - START;
+
+        std::cout << std::fixed << std::setprecision(1)
+                  << std::setw(10) << size
+                  << std::setw(10) << table.GetStats().Expansions_
+                  << std::setw(12) << growthTime
+                  << std::setw(12) << NUM_LOOKUPS / LOOKUP_TIME.count() / 1e6
+                  << std::setw(8)  << (valid ? "yes" : "NO") << '\n';
+    }
+    /********************************************************************************//*!
+    @brief      Times lookups of a list of keys in a table.
+
+    @param      table
+        The table, a ChHashTable or an OAHashTable.
+    @param      keys
+        The keys to look up.
+    @param      found
+        Set to the number of keys found.
+
+    @returns    The number of lookups per second, in millions.
+    *//*********************************************************************************/
+    template <typename Table>
+    double timeLookups(const Table& table, const std::vector<std::array<char, MAX_KEYLEN>>& keys, unsigned& found)
+    {
+        using Clock = std::chrono::steady_clock;
+
+        found = 0;
+        const Clock::time_point START = Clock::now();
+        for (const auto& key : keys)
+            found += table.lookup(key.data()) != nullptr;
+        const std::chrono::duration<double> ELAPSED = Clock::now() - START;
+
+        return keys.size() / ELAPSED.count() / 1e6;
+    }
+    /********************************************************************************//*!
+    @brief      Fills a ChHashTable and an OAHashTable with the same keys, up to a load
+                factor that neither grows at, and prints a row of lookup rates for
+                every hit ratio.
+
+    @param      slots
+        The number of slots in both tables, a power of two.
+    @param      loadFactor
+        The fraction of the slots to fill.
+    *//*********************************************************************************/
+    void benchmarkTables(unsigned slots, double loadFactor)
+    {
+        const unsigned SIZE = static_cast<unsigned>(slots * loadFactor);
+
+        // Chained tables don't need a prime size here, but the client hash is a plain mod
+        ChHashTable<unsigned>::HTConfig chainedConfig{ GetClosestPrime(slots), fnvHash };
+        OAHashTable<unsigned>::HTConfig openConfig{ slots, fnvHash, 1.0 };
+        ChHashTable<unsigned> chained{ chainedConfig };
+        OAHashTable<unsigned> open{ openConfig };
+
+        char key[MAX_KEYLEN];
+        for (unsigned i = 0; i < SIZE; ++i)
+        {
+            makeKey(i, key);
+            chained.insert(key, i);
+            open.insert(key, i);
+        }
+
+        for (double hitRatio : { 1.0, 0.5, 0.0 })
+        {
+            // Hits are random keys in the tables, misses are keys after the last one
+            std::vector<std::array<char, MAX_KEYLEN>> keys(NUM_PROBES);
+            const unsigned HITS = static_cast<unsigned>(NUM_PROBES * hitRatio);
+            for (unsigned i = 0; i < NUM_PROBES; ++i)
+            {
+                if (i < HITS)
+                    makeKey(static_cast<unsigned>((i * 2654435761ull) % SIZE), keys[i].data());
+                else
+                    makeKey(SIZE + i, keys[i].data());
+            }
+            std::shuffle(keys.begin(), keys.end(), std::mt19937{ 5489u });
+
+            unsigned chainedFound, openFound;
+            const double CHAINED_RATE   = timeLookups(chained, keys, chainedFound);
+            const double OPEN_RATE      = timeLookups(open, keys, openFound);
+
+            std::cout << std::fixed << std::setprecision(2)
+                      << std::setw(10) << slots
+                      << std::setw(8)  << loadFactor
+                      << std::setw(8)  << std::setprecision(0) << hitRatio * 100.0 << '%'
+                      << std::setw(12) << std::setprecision(1) << CHAINED_RATE
+                      << std::setw(12) << OPEN_RATE
+                      << std::setw(10) << std::setprecision(2) << OPEN_RATE / CHAINED_RATE
+                      << std::setw(8)  << (chainedFound == HITS && openFound == HITS
+                                           && open.GetStats().Expansions_ == 0 ? "yes" : "NO") << '\n';
+        }
+    }
+    /********************************************************************************//*!
+    @brief      A ChHashTable behind one lock, the way it has to be shared without a
+                concurrent table.
+    *//*********************************************************************************/
+    class LockedTable
+    {
+    public:
+        explicit LockedTable(const ChHashTable<unsigned>::HTConfig& config)
+        : table ( config )
+        {}
+
+        void insert(const char* key, unsigned data)
+        {
+            std::lock_guard<std::mutex> lock{ mutex };
+            table.insert(key, data);
+        }
+        void remove(const char* key)
+        {
+            std::lock_guard<std::mutex> lock{ mutex };
+            table.remove(key);
+        }
+        bool lookup(const char* key, unsigned& data) const
+        {
+            std::lock_guard<std::mutex> lock{ mutex };
+            const unsigned* found = table.lookup(key);
+            if (found)
+                data = *found;
+            return found != nullptr;
+        }
+
+    private:
+        mutable std::mutex      mutex;
+        ChHashTable<unsigned>   table;
+    };
+
+    /********************************************************************************//*!
+    @brief      Runs a mix of operations on several threads at once. Every thread looks
+                up random shared keys, and its writes alternate between inserting a key
+                of its own and removing the one it inserted before, so the table keeps
+                its size and no operation fails.
+
+    @param      table
+        The table, filled with the shared keys.
+    @param      threadCount
+        The number of threads.
+    @param      writePercent
+        The percentage of operations that are writes.
+    @param      valid
+        Cleared if a lookup misses or finds the wrong data.
+
+    @returns    The operations per second over all threads, in millions.
+    *//*********************************************************************************/
+    template <typename Table>
+    double runMix(Table& table, unsigned threadCount, unsigned writePercent, bool& valid)
+    {
+        using Clock = std::chrono::steady_clock;
+        using KeyList = std::vector<std::array<char, MAX_KEYLEN>>;
+
+        // Keys are made up front so only the operations are timed. Every thread
+        // writes keys after the shared ones that no other thread uses.
+        std::vector<KeyList>                reads(threadCount, KeyList(KEYS_PER_THREAD));
+        std::vector<KeyList>                writes(threadCount, KeyList(KEYS_PER_THREAD));
+        std::vector<std::vector<unsigned>>  expected(threadCount, std::vector<unsigned>(KEYS_PER_THREAD));
+        for (unsigned t = 0; t < threadCount; ++t)
+        {
+            std::mt19937 rng{ t };
+            for (unsigned i = 0; i < KEYS_PER_THREAD; ++i)
+            {
+                expected[t][i] = rng() % NUM_SHARED;
+                makeKey(expected[t][i], reads[t][i].data());
+                makeKey(NUM_SHARED + t * KEYS_PER_THREAD + i, writes[t][i].data());
+            }
+        }
+
+        std::atomic<unsigned>   ready   { 0 };
+        std::atomic<bool>       go      { false };
+        std::atomic<bool>       correct { true };
+        const auto work = [&](unsigned t)
+        {
+            std::mt19937 rng{ 1000 + t };
+            unsigned read = 0, written = 0, data = 0;
+            bool ok = true;
+
+            ++ready;
+            while (!go.load())
+                std::this_thread::yield();
+
+            for (unsigned op = 0; op < OPS_PER_THREAD; ++op)
+            {
+                if (rng() % 100 < writePercent)
+                {
+                    // Even writes insert the next key, odd ones remove the one before it
+                    const char* key = writes[t][(written / 2) % KEYS_PER_THREAD].data();
+                    if (written++ % 2 == 0)
+                        table.insert(key, t);
+                    else
+                        table.remove(key);
+                }
+                else
+                {
+                    const unsigned INDEX = read++ % KEYS_PER_THREAD;
+                    ok &= table.lookup(reads[t][INDEX].data(), data) && data == expected[t][INDEX];
+                }
+            }
+
+            if (!ok)
+                correct = false;
+        };
+
+        std::vector<std::thread> threads;
+        for (unsigned t = 1; t < threadCount; ++t)
+            threads.emplace_back(work, t);
+        while (ready.load() + 1 < threadCount)
+            std::this_thread::yield();
+
+        const Clock::time_point START = Clock::now();
+        go = true;
+        work(0);
+        for (std::thread& thread : threads)
+            thread.join();
+        const std::chrono::duration<double> ELAPSED = Clock::now() - START;
+
+        // Remove the key a thread inserted last, if it was left in the table
+        for (unsigned t = 0; t < threadCount; ++t)
+        {
+            std::mt19937 rng{ 1000 + t };
+            unsigned written = 0;
+            for (unsigned op = 0; op < OPS_PER_THREAD; ++op)
+                written += rng() % 100 < writePercent;
+            if (written % 2 == 1)
+                table.remove(writes[t][(written / 2) % KEYS_PER_THREAD].data());
+        }
+
+        valid &= correct.load();
+        return static_cast<double>(threadCount) * OPS_PER_THREAD / ELAPSED.count() / 1e6;
+    }
+}
+
+/*-------------------------------------------------------------------------------------*/
+/* Function Definitions                                                                */
+/*-------------------------------------------------------------------------------------*/
+
+/************************************************************************************//*!
+ @brief     Measures the latency of every insert into a growing ChHashTable, with the
+            table grown all at once and a few slots per operation.
+*//*************************************************************************************/
+void BenchmarkInsertLatency()
+{
+    std::cout << "Insert latency (us) over " << NUM_INSERTS << " inserts, total (ms)\n";
+    std::cout << std::setw(14) << "growth"
+              << std::setw(10) << "grew"    << std::setw(10) << "p50"
+              << std::setw(10) << "p99"     << std::setw(10) << "p99.9"
+              << std::setw(10) << "p99.99"  << std::setw(12) << "max"
+              << std::setw(10) << "total"   << '\n';
+
+    benchmarkInserts("all at once", 0);
+    for (unsigned rate : { 1u, 4u, 16u })
+        benchmarkInserts(std::to_string(rate) + " per op", rate);
+}
+/************************************************************************************//*!
+ @brief     Measures the time ChHashTable spends growing, and how fast it finds keys
+            in it.
+*//*************************************************************************************/
+void BenchmarkGrowthAndLookup()
+{
+    std::cout << "\nGrowth (ms in inserts that grew) and lookups (M/s)\n";
+    std::cout << std::setw(10) << "keys"
+              << std::setw(10) << "grew"    << std::setw(12) << "growth"
+              << std::setw(12) << "finds"
+              << std::setw(8)  << "valid"   << '\n';
+
+    for (unsigned size : { 100000u, 1000000u, 10000000u })
+        benchmarkGrowth(size);
+}
+/************************************************************************************//*!
+ @brief     Measures lookups in a ChHashTable and an OAHashTable holding the same keys,
+            over table sizes, load factors and the share of lookups that hit.
+*//*************************************************************************************/
+void BenchmarkChainedVsOpen()
+{
+    std::cout << "\nChained vs open addressing lookups (M/s)\n";
+    std::cout << std::setw(10) << "slots"
+              << std::setw(8)  << "load"    << std::setw(9)  << "hits"
+              << std::setw(12) << "chained" << std::setw(12) << "open"
+              << std::setw(10) << "speedup" << std::setw(8)  << "valid" << '\n';
+
+    for (unsigned slots : { 1u << 12, 1u << 16, 1u << 22 })
+    {
+        for (double loadFactor : { 0.5, 0.75, 0.875 })
+            benchmarkTables(slots, loadFactor);
+    }
+}
+/************************************************************************************//*!
+ @brief     Measures a mix of lookups, inserts and removes on several threads, on a
+            ConcurrentChHashTable and on a ChHashTable behind one lock.
+*//*************************************************************************************/
+void BenchmarkConcurrentMix()
+{
+    const unsigned HARDWARE = std::max(std::thread::hardware_concurrency(), 1u);
+    std::cout << "\nConcurrent mix (M ops/s over all threads, " << HARDWARE << " hardware threads)\n";
+    std::cout << std::setw(8)  << "threads" << std::setw(8)  << "writes"
+              << std::setw(12) << "locked"  << std::setw(12) << "concurrent"
+              << std::setw(10) << "speedup" << std::setw(8)  << "valid" << '\n';
+
+    ChHashTable<unsigned>::HTConfig             lockedConfig{ INITIAL_SIZE, fnvHash };
+    ConcurrentChHashTable<unsigned>::HTConfig   concurrentConfig{ INITIAL_SIZE, fnvHash };
+    LockedTable                     locked{ lockedConfig };
+    ConcurrentChHashTable<unsigned> concurrent{ concurrentConfig };
+
+    char key[MAX_KEYLEN];
+    for (unsigned i = 0; i < NUM_SHARED; ++i)
+    {
+        makeKey(i, key);
+        locked.insert(key, i);
+        concurrent.insert(key, i);
+    }
+
+    for (unsigned threadCount : { 1u, 2u, 4u, 8u, 16u })
+    {
+        for (unsigned writePercent : { 0u, 5u, 50u })
+        {
+            bool valid = true;
+            const double LOCKED_RATE        = runMix(locked, threadCount, writePercent, valid);
+            const double CONCURRENT_RATE    = runMix(concurrent, threadCount, writePercent, valid);
+
+            std::cout << std::fixed << std::setprecision(1)
+                      << std::setw(8)  << threadCount
+                      << std::setw(7)  << writePercent << '%'
+                      << std::setw(12) << LOCKED_RATE
+                      << std::setw(12) << CONCURRENT_RATE
+                      << std::setw(10) << std::setprecision(2) << CONCURRENT_RATE / LOCKED_RATE
+                      << std::setw(8)  << (valid && concurrent.GetStats().Count_ == NUM_SHARED ? "yes" : "NO") << '\n';
+        }
+    }
+}
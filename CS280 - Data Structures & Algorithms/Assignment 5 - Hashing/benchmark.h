@@ -0,0 +1,40 @@
+/************************************************************************************//*!
+ @file    benchmark.h
+ @author  Diren D Bharwani, 2002216, diren.dbharwani, diren.dbharwani@digipen.edu
+ @date    Apr 10, 2022
+ @brief   Contains the interface for the hash table benchmarks.
+ 
+ Copyright (C) 2022 DigiPen Institute of Technology.
+ Reproduction or disclosure of this file or its contents without the prior written 
+ consent of DigiPen Institute of Technology is prohibited.
+*//*************************************************************************************/
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+/*-------------------------------------------------------------------------------------*/
+/* Function Declarations                                                               */
+/*-------------------------------------------------------------------------------------*/
+
+/************************************************************************************//*!
+ @brief     Measures the latency of every insert into a growing ChHashTable, with the
+            table grown all at once and a few slots per operation.
+*//*************************************************************************************/
+void BenchmarkInsertLatency();
+/************************************************************************************//*!
+ @brief     Measures the time ChHashTable spends growing, and how fast it finds keys
+            in it.
+*//*************************************************************************************/
+void BenchmarkGrowthAndLookup();
+/************************************************************************************//*!
+ @brief     Measures lookups in a ChHashTable and an OAHashTable holding the same keys,
+            over table sizes, load factors and the share of lookups that hit.
+*//*************************************************************************************/
+void BenchmarkChainedVsOpen();
+/************************************************************************************//*!
+ @brief     Measures a mix of lookups, inserts and removes on several threads, on a
+            ConcurrentChHashTable and on a ChHashTable behind one lock.
+*//*************************************************************************************/
+void BenchmarkConcurrentMix();
+
+#endif
@@ -1,4 +1,9 @@
+#include "benchmark.h"
+
 int main()
 {
-    
-}
\ No newline at end of file
+    BenchmarkInsertLatency();
+    BenchmarkGrowthAndLookup();
+    BenchmarkChainedVsOpen();
+    BenchmarkConcurrentMix();
+}
@@ -13,6 +13,7 @@
 #include <exception>
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 // Primary Headers
 #include "ChHashTable.h"
 
@@ -31,15 +32,18 @@
 template <typename T>
 ChHashTable<T>::ChHashTable(const HTConfig& Config, ObjectAllocator* allocator)
 : heads     { nullptr }
+, oldHeads  { nullptr }
 , stats     { nullptr }
 , config    { Config }
 {
     stats = new HTStats;
-    stats->Count_       = 0U;
-    stats->TableSize_   = config.InitialTableSize_;
-    stats->Probes_      = 0U;
-    stats->Expansions_  = 0U;
-    stats->HashFunc_    = config.HashFunc_;
+    stats->Count_           = 0U;
+    stats->TableSize_       = config.InitialTableSize_;
+    stats->Probes_          = 0U;
+    stats->Expansions_      = 0U;
+    stats->OldTableSize_    = 0U;
+    stats->Migrated_        = 0U;
+    stats->HashFunc_        = config.HashFunc_;
     stats->Allocator_   = allocator;
 
     try
@@ -68,11 +72,7 @@ ChHashTable<T>::ChHashTable(const HTConfig& Config, ObjectAllocator* allocator)
 template <typename T>
 ChHashTable<T>::~ChHashTable()
 {
-    for (unsigned int i = 0; i < stats->TableSize_; ++i)
-    {
-        // Delete nodes in each list
-        deleteHead(heads + i);
-    }
+    clear();
 
     delete[] heads;
     delete stats;
@@ -116,14 +116,15 @@ const typename ChHashTable<T>::ChHTHeadNode* ChHashTable<T>::GetTable() const
 template <typename T>
 void ChHashTable<T>::insert(const char* Key, const T& Data)
 {
+    migrate(config.MigrationRate_);
+
     const double LOAD_FACTOR = static_cast<double>(stats->Count_ + 1U) / stats->TableSize_;
     if (LOAD_FACTOR > config.MaxLoadFactor_)
     {
         growTable();
     }
 
-    const uint32_t INDEX = stats->HashFunc_(Key, stats->TableSize_);
-    insertNode(heads + INDEX, Key, Data);
+    insertNode(headOf(Key), Key, Data);
 }
 /************************************************************************************//*!
  @brief     Deletes an item by key
@@ -137,18 +138,21 @@ void ChHashTable<T>::insert(const char* Key, const T& Data)
 template <typename T>
 void ChHashTable<T>::remove(const char* Key)
 {
-    // Hash key to get the index of the element
-    const uint32_t INDEX = stats->HashFunc_(Key, stats->TableSize_);
+    migrate(config.MigrationRate_);
+
+    // Hash key to get the list of the element
+    ChHTHeadNode*   head = headOf(Key);
+    const unsigned  HASH = keyHash(Key);
 
     ChHTNode* prev = nullptr;
-    ChHTNode* temp = heads[INDEX].Nodes;
+    ChHTNode* temp = head->Nodes;
     ++stats->Probes_;
 
     // Find node with matching key
     bool keyFound = false;
     while (temp)
     {
-        if (!strcmp(temp->Key, Key))
+        if (temp->Hash == HASH && !strcmp(temp->Key, Key))
         {
             keyFound = true;
             break;
@@ -182,7 +186,7 @@ void ChHashTable<T>::remove(const char* Key)
     {
         // replace the head
         ChHTNode* newHead = temp->Next;
-        heads[INDEX].Nodes = newHead;
+        head->Nodes = newHead;
     }
     else
     {
@@ -193,7 +197,7 @@ void ChHashTable<T>::remove(const char* Key)
     deleteNode(temp);
 
     --stats->Count_;
-    --heads[INDEX].Count;
+    --head->Count;
 }
 /************************************************************************************//*!
  @brief     Find data by a given key.
@@ -209,20 +213,10 @@ void ChHashTable<T>::remove(const char* Key)
 template <typename T>
 const T& ChHashTable<T>::find(const char* Key) const
 {
-    const uint32_t INDEX = stats->HashFunc_(Key, stats->TableSize_);
-
-    ChHTNode* temp = heads[INDEX].Nodes;
-    ++stats->Probes_;
-
-    while (temp)
+    const T* data = lookup(Key);
+    if (data)
     {
-        if (!strcmp(temp->Key, Key))
-        {
-            return temp->Data;
-        }
-        temp = temp->Next;
-
-        ++stats->Probes_;
+        return *data;
     }
 
     std::string functionSignature;
@@ -238,6 +232,36 @@ const T& ChHashTable<T>::find(const char* Key) const
         functionSignature + ": Attempted to insert duplicate data!"
     );
 }
+/************************************************************************************//*!
+ @brief     Find data by a given key, without throwing.
+
+ @param     Key
+    The key for the value to find
+
+ @returns   The data found by the key, or nullptr if the key has not been found.
+*//*************************************************************************************/
+template <typename T>
+const T* ChHashTable<T>::lookup(const char* Key) const
+{
+    migrate(config.MigrationRate_);
+
+    ChHTNode*       temp = headOf(Key)->Nodes;
+    const unsigned  HASH = keyHash(Key);
+    ++stats->Probes_;
+
+    while (temp)
+    {
+        if (temp->Hash == HASH && !strcmp(temp->Key, Key))
+        {
+            return &temp->Data;
+        }
+        temp = temp->Next;
+
+        ++stats->Probes_;
+    }
+
+    return nullptr;
+}
 /************************************************************************************//*!
  @brief     Removes all items from the table (Doesn't deallocate table)
 *//*************************************************************************************/
@@ -250,6 +274,20 @@ void ChHashTable<T>::clear()
         deleteHead(heads + i);
     }
 
+    // Drop the table being migrated from, with the nodes it still has
+    if (oldHeads)
+    {
+        for (unsigned int i = stats->Migrated_; i < stats->OldTableSize_; ++i)
+        {
+            deleteHead(oldHeads + i);
+        }
+
+        delete[] oldHeads;
+        oldHeads                = nullptr;
+        stats->OldTableSize_    = 0U;
+        stats->Migrated_        = 0U;
+    }
+
     stats->Count_ = 0U;
 }
 
@@ -269,13 +307,14 @@ void ChHashTable<T>::clear()
 template <typename T>
 void ChHashTable<T>::insertNode(ChHTHeadNode* head, const char* key, const T& data)
 {
-    ChHTNode* temp = head->Nodes;
+    ChHTNode*       temp = head->Nodes;
+    const unsigned  HASH = keyHash(key);
     ++stats->Probes_;
 
     // Check for duplicate
     while (temp)
     {
-        if (!strcmp(temp->Key, key))
+        if (temp->Hash == HASH && !strcmp(temp->Key, key))
         {
             std::string functionSignature;
             #ifdef _MSC_VER
@@ -314,6 +353,7 @@ void ChHashTable<T>::insertNode(ChHTHeadNode* head, const char* key, const T& da
         #else
         strcpy(newNode->Key, key);
         #endif
+        newNode->Hash   = HASH;
         newNode->Next   = head->Nodes;
         head->Nodes     = newNode;
 
@@ -392,6 +432,9 @@ void ChHashTable<T>::deleteHead(ChHTHeadNode* head)
 template <typename T>
 void ChHashTable<T>::growTable()
 {
+    // Finish the last growth first, so there are never more than two tables
+    migrate(stats->OldTableSize_);
+
     const double        ACTUAL_GROWTH_FACTOR    = std::ceil(stats->TableSize_ * config.GrowthFactor_);
     const unsigned int  NEW_SIZE                = GetClosestPrime(static_cast<unsigned int>(ACTUAL_GROWTH_FACTOR));
 
@@ -418,34 +461,108 @@ void ChHashTable<T>::growTable()
         );
     }
 
-    const unsigned int OLD_SIZE = stats->TableSize_;
-    stats->TableSize_ = static_cast<unsigned int>(NEW_SIZE);
+    // Keep the old table, and move its nodes over a few slots per operation, or all
+    // of them now
+    oldHeads                = heads;
+    heads                   = newHead;
+    stats->OldTableSize_    = stats->TableSize_;
+    stats->Migrated_        = 0U;
+    stats->TableSize_       = NEW_SIZE;
+    ++stats->Expansions_;
 
-    // Reset count
-    stats->Count_ = 0U;
+    if (config.MigrationRate_ == 0)
+    {
+        migrate(stats->OldTableSize_);
+    }
+}
+/************************************************************************************//*!
+ @brief     Moves the next few slots of the old table to the new one, and frees the
+            old table once every slot is moved.
 
-    // Traverse current heads and reinsert
-    for (unsigned int i = 0; i < OLD_SIZE; ++i)
+ @param     slots
+    The number of slots to move.
+*//*************************************************************************************/
+template <typename T>
+void ChHashTable<T>::migrate(unsigned slots) const
+{
+    if (!oldHeads)
+        return;
+
+    for (; slots > 0 && stats->Migrated_ < stats->OldTableSize_; --slots, ++stats->Migrated_)
     {
-        ChHTNode* temp = heads[i].Nodes;
+        ChHTHeadNode& old = oldHeads[stats->Migrated_];
 
+        // Relink every node to the front of its new list. The nodes and their data stay
+        // where they are.
+        ChHTNode* temp = old.Nodes;
         while (temp)
         {
-            const uint32_t NEW_INDEX = stats->HashFunc_(temp->Key, stats->TableSize_);
-            insertNode(newHead + NEW_INDEX, temp->Key, temp->Data);
+            ChHTNode*       next = temp->Next;
+            ChHTHeadNode*   head = heads + stats->HashFunc_(temp->Key, stats->TableSize_);
+
+            // Count the probes a reinsert would make, the head and every node of the
+            // list, as rehashing through insertNode did
+            stats->Probes_ += 1U + head->Count;
+
+            temp->Next  = head->Nodes;
+            head->Nodes = temp;
+            ++head->Count;
 
-            // Next node
-            ChHTNode* next = temp->Next;
-            deleteNode(temp);
             temp = next;
         }
+
+        old.Nodes = nullptr;
+        old.Count = 0;
     }
 
-    // Delete Old Heads
-    delete[] heads;
-    heads = newHead;
+    if (stats->Migrated_ == stats->OldTableSize_)
+    {
+        delete[] oldHeads;
+        oldHeads                = nullptr;
+        stats->OldTableSize_    = 0U;
+        stats->Migrated_        = 0U;
+    }
+}
+/************************************************************************************//*!
+ @brief     Gets the list a key belongs in. While the table is growing, a key whose old
+            slot has not been migrated yet belongs in the old table.
 
-    ++stats->Expansions_;
+ @param     key
+    The key to look up.
+
+ @returns   The head of the list.
+*//*************************************************************************************/
+template <typename T>
+typename ChHashTable<T>::ChHTHeadNode* ChHashTable<T>::headOf(const char* key) const
+{
+    if (oldHeads)
+    {
+        const unsigned int OLD_INDEX = stats->HashFunc_(key, stats->OldTableSize_);
+        if (OLD_INDEX >= stats->Migrated_)
+            return oldHeads + OLD_INDEX;
+    }
+
+    return heads + stats->HashFunc_(key, stats->TableSize_);
+}
+/************************************************************************************//*!
+ @brief     Hashes a whole key to 32 bits (FNV-1a).
+
+ @param     key
+    The key to hash.
+
+ @returns   The hash of the key.
+*//*************************************************************************************/
+template <typename T>
+unsigned ChHashTable<T>::keyHash(const char* key)
+{
+    unsigned hash = 2166136261U;
+    while (*key)
+    {
+        hash ^= static_cast<unsigned char>(*key++);
+        hash *= 16777619U;
+    }
+
+    return hash;
 }
 
 
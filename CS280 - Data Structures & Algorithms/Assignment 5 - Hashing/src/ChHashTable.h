@@ -109,6 +109,8 @@ public:
     unsigned            TableSize_;     // Size of the table (total slots)
     unsigned            Probes_;        // Number of probes performed
     unsigned            Expansions_;    // Number of times the table grew
+    unsigned            OldTableSize_;  // Size of the table being migrated from (0 if none)
+    unsigned            Migrated_;      // Number of old slots migrated so far
     HASHFUNC            HashFunc_;      // Pointer to primary hash function
     ObjectAllocator*    Allocator_;     // The allocator in use (may be 0)
 
@@ -120,6 +122,8 @@ public:
     , TableSize_    (0)
     , Probes_       (0)
     , Expansions_   (0)
+    , OldTableSize_ (0)
+    , Migrated_     (0)
     , HashFunc_     (0)
     , Allocator_    (nullptr)
     {};
@@ -154,7 +158,7 @@ public:
         double      GrowthFactor_;      // The factor by which the table grows.
         HASHFUNC    HashFunc_;          // The hash function used in all cases.
         FREEPROC    FreeProc_;          // The method provided by the client that may need to be called when data in the table is removed.
-                                        
+        unsigned    MigrationRate_;     // The number of old slots moved per operation while growing, 0 to move them all at once.
 
         /*-----------------------------------------------------------------------------*/
         /* Constructor                                                                 */
@@ -168,13 +172,15 @@ public:
             HASHFUNC    HashFunc, 
             double      MaxLoadFactor       = 3.0, 
             double      GrowthFactor        = 2.0,
-            FREEPROC    FreeProc            = 0
+            FREEPROC    FreeProc            = 0,
+            unsigned    MigrationRate       = 0
         )
         : InitialTableSize_ (InitialTableSize)
         , MaxLoadFactor_    (MaxLoadFactor)
         , GrowthFactor_     (GrowthFactor)
         , HashFunc_         (HashFunc)
         , FreeProc_         (FreeProc)
+        , MigrationRate_    (MigrationRate)
         {}
     };
 
@@ -188,6 +194,7 @@ public:
         /* Data Members                                                                */
         /*-----------------------------------------------------------------------------*/
         char        Key[MAX_KEYLEN];    // Key is a string
+        unsigned    Hash;               // keyHash() of Key, checked before strcmp
         T           Data;               // Client data
         ChHTNode*   Next;               // Pointer to the next horntail
 
@@ -254,7 +261,9 @@ public:
     *//*********************************************************************************/
     HTStats             GetStats() const;
     /********************************************************************************//*!
-     @brief     Getter for the table of a ChHashTable.
+     @brief     Getter for the table of a ChHashTable. While the table is growing
+                incrementally, nodes in slots not migrated yet are still in the old
+                table.
 
      @returns   A pointer to the start of the array of head nodes.
     *//*********************************************************************************/
@@ -298,6 +307,16 @@ public:
     *//*********************************************************************************/
     const T& find(const char* Key) const;
 
+    /********************************************************************************//*!
+     @brief     Find data by a given key, without throwing.
+
+     @param     Key
+        The key for the value to find
+
+     @returns   The data found by the key, or nullptr if the key has not been found.
+    *//*********************************************************************************/
+    const T* lookup(const char* Key) const;
+
     /********************************************************************************//*!
      @brief     Removes all items from the table (Doesn't deallocate table)
     *//*********************************************************************************/
@@ -308,10 +327,11 @@ public:
     /*---------------------------------------------------------------------------------*/
     /* Data Members                                                                    */
     /*---------------------------------------------------------------------------------*/
-    ChHTHeadNode*       heads;
-    HTStats*            stats;
+    ChHTHeadNode*           heads;
+    mutable ChHTHeadNode*   oldHeads;   // The table being migrated from, freed by the last migration, even in find
+    HTStats*                stats;
 
-    HTConfig            config;
+    HTConfig                config;
 
     /*---------------------------------------------------------------------------------*/
     /* Function Members                                                                */
@@ -342,9 +362,40 @@ public:
     *//*********************************************************************************/
     void deleteHead     (ChHTHeadNode* head);
     /********************************************************************************//*!
-     @brief     Grows the table
+     @brief     Grows the table. The nodes are relinked into the new table by migrate(),
+                all at once, or a few slots at a time with a MigrationRate_.
     *//*********************************************************************************/
     void growTable      ();
+    /********************************************************************************//*!
+     @brief     Moves the next few slots of the old table to the new one, and frees
+                the old table once every slot is moved.
+
+     @param     slots
+        The number of slots to move.
+    *//*********************************************************************************/
+    void migrate        (unsigned slots) const;
+    /********************************************************************************//*!
+     @brief     Gets the list a key belongs in. While the table is growing, a key whose
+                old slot has not been migrated yet belongs in the old table.
+
+     @param     key
+        The key to look up.
+
+     @returns   The head of the list.
+    *//*********************************************************************************/
+    ChHTHeadNode* headOf(const char* key) const;
+    /********************************************************************************//*!
+     @brief     Hashes a whole key to 32 bits (FNV-1a). Every node keeps the hash of
+                its key, so a search only compares the keys of nodes whose hash
+                matches. Buckets still come from HashFunc_, which depends on the table
+                size.
+
+     @param     key
+        The key to hash.
+
+     @returns   The hash of the key.
+    *//*********************************************************************************/
+    static unsigned keyHash(const char* key);
 
 };
 
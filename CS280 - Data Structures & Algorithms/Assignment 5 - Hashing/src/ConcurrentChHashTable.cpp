@@ -0,0 +1,637 @@
+/************************************************************************************//*!
+ @file    ConcurrentChHashTable.cpp
+ @author  Diren D Bharwani, 2002216, diren.dbharwani, diren.dbharwani@digipen.edu
+ @date    Apr 10, 2022
+ @brief   Contains the implementation of the ConcurrentChHashTable
+
+ Copyright (C) 2022 DigiPen Institute of Technology.
+ Reproduction or disclosure of this file or its contents without the prior written
+ consent of DigiPen Institute of Technology is prohibited.
+*//*************************************************************************************/
+
+// Standard Libraries
+#include <new>
+#include <cmath>
+#include <cstring>
+#include <vector>
+// Primary Headers
+#include "ConcurrentChHashTable.h"
+
+/*-------------------------------------------------------------------------------------*/
+/* Constructors & Destructors                                                          */
+/*-------------------------------------------------------------------------------------*/
+
+/************************************************************************************//*!
+ @brief     Constructor for ConcurrentChHashTable
+
+ @param     Config
+    The configuration properties for the HornTail.
+*//*************************************************************************************/
+template <typename T>
+ConcurrentChHashTable<T>::ConcurrentChHashTable(const HTConfig& Config)
+: table         { nullptr }
+, expansions    { 0U }
+, config        { Config }
+{
+    for (Stripe& stripe : stripes)
+    {
+        stripe.Count.store(0U, std::memory_order_relaxed);
+    }
+
+    table.store(makeTable(config.InitialTableSize_));
+}
+/************************************************************************************//*!
+ @brief     Destructor for ConcurrentChHashTable
+*//*************************************************************************************/
+template <typename T>
+ConcurrentChHashTable<T>::~ConcurrentChHashTable()
+{
+    ChHTTable* current = table.load();
+
+    if (config.FreeProc_)
+    {
+        for (unsigned int i = 0; i < current->Size; ++i)
+        {
+            for (ChHTNode* node = current->Heads[i].load(); node; node = node->Next.load())
+            {
+                config.FreeProc_(node->Data);
+            }
+        }
+    }
+
+    freeTable(current);
+}
+
+/*-------------------------------------------------------------------------------------*/
+/* Getter Functions                                                                    */
+/*-------------------------------------------------------------------------------------*/
+/************************************************************************************//*!
+ @brief     Getter for the stats of a ConcurrentChHashTable.
+
+ @returns   The stats for a ConcurrentChHashTable.
+*//*************************************************************************************/
+template <typename T>
+HTStats ConcurrentChHashTable<T>::GetStats() const
+{
+    EpochReclaimer::Guard guard;
+
+    HTStats stats;
+    for (const Stripe& stripe : stripes)
+    {
+        stats.Count_ += stripe.Count.load(std::memory_order_relaxed);
+    }
+    stats.TableSize_    = table.load(std::memory_order_acquire)->Size;
+    stats.Expansions_   = expansions.load(std::memory_order_relaxed);
+    stats.HashFunc_     = config.HashFunc_;
+
+    return stats;
+}
+
+/*-------------------------------------------------------------------------------------*/
+/* Public Function Members                                                             */
+/*-------------------------------------------------------------------------------------*/
+/************************************************************************************//*!
+ @brief     Inserts data into the Hash Table
+
+ @param     Key
+    The key for the value
+ @param     Data
+    The data to insert
+*//*************************************************************************************/
+template <typename T>
+void ConcurrentChHashTable<T>::insert(const char* Key, const T& Data)
+{
+    // Keeps the table from being freed while it is used, even by a writer
+    EpochReclaimer::Guard guard;
+
+    const unsigned int HASH = keyHash(Key);
+    ChHTTable*      current;
+    unsigned int    bucket;
+    bool            overloaded;
+    {
+        std::unique_lock<std::mutex> lock = lockBucket(Key, current, bucket);
+        std::atomic<ChHTNode*>& head = current->Heads[bucket];
+
+        // Check for duplicate
+        for (ChHTNode* node = head.load(std::memory_order_relaxed); node; node = node->Next.load(std::memory_order_relaxed))
+        {
+            if (node->Hash == HASH && !strcmp(node->Key, Key))
+            {
+                std::string functionSignature;
+                #ifdef _MSC_VER
+                functionSignature = __FUNCTION__;
+                #else
+                functionSignature = __PRETTY_FUNCTION__;
+                #endif
+
+                throw HashTableException
+                (
+                    HashTableException::HASHTABLE_EXCEPTION::E_DUPLICATE,
+                    functionSignature + ": Attempted to insert duplicate data!"
+                );
+            }
+        }
+
+        ChHTNode* newNode = nullptr;
+        try
+        {
+            newNode = new ChHTNode(Data);
+        }
+        catch (const std::bad_alloc&)
+        {
+            std::string functionSignature;
+            #ifdef _MSC_VER
+            functionSignature = __FUNCTION__;
+            #else
+            functionSignature = __PRETTY_FUNCTION__;
+            #endif
+
+            throw HashTableException
+            (
+                HashTableException::HASHTABLE_EXCEPTION::E_NO_MEMORY,
+                functionSignature + ": No memory left to allocate a new node!"
+            );
+        }
+
+        #ifdef _MSC_VER
+        strcpy_s(newNode->Key, Key);
+        #else
+        strcpy(newNode->Key, Key);
+        #endif
+        newNode->Hash = HASH;
+        newNode->Next.store(head.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+        // Publish the node, whole, to readers
+        head.store(newNode, std::memory_order_release);
+
+        Stripe&             stripe  = stripes[stripeOf(bucket, current->Size)];
+        const unsigned int  COUNT   = stripe.Count.load(std::memory_order_relaxed) + 1U;
+        stripe.Count.store(COUNT, std::memory_order_relaxed);
+
+        overloaded = COUNT > config.MaxLoadFactor_ * bucketsIn(stripeOf(bucket, current->Size), current->Size);
+    }
+
+    if (overloaded)
+    {
+        growTable(current);
+    }
+}
+/************************************************************************************//*!
+ @brief     Deletes an item by key
+
+ @param     Key
+    The key for the value to delete
+
+ @throws    E_ITEM_NOT_FOUND
+    If the key has not been found
+*//*************************************************************************************/
+template <typename T>
+void ConcurrentChHashTable<T>::remove(const char* Key)
+{
+    EpochReclaimer::Guard guard;
+
+    const unsigned int HASH = keyHash(Key);
+    ChHTTable*      current;
+    unsigned int    bucket;
+    ChHTNode*       node;
+    {
+        std::unique_lock<std::mutex> lock = lockBucket(Key, current, bucket);
+
+        // Find node with matching key, and the link to it
+        std::atomic<ChHTNode*>* link = current->Heads + bucket;
+        node = link->load(std::memory_order_relaxed);
+        while (node && !(node->Hash == HASH && !strcmp(node->Key, Key)))
+        {
+            link = &node->Next;
+            node = link->load(std::memory_order_relaxed);
+        }
+
+        if (!node)
+        {
+            std::string functionSignature;
+            #ifdef _MSC_VER
+            functionSignature = __FUNCTION__;
+            #else
+            functionSignature = __PRETTY_FUNCTION__;
+            #endif
+
+            throw HashTableException
+            (
+                HashTableException::HASHTABLE_EXCEPTION::E_ITEM_NOT_FOUND,
+                functionSignature + ": Attempted to remove missing data!"
+            );
+        }
+
+        // Readers on the node still reach the rest of the chain through it
+        link->store(node->Next.load(std::memory_order_relaxed), std::memory_order_release);
+
+        Stripe& stripe = stripes[stripeOf(bucket, current->Size)];
+        stripe.Count.store(stripe.Count.load(std::memory_order_relaxed) - 1U, std::memory_order_relaxed);
+    }
+
+    retireNode(node);
+}
+/************************************************************************************//*!
+ @brief     Find data by a given key.
+
+ @param     Key
+    The key for the value to find
+
+ @returns   A copy of the data found by the key
+
+ @throws    E_ITEM_NOT_FOUND
+    If the key has not been found
+*//*************************************************************************************/
+template <typename T>
+T ConcurrentChHashTable<T>::find(const char* Key) const
+{
+    {
+        EpochReclaimer::Guard guard;
+
+        const ChHTNode* node = findNode(Key);
+        if (node)
+        {
+            return node->Data;
+        }
+    }
+
+    std::string functionSignature;
+    #ifdef _MSC_VER
+    functionSignature = __FUNCTION__;
+    #else
+    functionSignature = __PRETTY_FUNCTION__;
+    #endif
+
+    throw HashTableException
+    (
+        HashTableException::HASHTABLE_EXCEPTION::E_ITEM_NOT_FOUND,
+        functionSignature + ": Attempted to find missing data!"
+    );
+}
+/************************************************************************************//*!
+ @brief     Find data by a given key, without throwing.
+
+ @param     Key
+    The key for the value to find
+ @param     Data
+    Set to a copy of the data found by the key.
+
+ @returns   True if the key has been found.
+*//*************************************************************************************/
+template <typename T>
+bool ConcurrentChHashTable<T>::lookup(const char* Key, T& Data) const
+{
+    EpochReclaimer::Guard guard;
+
+    const ChHTNode* node = findNode(Key);
+    if (!node)
+    {
+        return false;
+    }
+
+    Data = node->Data;
+    return true;
+}
+/************************************************************************************//*!
+ @brief     Removes all items from the table (Doesn't deallocate table)
+*//*************************************************************************************/
+template <typename T>
+void ConcurrentChHashTable<T>::clear()
+{
+    // Unlink every chain under the locks, and free the nodes once they are released
+    std::vector<ChHTNode*> chains;
+    {
+        std::unique_lock<std::mutex> locks[STRIPES];
+        for (unsigned int i = 0; i < STRIPES; ++i)
+        {
+            locks[i] = std::unique_lock<std::mutex>{ stripes[i].Mutex };
+        }
+
+        ChHTTable* current = table.load(std::memory_order_relaxed);
+        for (unsigned int i = 0; i < current->Size; ++i)
+        {
+            ChHTNode* node = current->Heads[i].exchange(nullptr, std::memory_order_release);
+            if (node)
+            {
+                chains.emplace_back(node);
+            }
+        }
+
+        for (Stripe& stripe : stripes)
+        {
+            stripe.Count.store(0U, std::memory_order_relaxed);
+        }
+    }
+
+    for (ChHTNode* node : chains)
+    {
+        while (node)
+        {
+            ChHTNode* next = node->Next.load(std::memory_order_relaxed);
+
+            retireNode(node);
+
+            node = next;
+        }
+    }
+}
+
+/*-------------------------------------------------------------------------------------*/
+/* Private Function Members                                                            */
+/*-------------------------------------------------------------------------------------*/
+/************************************************************************************//*!
+ @brief     Finds the node of a key. The caller must hold a Guard.
+
+ @param     key
+    The key to find.
+
+ @returns   The node, or nullptr if the key has not been found.
+*//*************************************************************************************/
+template <typename T>
+const typename ConcurrentChHashTable<T>::ChHTNode* ConcurrentChHashTable<T>::findNode(const char* key) const
+{
+    const unsigned int  HASH    = keyHash(key);
+    const ChHTTable*    current = table.load(std::memory_order_acquire);
+
+    const ChHTNode* node = current->Heads[config.HashFunc_(key, current->Size)].load(std::memory_order_acquire);
+    while (node)
+    {
+        if (node->Hash == HASH && !strcmp(node->Key, key))
+        {
+            return node;
+        }
+        node = node->Next.load(std::memory_order_acquire);
+    }
+
+    return nullptr;
+}
+/************************************************************************************//*!
+ @brief     Locks the range of a key's bucket in the current table.
+
+ @param     key
+    The key.
+ @param     current
+    Set to the current table, which can't be replaced while the lock is held.
+ @param     bucket
+    Set to the bucket of the key in it.
+
+ @returns   The lock, held.
+*//*************************************************************************************/
+template <typename T>
+std::unique_lock<std::mutex> ConcurrentChHashTable<T>::lockBucket(const char* key, ChHTTable*& current, unsigned& bucket)
+{
+    while (true)
+    {
+        current = table.load(std::memory_order_acquire);
+        bucket  = config.HashFunc_(key, current->Size);
+
+        std::unique_lock<std::mutex> lock{ stripes[stripeOf(bucket, current->Size)].Mutex };
+
+        // Growing holds every lock, so the table only changes between the load and here
+        if (table.load(std::memory_order_acquire) == current)
+        {
+            return lock;
+        }
+    }
+}
+/************************************************************************************//*!
+ @brief     Grows the table, unless another thread already has.
+
+ @param     full
+    The table that was found too full.
+*//*************************************************************************************/
+template <typename T>
+void ConcurrentChHashTable<T>::growTable(ChHTTable* full)
+{
+    {
+        std::unique_lock<std::mutex> locks[STRIPES];
+        for (unsigned int i = 0; i < STRIPES; ++i)
+        {
+            locks[i] = std::unique_lock<std::mutex>{ stripes[i].Mutex };
+        }
+
+        if (table.load(std::memory_order_relaxed) != full)
+        {
+            return;
+        }
+
+        copyTable(full);
+    }
+
+    // The old table stays whole for the readers still in it
+    EpochReclaimer::Retire(full, freeTable);
+}
+/************************************************************************************//*!
+ @brief     Copies every node of the current table into a bigger one, and publishes
+            it. Every lock must be held.
+
+ @param     full
+    The current table.
+*//*************************************************************************************/
+template <typename T>
+void ConcurrentChHashTable<T>::copyTable(ChHTTable* full)
+{
+    const double        ACTUAL_GROWTH_FACTOR    = std::ceil(full->Size * config.GrowthFactor_);
+    const unsigned int  NEW_SIZE                = GetClosestPrime(static_cast<unsigned int>(ACTUAL_GROWTH_FACTOR));
+
+    // Copy every node, since readers may still be following the old chains
+    ChHTTable*      grown = makeTable(NEW_SIZE);
+    unsigned int    counts[STRIPES] = {};
+    try
+    {
+        for (unsigned int i = 0; i < full->Size; ++i)
+        {
+            for (ChHTNode* node = full->Heads[i].load(std::memory_order_relaxed); node; node = node->Next.load(std::memory_order_relaxed))
+            {
+                ChHTNode* copy = new ChHTNode(node->Data);
+                std::memcpy(copy->Key, node->Key, MAX_KEYLEN);
+                copy->Hash = node->Hash;
+
+                const unsigned int NEW_INDEX = config.HashFunc_(copy->Key, NEW_SIZE);
+                copy->Next.store(grown->Heads[NEW_INDEX].load(std::memory_order_relaxed), std::memory_order_relaxed);
+                grown->Heads[NEW_INDEX].store(copy, std::memory_order_relaxed);
+
+                ++counts[stripeOf(NEW_INDEX, NEW_SIZE)];
+            }
+        }
+    }
+    catch (const std::bad_alloc&)
+    {
+        freeTable(grown);
+
+        std::string functionSignature;
+        #ifdef _MSC_VER
+        functionSignature = __FUNCTION__;
+        #else
+        functionSignature = __PRETTY_FUNCTION__;
+        #endif
+
+        throw HashTableException
+        (
+            HashTableException::HASHTABLE_EXCEPTION::E_NO_MEMORY,
+            functionSignature + ": No memory left to allocate!"
+        );
+    }
+    catch (...)
+    {
+        freeTable(grown);
+        throw;
+    }
+
+    for (unsigned int i = 0; i < STRIPES; ++i)
+    {
+        stripes[i].Count.store(counts[i], std::memory_order_relaxed);
+    }
+
+    table.store(grown, std::memory_order_release);
+    expansions.fetch_add(1U, std::memory_order_relaxed);
+}
+/************************************************************************************//*!
+ @brief     Allocates a table with every chain empty.
+
+ @param     size
+    The number of chains.
+
+ @returns   The table.
+*//*************************************************************************************/
+template <typename T>
+typename ConcurrentChHashTable<T>::ChHTTable* ConcurrentChHashTable<T>::makeTable(unsigned size)
+{
+    ChHTTable* newTable = nullptr;
+    try
+    {
+        newTable        = new ChHTTable{ size, nullptr };
+        newTable->Heads = new std::atomic<ChHTNode*>[size];
+    }
+    catch (const std::bad_alloc&)
+    {
+        delete newTable;
+
+        std::string functionSignature;
+        #ifdef _MSC_VER
+        functionSignature = __FUNCTION__;
+        #else
+        functionSignature = __PRETTY_FUNCTION__;
+        #endif
+
+        throw HashTableException
+        (
+            HashTableException::HASHTABLE_EXCEPTION::E_NO_MEMORY,
+            functionSignature + ": No memory left to allocate!"
+        );
+    }
+
+    for (unsigned int i = 0; i < size; ++i)
+    {
+        newTable->Heads[i].store(nullptr, std::memory_order_relaxed);
+    }
+
+    return newTable;
+}
+/************************************************************************************//*!
+ @brief     Frees a table and every node still in its chains.
+
+ @param     oldTable
+    The table.
+*//*************************************************************************************/
+template <typename T>
+void ConcurrentChHashTable<T>::freeTable(void* oldTable)
+{
+    ChHTTable* freed = static_cast<ChHTTable*>(oldTable);
+
+    for (unsigned int i = 0; i < freed->Size; ++i)
+    {
+        ChHTNode* node = freed->Heads[i].load(std::memory_order_relaxed);
+        while (node)
+        {
+            ChHTNode* next = node->Next.load(std::memory_order_relaxed);
+            delete node;
+            node = next;
+        }
+    }
+
+    delete[] freed->Heads;
+    delete freed;
+}
+/************************************************************************************//*!
+ @brief     Retires a node that has been unlinked.
+
+ @param     node
+    The node.
+*//*************************************************************************************/
+template <typename T>
+void ConcurrentChHashTable<T>::retireNode(ChHTNode* node) const
+{
+    // No reader looks at FreeProc, so it can be set while they copy the rest
+    node->FreeProc = config.FreeProc_;
+    EpochReclaimer::Retire(node, freeNode);
+}
+/************************************************************************************//*!
+ @brief     Frees a node, calling its FreeProc first if it has one.
+
+ @param     node
+    The node.
+*//*************************************************************************************/
+template <typename T>
+void ConcurrentChHashTable<T>::freeNode(void* node)
+{
+    ChHTNode* freed = static_cast<ChHTNode*>(node);
+    if (freed->FreeProc)
+    {
+        freed->FreeProc(freed->Data);
+    }
+    delete freed;
+}
+/************************************************************************************//*!
+ @brief     Gets the lock range of a bucket.
+
+ @param     bucket
+    The bucket.
+ @param     size
+    The number of buckets.
+
+ @returns   The index of the stripe.
+*//*************************************************************************************/
+template <typename T>
+unsigned ConcurrentChHashTable<T>::stripeOf(unsigned bucket, unsigned size)
+{
+    return static_cast<unsigned>(static_cast<unsigned long long>(bucket) * STRIPES / size);
+}
+/************************************************************************************//*!
+ @brief     Gets the number of buckets in a lock range, the buckets whose stripeOf() is
+            the stripe.
+
+ @param     stripe
+    The index of the stripe.
+ @param     size
+    The number of buckets.
+
+ @returns   The number of buckets.
+*//*************************************************************************************/
+template <typename T>
+unsigned ConcurrentChHashTable<T>::bucketsIn(unsigned stripe, unsigned size)
+{
+    const unsigned long long FIRST  = (static_cast<unsigned long long>(stripe) * size + STRIPES - 1) / STRIPES;
+    const unsigned long long END    = (static_cast<unsigned long long>(stripe + 1) * size + STRIPES - 1) / STRIPES;
+    return static_cast<unsigned>(END - FIRST);
+}
+/************************************************************************************//*!
+ @brief     Hashes a whole key to 32 bits (FNV-1a).
+
+ @param     key
+    The key to hash.
+
+ @returns   The hash of the key.
+*//*************************************************************************************/
+template <typename T>
+unsigned ConcurrentChHashTable<T>::keyHash(const char* key)
+{
+    unsigned hash = 2166136261U;
+    while (*key)
+    {
+        hash ^= static_cast<unsigned char>(*key++);
+        hash *= 16777619U;
+    }
+
+    return hash;
+}
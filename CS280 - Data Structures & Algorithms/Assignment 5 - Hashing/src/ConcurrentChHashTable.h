@@ -0,0 +1,343 @@
+/************************************************************************************//*!
+ @file    ConcurrentChHashTable.h
+ @author  Diren D Bharwani, 2002216, diren.dbharwani, diren.dbharwani@digipen.edu
+ @date    Apr 10, 2022
+ @brief   Contains the interface for the ConcurrentChHashTable, a ChHashTable that
+          many threads can use at once.
+
+ Copyright (C) 2022 DigiPen Institute of Technology.
+ Reproduction or disclosure of this file or its contents without the prior written
+ consent of DigiPen Institute of Technology is prohibited.
+*//*************************************************************************************/
+
+#ifndef CONCURRENTCHHASHTABLEH
+#define CONCURRENTCHHASHTABLEH
+
+// Standard Libraries
+#include <atomic>
+#include <mutex>
+// Project Headers
+#include "ChHashTable.h"    // MAX_KEYLEN, HASHFUNC, HashTableException & HTStats
+#include "EpochReclaimer.h"
+
+/************************************************************************************//*!
+ @brief     Encapsulates a Chaos HornTail that many threads can insert into, remove
+            from and search at once.
+
+            The buckets are split into STRIPES contiguous ranges, each with a lock. A
+            writer only locks the range of the key it changes, so writers to different
+            ranges don't wait for each other. Readers take no locks: they hold an
+            EpochReclaimer::Guard and follow the chains, and a writer links a node in
+            or out with a single store, so a reader sees a chain before or after it.
+            Removed nodes are retired rather than freed, until no reader can be on
+            them. The client's FreeProc is only called on their data then, so a
+            reader never copies data that has been freed.
+
+            Growing locks every range, copies the nodes into a new table and publishes
+            it. Readers that started before keep reading the old table, which stays
+            whole and is retired as one object.
+
+            Data is copied out of the table, since a reference could outlive its node.
+*//*************************************************************************************/
+template <typename T>
+class ConcurrentChHashTable
+{
+public:
+    /*---------------------------------------------------------------------------------*/
+    /* Type Definitions                                                                */
+    /*---------------------------------------------------------------------------------*/
+    /********************************************************************************//*!
+     @brief     Callback for freeing data
+    *//*********************************************************************************/
+    typedef void (*FREEPROC)(T); // client-provided free proc (we own the data)
+
+    /********************************************************************************//*!
+     @brief     Encapsulates the properties of the HornTail.
+    *//*********************************************************************************/
+    struct HTConfig
+    {
+    public:
+        /*-----------------------------------------------------------------------------*/
+        /* Data Members                                                                */
+        /*-----------------------------------------------------------------------------*/
+        unsigned    InitialTableSize_;  // The number of slots in the table initially.
+        double      MaxLoadFactor_;     // The maximum "fullness" of the table, checked per lock range.
+        double      GrowthFactor_;      // The factor by which the table grows.
+        HASHFUNC    HashFunc_;          // The hash function used in all cases.
+        FREEPROC    FreeProc_;          // The method provided by the client that may need to be called when data in the table is removed.
+
+        /*-----------------------------------------------------------------------------*/
+        /* Constructor                                                                 */
+        /*-----------------------------------------------------------------------------*/
+        /****************************************************************************//*!
+         @brief     Constructor for HTConfig
+        *//*****************************************************************************/
+        HTConfig
+        (
+            unsigned    InitialTableSize,
+            HASHFUNC    HashFunc,
+            double      MaxLoadFactor       = 3.0,
+            double      GrowthFactor        = 2.0,
+            FREEPROC    FreeProc            = 0
+        )
+        : InitialTableSize_ (InitialTableSize)
+        , MaxLoadFactor_    (MaxLoadFactor)
+        , GrowthFactor_     (GrowthFactor)
+        , HashFunc_         (HashFunc)
+        , FreeProc_         (FreeProc)
+        {}
+    };
+
+    /*---------------------------------------------------------------------------------*/
+    /* Constructors & Destructor                                                       */
+    /*---------------------------------------------------------------------------------*/
+    /********************************************************************************//*!
+     @brief     Constructor for ConcurrentChHashTable
+
+     @param     Config
+        The configuration properties for the HornTail.
+    *//*********************************************************************************/
+    ConcurrentChHashTable(const HTConfig& Config);
+    /********************************************************************************//*!
+     @brief     Destructor for ConcurrentChHashTable. No other thread may be using the
+                table.
+    *//*********************************************************************************/
+    ~ConcurrentChHashTable();
+
+    ConcurrentChHashTable(const ConcurrentChHashTable&)             = delete;
+    ConcurrentChHashTable& operator=(const ConcurrentChHashTable&)  = delete;
+
+    /*---------------------------------------------------------------------------------*/
+    /* Getter Functions                                                                */
+    /*---------------------------------------------------------------------------------*/
+    /********************************************************************************//*!
+     @brief     Getter for the stats of a ConcurrentChHashTable, a snapshot while other
+                threads write. Probes_ is not counted, since a shared counter would
+                serialise the readers, and nodes come from new, so there is never an
+                Allocator_.
+
+     @returns   The stats for a ConcurrentChHashTable
+    *//*********************************************************************************/
+    HTStats     GetStats() const;
+
+    /*---------------------------------------------------------------------------------*/
+    /* Function Members                                                                */
+    /*---------------------------------------------------------------------------------*/
+    /********************************************************************************//*!
+     @brief     Inserts data into the Hash Table
+
+     @param     Key
+        The key for the value
+     @param     Data
+        The data to insert
+
+     @throws    E_DUPLICATE
+        If the key is already in the table
+     @throws    E_NO_MEMORY
+        If there is no memory for the node or a bigger table
+    *//*********************************************************************************/
+    void        insert  (const char* Key, const T& Data);
+    /********************************************************************************//*!
+     @brief     Deletes an item by key
+
+     @param     Key
+        The key for the value to delete
+
+     @throws    E_ITEM_NOT_FOUND
+        If the key has not been found
+    *//*********************************************************************************/
+    void        remove  (const char* Key);
+    /********************************************************************************//*!
+     @brief     Find data by a given key.
+
+     @param     Key
+        The key for the value to find
+
+     @returns   A copy of the data found by the key
+
+     @throws    E_ITEM_NOT_FOUND
+        If the key has not been found
+    *//*********************************************************************************/
+    T           find    (const char* Key) const;
+    /********************************************************************************//*!
+     @brief     Find data by a given key, without throwing.
+
+     @param     Key
+        The key for the value to find
+     @param     Data
+        Set to a copy of the data found by the key.
+
+     @returns   True if the key has been found.
+    *//*********************************************************************************/
+    bool        lookup  (const char* Key, T& Data) const;
+    /********************************************************************************//*!
+     @brief     Removes all items from the table (Doesn't deallocate table)
+    *//*********************************************************************************/
+    void        clear   ();
+
+private:
+    /*---------------------------------------------------------------------------------*/
+    /* Type Definitions                                                                */
+    /*---------------------------------------------------------------------------------*/
+    /********************************************************************************//*!
+     @brief     A node of a chain. Only Next changes once the node is linked in.
+    *//*********************************************************************************/
+    struct ChHTNode
+    {
+        char                    Key[MAX_KEYLEN];    // Key is a string
+        unsigned                Hash;               // keyHash() of Key, checked before strcmp
+        T                       Data;               // Client data
+        std::atomic<ChHTNode*>  Next;               // Pointer to the next horntail
+        FREEPROC                FreeProc;           // Called on Data when the node is freed, set when it is retired
+
+        ChHTNode(const T& data)
+        : Data      (data)
+        , Next      (nullptr)
+        , FreeProc  (nullptr)
+        {}
+    };
+
+    /********************************************************************************//*!
+     @brief     The heads of the chains, replaced as a whole when the table grows.
+    *//*********************************************************************************/
+    struct ChHTTable
+    {
+        unsigned                Size;   // Number of chains
+        std::atomic<ChHTNode*>* Heads;  // The first node of every chain
+    };
+
+    /********************************************************************************//*!
+     @brief     A lock and the number of keys in its range of buckets, on a cache line
+                of its own.
+    *//*********************************************************************************/
+    struct alignas(64) Stripe
+    {
+        std::mutex              Mutex;
+        std::atomic<unsigned>   Count;  // Written under Mutex, read by GetStats
+    };
+
+    /*---------------------------------------------------------------------------------*/
+    /* Data Members                                                                    */
+    /*---------------------------------------------------------------------------------*/
+    static const unsigned       STRIPES     = 64;   // Number of locks
+
+    std::atomic<ChHTTable*>     table;
+    Stripe                      stripes[STRIPES];
+    std::atomic<unsigned>       expansions;
+
+    HTConfig                    config;
+
+    /*---------------------------------------------------------------------------------*/
+    /* Function Members                                                                */
+    /*---------------------------------------------------------------------------------*/
+    /********************************************************************************//*!
+     @brief     Locks the range of a key's bucket in the current table.
+
+     @param     key
+        The key.
+     @param     current
+        Set to the current table, which can't be replaced while the lock is held.
+     @param     bucket
+        Set to the bucket of the key in it.
+
+     @returns   The lock, held.
+    *//*********************************************************************************/
+    std::unique_lock<std::mutex>    lockBucket  (const char* key, ChHTTable*& current, unsigned& bucket);
+    /********************************************************************************//*!
+     @brief     Finds the node of a key. The caller must hold a Guard for as long as it
+                uses the node.
+
+     @param     key
+        The key to find.
+
+     @returns   The node, or nullptr if the key has not been found.
+    *//*********************************************************************************/
+    const ChHTNode*     findNode    (const char* key) const;
+    /********************************************************************************//*!
+     @brief     Grows the table, unless another thread already has.
+
+     @param     full
+        The table that was found too full.
+    *//*********************************************************************************/
+    void        growTable   (ChHTTable* full);
+    /********************************************************************************//*!
+     @brief     Copies every node of the current table into a bigger one, and publishes
+                it. Every lock must be held.
+
+     @param     full
+        The current table.
+    *//*********************************************************************************/
+    void        copyTable   (ChHTTable* full);
+    /********************************************************************************//*!
+     @brief     Allocates a table with every chain empty.
+
+     @param     size
+        The number of chains.
+
+     @returns   The table.
+
+     @throws    E_NO_MEMORY
+        If there is no memory for it.
+    *//*********************************************************************************/
+    static ChHTTable*   makeTable   (unsigned size);
+    /********************************************************************************//*!
+     @brief     Frees a table and every node still in its chains. Passed to the
+                EpochReclaimer when a table is replaced.
+
+     @param     oldTable
+        The table.
+    *//*********************************************************************************/
+    static void         freeTable   (void* oldTable);
+    /********************************************************************************//*!
+     @brief     Retires a node that has been unlinked. The client's FreeProc is called
+                on its data when it is freed, as readers may still be copying it until
+                then.
+
+     @param     node
+        The node.
+    *//*********************************************************************************/
+    void                retireNode  (ChHTNode* node) const;
+    /********************************************************************************//*!
+     @brief     Frees a node, calling its FreeProc first if it has one. Passed to the
+                EpochReclaimer when a node is removed.
+
+     @param     node
+        The node.
+    *//*********************************************************************************/
+    static void         freeNode    (void* node);
+    /********************************************************************************//*!
+     @brief     Gets the lock range of a bucket.
+
+     @param     bucket
+        The bucket.
+     @param     size
+        The number of buckets.
+
+     @returns   The index of the stripe.
+    *//*********************************************************************************/
+    static unsigned     stripeOf    (unsigned bucket, unsigned size);
+    /********************************************************************************//*!
+     @brief     Gets the number of buckets in a lock range.
+
+     @param     stripe
+        The index of the stripe.
+     @param     size
+        The number of buckets.
+
+     @returns   The number of buckets.
+    *//*********************************************************************************/
+    static unsigned     bucketsIn   (unsigned stripe, unsigned size);
+    /********************************************************************************//*!
+     @brief     Hashes a whole key to 32 bits (FNV-1a), to compare before the key.
+
+     @param     key
+        The key to hash.
+
+     @returns   The hash of the key.
+    *//*********************************************************************************/
+    static unsigned     keyHash     (const char* key);
+};
+
+#include "ConcurrentChHashTable.cpp"
+
+#endif
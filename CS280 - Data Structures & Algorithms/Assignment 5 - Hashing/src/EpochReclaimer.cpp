@@ -0,0 +1,253 @@
+/************************************************************************************//*!
+ @file    EpochReclaimer.cpp
+ @author  Diren D Bharwani, 2002216, diren.dbharwani, diren.dbharwani@digipen.edu
+ @date    Apr 10, 2022
+ @brief   Contains the implementation of the EpochReclaimer
+
+ Copyright (C) 2022 DigiPen Institute of Technology.
+ Reproduction or disclosure of this file or its contents without the prior written
+ consent of DigiPen Institute of Technology is prohibited.
+*//*************************************************************************************/
+
+// Primary Header
+#include "EpochReclaimer.h"
+// Standard Libraries
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <algorithm>
+
+/*-------------------------------------------------------------------------------------*/
+/* Local Helpers                                                                       */
+/*-------------------------------------------------------------------------------------*/
+namespace
+{
+    const unsigned RETIRES_PER_ADVANCE = 64;   //!< Retires between tries to advance the epoch
+
+    /********************************************************************************//*!
+    @brief      An object waiting to be freed, and the epoch it was retired in.
+    *//*********************************************************************************/
+    struct Retired
+    {
+        void*                           Object;
+        EpochReclaimer::RECLAIMPROC     Reclaim;
+        unsigned long long              Epoch;
+    };
+
+    /********************************************************************************//*!
+    @brief      The epoch a thread is reading in, or 0 if it isn't. Kept on a cache line
+                of its own, since its thread writes it on every Guard.
+    *//*********************************************************************************/
+    struct alignas(64) Participant
+    {
+        std::atomic<unsigned long long> Epoch { 0 };
+    };
+
+    /********************************************************************************//*!
+    @brief      The global epoch, every thread taking part, and the retired objects of
+                threads that have exited.
+    *//*********************************************************************************/
+    class Domain
+    {
+    public:
+        /****************************************************************************//*!
+        @brief      Gets the domain every thread shares.
+
+        @returns    The domain.
+        *//*****************************************************************************/
+        static Domain& Instance()
+        {
+            static Domain domain;
+            return domain;
+        }
+
+        /****************************************************************************//*!
+        @brief      Destructor for a Domain. Only runs once every thread is gone, so
+                    nothing left can be read.
+        *//*****************************************************************************/
+        ~Domain()
+        {
+            for (const Retired& retired : orphans)
+                retired.Reclaim(retired.Object);
+        }
+
+        std::atomic<unsigned long long> epoch   { 1 };  //!< Never 0, which means not reading
+
+        /****************************************************************************//*!
+        @brief      Adds a thread.
+
+        @param      participant
+            The epoch of the thread.
+        *//*****************************************************************************/
+        void Join(Participant* participant)
+        {
+            std::lock_guard<std::mutex> lock{ mutex };
+            participants.emplace_back(participant);
+        }
+        /****************************************************************************//*!
+        @brief      Removes a thread, keeping the objects it retired until they are
+                    safe to free.
+
+        @param      participant
+            The epoch of the thread.
+        @param      limbo
+            The objects the thread retired.
+        *//*****************************************************************************/
+        void Leave(Participant* participant, std::vector<Retired>& limbo)
+        {
+            std::lock_guard<std::mutex> lock{ mutex };
+            participants.erase(std::find(participants.begin(), participants.end(), participant));
+            orphans.insert(orphans.end(), limbo.begin(), limbo.end());
+            limbo.clear();
+        }
+        /****************************************************************************//*!
+        @brief      Advances the epoch if every reading thread has seen it, and frees
+                    the objects of exited threads that are now safe.
+
+        @returns    The epoch.
+        *//*****************************************************************************/
+        unsigned long long TryAdvance()
+        {
+            std::vector<Retired> safe;
+            unsigned long long current;
+            {
+                std::lock_guard<std::mutex> lock{ mutex };
+
+                current = epoch.load();
+                const bool ALL_SEEN = std::all_of
+                (
+                    participants.begin(), participants.end(),
+                    [current](const Participant* participant)
+                    {
+                        const unsigned long long READING = participant->Epoch.load();
+                        return READING == 0 || READING == current;
+                    }
+                );
+
+                if (ALL_SEEN)
+                    epoch.store(++current);
+
+                const auto UNSAFE = std::partition
+                (
+                    orphans.begin(), orphans.end(),
+                    [current](const Retired& retired) { return retired.Epoch + 2 <= current; }
+                );
+                safe.assign(orphans.begin(), UNSAFE);
+                orphans.erase(orphans.begin(), UNSAFE);
+            }
+
+            for (const Retired& retired : safe)
+                retired.Reclaim(retired.Object);
+
+            return current;
+        }
+
+    private:
+        std::mutex                  mutex;          //!< Guards everything below
+        std::vector<Participant*>   participants;
+        std::vector<Retired>        orphans;        //!< Retired by threads that have exited
+
+        Domain() = default;
+    };
+
+    /********************************************************************************//*!
+    @brief      A thread's part in the domain, made the first time it reads or retires.
+    *//*********************************************************************************/
+    class ThreadRecord
+    {
+    public:
+        ThreadRecord()
+        : domain    ( Domain::Instance() )
+        {
+            domain.Join(&participant);
+        }
+        ~ThreadRecord()
+        {
+            domain.Leave(&participant, limbo);
+        }
+
+        Domain&                 domain;
+        Participant             participant;
+        std::vector<Retired>    limbo;              //!< Retired by this thread, oldest first
+        unsigned                depth       = 0;    //!< Guards held
+        unsigned                retires     = 0;    //!< Retires since the last try to advance
+
+        /****************************************************************************//*!
+        @brief      Gets the record of the calling thread.
+
+        @returns    The record.
+        *//*****************************************************************************/
+        static ThreadRecord& Current()
+        {
+            static thread_local ThreadRecord record;
+            return record;
+        }
+
+        /****************************************************************************//*!
+        @brief      Frees the objects retired two or more epochs ago.
+
+        @param      current
+            The current epoch.
+        *//*****************************************************************************/
+        void Collect(unsigned long long current)
+        {
+            size_t safe = 0;
+            while (safe < limbo.size() && limbo[safe].Epoch + 2 <= current)
+            {
+                limbo[safe].Reclaim(limbo[safe].Object);
+                ++safe;
+            }
+            limbo.erase(limbo.begin(), limbo.begin() + safe);
+        }
+    };
+}
+
+/*-------------------------------------------------------------------------------------*/
+/* Guard                                                                               */
+/*-------------------------------------------------------------------------------------*/
+/************************************************************************************//*!
+ @brief     Marks the calling thread as reading in the current epoch.
+*//*************************************************************************************/
+EpochReclaimer::Guard::Guard()
+{
+    ThreadRecord& record = ThreadRecord::Current();
+    if (record.depth++ == 0)
+    {
+        // Sequentially consistent, so the epoch is published before any node is read
+        record.participant.Epoch.store(record.domain.epoch.load());
+    }
+}
+/************************************************************************************//*!
+ @brief     Marks the calling thread as done reading, once its outermost Guard ends.
+*//*************************************************************************************/
+EpochReclaimer::Guard::~Guard()
+{
+    ThreadRecord& record = ThreadRecord::Current();
+    if (--record.depth == 0)
+    {
+        record.participant.Epoch.store(0, std::memory_order_release);
+    }
+}
+
+/*-------------------------------------------------------------------------------------*/
+/* Function Members                                                                    */
+/*-------------------------------------------------------------------------------------*/
+/************************************************************************************//*!
+ @brief     Frees an object once no reader can still be visiting it.
+
+ @param     object
+    The object to free.
+ @param     reclaim
+    The function that frees it.
+*//*************************************************************************************/
+void EpochReclaimer::Retire(void* object, RECLAIMPROC reclaim)
+{
+    ThreadRecord& record = ThreadRecord::Current();
+    record.limbo.push_back(Retired{ object, reclaim, record.domain.epoch.load() });
+
+    if (++record.retires >= RETIRES_PER_ADVANCE)
+    {
+        record.retires = 0;
+        record.Collect(record.domain.TryAdvance());
+    }
+}
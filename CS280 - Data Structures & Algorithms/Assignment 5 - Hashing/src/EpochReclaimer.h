@@ -0,0 +1,69 @@
+/************************************************************************************//*!
+ @file    EpochReclaimer.h
+ @author  Diren D Bharwani, 2002216, diren.dbharwani, diren.dbharwani@digipen.edu
+ @date    Apr 10, 2022
+ @brief   Contains the interface for the EpochReclaimer, which frees memory that
+          lock-free readers may still be visiting once they are all done with it.
+
+ Copyright (C) 2022 DigiPen Institute of Technology.
+ Reproduction or disclosure of this file or its contents without the prior written
+ consent of DigiPen Institute of Technology is prohibited.
+*//*************************************************************************************/
+
+#ifndef EPOCHRECLAIMERH
+#define EPOCHRECLAIMERH
+
+/************************************************************************************//*!
+ @brief     Epoch-based reclamation, shared by every structure in the program.
+
+            A reader holds a Guard while it visits shared nodes. A writer that unlinks
+            a node retires it instead of freeing it. Retired objects are stamped with
+            the global epoch, and the epoch only advances once every thread holding a
+            Guard has seen the current one, so an object is freed two epochs after it
+            was retired, when no reader can still reach it.
+
+            Every thread keeps its own list of retired objects and tries to advance
+            the epoch every few retires. The objects of a thread that exits are freed
+            by the threads left.
+*//*************************************************************************************/
+class EpochReclaimer
+{
+public:
+    /*---------------------------------------------------------------------------------*/
+    /* Type Definitions                                                                */
+    /*---------------------------------------------------------------------------------*/
+    /********************************************************************************//*!
+     @brief     Frees a retired object.
+    *//*********************************************************************************/
+    typedef void (*RECLAIMPROC)(void* object);
+
+    /********************************************************************************//*!
+     @brief     Marks the calling thread as reading for as long as it lives. Guards
+                nest.
+    *//*********************************************************************************/
+    class Guard
+    {
+    public:
+        Guard();
+        ~Guard();
+
+        Guard(const Guard&)             = delete;
+        Guard& operator=(const Guard&)  = delete;
+    };
+
+    /*---------------------------------------------------------------------------------*/
+    /* Function Members                                                                */
+    /*---------------------------------------------------------------------------------*/
+    /********************************************************************************//*!
+     @brief     Frees an object once no reader can still be visiting it. The object
+                must already be unreachable for new readers.
+
+     @param     object
+        The object to free.
+     @param     reclaim
+        The function that frees it.
+    *//*********************************************************************************/
+    static void Retire  (void* object, RECLAIMPROC reclaim);
+};
+
+#endif
@@ -0,0 +1,523 @@
+/************************************************************************************//*!
+ @file    OAHashTable.cpp
+ @author  Diren D Bharwani, 2002216, diren.dbharwani, diren.dbharwani@digipen.edu
+ @date    Apr 10, 2022
+ @brief   Contains the implementation of the OAHashTable
+
+ Copyright (C) 2022 DigiPen Institute of Technology.
+ Reproduction or disclosure of this file or its contents without the prior written
+ consent of DigiPen Institute of Technology is prohibited.
+*//*************************************************************************************/
+
+// Standard Libraries
+#include <new>
+#include <cmath>
+#include <cstring>
+#include <utility>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define OAHT_SSE2
+#include <emmintrin.h>
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+// Primary Headers
+#include "OAHashTable.h"
+
+/*-------------------------------------------------------------------------------------*/
+/* Constructors & Destructors                                                          */
+/*-------------------------------------------------------------------------------------*/
+
+/************************************************************************************//*!
+ @brief     Constructor for OAHashTable
+
+ @param     Config
+    The configuration properties for the table.
+*//*************************************************************************************/
+template <typename T>
+OAHashTable<T>::OAHashTable(const HTConfig& Config)
+: controls  { nullptr }
+, slots     { nullptr }
+, deleted   { 0U }
+, maxUsed   { 0U }
+, config    { Config }
+{
+    stats.HashFunc_ = config.HashFunc_;
+
+    unsigned int tableSize = GROUP_SIZE;
+    while (tableSize < config.InitialTableSize_)
+    {
+        tableSize *= 2;
+    }
+
+    allocate(tableSize);
+}
+/************************************************************************************//*!
+ @brief     Destructor for OAHashTable
+*//*************************************************************************************/
+template <typename T>
+OAHashTable<T>::~OAHashTable()
+{
+    clear();
+
+    delete[] controls;
+    ::operator delete(slots);
+}
+
+/*-------------------------------------------------------------------------------------*/
+/* Getter Functions                                                                    */
+/*-------------------------------------------------------------------------------------*/
+/************************************************************************************//*!
+ @brief     Getter for the stats of an OAHashTable.
+
+ @returns   The stats for an OAHashTable.
+*//*************************************************************************************/
+template <typename T>
+HTStats OAHashTable<T>::GetStats() const
+{
+    return stats;
+}
+
+/*-------------------------------------------------------------------------------------*/
+/* Public Function Members                                                             */
+/*-------------------------------------------------------------------------------------*/
+/************************************************************************************//*!
+ @brief     Inserts data into the Hash Table
+
+ @param     Key
+    The key for the value
+ @param     Data
+    The data to insert
+*//*************************************************************************************/
+template <typename T>
+void OAHashTable<T>::insert(const char* Key, const T& Data)
+{
+    const unsigned char TAG = tagOf(Key);
+    if (findSlot(Key, TAG) != stats.TableSize_)
+    {
+        std::string functionSignature;
+        #ifdef _MSC_VER
+        functionSignature = __FUNCTION__;
+        #else
+        functionSignature = __PRETTY_FUNCTION__;
+        #endif
+
+        throw HashTableException
+        (
+            HashTableException::HASHTABLE_EXCEPTION::E_DUPLICATE,
+            functionSignature + ": Attempted to insert duplicate data!"
+        );
+    }
+
+    // Rebuild once the full and deleted slots reach the limit. Grow if the keys alone
+    // are over half of it, otherwise clearing the deleted slots makes enough room.
+    if (stats.Count_ + deleted + 1U > maxUsed)
+    {
+        unsigned int tableSize = stats.TableSize_;
+        if (stats.Count_ + 1U > maxUsed / 2U)
+        {
+            const double ACTUAL_GROWTH_FACTOR = std::ceil(tableSize * config.GrowthFactor_);
+            do
+            {
+                tableSize *= 2;
+            } while (tableSize < ACTUAL_GROWTH_FACTOR || limitFor(tableSize) < stats.Count_ + 1U);
+        }
+
+        const bool GROWING = tableSize != stats.TableSize_;
+        rebuild(tableSize);
+
+        if (GROWING)
+        {
+            ++stats.Expansions_;
+        }
+    }
+
+    const unsigned int SLOT = freeSlot(Key);
+    new (&slots[SLOT].Data) T(Data);
+
+    #ifdef _MSC_VER
+    strcpy_s(slots[SLOT].Key, Key);
+    #else
+    strcpy(slots[SLOT].Key, Key);
+    #endif
+
+    if (controls[SLOT] == DELETED)
+    {
+        --deleted;
+    }
+    controls[SLOT] = TAG;
+
+    ++stats.Count_;
+}
+/************************************************************************************//*!
+ @brief     Deletes an item by key
+
+ @param     Key
+    The key for the value to delete
+
+ @throws    E_ITEM_NOT_FOUND
+    If the key has not been found
+*//*************************************************************************************/
+template <typename T>
+void OAHashTable<T>::remove(const char* Key)
+{
+    const unsigned int SLOT = findSlot(Key, tagOf(Key));
+    if (SLOT == stats.TableSize_)
+    {
+        std::string functionSignature;
+        #ifdef _MSC_VER
+        functionSignature = __FUNCTION__;
+        #else
+        functionSignature = __PRETTY_FUNCTION__;
+        #endif
+
+        throw HashTableException
+        (
+            HashTableException::HASHTABLE_EXCEPTION::E_ITEM_NOT_FOUND,
+            functionSignature + ": Attempted to remove missing data!"
+        );
+    }
+
+    if (config.FreeProc_)
+    {
+        config.FreeProc_(slots[SLOT].Data);
+    }
+    slots[SLOT].Data.~T();
+
+    // No probe has ever gone past a group with an empty slot, so the slot can be empty
+    // again. Otherwise a probe may have, and must keep going past it.
+    const unsigned int GROUP = SLOT & ~(GROUP_SIZE - 1U);
+    if (matchGroup(controls + GROUP, EMPTY))
+    {
+        controls[SLOT] = EMPTY;
+    }
+    else
+    {
+        controls[SLOT] = DELETED;
+        ++deleted;
+    }
+
+    --stats.Count_;
+}
+/************************************************************************************//*!
+ @brief     Find data by a given key.
+
+ @param     Key
+    The key for the value to find
+
+ @returns   The data found by the key
+
+ @throws    E_ITEM_NOT_FOUND
+    If the key has not been found
+*//*************************************************************************************/
+template <typename T>
+const T& OAHashTable<T>::find(const char* Key) const
+{
+    const T* data = lookup(Key);
+    if (data)
+    {
+        return *data;
+    }
+
+    std::string functionSignature;
+    #ifdef _MSC_VER
+    functionSignature = __FUNCTION__;
+    #else
+    functionSignature = __PRETTY_FUNCTION__;
+    #endif
+
+    throw HashTableException
+    (
+        HashTableException::HASHTABLE_EXCEPTION::E_ITEM_NOT_FOUND,
+        functionSignature + ": Attempted to find missing data!"
+    );
+}
+/************************************************************************************//*!
+ @brief     Find data by a given key, without throwing.
+
+ @param     Key
+    The key for the value to find
+
+ @returns   The data found by the key, or nullptr if the key has not been found.
+*//*************************************************************************************/
+template <typename T>
+const T* OAHashTable<T>::lookup(const char* Key) const
+{
+    const unsigned int SLOT = findSlot(Key, tagOf(Key));
+    return SLOT == stats.TableSize_ ? nullptr : &slots[SLOT].Data;
+}
+/************************************************************************************//*!
+ @brief     Removes all items from the table (Doesn't deallocate table)
+*//*************************************************************************************/
+template <typename T>
+void OAHashTable<T>::clear()
+{
+    for (unsigned int i = 0; i < stats.TableSize_; ++i)
+    {
+        if (controls[i] & EMPTY)
+            continue;
+
+        if (config.FreeProc_)
+        {
+            config.FreeProc_(slots[i].Data);
+        }
+        slots[i].Data.~T();
+    }
+
+    std::memset(controls, EMPTY, stats.TableSize_);
+    deleted         = 0U;
+    stats.Count_    = 0U;
+}
+
+/*-------------------------------------------------------------------------------------*/
+/* Private Function Members                                                            */
+/*-------------------------------------------------------------------------------------*/
+/************************************************************************************//*!
+ @brief     Finds the slot of a key.
+
+ @param     key
+    The key to find.
+ @param     tag
+    The 7 bit hash of the key.
+
+ @returns   The index of the slot, or TableSize_ if the key has not been found.
+*//*************************************************************************************/
+template <typename T>
+unsigned OAHashTable<T>::findSlot(const char* key, unsigned char tag) const
+{
+    const unsigned int GROUP_MASK = stats.TableSize_ / GROUP_SIZE - 1U;
+
+    unsigned int group = stats.HashFunc_(key, stats.TableSize_) / GROUP_SIZE;
+    for (unsigned int step = 1; ; ++step)
+    {
+        const unsigned char* GROUP_CONTROLS = controls + group * GROUP_SIZE;
+        ++stats.Probes_;
+
+        for (unsigned int match = matchGroup(GROUP_CONTROLS, tag); match; match &= match - 1U)
+        {
+            const unsigned int SLOT = group * GROUP_SIZE + lowestBit(match);
+            ++stats.Probes_;
+
+            if (!strcmp(slots[SLOT].Key, key))
+            {
+                return SLOT;
+            }
+        }
+
+        if (matchGroup(GROUP_CONTROLS, EMPTY))
+        {
+            return stats.TableSize_;
+        }
+
+        // Triangular steps visit every group of a power of two number of them
+        group = (group + step) & GROUP_MASK;
+    }
+}
+/************************************************************************************//*!
+ @brief     Finds the first empty or deleted slot on the probe sequence of a key.
+
+ @param     key
+    The key to place.
+
+ @returns   The index of the slot.
+*//*************************************************************************************/
+template <typename T>
+unsigned OAHashTable<T>::freeSlot(const char* key) const
+{
+    const unsigned int GROUP_MASK = stats.TableSize_ / GROUP_SIZE - 1U;
+
+    unsigned int group = stats.HashFunc_(key, stats.TableSize_) / GROUP_SIZE;
+    for (unsigned int step = 1; ; ++step)
+    {
+        const unsigned int FREE = freeInGroup(controls + group * GROUP_SIZE);
+        if (FREE)
+        {
+            return group * GROUP_SIZE + lowestBit(FREE);
+        }
+
+        group = (group + step) & GROUP_MASK;
+    }
+}
+/************************************************************************************//*!
+ @brief     Moves every key into a new array of slots, dropping the deleted slots.
+
+ @param     tableSize
+    The number of slots in the new array, a power of two.
+*//*************************************************************************************/
+template <typename T>
+void OAHashTable<T>::rebuild(unsigned tableSize)
+{
+    unsigned char*      oldControls = controls;
+    OAHTSlot*           oldSlots    = slots;
+    const unsigned int  OLD_SIZE    = stats.TableSize_;
+
+    allocate(tableSize);
+
+    for (unsigned int i = 0; i < OLD_SIZE; ++i)
+    {
+        if (oldControls[i] & EMPTY)
+            continue;
+
+        const unsigned int SLOT = freeSlot(oldSlots[i].Key);
+        new (&slots[SLOT].Data) T(std::move(oldSlots[i].Data));
+        oldSlots[i].Data.~T();
+
+        std::memcpy(slots[SLOT].Key, oldSlots[i].Key, MAX_KEYLEN);
+        controls[SLOT] = oldControls[i];
+    }
+
+    delete[] oldControls;
+    ::operator delete(oldSlots);
+}
+/************************************************************************************//*!
+ @brief     Allocates the arrays for a number of slots, with every slot empty.
+
+ @param     tableSize
+    The number of slots, a power of two.
+*//*************************************************************************************/
+template <typename T>
+void OAHashTable<T>::allocate(unsigned tableSize)
+{
+    unsigned char*  newControls = nullptr;
+    OAHTSlot*       newSlots    = nullptr;
+
+    try
+    {
+        newControls = new unsigned char[tableSize];
+        newSlots    = static_cast<OAHTSlot*>(::operator new(sizeof(OAHTSlot) * tableSize));
+    }
+    catch (const std::bad_alloc&)
+    {
+        delete[] newControls;
+
+        std::string functionSignature;
+        #ifdef _MSC_VER
+        functionSignature = __FUNCTION__;
+        #else
+        functionSignature = __PRETTY_FUNCTION__;
+        #endif
+
+        throw HashTableException
+        (
+            HashTableException::HASHTABLE_EXCEPTION::E_NO_MEMORY,
+            functionSignature + ": No memory left to allocate!"
+        );
+    }
+
+    std::memset(newControls, EMPTY, tableSize);
+
+    controls            = newControls;
+    slots               = newSlots;
+    deleted             = 0U;
+    maxUsed             = limitFor(tableSize);
+    stats.TableSize_    = tableSize;
+}
+/************************************************************************************//*!
+ @brief     Gets the number of full and deleted slots that triggers a rebuild of a
+            table, always leaving at least one empty slot so every probe ends.
+
+ @param     tableSize
+    The number of slots in the table.
+
+ @returns   The number of used slots allowed.
+*//*************************************************************************************/
+template <typename T>
+unsigned OAHashTable<T>::limitFor(unsigned tableSize) const
+{
+    const double        LIMIT       = std::floor(tableSize * config.MaxLoadFactor_);
+    const unsigned int  MOST_USED   = tableSize - 1U;
+
+    if (LIMIT < 1.0)
+        return 1U;
+
+    return LIMIT < MOST_USED ? static_cast<unsigned int>(LIMIT) : MOST_USED;
+}
+/************************************************************************************//*!
+ @brief     Finds the slots in a group whose control byte matches a value.
+
+ @param     group
+    The first control byte of the group.
+ @param     value
+    The value to match.
+
+ @returns   A mask with bit i set if slot i of the group matches.
+*//*************************************************************************************/
+template <typename T>
+unsigned OAHashTable<T>::matchGroup(const unsigned char* group, unsigned char value)
+{
+#ifdef OAHT_SSE2
+    const __m128i CONTROLS  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+    const __m128i VALUE     = _mm_set1_epi8(static_cast<char>(value));
+    return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(CONTROLS, VALUE)));
+#else
+    unsigned int mask = 0U;
+    for (unsigned int i = 0; i < GROUP_SIZE; ++i)
+    {
+        mask |= static_cast<unsigned int>(group[i] == value) << i;
+    }
+    return mask;
+#endif
+}
+/************************************************************************************//*!
+ @brief     Finds the empty and deleted slots in a group. Both have the high bit of
+            their control byte set, and full slots don't.
+
+ @param     group
+    The first control byte of the group.
+
+ @returns   A mask with bit i set if slot i of the group is empty or deleted.
+*//*************************************************************************************/
+template <typename T>
+unsigned OAHashTable<T>::freeInGroup(const unsigned char* group)
+{
+#ifdef OAHT_SSE2
+    return static_cast<unsigned>(_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(group))));
+#else
+    unsigned int mask = 0U;
+    for (unsigned int i = 0; i < GROUP_SIZE; ++i)
+    {
+        mask |= static_cast<unsigned int>(group[i] >> 7) << i;
+    }
+    return mask;
+#endif
+}
+/************************************************************************************//*!
+ @brief     Gets the 7 bit hash of a key stored in its control byte, from the top bits
+            of a hash of the whole key (FNV-1a).
+
+ @param     key
+    The key to hash.
+
+ @returns   The control byte for the key.
+*//*************************************************************************************/
+template <typename T>
+unsigned char OAHashTable<T>::tagOf(const char* key)
+{
+    unsigned int hash = 2166136261U;
+    while (*key)
+    {
+        hash ^= static_cast<unsigned char>(*key++);
+        hash *= 16777619U;
+    }
+
+    return static_cast<unsigned char>(hash >> 25);
+}
+/************************************************************************************//*!
+ @brief     Gets the index of the lowest set bit of a non-zero mask.
+
+ @param     mask
+    The mask.
+
+ @returns   The index of the bit.
+*//*************************************************************************************/
+template <typename T>
+unsigned OAHashTable<T>::lowestBit(unsigned mask)
+{
+#if defined(_MSC_VER)
+    unsigned long bit;
+    _BitScanForward(&bit, mask);
+    return static_cast<unsigned>(bit);
+#else
+    return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
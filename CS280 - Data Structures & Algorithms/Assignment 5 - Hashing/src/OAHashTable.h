@@ -0,0 +1,284 @@
+/************************************************************************************//*!
+ @file    OAHashTable.h
+ @author  Diren D Bharwani, 2002216, diren.dbharwani, diren.dbharwani@digipen.edu
+ @date    Apr 10, 2022
+ @brief   Contains the interface for the OAHashTable, an open-addressing companion to
+          the ChHashTable.
+
+ Copyright (C) 2022 DigiPen Institute of Technology.
+ Reproduction or disclosure of this file or its contents without the prior written
+ consent of DigiPen Institute of Technology is prohibited.
+*//*************************************************************************************/
+
+#ifndef OAHASHTABLEH
+#define OAHASHTABLEH
+
+// Project Headers
+#include "ChHashTable.h"    // MAX_KEYLEN, HASHFUNC, HashTableException & HTStats
+
+/************************************************************************************//*!
+ @brief     Encapsulates an open-addressing hash table, with keys and data kept inline
+            in one array of slots, so a lookup follows no pointers.
+
+            Every slot has one control byte: empty, deleted, or 7 bits of a hash of the
+            key in it. The slots are probed 16 at a time. All 16 control bytes are
+            compared against the hash at once (with SSE2 where available), and only
+            the keys of slots that match are compared, so a miss rarely touches a key.
+
+            The table has a power of two number of slots. HashFunc_ picks the group of
+            16 slots to start in, and groups are probed from there in triangular steps,
+            which visit every group. A probe stops at the first group with an empty
+            slot, so removing a key leaves a deleted slot unless its group still has an
+            empty one.
+*//*************************************************************************************/
+template <typename T>
+class OAHashTable
+{
+public:
+    /*---------------------------------------------------------------------------------*/
+    /* Type Definitions                                                                */
+    /*---------------------------------------------------------------------------------*/
+    /********************************************************************************//*!
+     @brief     Callback for freeing data
+    *//*********************************************************************************/
+    typedef void (*FREEPROC)(T); // client-provided free proc (we own the data)
+
+    /********************************************************************************//*!
+     @brief     Encapsulates the properties of the table.
+    *//*********************************************************************************/
+    struct HTConfig
+    {
+    public:
+        /*-----------------------------------------------------------------------------*/
+        /* Data Members                                                                */
+        /*-----------------------------------------------------------------------------*/
+        unsigned    InitialTableSize_;  // The number of slots in the table initially, rounded up to a power of two.
+        double      MaxLoadFactor_;     // The maximum "fullness" of the table, deleted slots included. At most 1 slot less than full.
+        double      GrowthFactor_;      // The factor by which the table grows, rounded up to a power of two.
+        HASHFUNC    HashFunc_;          // The hash function used in all cases.
+        FREEPROC    FreeProc_;          // The method provided by the client that may need to be called when data in the table is removed.
+
+        /*-----------------------------------------------------------------------------*/
+        /* Constructor                                                                 */
+        /*-----------------------------------------------------------------------------*/
+        /****************************************************************************//*!
+         @brief     Constructor for HTConfig
+        *//*****************************************************************************/
+        HTConfig
+        (
+            unsigned    InitialTableSize,
+            HASHFUNC    HashFunc,
+            double      MaxLoadFactor       = 0.875,
+            double      GrowthFactor        = 2.0,
+            FREEPROC    FreeProc            = 0
+        )
+        : InitialTableSize_ (InitialTableSize)
+        , MaxLoadFactor_    (MaxLoadFactor)
+        , GrowthFactor_     (GrowthFactor)
+        , HashFunc_         (HashFunc)
+        , FreeProc_         (FreeProc)
+        {}
+    };
+
+    /*---------------------------------------------------------------------------------*/
+    /* Constructors & Destructor                                                       */
+    /*---------------------------------------------------------------------------------*/
+    /********************************************************************************//*!
+     @brief     Constructor for OAHashTable
+
+     @param     Config
+        The configuration properties for the table.
+    *//*********************************************************************************/
+    OAHashTable(const HTConfig& Config);
+    /********************************************************************************//*!
+     @brief     Destructor for OAHashTable
+    *//*********************************************************************************/
+    ~OAHashTable();
+
+    OAHashTable(const OAHashTable&)             = delete;
+    OAHashTable& operator=(const OAHashTable&)  = delete;
+
+    /*---------------------------------------------------------------------------------*/
+    /* Getter Functions                                                                */
+    /*---------------------------------------------------------------------------------*/
+    /********************************************************************************//*!
+     @brief     Getter for the stats of an OAHashTable. A probe is a group of 16 control
+                bytes scanned or a key compared. Keys are stored inline, so there is
+                never an Allocator_.
+
+     @returns   The stats for an OAHashTable
+    *//*********************************************************************************/
+    HTStats GetStats() const;
+
+    /*---------------------------------------------------------------------------------*/
+    /* Function Members                                                                */
+    /*---------------------------------------------------------------------------------*/
+    /********************************************************************************//*!
+     @brief     Inserts data into the Hash Table
+
+     @param     Key
+        The key for the value
+     @param     Data
+        The data to insert
+
+     @throws    E_DUPLICATE
+        If the key is already in the table
+     @throws    E_NO_MEMORY
+        If the table could not grow
+    *//*********************************************************************************/
+    void        insert  (const char* Key, const T& Data);
+    /********************************************************************************//*!
+     @brief     Deletes an item by key
+
+     @param     Key
+        The key for the value to delete
+
+     @throws    E_ITEM_NOT_FOUND
+        If the key has not been found
+    *//*********************************************************************************/
+    void        remove  (const char* Key);
+    /********************************************************************************//*!
+     @brief     Find data by a given key.
+
+     @param     Key
+        The key for the value to find
+
+     @returns   The data found by the key
+
+     @throws    E_ITEM_NOT_FOUND
+        If the key has not been found
+    *//*********************************************************************************/
+    const T&    find    (const char* Key) const;
+    /********************************************************************************//*!
+     @brief     Find data by a given key, without throwing.
+
+     @param     Key
+        The key for the value to find
+
+     @returns   The data found by the key, or nullptr if the key has not been found.
+    *//*********************************************************************************/
+    const T*    lookup  (const char* Key) const;
+    /********************************************************************************//*!
+     @brief     Removes all items from the table (Doesn't deallocate table)
+    *//*********************************************************************************/
+    void        clear   ();
+
+private:
+    /*---------------------------------------------------------------------------------*/
+    /* Type Definitions                                                                */
+    /*---------------------------------------------------------------------------------*/
+    /********************************************************************************//*!
+     @brief     A key and its data. Data is only constructed in full slots.
+    *//*********************************************************************************/
+    struct OAHTSlot
+    {
+        char        Key[MAX_KEYLEN];    // Key is a string
+        T           Data;               // Client data
+    };
+
+    /*---------------------------------------------------------------------------------*/
+    /* Data Members                                                                    */
+    /*---------------------------------------------------------------------------------*/
+    static const unsigned       GROUP_SIZE  = 16;       // Slots scanned at once
+    static const unsigned char  EMPTY       = 0x80;     // Control byte of a slot never used since the last rebuild
+    static const unsigned char  DELETED     = 0xFE;     // Control byte of a slot whose key was removed
+
+    unsigned char*      controls;   // One control byte per slot
+    OAHTSlot*           slots;      // Raw storage for the slots
+    unsigned            deleted;    // Number of deleted slots
+    unsigned            maxUsed;    // Number of full and deleted slots that triggers a rebuild
+    mutable HTStats     stats;      // Probes_ is counted even in find
+
+    HTConfig          config;
+
+    /*---------------------------------------------------------------------------------*/
+    /* Function Members                                                                */
+    /*---------------------------------------------------------------------------------*/
+    /********************************************************************************//*!
+     @brief     Finds the slot of a key.
+
+     @param     key
+        The key to find.
+     @param     tag
+        The 7 bit hash of the key.
+
+     @returns   The index of the slot, or TableSize_ if the key has not been found.
+    *//*********************************************************************************/
+    unsigned    findSlot    (const char* key, unsigned char tag) const;
+    /********************************************************************************//*!
+     @brief     Finds the first empty or deleted slot on the probe sequence of a key.
+
+     @param     key
+        The key to place.
+
+     @returns   The index of the slot.
+    *//*********************************************************************************/
+    unsigned    freeSlot    (const char* key) const;
+    /********************************************************************************//*!
+     @brief     Moves every key into a new array of slots, dropping the deleted slots.
+
+     @param     tableSize
+        The number of slots in the new array, a power of two.
+    *//*********************************************************************************/
+    void        rebuild     (unsigned tableSize);
+    /********************************************************************************//*!
+     @brief     Allocates the arrays for a number of slots, with every slot empty.
+
+     @param     tableSize
+        The number of slots, a power of two.
+    *//*********************************************************************************/
+    void        allocate    (unsigned tableSize);
+    /********************************************************************************//*!
+     @brief     Gets the number of full and deleted slots that triggers a rebuild of a
+                table, always leaving at least one empty slot so every probe ends.
+
+     @param     tableSize
+        The number of slots in the table.
+
+     @returns   The number of used slots allowed.
+    *//*********************************************************************************/
+    unsigned    limitFor    (unsigned tableSize) const;
+    /********************************************************************************//*!
+     @brief     Finds the slots in a group whose control byte matches a value.
+
+     @param     group
+        The first control byte of the group.
+     @param     value
+        The value to match.
+
+     @returns   A mask with bit i set if slot i of the group matches.
+    *//*********************************************************************************/
+    static unsigned     matchGroup  (const unsigned char* group, unsigned char value);
+    /********************************************************************************//*!
+     @brief     Finds the empty and deleted slots in a group.
+
+     @param     group
+        The first control byte of the group.
+
+     @returns   A mask with bit i set if slot i of the group is empty or deleted.
+    *//*********************************************************************************/
+    static unsigned     freeInGroup (const unsigned char* group);
+    /********************************************************************************//*!
+     @brief     Gets the 7 bit hash of a key stored in its control byte. It comes from a
+                hash of the whole key (FNV-1a), so it is independent of the slot.
+
+     @param     key
+        The key to hash.
+
+     @returns   The control byte for the key.
+    *//*********************************************************************************/
+    static unsigned char tagOf      (const char* key);
+    /********************************************************************************//*!
+     @brief     Gets the index of the lowest set bit of a non-zero mask.
+
+     @param     mask
+        The mask.
+
+     @returns   The index of the bit.
+    *//*********************************************************************************/
+    static unsigned     lowestBit   (unsigned mask);
+};
+
+#include "OAHashTable.cpp"
+
+#endif
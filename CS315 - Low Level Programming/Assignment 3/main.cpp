@@ -5,6 +5,8 @@
 #include <fstream>
 #include <string>
 #include <sstream>
+#include <cmath>
+#include <algorithm>
 
 #include "measure.hpp"
 #include "opt_poly.hpp"
@@ -13,13 +15,112 @@
 #define NUM_ELEMS_MULT  50
 #define UPPER_RAND      9
 #define LOWER_RAND      1
+#define BATCH_POINTS    (1L << 20)
+#define BATCH_REPS      10
+
+using PolyFunc = double(*)(double*, double, long);
+
+// Keeps the results, so no call can be dropped as unused
+volatile double sink;
+
+// Cycles per call of func, less the cost of reading the clock
+double measureCycles(PolyFunc func, double* a, double x, long degree)
+{
+  cyc_time_t start  = PerfClock::measure();
+  cyc_time_t end    = PerfClock::measure();
+  cyc_time_t base   = end - start;
+
+  double sum = 0.0;
+  start = PerfClock::measure();
+  {
+    for (unsigned int j = 0; j < MEASURE_COUNT; ++j)
+      sum += func(a, x, degree);
+  }
+  end   = PerfClock::measure();
+  sink  = sum;
+
+  cyc_time_t numCycles = end - start - base;
+  return numCycles / static_cast<double>(MEASURE_COUNT);
+}
+
+// The compile-time evaluator, called through a pointer like the others
+template <long Degree>
+ESTRIN_NOINLINE double estrinFixed(double* a, double x, long)
+{
+  return Math::poly_estrin<Degree>(a, x);
+}
+
+template <long Degree>
+void compareFixedDegree(double* a, double x)
+{
+  const double OPT    = measureCycles(Math::poly_opt, a, x, Degree);
+  const double ESTRIN = measureCycles(estrinFixed<Degree>, a, x, Degree);
+
+  std::cout << std::fixed << std::setprecision(2)
+            << std::setw(8)   << Degree
+            << std::setw(12)  << OPT
+            << std::setw(12)  << ESTRIN
+            << std::setw(10)  << OPT / ESTRIN << "x" << std::endl;
+}
+
+// Cycles per point, evaluating every point with func in a loop or, without func,
+// with poly_eval_batch
+double measureBatchCycles(PolyFunc func, double* a, long degree, const std::vector<double>& xs, std::vector<double>& out)
+{
+  const long NUM_POINTS = static_cast<long>(xs.size());
+
+  cyc_time_t start  = PerfClock::measure();
+  for (int rep = 0; rep < BATCH_REPS; ++rep)
+  {
+    if (func)
+    {
+      for (long j = 0; j < NUM_POINTS; ++j)
+        out[j] = func(a, xs[j], degree);
+    }
+    else
+    {
+      Math::poly_eval_batch(a, degree, xs.data(), out.data(), NUM_POINTS);
+    }
+  }
+  cyc_time_t end    = PerfClock::measure();
+  sink = out[NUM_POINTS - 1];
+
+  return (end - start) / static_cast<double>(BATCH_REPS * NUM_POINTS);
+}
+
+void compareBatch(double* a, long degree, const std::vector<double>& xs)
+{
+  std::vector<double> expected(xs.size());
+  std::vector<double> out(xs.size());
+
+  const double POLYH  = measureBatchCycles(Math::polyh, a, degree, xs, expected);
+  const double OPT    = measureBatchCycles(Math::poly_opt, a, degree, xs, out);
+  const double BATCH  = measureBatchCycles(nullptr, a, degree, xs, out);
+
+  // Only the rounding of the multiply-adds may differ
+  for (size_t j = 0; j < xs.size(); ++j)
+  {
+    if (std::abs(out[j] - expected[j]) > 1e-9 * std::max(std::abs(expected[j]), 1.0))
+    {
+      std::cout << "poly_eval_batch disagrees with polyh at x = " << xs[j] << std::endl;
+      return;
+    }
+  }
+
+  std::cout << std::fixed << std::setprecision(2)
+            << std::setw(8)   << degree
+            << std::setw(12)  << POLYH
+            << std::setw(12)  << OPT
+            << std::setw(12)  << BATCH
+            << std::setw(10)  << OPT / BATCH << "x" << std::endl;
+}
 
 int main()
 {
   Math::RNG::init();
 
-  double(*funcs[3])(double*, double, long) = { Math::poly, Math::polyh, Math::poly_opt };
-  double cycles[3] = { 0.0 };
+  PolyFunc funcs[4] = { Math::poly, Math::polyh, Math::poly_opt, Math::poly_estrin };
+  double cycles[4] = { 0.0 };
 
   // Open file to write to
   std::ofstream csvFile { "cpe2.csv" };
@@ -30,9 +131,9 @@ int main()
   }
 
   // Headers
-  csvFile << "Num Elems,poly,polyh,opt_poly" << std::endl;
+  csvFile << "Num Elems,poly,polyh,opt_poly,estrin" << std::endl;
   // First line
-  csvFile << "0,0,0,0" << std::endl;
+  csvFile << "0,0,0,0,0" << std::endl;
 
   long numSteps = 40L;
   for (long step = 1L; step <= numSteps; ++step)
@@ -44,35 +145,42 @@ int main()
     for (long i = 0L; i < NUM_ELEMS; ++i)
       coeffs.emplace_back(static_cast<double>(Math::RNG::generateNumber<int>(LOWER_RAND, UPPER_RAND)));
 
-    // Get base time
-    cyc_time_t start  = 0;
-    cyc_time_t end    = 0;
-
-    start = PerfClock::measure();
-    end   = PerfClock::measure();
-    cyc_time_t base = end - start;
-
-    for (int i = 0; i < 3; ++i)
-    {
-      start = PerfClock::measure();
-      {
-        for (unsigned int j = 0; j < MEASURE_COUNT; ++j)
-          funcs[i](coeffs.data(), x, NUM_ELEMS);
-      }
-      end   = PerfClock::measure();
-
-      cyc_time_t numCycles = end - start - base;
-      cycles[i] = (numCycles / static_cast<double>(MEASURE_COUNT));
-    }
+    // NUM_ELEMS coefficients, so the last is a[NUM_ELEMS - 1]
+    for (int i = 0; i < 4; ++i)
+      cycles[i] = measureCycles(funcs[i], coeffs.data(), x, NUM_ELEMS - 1);
 
     csvFile << std::fixed << std::setprecision(4) 
             << NUM_ELEMS  << ","
             << cycles[0]  << ","
             << cycles[1]  << ","
-            << cycles[2]  << std::endl;
+            << cycles[2]  << ","
+            << cycles[3]  << std::endl;
   }
 
   csvFile.close();
 
+  // Degrees known at compile time, against poly_opt at the same degree
+  std::vector<double> coeffs;
+  for (long i = 0L; i <= 63L; ++i)
+    coeffs.emplace_back(static_cast<double>(Math::RNG::generateNumber<int>(LOWER_RAND, UPPER_RAND)));
+  const double x = 1.0 / static_cast<double>(Math::RNG::generateNumber<int>(2, 4));
+
+  std::cout << std::setw(8) << "degree" << std::setw(12) << "poly_opt" << std::setw(12) << "estrin" << std::setw(11) << "speedup" << std::endl;
+  compareFixedDegree<3>   (coeffs.data(), x);
+  compareFixedDegree<7>   (coeffs.data(), x);
+  compareFixedDegree<15>  (coeffs.data(), x);
+  compareFixedDegree<31>  (coeffs.data(), x);
+  compareFixedDegree<63>  (coeffs.data(), x);
+
+  // One polynomial at many points, in cycles per point
+  std::vector<double> xs;
+  for (long j = 0L; j < BATCH_POINTS; ++j)
+    xs.emplace_back(Math::RNG::generateNumber<double>(-1.0, 1.0));
+
+  std::cout << std::endl << std::setw(8) << "degree" << std::setw(12) << "polyh" << std::setw(12) << "poly_opt"
+            << std::setw(12) << "batch" << std::setw(11) << "speedup" << std::endl;
+  for (long degree : { 3L, 7L, 15L, 31L, 63L })
+    compareBatch(coeffs.data(), degree, xs);
+
   return 0;
 }
\ No newline at end of file
@@ -10,6 +10,24 @@
 
 #include "opt_poly.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+// The loops over the chains must unroll, or the chains are kept in memory
+#ifdef __GNUC__
+  #define POLY_UNROLL _Pragma("GCC unroll 8")
+#else
+  #define POLY_UNROLL
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+  #define POLY_X86
+  #include <immintrin.h>
+#endif
+
 namespace Math
 {
   std::default_random_engine RNG::rng;
@@ -74,6 +92,179 @@ namespace Math
 
     return result;
   }
-}
 
+  namespace
+  {
+    using EstrinBlock = double(*)(const double*, const double*);
+
+    // poly_estrin<0> ... poly_estrin<ESTRIN_MAX_DEGREE>, indexed by degree
+    template <std::size_t... Degree>
+    constexpr std::array<EstrinBlock, sizeof...(Degree)> makeEstrinTable(std::index_sequence<Degree...>)
+    {
+      return {{ &poly_estrin<static_cast<long>(Degree)>... }};
+    }
+
+    constexpr auto ESTRIN_TABLE = makeEstrinTable(std::make_index_sequence<ESTRIN_MAX_DEGREE + 1>{});
+  }
+
+  double poly_estrin(double* a, double x, long degree)
+  {
+    static constexpr long BLOCK = ESTRIN_MAX_DEGREE + 1;
+    static constexpr std::size_t LEVELS = Estrin::levels(BLOCK);
+
+    // One more rung than a block needs, for x^BLOCK to chain them
+    const auto LADDER = Estrin::powerLadder(x, std::make_index_sequence<LEVELS + 1>{});
+
+    // The coefficients past the last full block, as a block of their own degree
+    const long FULL_BLOCKS  = (degree + 1) / BLOCK;
+    const long LEFT_OVER    = (degree + 1) % BLOCK;
+    double result = LEFT_OVER > 0 ? ESTRIN_TABLE[LEFT_OVER - 1](a + FULL_BLOCKS * BLOCK, LADDER.data()) : 0.0;
+
+    for (long i = FULL_BLOCKS - 1; i >= 0; --i)
+      result = poly_estrin<ESTRIN_MAX_DEGREE>(a + i * BLOCK, LADDER.data()) + LADDER[LEVELS] * result;
+
+    return result;
+  }
+
+  namespace
+  {
+    // Horner chains in flight at once. A multiply-add takes 4 cycles and 2 can
+    // start every cycle, so more chains keep more of them busy, up to the
+    // registers there are to hold them.
+    static constexpr long CHAINS                = 6;
+    // Below this many points a thread costs more to start than it saves
+    static constexpr long MIN_POINTS_PER_THREAD = 1L << 15;
+
+    using BatchKernel = void(*)(const double*, long, const double*, double*, long);
+
+    void evalBatchGeneric(const double* a, long degree, const double* xs, double* out, long n)
+    {
+      long j = 0;
+      for (; j + CHAINS <= n; j += CHAINS)
+      {
+        double result[CHAINS];
+        POLY_UNROLL
+        for (long k = 0; k < CHAINS; ++k)
+          result[k] = a[degree];
+
+        for (long i = degree - 1; i >= 0; --i)
+        {
+          POLY_UNROLL
+          for (long k = 0; k < CHAINS; ++k)
+            result[k] = a[i] + xs[j + k] * result[k];
+        }
+
+        POLY_UNROLL
+        for (long k = 0; k < CHAINS; ++k)
+          out[j + k] = result[k];
+      }
+
+      for (; j < n; ++j)
+      {
+        double result = a[degree];
+        for (long i = degree - 1; i >= 0; --i)
+          result = a[i] + xs[j] * result;
+        out[j] = result;
+      }
+    }
 
+#ifdef POLY_X86
+    __attribute__((target("avx2,fma")))
+    void evalBatchAvx2(const double* a, long degree, const double* xs, double* out, long n)
+    {
+      static constexpr long LANES = 4;
+
+      long j = 0;
+      for (; j + CHAINS * LANES <= n; j += CHAINS * LANES)
+      {
+        __m256d x[CHAINS];
+        __m256d result[CHAINS];
+        POLY_UNROLL
+        for (long k = 0; k < CHAINS; ++k)
+        {
+          x[k]      = _mm256_loadu_pd(xs + j + k * LANES);
+          result[k] = _mm256_broadcast_sd(a + degree);
+        }
+
+        for (long i = degree - 1; i >= 0; --i)
+        {
+          const __m256d COEFF = _mm256_broadcast_sd(a + i);
+          POLY_UNROLL
+          for (long k = 0; k < CHAINS; ++k)
+            result[k] = _mm256_fmadd_pd(result[k], x[k], COEFF);
+        }
+
+        POLY_UNROLL
+        for (long k = 0; k < CHAINS; ++k)
+          _mm256_storeu_pd(out + j + k * LANES, result[k]);
+      }
+
+      for (; j + LANES <= n; j += LANES)
+      {
+        const __m256d X = _mm256_loadu_pd(xs + j);
+        __m256d result  = _mm256_broadcast_sd(a + degree);
+        for (long i = degree - 1; i >= 0; --i)
+          result = _mm256_fmadd_pd(result, X, _mm256_broadcast_sd(a + i));
+        _mm256_storeu_pd(out + j, result);
+      }
+
+      // Rounded like the lanes, so a point gets the same result wherever it is
+      for (; j < n; ++j)
+      {
+        double result = a[degree];
+        for (long i = degree - 1; i >= 0; --i)
+          result = std::fma(result, xs[j], a[i]);
+        out[j] = result;
+      }
+    }
+#endif
+
+    BatchKernel selectBatchKernel()
+    {
+#ifdef POLY_X86
+      __builtin_cpu_init();
+      if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+        return evalBatchAvx2;
+#endif
+      return evalBatchGeneric;
+    }
+  }
+
+  void poly_eval_batch(const double* a, long degree, const double* xs, double* out, long n)
+  {
+    static const BatchKernel KERNEL = selectBatchKernel();
+
+    if (n <= 0)
+      return;
+
+    const long HARDWARE = std::max(static_cast<long>(std::thread::hardware_concurrency()), 1L);
+    const long THREADS  = std::clamp(n / MIN_POINTS_PER_THREAD, 1L, HARDWARE);
+    if (THREADS == 1)
+    {
+      KERNEL(a, degree, xs, out, n);
+      return;
+    }
+
+    // Whole passes of the widest kernel, so only the last part has a tail
+    static constexpr long PASS = CHAINS * 4;
+    const long PART = ((n + THREADS - 1) / THREADS + PASS - 1) / PASS * PASS;
+
+    // The calling thread takes the first part
+    std::vector<std::thread> threads;
+    long start = PART;
+    try
+    {
+      for (; start < n; start += PART)
+        threads.emplace_back(KERNEL, a, degree, xs + start, out + start, std::min(PART, n - start));
+    }
+    catch (const std::system_error&)
+    {
+      // Evaluate the parts no thread was started for here
+      KERNEL(a, degree, xs + start, out + start, n - start);
+    }
+
+    KERNEL(a, degree, xs, out, std::min(PART, n));
+    for (std::thread& thread : threads)
+      thread.join();
+  }
+}
@@ -12,12 +12,108 @@
 #include <chrono>
 #include <numeric>
 #include <random>
+#include <array>
+#include <cstddef>
+#include <utility>
+
+// The Estrin helpers only make sense unrolled into one body, so they are always inlined
+#ifdef _WIN32
+  #define ESTRIN_INLINE __forceinline
+#else
+  #define ESTRIN_INLINE inline __attribute__((always_inline))
+#endif
+
+// Keeps a function measured through a pointer from being folded into its caller
+#ifdef _WIN32
+  #define ESTRIN_NOINLINE __declspec(noinline)
+#else
+  #define ESTRIN_NOINLINE __attribute__((noinline))
+#endif
 
 namespace Math
 {
-  [[maybe_unused]] double poly     (double* a, double x, long degree);
-  [[maybe_unused]] double polyh    (double* a, double x, long degree);
-  [[maybe_unused]] double poly_opt (double* a, double x, long degree);
+  [[maybe_unused]] double poly        (double* a, double x, long degree);
+  [[maybe_unused]] double polyh       (double* a, double x, long degree);
+  [[maybe_unused]] double poly_opt    (double* a, double x, long degree);
+  // Estrin blocks of up to ESTRIN_MAX_DEGREE + 1 coefficients, chained like Horner
+  [[maybe_unused]] double poly_estrin (double* a, double x, long degree);
+
+  /**
+   * Evaluates one polynomial at n points, out[j] = a(xs[j]), with Horner's rule
+   * across the lanes of the vector units and several independent chains at once.
+   * Uses AVX2 and FMA where the CPU has them, and threads once n is large enough.
+   * With FMA every result is rounded once per coefficient, so it may differ from
+   * polyh in the last bits.
+   */
+  [[maybe_unused]] void poly_eval_batch (const double* a, long degree, const double* xs, double* out, long n);
+
+  static constexpr long ESTRIN_MAX_DEGREE = 15;
+
+  namespace Estrin
+  {
+    // Number of times a count of terms is halved to get to 1
+    constexpr std::size_t levels(std::size_t count)
+    {
+      std::size_t result = 0;
+      for (; count > 1; count = (count + 1) / 2)
+        ++result;
+      return result;
+    }
+
+    // x, x^2, x^4 ... x^(2^(N-1)), each the square of the one before
+    template <std::size_t... Level>
+    ESTRIN_INLINE std::array<double, sizeof...(Level)> powerLadder(double x, std::index_sequence<Level...>)
+    {
+      std::array<double, sizeof...(Level)> ladder {};
+      ((ladder[Level] = x, x *= x), ...);
+      return ladder;
+    }
+
+    // Pairs neighbouring terms into t[2i] + power * t[2i + 1]. An odd last term is
+    // carried up as it is.
+    template <std::size_t N, std::size_t... Pair>
+    ESTRIN_INLINE std::array<double, sizeof...(Pair)> fold(const double* terms, double power, std::index_sequence<Pair...>)
+    {
+      return {{ (2 * Pair + 1 < N ? terms[2 * Pair] + power * terms[2 * Pair + 1] : terms[2 * Pair])... }};
+    }
+
+    // Folds the N terms level by level, with x^(2^level) from the ladder, until one
+    // is left. Every level is independent of the others but for its input, so a
+    // level of k pairs is k multiply-adds in flight at once.
+    template <std::size_t N>
+    ESTRIN_INLINE double reduce(const double* terms, const double* ladder)
+    {
+      if constexpr (N == 1)
+      {
+        return terms[0];
+      }
+      else
+      {
+        const std::array<double, (N + 1) / 2> FOLDED = fold<N>(terms, ladder[0], std::make_index_sequence<(N + 1) / 2>{});
+        return reduce<(N + 1) / 2>(FOLDED.data(), ladder + 1);
+      }
+    }
+  }
+
+  /**
+   * Evaluates a polynomial of a degree known at compile time with the Estrin scheme,
+   * fully unrolled. The ladder of x^(2^level) must have a power for every level, as
+   * from Estrin::powerLadder.
+   */
+  template <long Degree>
+  ESTRIN_INLINE double poly_estrin(const double* a, const double* ladder)
+  {
+    static_assert(Degree >= 0, "The degree of a polynomial can't be negative.");
+    return Estrin::reduce<Degree + 1>(a, ladder);
+  }
+
+  template <long Degree>
+  double poly_estrin(const double* a, double x)
+  {
+    constexpr std::size_t LEVELS = Estrin::levels(Degree + 1);
+    const auto LADDER = Estrin::powerLadder(x, std::make_index_sequence<LEVELS == 0 ? 1 : LEVELS>{});
+    return poly_estrin<Degree>(a, LADDER.data());
+  }
 
   class RNG
   {